@@ -6,6 +6,7 @@
 #include <Beam/Codecs/ZLibEncoder.hpp>
 #include <Beam/IO/SharedBuffer.hpp>
 #include <Beam/Network/TcpServerSocket.hpp>
+#include <Beam/Queues/RoutineTaskQueue.hpp>
 #include <Beam/Serialization/BinaryReceiver.hpp>
 #include <Beam/Serialization/BinarySender.hpp>
 #include <Beam/ServiceLocator/ApplicationDefinitions.hpp>
@@ -53,13 +54,13 @@ namespace {
   using MarketDataRelayServletContainer =
     ServiceProtocolServletContainer<MetaAuthenticationServletAdapter<
     MetaMarketDataRelayServlet<IncomingMarketDataClient,
-    ApplicationAdministrationClient::Client*>,
+    ApplicationAdministrationClient::Client*, std::unique_ptr<LiveTimer>>,
     ApplicationServiceLocatorClient::Client*, NativePointerPolicy>,
     TcpServerSocket, BinarySender<SharedBuffer>,
     SizeDeclarativeEncoder<ZLibEncoder>, std::shared_ptr<LiveTimer>>;
   using BaseMarketDataRelayServlet = MarketDataRelayServlet<
     MarketDataRelayServletContainer, IncomingMarketDataClient,
-    ApplicationAdministrationClient::Client*>;
+    ApplicationAdministrationClient::Client*, std::unique_ptr<LiveTimer>>;
 
   struct MarketDataRelayServerConnectionInitializer {
     std::string m_serviceName;
@@ -209,6 +210,7 @@ int main(int argc, const char** argv) {
       std::move(marketToMarketDataClients)));
   };
   auto baseRegistryServlet = optional<BaseMarketDataRelayServlet>();
+  auto metricsInterval = optional<time_duration>();
   try {
     auto entitlements = administrationClient->LoadEntitlements();
     auto clientTimeout = Extract<time_duration>(config, "connection_timeout",
@@ -217,8 +219,17 @@ int main(int argc, const char** argv) {
       "min_connections", thread::hardware_concurrency()));
     auto maxConnections = static_cast<std::size_t>(Extract<int>(config,
       "max_connections", 10 * minConnections));
+    auto rebalanceInterval = Extract<time_duration>(config,
+      "rebalance_interval", minutes(1));
+    auto conflationInterval = Extract<time_duration>(config,
+      "conflation_interval", milliseconds(100));
+    if(config["metrics_interval"]) {
+      metricsInterval = Extract<time_duration>(config, "metrics_interval");
+    }
     baseRegistryServlet.emplace(entitlements, clientTimeout,
       marketDataClientBuilder, minConnections, maxConnections,
+      rebalanceInterval,
+      std::make_unique<LiveTimer>(conflationInterval, Ref(timerThreadPool)),
       &*administrationClient, Ref(timerThreadPool));
   } catch(const std::exception& e) {
     std::cerr << "Error initializing registry servlet: " << e.what() <<
@@ -254,6 +265,32 @@ int main(int argc, const char** argv) {
     std::cerr << "Error registering service: " << e.what() << std::endl;
     return -1;
   }
+  auto metricsTasks = RoutineTaskQueue();
+  auto metricsTimer = optional<LiveTimer>();
+  if(metricsInterval) {
+    metricsTimer.emplace(*metricsInterval, Ref(timerThreadPool));
+    metricsTimer->GetPublisher().Monitor(metricsTasks.GetSlot<Timer::Result>(
+      [&] (auto result) {
+        if(result != Timer::Result::EXPIRED) {
+          return;
+        }
+        auto metrics = baseRegistryServlet->GetRealTimeQueryEntryMetrics();
+        for(auto i = std::size_t(0); i != metrics.size(); ++i) {
+          std::cout << "Upstream client " << i << ": subscriptions=" <<
+            metrics[i].m_subscriptionCount << " messages=" <<
+            metrics[i].m_messageCount << " rate=" <<
+            metrics[i].m_messageRate << " queue_depth=" <<
+            metrics[i].m_queueDepth << std::endl;
+        }
+        metricsTimer->Start();
+      }));
+    metricsTimer->Start();
+  }
   WaitForKillEvent();
+  if(metricsTimer) {
+    metricsTimer->Cancel();
+  }
+  metricsTasks.Break();
+  metricsTasks.Wait();
   return 0;
 }
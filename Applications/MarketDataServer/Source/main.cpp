@@ -26,6 +26,7 @@
 #include "Nexus/MarketDataService/AsyncHistoricalDataStore.hpp"
 #include "Nexus/MarketDataService/MarketDataFeedServlet.hpp"
 #include "Nexus/MarketDataService/MarketDataRegistry.hpp"
+#include "Nexus/MarketDataService/MarketDataRegistryCheckpointer.hpp"
 #include "Nexus/MarketDataService/MarketDataRegistryServlet.hpp"
 #include "Nexus/MarketDataService/SessionCachedHistoricalDataStore.hpp"
 #include "Nexus/MarketDataService/SqlHistoricalDataStore.hpp"
@@ -55,20 +56,22 @@ namespace {
     MetaAuthenticationServletAdapter<MetaMarketDataRegistryServlet<
     MarketDataRegistry*, SessionCachedHistoricalDataStore<
     AsyncHistoricalDataStore<SqlDataStore*>*>,
-    ApplicationAdministrationClient::Client*>,
+    ApplicationAdministrationClient::Client*, std::unique_ptr<LiveTimer>>,
     ApplicationServiceLocatorClient::Client*, NativePointerPolicy>,
     TcpServerSocket, BinarySender<SharedBuffer>, NullEncoder,
     std::shared_ptr<LiveTimer>>;
   using BaseRegistryServlet = MarketDataRegistryServlet<
     RegistryServletContainer, MarketDataRegistry*,
     SessionCachedHistoricalDataStore<AsyncHistoricalDataStore<SqlDataStore*>*>,
-    ApplicationAdministrationClient::Client*>;
+    ApplicationAdministrationClient::Client*, std::unique_ptr<LiveTimer>>;
   using FeedServletContainer = ServiceProtocolServletContainer<
     MetaAuthenticationServletAdapter<
     MetaMarketDataFeedServlet<BaseRegistryServlet*>,
     ApplicationServiceLocatorClient::Client*>, TcpServerSocket,
     BinarySender<SharedBuffer>, SizeDeclarativeEncoder<ZLibEncoder>,
     std::shared_ptr<LiveTimer>>;
+  using Checkpointer = MarketDataRegistryCheckpointer<MarketDataRegistry*,
+    std::unique_ptr<LiveTimer>>;
 
   JsonValue ParseCountries(const YAML::Node& config,
       const CountryDatabase& countryDatabase) {
@@ -84,6 +87,15 @@ namespace {
     return countries;
   }
 
+  ptime GetSessionStart(time_duration sessionStartTime) {
+    auto currentTime = microsec_clock::universal_time();
+    auto sessionStart = ptime(currentTime.date(), sessionStartTime);
+    if(sessionStart > currentTime) {
+      sessionStart -= hours(24);
+    }
+    return sessionStart;
+  }
+
   struct RegistryServerConnectionInitializer {
     std::string m_serviceName;
     IpAddress m_interface;
@@ -225,11 +237,30 @@ int main(int argc, const char** argv) {
   auto asyncDataStore = optional<AsyncHistoricalDataStore<SqlDataStore*>>();
   auto marketDataRegistry = MarketDataRegistry();
   auto baseRegistryServlet = optional<BaseRegistryServlet>();
+  auto checkpointer = optional<Checkpointer>();
   try {
     auto cacheBlockSize = Extract<int>(config, "cache_block_size", 1000);
+    auto conflationInterval = Extract<time_duration>(config,
+      "conflation_interval", milliseconds(100));
+    auto searchRankInterval = Extract<time_duration>(config,
+      "search_rank_interval", minutes(1));
+    auto checkpointPath = Extract<std::string>(config, "checkpoint_path",
+      "checkpoints");
+    auto checkpointInterval = Extract<time_duration>(config,
+      "checkpoint_interval", minutes(1));
+    auto sessionStartTime = Extract<time_duration>(config,
+      "session_start_time", hours(0));
     asyncDataStore.emplace(&historicalDataStore);
     baseRegistryServlet.emplace(&*administrationClient, &marketDataRegistry,
-      Initialize(&*asyncDataStore, cacheBlockSize));
+      Initialize(&*asyncDataStore, cacheBlockSize),
+      std::make_unique<LiveTimer>(conflationInterval, Ref(timerThreadPool)),
+      std::make_unique<LiveTimer>(searchRankInterval, Ref(timerThreadPool)));
+    if(auto checkpoint = LoadLatestCheckpoint(checkpointPath,
+        GetSessionStart(sessionStartTime))) {
+      marketDataRegistry.Restore(*checkpoint, *asyncDataStore);
+    }
+    checkpointer.emplace(&marketDataRegistry, checkpointPath,
+      std::make_unique<LiveTimer>(checkpointInterval, Ref(timerThreadPool)));
   } catch(const std::exception& e) {
     std::cerr << "Error initializing server: " << e.what() << std::endl;
     return -1;
@@ -29,43 +29,6 @@ namespace {
   const auto UPDATE_INTERVAL = 100;
   const auto EXPIRY_INTERVAL = 500;
 
-  void QueryDailyOrderSubmissions(const UserProfile& userProfile,
-      const DirectoryEntry& account, ScopedQueueWriter<const Order*> queue) {
-    Spawn(
-      [&userProfile, account, queue = std::move(queue)] () mutable {
-        auto currentTime =
-          userProfile.GetServiceClients().GetTimeClient().GetTime();
-        auto lastSequence = Beam::Queries::Sequence::First();
-        auto timeOfDay =
-          userProfile.GetServiceClients().GetTimeClient().GetTime();
-        for(auto& market : userProfile.GetMarketDatabase().GetEntries()) {
-          auto snapshotQuery = BuildDailyOrderSubmissionQuery(market.m_code,
-            account, timeOfDay, timeOfDay, userProfile.GetMarketDatabase(),
-            userProfile.GetTimeZoneDatabase());
-          auto snapshotQueue = std::make_shared<Queue<SequencedOrder>>();
-          userProfile.GetServiceClients().GetOrderExecutionClient().
-            QueryOrderSubmissions(snapshotQuery, snapshotQueue);
-          try {
-            while(true) {
-              auto value = snapshotQueue->Pop();
-              queue.Push(value.GetValue());
-              lastSequence = std::max(lastSequence, value.GetSequence());
-            }
-          } catch(const std::exception&) {}
-        }
-        auto query = AccountQuery();
-        query.SetIndex(account);
-        query.SetSnapshotLimit(SnapshotLimit::Unlimited());
-        if(lastSequence == Beam::Queries::Sequence::First()) {
-          query.SetRange(currentTime, pos_infin);
-        } else {
-          query.SetRange(Increment(lastSequence), pos_infin);
-        }
-        userProfile.GetServiceClients().GetOrderExecutionClient().
-          QueryOrderSubmissions(query, std::move(queue));
-      });
-  }
-
   struct UniqueFilter {
     std::unordered_set<const Order*> m_orders;
 
@@ -90,7 +53,10 @@ BlotterTasksModel::BlotterTasksModel(Ref<UserProfile> userProfile,
   m_taskSlotHandler.emplace();
   if(isConsolidated) {
     auto orderQueue = std::make_shared<Queue<const Order*>>();
-    QueryDailyOrderSubmissions(*m_userProfile, m_executingAccount, orderQueue);
+    MonitorDailyOrderSubmissions(m_executingAccount,
+      m_userProfile->GetServiceClients().GetTimeClient().GetTime(),
+      m_userProfile->GetMarketDatabase(), m_userProfile->GetTimeZoneDatabase(),
+      m_userProfile->GetServiceClients().GetOrderExecutionClient(), orderQueue);
     m_accountOrderPublisher = MakeSequencePublisherAdaptor(
       std::make_shared<QueueReaderPublisher<const Order*>>(orderQueue));
   } else {
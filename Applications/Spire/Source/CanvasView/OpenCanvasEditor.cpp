@@ -209,14 +209,15 @@ void OpenEditorCanvasNodeVisitor::Visit(const DestinationNode& node) {
   auto editor = new QComboBox();
   auto marketCode = node.GetMarket();
   auto& destinationDatabase = m_userProfile->GetDestinationDatabase();
-  auto destinations = destinationDatabase.SelectEntries(
-    [=] (const DestinationDatabase::Entry& entry) -> bool {
-      if(marketCode.IsEmpty()) {
-        return true;
-      }
-      return find(entry.m_markets.begin(), entry.m_markets.end(), marketCode) !=
-        entry.m_markets.end();
-    });
+  auto destinations = [&] {
+    if(marketCode.IsEmpty()) {
+      return destinationDatabase.SelectEntries(
+        [] (const DestinationDatabase::Entry& entry) {
+          return true;
+        });
+    }
+    return destinationDatabase.FromMarket(marketCode);
+  }();
   if(m_userProfile->IsAdministrator() &&
       destinationDatabase.GetManualOrderEntryDestination().is_initialized()) {
     destinations.push_back(
@@ -2,6 +2,7 @@
 #include <Beam/Queues/RoutineTaskQueue.hpp>
 #include <Beam/Threading/Sync.hpp>
 #include <boost/algorithm/string/case_conv.hpp>
+#include "Nexus/MarketDataService/MarketDataRegistryServices.hpp"
 #include "Nexus/ServiceClients/VirtualServiceClients.hpp"
 #include "Spire/UI/CustomQtVariants.hpp"
 #include "Spire/UI/UserProfile.hpp"
@@ -44,7 +45,8 @@ void SecurityInfoModel::Search(const string& prefix) {
     [=] {
       vector<SecurityInfo> securityInfoItems =
         selfUserProfile->GetServiceClients().GetMarketDataClient().
-        LoadSecurityInfoFromPrefix(uppercasePrefix);
+        LoadSecurityInfoFromPrefix(uppercasePrefix, Security(),
+        MarketDataService::DEFAULT_SECURITY_INFO_PAGE_SIZE);
       With(*isAliveFlag,
         [&] (bool isAliveFlag) {
           if(!isAliveFlag) {
@@ -34,6 +34,8 @@ namespace Nexus::WebPortal {
 
       Beam::WebServices::HttpResponse OnLoadSecurityInfoFromPrefix(
         const Beam::WebServices::HttpRequest& request);
+      Beam::WebServices::HttpResponse OnLoadSecurityInfoPageFromPrefix(
+        const Beam::WebServices::HttpRequest& request);
   };
 }
 
@@ -1,7 +1,9 @@
 #include "WebPortal/MarketDataWebServlet.hpp"
+#include <algorithm>
 #include <Beam/WebServices/HttpRequest.hpp>
 #include <Beam/WebServices/HttpResponse.hpp>
 #include <Beam/WebServices/HttpServerPredicates.hpp>
+#include "Nexus/MarketDataService/MarketDataRegistryServices.hpp"
 #include "WebPortal/WebPortalSession.hpp"
 
 using namespace Beam;
@@ -28,6 +30,10 @@ std::vector<HttpRequestSlot> MarketDataWebServlet::GetSlots() {
     "/api/market_data_service/load_security_info_from_prefix"),
     std::bind(&MarketDataWebServlet::OnLoadSecurityInfoFromPrefix, this,
     std::placeholders::_1));
+  slots.emplace_back(MatchesPath(HttpMethod::POST,
+    "/api/market_data_service/load_security_info_page_from_prefix"),
+    std::bind(&MarketDataWebServlet::OnLoadSecurityInfoPageFromPrefix, this,
+    std::placeholders::_1));
   return slots;
 }
 
@@ -54,7 +60,36 @@ HttpResponse MarketDataWebServlet::OnLoadSecurityInfoFromPrefix(
   auto& serviceClients = session->GetServiceClients();
   auto securityInfos =
     serviceClients.GetMarketDataClient().LoadSecurityInfoFromPrefix(
-    parameters.m_prefix);
+    parameters.m_prefix, Security(), DEFAULT_SECURITY_INFO_PAGE_SIZE);
+  session->ShuttleResponse(securityInfos, Store(response));
+  return response;
+}
+
+HttpResponse MarketDataWebServlet::OnLoadSecurityInfoPageFromPrefix(
+    const HttpRequest& request) {
+  struct Parameters {
+    std::string m_prefix;
+    Security m_start;
+    int m_count = DEFAULT_SECURITY_INFO_PAGE_SIZE;
+
+    void Shuttle(JsonReceiver<SharedBuffer>& shuttle, unsigned int version) {
+      shuttle.Shuttle("prefix", m_prefix);
+      shuttle.Shuttle("start", m_start);
+      shuttle.Shuttle("count", m_count);
+    }
+  };
+  auto response = HttpResponse();
+  auto session = m_sessions->Find(request);
+  if(session == nullptr) {
+    response.SetStatusCode(HttpStatusCode::UNAUTHORIZED);
+    return response;
+  }
+  auto parameters = session->ShuttleParameters<Parameters>(request);
+  auto& serviceClients = session->GetServiceClients();
+  auto securityInfos =
+    serviceClients.GetMarketDataClient().LoadSecurityInfoFromPrefix(
+    parameters.m_prefix, parameters.m_start,
+    std::clamp(parameters.m_count, 0, MAX_SECURITY_INFO_PAGE_SIZE));
   session->ShuttleResponse(securityInfos, Store(response));
   return response;
 }
@@ -4,11 +4,13 @@
 #include <iostream>
 #include <sstream>
 #include <unordered_set>
+#include <Beam/Collections/SynchronizedMap.hpp>
 #include <Beam/Pointers/LocalPtr.hpp>
 #include <Beam/Threading/Sync.hpp>
 #include <Beam/Utilities/Algorithm.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/noncopyable.hpp>
+#include <boost/optional/optional.hpp>
 #include <boost/range/adaptor/map.hpp>
 #include "Nexus/AdministrationService/AccountModificationRequest.hpp"
 #include "Nexus/AdministrationService/AdministrationDataStore.hpp"
@@ -79,6 +81,8 @@ namespace Nexus::AdministrationService {
       Beam::ServiceLocator::DirectoryEntry m_administratorsRoot;
       Beam::ServiceLocator::DirectoryEntry m_servicesRoot;
       Beam::ServiceLocator::DirectoryEntry m_tradingGroupsRoot;
+      Beam::SynchronizedUnorderedMap<Beam::ServiceLocator::DirectoryEntry,
+        Beam::ServiceLocator::DirectoryEntry> m_tradingGroupDirectories;
       SyncAccountToSubscribers m_riskParametersSubscribers;
       SyncRiskStateEntries m_riskStateEntries;
       std::atomic_int m_nextModificationRequestId;
@@ -90,6 +94,11 @@ namespace Nexus::AdministrationService {
       AccountRoles LoadAccountRoles(
         const Beam::ServiceLocator::DirectoryEntry& parent,
         const Beam::ServiceLocator::DirectoryEntry& child);
+      boost::optional<Beam::ServiceLocator::DirectoryEntry> FindTradingGroup(
+        const Beam::ServiceLocator::DirectoryEntry& directory);
+      std::vector<Beam::ServiceLocator::DirectoryEntry> FindTradingGroups(
+        const std::vector<Beam::ServiceLocator::DirectoryEntry>& parents,
+        const std::string& name);
       bool CheckAdministrator(
         const Beam::ServiceLocator::DirectoryEntry& account);
       bool CheckReadPermission(
@@ -248,6 +257,15 @@ namespace Nexus::AdministrationService {
       m_tradingGroupsRoot = Beam::ServiceLocator::LoadOrCreateDirectory(
         *m_serviceLocatorClient, "trading_groups",
         Beam::ServiceLocator::DirectoryEntry::GetStarDirectory());
+      for(auto& tradingGroup :
+          m_serviceLocatorClient->LoadChildren(m_tradingGroupsRoot)) {
+        for(auto& directory :
+            m_serviceLocatorClient->LoadChildren(tradingGroup)) {
+          if(directory.m_name == "managers" || directory.m_name == "traders") {
+            m_tradingGroupDirectories.Insert(directory, tradingGroup);
+          }
+        }
+      }
     } catch(const std::exception&) {
       Close();
       BOOST_RETHROW;
@@ -402,8 +420,6 @@ namespace Nexus::AdministrationService {
       const Beam::ServiceLocator::DirectoryEntry& account) {
     auto roles = AccountRoles();
     auto parents = m_serviceLocatorClient->LoadParents(account);
-    auto tradingGroups = m_serviceLocatorClient->LoadChildren(
-      m_tradingGroupsRoot);
     for(auto& parent : parents) {
       if(parent == m_administratorsRoot) {
         roles.Set(AccountRole::ADMINISTRATOR);
@@ -411,23 +427,13 @@ namespace Nexus::AdministrationService {
         roles.Set(AccountRole::SERVICE);
       } else if(!roles.Test(AccountRole::TRADER) &&
           parent.m_name == "traders") {
-        auto entryParents = m_serviceLocatorClient->LoadParents(parent);
-        for(auto& entryParent : entryParents) {
-          if(std::find(tradingGroups.begin(), tradingGroups.end(),
-              entryParent) != tradingGroups.end()) {
-            roles.Set(AccountRole::TRADER);
-            break;
-          }
+        if(FindTradingGroup(parent)) {
+          roles.Set(AccountRole::TRADER);
         }
       } else if(!roles.Test(AccountRole::MANAGER) &&
           parent.m_name == "managers") {
-        auto entryParents = m_serviceLocatorClient->LoadParents(parent);
-        for(auto& entryParent : entryParents) {
-          if(std::find(tradingGroups.begin(), tradingGroups.end(),
-              entryParent) != tradingGroups.end()) {
-            roles.Set(AccountRole::MANAGER);
-            break;
-          }
+        if(FindTradingGroup(parent)) {
+          roles.Set(AccountRole::MANAGER);
         }
       }
     }
@@ -442,30 +448,69 @@ namespace Nexus::AdministrationService {
       return LoadAccountRoles(child);
     }
     auto roles = AccountRoles();
-    if(CheckAdministrator(parent)) {
+    auto parentEntries = m_serviceLocatorClient->LoadParents(parent);
+    auto isAdministrator = std::find(parentEntries.begin(),
+      parentEntries.end(), m_administratorsRoot) != parentEntries.end();
+    if(isAdministrator) {
       roles.Set(AccountRole::ADMINISTRATOR);
     }
-    auto tradingGroupEntries = LoadManagedTradingGroups(parent);
-    auto parents = m_serviceLocatorClient->LoadParents(child);
-    for(auto& tradingGroupEntry : tradingGroupEntries) {
-      auto managersGroup = m_serviceLocatorClient->LoadDirectoryEntry(
-        tradingGroupEntry, "managers");
-      if(std::find(parents.begin(), parents.end(), managersGroup) !=
-          parents.end()) {
-        roles.Set(AccountRole::MANAGER);
-        break;
+    auto managedGroups = FindTradingGroups(parentEntries, "managers");
+    auto childEntries = m_serviceLocatorClient->LoadParents(child);
+    for(auto& childEntry : childEntries) {
+      if(childEntry.m_name != "managers" && childEntry.m_name != "traders") {
+        continue;
       }
-      auto tradersGroup = m_serviceLocatorClient->LoadDirectoryEntry(
-        tradingGroupEntry, "traders");
-      if(std::find(parents.begin(), parents.end(), tradersGroup) !=
-          parents.end()) {
-        roles.Set(AccountRole::MANAGER);
-        break;
+      if(auto tradingGroup = FindTradingGroup(childEntry)) {
+        if(isAdministrator || std::find(managedGroups.begin(),
+            managedGroups.end(), *tradingGroup) != managedGroups.end()) {
+          roles.Set(AccountRole::MANAGER);
+          break;
+        }
       }
     }
     return roles;
   }
 
+  template<typename C, typename S, typename D>
+  boost::optional<Beam::ServiceLocator::DirectoryEntry>
+      AdministrationServlet<C, S, D>::FindTradingGroup(
+      const Beam::ServiceLocator::DirectoryEntry& directory) {
+    if(auto tradingGroup = m_tradingGroupDirectories.Find(directory)) {
+      return *tradingGroup;
+    }
+
+    // A managers or traders directory never moves to another trading group
+    // and directory ids are not reused, so only successful lookups are
+    // cached; anything else is resolved against the service locator.
+    auto tradingGroups = m_serviceLocatorClient->LoadChildren(
+      m_tradingGroupsRoot);
+    auto entryParents = m_serviceLocatorClient->LoadParents(directory);
+    for(auto& entryParent : entryParents) {
+      if(std::find(tradingGroups.begin(), tradingGroups.end(), entryParent) !=
+          tradingGroups.end()) {
+        m_tradingGroupDirectories.Insert(directory, entryParent);
+        return entryParent;
+      }
+    }
+    return boost::none;
+  }
+
+  template<typename C, typename S, typename D>
+  std::vector<Beam::ServiceLocator::DirectoryEntry>
+      AdministrationServlet<C, S, D>::FindTradingGroups(
+      const std::vector<Beam::ServiceLocator::DirectoryEntry>& parents,
+      const std::string& name) {
+    auto tradingGroups = std::vector<Beam::ServiceLocator::DirectoryEntry>();
+    for(auto& parent : parents) {
+      if(parent.m_name == name) {
+        if(auto tradingGroup = FindTradingGroup(parent)) {
+          tradingGroups.push_back(std::move(*tradingGroup));
+        }
+      }
+    }
+    return tradingGroups;
+  }
+
   template<typename C, typename S, typename D>
   bool AdministrationServlet<C, S, D>::CheckAdministrator(
       const Beam::ServiceLocator::DirectoryEntry& account) {
@@ -482,26 +527,9 @@ namespace Nexus::AdministrationService {
     if(parent == child) {
       return true;
     }
-    if(CheckAdministrator(parent)) {
-      return true;
-    }
-    auto tradingGroups = LoadManagedTradingGroups(parent);
-    auto parentGroups = m_serviceLocatorClient->LoadParents(child);
-    for(auto& tradingGroup : tradingGroups) {
-      auto traders = m_serviceLocatorClient->LoadDirectoryEntry(tradingGroup,
-        "traders");
-      if(std::find(parentGroups.begin(), parentGroups.end(), traders) !=
-          parentGroups.end()) {
-        return true;
-      }
-      auto managers = m_serviceLocatorClient->LoadDirectoryEntry(tradingGroup,
-        "managers");
-      if(std::find(parentGroups.begin(), parentGroups.end(), managers) !=
-          parentGroups.end()) {
-        return true;
-      }
-    }
-    return false;
+    auto roles = LoadAccountRoles(parent, child);
+    return roles.Test(AccountRole::ADMINISTRATOR) ||
+      roles.Test(AccountRole::MANAGER);
   }
 
   template<typename C, typename S, typename D>
@@ -509,27 +537,11 @@ namespace Nexus::AdministrationService {
       AdministrationServlet<C, S, D>::LoadManagedTradingGroups(
       const Beam::ServiceLocator::DirectoryEntry& account) {
     auto parents = m_serviceLocatorClient->LoadParents(account);
-    auto tradingGroups = m_serviceLocatorClient->LoadChildren(
-      m_tradingGroupsRoot);
-    for(auto& parent : parents) {
-      if(parent == m_administratorsRoot) {
-        return tradingGroups;
-      }
-    }
-    auto result = std::vector<Beam::ServiceLocator::DirectoryEntry>();
-    for(auto& parent : parents) {
-      if(parent.m_name == "managers") {
-        auto entryParents = m_serviceLocatorClient->LoadParents(parent);
-        for(auto& entryParent : entryParents) {
-          if(std::find(tradingGroups.begin(), tradingGroups.end(),
-              entryParent) != tradingGroups.end()) {
-            result.push_back(entryParent);
-            break;
-          }
-        }
-      }
+    if(std::find(parents.begin(), parents.end(), m_administratorsRoot) !=
+        parents.end()) {
+      return m_serviceLocatorClient->LoadChildren(m_tradingGroupsRoot);
     }
-    return result;
+    return FindTradingGroups(parents, "managers");
   }
 
   template<typename C, typename S, typename D>
@@ -755,21 +767,12 @@ namespace Nexus::AdministrationService {
   Beam::ServiceLocator::DirectoryEntry AdministrationServlet<C, S, D>::
       OnLoadParentTradingGroupRequest(ServiceProtocolClient& client,
       const Beam::ServiceLocator::DirectoryEntry& account) {
-    auto parents = m_serviceLocatorClient->LoadParents(account);
-    auto tradingGroups = m_serviceLocatorClient->LoadChildren(
-      m_tradingGroupsRoot);
-    for(auto& parent : parents) {
-      if(parent.m_name == "traders") {
-        auto entryParents = m_serviceLocatorClient->LoadParents(parent);
-        for(auto& entryParent : entryParents) {
-          if(std::find(tradingGroups.begin(), tradingGroups.end(),
-              entryParent) != tradingGroups.end()) {
-            return entryParent;
-          }
-        }
-      }
+    auto tradingGroups = FindTradingGroups(
+      m_serviceLocatorClient->LoadParents(account), "traders");
+    if(tradingGroups.empty()) {
+      return {};
     }
-    return {};
+    return tradingGroups.front();
   }
 
   template<typename C, typename S, typename D>
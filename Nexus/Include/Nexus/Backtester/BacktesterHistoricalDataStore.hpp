@@ -31,6 +31,13 @@ namespace Nexus {
 
       std::vector<SecurityInfo> LoadAllSecurityInfo();
 
+      std::unordered_map<Security,
+        MarketDataService::SecurityEntry::InitialSequences>
+        LoadAllInitialSequences();
+
+      std::unordered_map<Security, std::unordered_map<std::string, Money>>
+        LoadAllLastPrices();
+
       std::vector<SequencedOrderImbalance> LoadOrderImbalances(
         const MarketDataService::MarketWideDataQuery& query);
 
@@ -103,6 +110,19 @@ namespace Nexus {
     return m_dataStore.LoadAllSecurityInfo();
   }
 
+  template<typename H>
+  std::unordered_map<Security,
+      MarketDataService::SecurityEntry::InitialSequences>
+      BacktesterHistoricalDataStore<H>::LoadAllInitialSequences() {
+    return m_dataStore.LoadAllInitialSequences();
+  }
+
+  template<typename H>
+  std::unordered_map<Security, std::unordered_map<std::string, Money>>
+      BacktesterHistoricalDataStore<H>::LoadAllLastPrices() {
+    return m_dataStore.LoadAllLastPrices();
+  }
+
   template<typename H>
   std::vector<SequencedOrderImbalance>
       BacktesterHistoricalDataStore<H>::LoadOrderImbalances(
@@ -70,10 +70,16 @@ namespace Nexus {
       SecurityTechnicals LoadSecurityTechnicals(
         const Security& security);
 
+      std::vector<MarketDataService::SecuritySnapshot> LoadSecuritySnapshots(
+        const std::vector<Security>& securities);
+
+      std::vector<SecurityTechnicals> LoadSecurityTechnicalsList(
+        const std::vector<Security>& securities);
+
       boost::optional<SecurityInfo> LoadSecurityInfo(const Security& security);
 
       std::vector<SecurityInfo> LoadSecurityInfoFromPrefix(
-        const std::string& prefix);
+        const std::string& prefix, const Security& start, int count);
 
       void Close();
 
@@ -180,14 +186,28 @@ namespace Nexus {
     return m_marketDataClient->LoadSecurityTechnicals(security);
   }
 
+  inline std::vector<MarketDataService::SecuritySnapshot>
+      BacktesterMarketDataClient::LoadSecuritySnapshots(
+      const std::vector<Security>& securities) {
+    return m_marketDataClient->LoadSecuritySnapshots(securities);
+  }
+
+  inline std::vector<SecurityTechnicals>
+      BacktesterMarketDataClient::LoadSecurityTechnicalsList(
+      const std::vector<Security>& securities) {
+    return m_marketDataClient->LoadSecurityTechnicalsList(securities);
+  }
+
   inline boost::optional<SecurityInfo>
       BacktesterMarketDataClient::LoadSecurityInfo(const Security& security) {
     return m_marketDataClient->LoadSecurityInfo(security);
   }
 
   inline std::vector<SecurityInfo> BacktesterMarketDataClient::
-      LoadSecurityInfoFromPrefix(const std::string& prefix) {
-    return m_marketDataClient->LoadSecurityInfoFromPrefix(prefix);
+      LoadSecurityInfoFromPrefix(const std::string& prefix,
+      const Security& start, int count) {
+    return m_marketDataClient->LoadSecurityInfoFromPrefix(prefix, start,
+      count);
   }
 
   inline void BacktesterMarketDataClient::Close() {
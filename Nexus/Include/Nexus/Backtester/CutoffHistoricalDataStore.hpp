@@ -36,6 +36,13 @@ namespace Nexus {
 
       std::vector<SecurityInfo> LoadAllSecurityInfo();
 
+      std::unordered_map<Security,
+        MarketDataService::SecurityEntry::InitialSequences>
+        LoadAllInitialSequences();
+
+      std::unordered_map<Security, std::unordered_map<std::string, Money>>
+        LoadAllLastPrices();
+
       std::vector<SequencedOrderImbalance> LoadOrderImbalances(
         const MarketDataService::MarketWideDataQuery& query);
 
@@ -125,6 +132,19 @@ namespace Nexus {
     return m_dataStore->LoadAllSecurityInfo();
   }
 
+  template<typename H>
+  std::unordered_map<Security,
+      MarketDataService::SecurityEntry::InitialSequences>
+      CutoffHistoricalDataStore<H>::LoadAllInitialSequences() {
+    return {};
+  }
+
+  template<typename H>
+  std::unordered_map<Security, std::unordered_map<std::string, Money>>
+      CutoffHistoricalDataStore<H>::LoadAllLastPrices() {
+    return {};
+  }
+
   template<typename H>
   std::vector<SequencedOrderImbalance>
       CutoffHistoricalDataStore<H>::LoadOrderImbalances(
@@ -2,10 +2,13 @@
 #define NEXUS_BINARY_SEQUENCE_PROTOCOL_HPP
 
 namespace Nexus::BinarySequenceProtocol {
-  template<typename C, typename S> class BinarySequenceProtocolClient;
+  template<typename C, typename S, typename R>
+  class BinarySequenceProtocolClient;
   struct BinarySequenceProtocolMessage;
+  template<typename S> struct BinarySequenceProtocolMessageBatch;
   template<typename S> struct BinarySequenceProtocolPacket;
   class BinarySequenceProtocolParserException;
+  template<typename C, typename P, typename R> class SequencedPacketClient;
 }
 
 #endif
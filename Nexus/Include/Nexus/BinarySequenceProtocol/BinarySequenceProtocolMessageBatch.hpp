@@ -0,0 +1,29 @@
+#ifndef NEXUS_BINARY_SEQUENCE_PROTOCOL_MESSAGE_BATCH_HPP
+#define NEXUS_BINARY_SEQUENCE_PROTOCOL_MESSAGE_BATCH_HPP
+#include <vector>
+#include "Nexus/BinarySequenceProtocol/BinarySequenceProtocol.hpp"
+#include "Nexus/BinarySequenceProtocol/BinarySequenceProtocolMessage.hpp"
+
+namespace Nexus::BinarySequenceProtocol {
+
+  /**
+   * Stores the messages contained in one or more consecutive packets. Each
+   * message refers directly to the memory the packet was received into and
+   * remains valid until the next batch is read.
+   * @param <S> The type used to represent sequence numbers.
+   */
+  template<typename S>
+  struct BinarySequenceProtocolMessageBatch {
+
+    /** The type used to represent sequence numbers. */
+    using Sequence = S;
+
+    /** The sequence number of the first message in the batch. */
+    Sequence m_sequenceNumber;
+
+    /** The messages in order of increasing sequence number. */
+    std::vector<BinarySequenceProtocolMessage> m_messages;
+  };
+}
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef NEXUS_BINARY_SEQUENCE_PROTOCOL_REQUEST_PACKET_HPP
+#define NEXUS_BINARY_SEQUENCE_PROTOCOL_REQUEST_PACKET_HPP
+#include <cstdint>
+#include <Beam/Pointers/Out.hpp>
+#include <Beam/Utilities/Endian.hpp>
+#include "Nexus/BinarySequenceProtocol/BinarySequenceProtocol.hpp"
+
+namespace Nexus::BinarySequenceProtocol {
+
+  /**
+   * Builds a packet requesting the retransmission of a range of messages.
+   * @param <S> The type used to represent sequence numbers.
+   * @param sequenceNumber The sequence number of the first message requested.
+   * @param count The number of messages requested.
+   * @param buffer The buffer to store the packet in.
+   */
+  template<typename S, typename Buffer>
+  void BuildRequestPacket(S sequenceNumber, std::uint16_t count,
+      Beam::Out<Buffer> buffer) {
+    buffer->Append(Beam::ToBigEndian(sequenceNumber));
+    buffer->Append(Beam::ToBigEndian(count));
+  }
+}
+
+#endif
@@ -0,0 +1,540 @@
+#ifndef NEXUS_SEQUENCED_PACKET_CLIENT_HPP
+#define NEXUS_SEQUENCED_PACKET_CLIENT_HPP
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <Beam/IO/OpenState.hpp>
+#include <Beam/Pointers/Dereference.hpp>
+#include <Beam/Pointers/LocalPtr.hpp>
+#include <Beam/Pointers/Out.hpp>
+#include <Beam/Queues/Queue.hpp>
+#include <Beam/Routines/RoutineHandler.hpp>
+#include <Beam/Threading/Timer.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/optional/optional.hpp>
+#include "Nexus/BinarySequenceProtocol/BinarySequenceProtocol.hpp"
+
+namespace Nexus::BinarySequenceProtocol {
+
+  /**
+   * Implements the receive side shared by sequenced packet protocols. Packets
+   * are received into a ring of buffers by a dedicated routine so that
+   * decoding one packet overlaps with receiving the next.
+   *
+   * Messages are always delivered in sequence. Packets that arrive ahead of a
+   * gap are held until the gap is filled, and if a recovery channel is
+   * provided the missing range is requested from it, both as packets arrive
+   * and each time the retransmit timer expires. A gap is skipped and counted
+   * as lost once too many packets are held or too many requests go
+   * unanswered. Without a recovery channel a gap can't be filled, so it's
+   * skipped as soon as a later packet arrives.
+   * @param <C> The type of Channel connected to the server.
+   * @param <P> The protocol defining the packet layout, must provide the
+   *        Sequence, Message, MessageBatch and Packet types, an
+   *        Update(const Packet&) hook called for every packet received, and a
+   *        BuildRequest(Sequence, std::uint16_t, Out<Buffer>) method.
+   * @param <R> The type of Channel connected to the retransmission server.
+   * @param <T> The type of Timer used to repeat retransmission requests.
+   */
+  template<typename C, typename P, typename R, typename T>
+  class SequencedPacketClient : private boost::noncopyable {
+    public:
+
+      /** The type of Channel connected to the server. */
+      using Channel = Beam::GetTryDereferenceType<C>;
+
+      /** The protocol defining the packet layout. */
+      using Protocol = P;
+
+      /** The type of Channel connected to the retransmission server. */
+      using RecoveryChannel = Beam::GetTryDereferenceType<R>;
+
+      /** The type of Timer used to repeat retransmission requests. */
+      using Timer = Beam::GetTryDereferenceType<T>;
+
+      /** The type used to represent sequence numbers. */
+      using Sequence = typename Protocol::Sequence;
+
+      /** The type of message read from the server. */
+      using Message = typename Protocol::Message;
+
+      /** The type of batch read from the server. */
+      using MessageBatch = typename Protocol::MessageBatch;
+
+      /** The default number of receive buffers. */
+      static constexpr auto DEFAULT_BUFFER_COUNT = std::size_t(8);
+
+      /** The number of packets held ahead of a gap before it's skipped. */
+      static constexpr auto MAX_OUT_OF_ORDER_PACKETS = std::size_t(1024);
+
+      /**
+       * The number of requests sent for a gap before the retransmit timer
+       * skips it.
+       */
+      static constexpr auto MAX_RETRANSMIT_REQUESTS = std::size_t(3);
+
+      /**
+       * The number of packets received while a gap remains open before the
+       * missing range is requested again.
+       */
+      static constexpr auto RETRANSMIT_INTERVAL = std::size_t(64);
+
+      /**
+       * Constructs a SequencedPacketClient.
+       * @param channel The Channel to connect to the server
+       */
+      template<typename CF>
+      SequencedPacketClient(CF&& channel);
+
+      /**
+       * Constructs a SequencedPacketClient.
+       * @param channel The Channel to connect to the server
+       * @param bufferCount The number of packets that can be received ahead of
+       *        the packets being decoded, at least two.
+       */
+      template<typename CF>
+      SequencedPacketClient(CF&& channel, std::size_t bufferCount);
+
+      /**
+       * Constructs a SequencedPacketClient that recovers missing messages.
+       * @param channel The Channel to connect to the server
+       * @param recoveryChannel The Channel that receives retransmission
+       *        requests and replies with the requested packets.
+       * @param retransmitTimer The Timer used to repeat requests for a gap
+       *        that remains open.
+       * @param bufferCount The number of packets that can be received ahead of
+       *        the packets being decoded, at least two.
+       */
+      template<typename CF, typename RF, typename TF>
+      SequencedPacketClient(CF&& channel, RF&& recoveryChannel,
+        TF&& retransmitTimer, std::size_t bufferCount);
+
+      ~SequencedPacketClient();
+
+      /** Reads the next message from the feed. */
+      Message Read();
+
+      /**
+       * Reads the next message from the feed.
+       * @param sequenceNumber The message's sequence number.
+       */
+      Message Read(Beam::Out<Sequence> sequenceNumber);
+
+      /**
+       * Reads all messages from the packets received so far, waiting for a
+       * packet if none are available. The messages in a batch are always
+       * consecutive, a batch ends early if a gap has to be skipped. Messages
+       * returned by a previous batch or by Read are invalidated.
+       * @param batch Stores the messages read.
+       */
+      void ReadBatch(Beam::Out<MessageBatch> batch);
+
+      /**
+       * Returns the number of messages skipped because they could not be
+       * recovered.
+       */
+      std::uint64_t GetLostMessageCount() const;
+
+      void Close();
+
+    private:
+      using Buffer = typename Channel::Reader::Buffer;
+      using Packet = typename Protocol::Packet;
+      static constexpr auto RETRANSMIT_TIMER_INDEX =
+        std::numeric_limits<std::size_t>::max();
+      Beam::GetOptionalLocalPtr<C> m_channel;
+      boost::optional<Beam::GetOptionalLocalPtr<R>> m_recoveryChannel;
+      boost::optional<Beam::GetOptionalLocalPtr<T>> m_retransmitTimer;
+      std::shared_ptr<Beam::Queue<Beam::Threading::Timer::Result>>
+        m_timerQueue;
+      std::atomic_bool m_isRetransmitPending;
+      Protocol m_protocol;
+      std::vector<Buffer> m_buffers;
+      std::shared_ptr<Beam::Queue<std::size_t>> m_freeBuffers;
+      std::shared_ptr<Beam::Queue<std::size_t>> m_receivedBuffers;
+      std::vector<std::size_t> m_heldBuffers;
+      std::deque<Buffer> m_heldPackets;
+      std::map<Sequence, Buffer> m_outOfOrderPackets;
+      boost::optional<Sequence> m_nextSequenceNumber;
+      Sequence m_highestSequenceNumber;
+      boost::optional<Sequence> m_requestedSequenceNumber;
+      std::size_t m_packetsSinceRequest;
+      std::size_t m_requestCount;
+      bool m_isGapExpired;
+      std::uint64_t m_lostMessageCount;
+      MessageBatch m_batch;
+      std::size_t m_nextMessage;
+      Beam::Routines::RoutineHandler m_receiveLoop;
+      Beam::Routines::RoutineHandler m_recoveryLoop;
+      Beam::Routines::RoutineHandler m_retransmitLoop;
+      Beam::IO::OpenState m_openState;
+
+      void Open();
+      void Append(std::size_t index, MessageBatch& batch);
+      void AppendMessages(const Buffer& buffer, MessageBatch& batch);
+      void AppendOutOfOrderPackets(MessageBatch& batch);
+      Sequence GetGapEnd() const;
+      void RequestRetransmission(bool isTimerExpired);
+      void OnRetransmitTimer(MessageBatch& batch);
+      void ReceiveLoop();
+      void RecoveryLoop();
+      void RetransmitLoop();
+  };
+
+  template<typename C, typename P, typename R, typename T>
+  template<typename CF>
+  SequencedPacketClient<C, P, R, T>::SequencedPacketClient(CF&& channel)
+    : SequencedPacketClient(std::forward<CF>(channel), DEFAULT_BUFFER_COUNT) {}
+
+  template<typename C, typename P, typename R, typename T>
+  template<typename CF>
+  SequencedPacketClient<C, P, R, T>::SequencedPacketClient(CF&& channel,
+      std::size_t bufferCount)
+      : m_channel(std::forward<CF>(channel)),
+        m_buffers(std::max<std::size_t>(bufferCount, 2)),
+        m_freeBuffers(std::make_shared<Beam::Queue<std::size_t>>()),
+        m_receivedBuffers(std::make_shared<Beam::Queue<std::size_t>>()),
+        m_isRetransmitPending(false),
+        m_highestSequenceNumber(0),
+        m_packetsSinceRequest(0),
+        m_requestCount(0),
+        m_isGapExpired(false),
+        m_lostMessageCount(0),
+        m_nextMessage(0) {
+    Open();
+  }
+
+  template<typename C, typename P, typename R, typename T>
+  template<typename CF, typename RF, typename TF>
+  SequencedPacketClient<C, P, R, T>::SequencedPacketClient(CF&& channel,
+      RF&& recoveryChannel, TF&& retransmitTimer, std::size_t bufferCount)
+      : m_channel(std::forward<CF>(channel)),
+        m_buffers(std::max<std::size_t>(bufferCount, 2)),
+        m_freeBuffers(std::make_shared<Beam::Queue<std::size_t>>()),
+        m_receivedBuffers(std::make_shared<Beam::Queue<std::size_t>>()),
+        m_timerQueue(
+          std::make_shared<Beam::Queue<Beam::Threading::Timer::Result>>()),
+        m_isRetransmitPending(false),
+        m_highestSequenceNumber(0),
+        m_packetsSinceRequest(0),
+        m_requestCount(0),
+        m_isGapExpired(false),
+        m_lostMessageCount(0),
+        m_nextMessage(0) {
+    m_recoveryChannel.emplace(std::forward<RF>(recoveryChannel));
+    m_retransmitTimer.emplace(std::forward<TF>(retransmitTimer));
+    Open();
+  }
+
+  template<typename C, typename P, typename R, typename T>
+  SequencedPacketClient<C, P, R, T>::~SequencedPacketClient() {
+    Close();
+  }
+
+  template<typename C, typename P, typename R, typename T>
+  typename SequencedPacketClient<C, P, R, T>::Message
+      SequencedPacketClient<C, P, R, T>::Read() {
+    auto sequenceNumber = Sequence();
+    return Read(Beam::Store(sequenceNumber));
+  }
+
+  template<typename C, typename P, typename R, typename T>
+  typename SequencedPacketClient<C, P, R, T>::Message
+      SequencedPacketClient<C, P, R, T>::Read(
+        Beam::Out<Sequence> sequenceNumber) {
+    if(m_nextMessage == m_batch.m_messages.size()) {
+      ReadBatch(Beam::Store(m_batch));
+      m_nextMessage = 0;
+    }
+    *sequenceNumber = m_batch.m_sequenceNumber +
+      static_cast<Sequence>(m_nextMessage);
+    return m_batch.m_messages[m_nextMessage++];
+  }
+
+  template<typename C, typename P, typename R, typename T>
+  void SequencedPacketClient<C, P, R, T>::ReadBatch(
+      Beam::Out<MessageBatch> batch) {
+    m_openState.EnsureOpen();
+    for(auto index : m_heldBuffers) {
+      m_freeBuffers->Push(index);
+    }
+    m_heldBuffers.clear();
+    m_heldPackets.clear();
+    batch->m_messages.clear();
+    if(&*batch != &m_batch) {
+      m_batch.m_messages.clear();
+      m_nextMessage = 0;
+    }
+    AppendOutOfOrderPackets(*batch);
+    while(batch->m_messages.empty()) {
+      Append(m_receivedBuffers->Pop(), *batch);
+    }
+    while(m_heldBuffers.size() + 1 < m_buffers.size()) {
+      auto index = m_receivedBuffers->TryPop();
+      if(!index) {
+        break;
+      }
+      Append(*index, *batch);
+    }
+  }
+
+  template<typename C, typename P, typename R, typename T>
+  std::uint64_t SequencedPacketClient<C, P, R, T>::GetLostMessageCount() const {
+    return m_lostMessageCount;
+  }
+
+  template<typename C, typename P, typename R, typename T>
+  void SequencedPacketClient<C, P, R, T>::Close() {
+    if(m_openState.SetClosing()) {
+      return;
+    }
+    m_channel->GetConnection().Close();
+    if(m_recoveryChannel) {
+      (*m_recoveryChannel)->GetConnection().Close();
+      (*m_retransmitTimer)->Cancel();
+      m_timerQueue->Break();
+    }
+    m_freeBuffers->Break();
+    m_receiveLoop.Wait();
+    m_recoveryLoop.Wait();
+    m_retransmitLoop.Wait();
+    m_openState.Close();
+  }
+
+  template<typename C, typename P, typename R, typename T>
+  void SequencedPacketClient<C, P, R, T>::Open() {
+    for(auto i = std::size_t(0); i != m_buffers.size(); ++i) {
+      m_freeBuffers->Push(i);
+    }
+    m_heldBuffers.reserve(m_buffers.size());
+    m_receiveLoop = Beam::Routines::Spawn(
+      std::bind(&SequencedPacketClient::ReceiveLoop, this));
+    if(m_recoveryChannel) {
+      m_recoveryLoop = Beam::Routines::Spawn(
+        std::bind(&SequencedPacketClient::RecoveryLoop, this));
+      (*m_retransmitTimer)->GetPublisher().Monitor(m_timerQueue);
+      (*m_retransmitTimer)->Start();
+      m_retransmitLoop = Beam::Routines::Spawn(
+        std::bind(&SequencedPacketClient::RetransmitLoop, this));
+    }
+  }
+
+  template<typename C, typename P, typename R, typename T>
+  void SequencedPacketClient<C, P, R, T>::Append(std::size_t index,
+      MessageBatch& batch) {
+    if(index == RETRANSMIT_TIMER_INDEX) {
+      m_isRetransmitPending = false;
+      OnRetransmitTimer(batch);
+      return;
+    }
+    auto& buffer = m_buffers[index];
+    auto packet = [&] {
+      try {
+        return Packet::Parse(buffer.GetData(), buffer.GetSize());
+      } catch(const std::exception&) {
+        m_freeBuffers->Push(index);
+        throw;
+      }
+    }();
+    m_protocol.Update(packet);
+    if(!m_nextSequenceNumber) {
+      m_nextSequenceNumber = packet.m_sequenceNumber;
+    }
+    auto packetEnd = packet.m_sequenceNumber +
+      static_cast<Sequence>(packet.m_count);
+    m_highestSequenceNumber = std::max(m_highestSequenceNumber, packetEnd);
+    if(packet.m_count == 0 || packetEnd <= *m_nextSequenceNumber) {
+      m_freeBuffers->Push(index);
+    } else if(packet.m_sequenceNumber > *m_nextSequenceNumber) {
+      m_outOfOrderPackets.emplace(packet.m_sequenceNumber,
+        std::exchange(buffer, Buffer()));
+      m_freeBuffers->Push(index);
+      AppendOutOfOrderPackets(batch);
+    } else {
+      m_heldBuffers.push_back(index);
+      AppendMessages(buffer, batch);
+      AppendOutOfOrderPackets(batch);
+    }
+    RequestRetransmission(false);
+  }
+
+  template<typename C, typename P, typename R, typename T>
+  void SequencedPacketClient<C, P, R, T>::AppendMessages(const Buffer& buffer,
+      MessageBatch& batch) {
+    auto packet = Packet::Parse(buffer.GetData(), buffer.GetSize());
+    if(batch.m_messages.empty()) {
+      batch.m_sequenceNumber = *m_nextSequenceNumber;
+    }
+    auto source = packet.m_payload;
+    auto remainingSize = buffer.GetSize() - Packet::PACKET_LENGTH;
+    for(auto i = std::uint16_t(0); i != packet.m_count; ++i) {
+      auto message = Message::Parse(source, remainingSize);
+      auto messageSize = message.m_length + sizeof(message.m_length);
+      remainingSize -= messageSize;
+      source += messageSize;
+      if(packet.m_sequenceNumber + static_cast<Sequence>(i) >=
+          *m_nextSequenceNumber) {
+        batch.m_messages.push_back(message);
+      }
+    }
+    m_nextSequenceNumber = std::max<Sequence>(*m_nextSequenceNumber,
+      packet.m_sequenceNumber + static_cast<Sequence>(packet.m_count));
+  }
+
+  template<typename C, typename P, typename R, typename T>
+  void SequencedPacketClient<C, P, R, T>::AppendOutOfOrderPackets(
+      MessageBatch& batch) {
+    auto maxHeldPackets = [&] {
+      if(m_recoveryChannel) {
+        return MAX_OUT_OF_ORDER_PACKETS;
+      }
+      return std::size_t(0);
+    }();
+    while(!m_outOfOrderPackets.empty()) {
+      auto packet = m_outOfOrderPackets.begin();
+      if(packet->first > *m_nextSequenceNumber) {
+        if(!batch.m_messages.empty() || (!m_isGapExpired &&
+            m_outOfOrderPackets.size() <= maxHeldPackets)) {
+          return;
+        }
+        m_lostMessageCount += packet->first - *m_nextSequenceNumber;
+        m_nextSequenceNumber = packet->first;
+        m_isGapExpired = false;
+      }
+      m_heldPackets.push_back(std::move(packet->second));
+      m_outOfOrderPackets.erase(packet);
+      AppendMessages(m_heldPackets.back(), batch);
+    }
+  }
+
+  template<typename C, typename P, typename R, typename T>
+  typename SequencedPacketClient<C, P, R, T>::Sequence
+      SequencedPacketClient<C, P, R, T>::GetGapEnd() const {
+    if(m_outOfOrderPackets.empty()) {
+      return m_highestSequenceNumber;
+    }
+    return m_outOfOrderPackets.begin()->first;
+  }
+
+  template<typename C, typename P, typename R, typename T>
+  void SequencedPacketClient<C, P, R, T>::RequestRetransmission(
+      bool isTimerExpired) {
+    if(!m_recoveryChannel) {
+      return;
+    }
+    auto gapEnd = GetGapEnd();
+    if(gapEnd <= *m_nextSequenceNumber) {
+      m_requestedSequenceNumber = boost::none;
+      m_isGapExpired = false;
+      return;
+    }
+    if(m_requestedSequenceNumber == m_nextSequenceNumber) {
+      if(!isTimerExpired && ++m_packetsSinceRequest < RETRANSMIT_INTERVAL) {
+        return;
+      }
+    } else {
+      m_requestedSequenceNumber = m_nextSequenceNumber;
+      m_requestCount = 0;
+      m_isGapExpired = false;
+    }
+    m_packetsSinceRequest = 0;
+    ++m_requestCount;
+    auto count = static_cast<std::uint16_t>(std::min<std::uint64_t>(
+      gapEnd - *m_nextSequenceNumber,
+      std::numeric_limits<std::uint16_t>::max()));
+    auto request = typename RecoveryChannel::Writer::Buffer();
+    m_protocol.BuildRequest(*m_nextSequenceNumber, count,
+      Beam::Store(request));
+    try {
+      (*m_recoveryChannel)->GetWriter().Write(request);
+    } catch(const std::exception&) {
+
+      // A failed request is treated like a lost reply, the gap is requested
+      // again after the retransmit interval and skipped if it stays open.
+    }
+  }
+
+  template<typename C, typename P, typename R, typename T>
+  void SequencedPacketClient<C, P, R, T>::OnRetransmitTimer(
+      MessageBatch& batch) {
+    if(!m_nextSequenceNumber) {
+      return;
+    }
+
+    // A gap at the end of a burst gets no further packets to trigger a
+    // request, so the timer repeats it and eventually gives up on it.
+    if(m_requestedSequenceNumber == m_nextSequenceNumber &&
+        m_requestCount >= MAX_RETRANSMIT_REQUESTS) {
+      m_isGapExpired = true;
+      AppendOutOfOrderPackets(batch);
+    } else {
+      RequestRetransmission(true);
+    }
+  }
+
+  template<typename C, typename P, typename R, typename T>
+  void SequencedPacketClient<C, P, R, T>::ReceiveLoop() {
+    try {
+      while(true) {
+        auto index = m_freeBuffers->Pop();
+        auto& buffer = m_buffers[index];
+        buffer.Reset();
+        m_channel->GetReader().Read(Beam::Store(buffer));
+        m_receivedBuffers->Push(index);
+      }
+    } catch(const std::exception&) {
+      m_receivedBuffers->Break(std::current_exception());
+    }
+  }
+
+  template<typename C, typename P, typename R, typename T>
+  void SequencedPacketClient<C, P, R, T>::RecoveryLoop() {
+    try {
+      auto buffer = Buffer();
+      while(true) {
+
+        // Replies are read into a buffer of their own so that waiting on an
+        // idle recovery channel doesn't take a buffer away from the feed.
+        buffer.Reset();
+        (*m_recoveryChannel)->GetReader().Read(Beam::Store(buffer));
+        auto index = m_freeBuffers->Pop();
+        std::swap(m_buffers[index], buffer);
+        m_receivedBuffers->Push(index);
+      }
+    } catch(const std::exception&) {
+
+      // Losing the recovery channel doesn't interrupt the feed, gaps are
+      // skipped once too many packets are held.
+    }
+  }
+
+  template<typename C, typename P, typename R, typename T>
+  void SequencedPacketClient<C, P, R, T>::RetransmitLoop() {
+    try {
+      while(true) {
+        auto result = m_timerQueue->Pop();
+        if(result != Beam::Threading::Timer::Result::EXPIRED) {
+          break;
+        }
+
+        // The expiry is handled on the reading thread along with the
+        // packets, at most one is queued while that thread is busy.
+        if(!m_isRetransmitPending.exchange(true)) {
+          m_receivedBuffers->Push(RETRANSMIT_TIMER_INDEX);
+        }
+        (*m_retransmitTimer)->Start();
+      }
+    } catch(const std::exception&) {
+      return;
+    }
+  }
+}
+
+#endif
@@ -18,6 +18,7 @@
 #include "Nexus/MarketDataService/MarketDataClientUtilities.hpp"
 #include "Nexus/Queries/ShuttleQueryTypes.hpp"
 #include "Nexus/TechnicalAnalysis/CandlestickTypes.hpp"
+#include "Nexus/TechnicalAnalysis/StandardReductionEvaluator.hpp"
 
 namespace Nexus::ChartingService {
 namespace Details {
@@ -90,6 +91,9 @@ namespace Details {
         ServiceProtocolClient& client, const Security& security,
         boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
         boost::posix_time::time_duration interval);
+      bool HandleStandardReductionQuery(Beam::Services::RequestToken<
+        ServiceProtocolClient, QuerySecurityService>& request,
+        const SecurityChartingQuery& query, int clientQueryId);
       template<typename MarketDataType>
       void HandleQuery(Beam::Services::RequestToken<
         ServiceProtocolClient, QuerySecurityService>& request,
@@ -157,7 +161,9 @@ namespace Details {
     auto& session = request.GetSession();
     if(query.GetMarketDataType() ==
         MarketDataService::MarketDataType::TIME_AND_SALE) {
-      HandleQuery(request, query, clientQueryId, m_timeAndSaleQueries);
+      if(!HandleStandardReductionQuery(request, query, clientQueryId)) {
+        HandleQuery(request, query, clientQueryId, m_timeAndSaleQueries);
+      }
     } else {
       request.SetResult(SecurityChartingQueryResult());
     }
@@ -218,6 +224,50 @@ namespace Details {
     return result;
   }
 
+  template<typename C, typename M>
+  bool ChartingServlet<C, M>::HandleStandardReductionQuery(
+      Beam::Services::RequestToken<ServiceProtocolClient, QuerySecurityService>&
+      request, const SecurityChartingQuery& query, int clientQueryId) {
+    // Real-time queries carry the reduction into live updates, only
+    // historical queries for the final value are evaluated in batch.
+    if(query.GetRange().GetEnd() == Beam::Queries::Sequence::Last() ||
+        !(query.GetSnapshotLimit() == Beam::Queries::SnapshotLimit(
+        Beam::Queries::SnapshotLimit::Type::TAIL, 1))) {
+      return false;
+    }
+    auto reduction = TechnicalAnalysis::RecognizeStandardReduction(
+      query.GetExpression(), query.GetFilter());
+    if(!reduction) {
+      return false;
+    }
+    auto snapshotQuery = query;
+    snapshotQuery.SetSnapshotLimit(Beam::Queries::SnapshotLimit::Unlimited());
+    auto snapshot = MarketDataService::HistoricalDataStoreLoad<
+      SequencedTimeAndSale>(m_dataStore, snapshotQuery);
+    auto columns = TechnicalAnalysis::TimeAndSaleColumns(snapshot.begin(),
+      snapshot.end());
+    auto result = SecurityChartingQueryResult();
+    result.m_queryId = clientQueryId;
+
+    // Under UpdatePolicy::CHANGE the interpreter only publishes rows that
+    // change the reduced value, so the final value carries the sequence of
+    // the last such row rather than the last selected row.
+    auto row = [&] {
+      if(query.GetUpdatePolicy() ==
+          Beam::Queries::ExpressionQuery::UpdatePolicy::CHANGE) {
+        return TechnicalAnalysis::FindLastChangedRow(*reduction, columns);
+      }
+      return TechnicalAnalysis::FindLastSelectedRow(*reduction, columns);
+    }();
+    if(row) {
+      result.m_snapshot.push_back(Beam::Queries::SequencedValue(
+        TechnicalAnalysis::Evaluate(*reduction, columns),
+        snapshot[*row].GetSequence()));
+    }
+    request.SetResult(result);
+    return true;
+  }
+
   template<typename C, typename M>
   template<typename MarketDataType>
   void ChartingServlet<C, M>::HandleQuery(
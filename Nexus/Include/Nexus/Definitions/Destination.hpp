@@ -49,6 +49,13 @@ namespace Nexus {
        */
       const Entry& GetPreferredDestination(MarketCode market) const;
 
+      /**
+       * Returns all Entries available on a market.
+       * @param market The market to lookup.
+       * @return The list of Entries available on the specified <i>market</i>.
+       */
+      std::vector<Entry> FromMarket(MarketCode market) const;
+
       /**
        * Returns the first Entry matching a predicate.
        * @param predicate The predicate to match against.
@@ -108,6 +115,10 @@ namespace Nexus {
       std::vector<Entry> m_entries;
       std::unordered_map<MarketCode, Destination> m_preferredDestinations;
       boost::optional<Entry> m_manualOrderEntryDestination;
+      std::unordered_map<Destination, std::size_t> m_idIndex;
+      std::unordered_map<MarketCode, std::vector<std::size_t>> m_marketIndex;
+
+      void Index();
   };
 
   /**
@@ -195,10 +206,11 @@ namespace Nexus {
 
   inline const DestinationDatabase::Entry& DestinationDatabase::FromId(
       const std::string& id) const {
-    return SelectEntry(
-      [&] (auto& entry) {
-        return entry.m_id == id;
-      });
+    auto i = m_idIndex.find(id);
+    if(i == m_idIndex.end()) {
+      return NoneEntry<void>::NONE_ENTRY;
+    }
+    return m_entries[i->second];
   }
 
   inline const DestinationDatabase::Entry&
@@ -207,14 +219,21 @@ namespace Nexus {
     if(i == m_preferredDestinations.end()) {
       return NoneEntry<void>::NONE_ENTRY;
     }
-    auto j = std::find_if(m_entries.begin(), m_entries.end(),
-      [&] (auto& entry) {
-        return entry.m_id == i->second;
-      });
-    if(j == m_entries.end()) {
-      return NoneEntry<void>::NONE_ENTRY;
+    return FromId(i->second);
+  }
+
+  inline std::vector<DestinationDatabase::Entry>
+      DestinationDatabase::FromMarket(MarketCode market) const {
+    auto i = m_marketIndex.find(market);
+    if(i == m_marketIndex.end()) {
+      return {};
+    }
+    auto result = std::vector<DestinationDatabase::Entry>();
+    result.reserve(i->second.size());
+    for(auto index : i->second) {
+      result.push_back(m_entries[index]);
     }
-    return *j;
+    return result;
   }
 
   template<typename P>
@@ -250,6 +269,7 @@ namespace Nexus {
       });
     if(i == m_entries.end() || i->m_id != entry.m_id) {
       m_entries.insert(i, entry);
+      Index();
     }
   }
 
@@ -272,6 +292,7 @@ namespace Nexus {
       return;
     }
     m_entries.erase(entryIterator);
+    Index();
   }
 
   inline void DestinationDatabase::DeletePreferredDestination(
@@ -279,6 +300,17 @@ namespace Nexus {
     m_preferredDestinations.erase(market);
   }
 
+  inline void DestinationDatabase::Index() {
+    m_idIndex.clear();
+    m_marketIndex.clear();
+    for(auto i = std::size_t(0); i != m_entries.size(); ++i) {
+      m_idIndex.emplace(m_entries[i].m_id, i);
+      for(auto& market : m_entries[i].m_markets) {
+        m_marketIndex[market].push_back(i);
+      }
+    }
+  }
+
   template<typename T>
   DestinationDatabase::Entry DestinationDatabase::NoneEntry<T>::NONE_ENTRY;
 }
@@ -304,6 +336,9 @@ namespace Beam::Serialization {
       shuttle.Shuttle("preferred_destinations", value.m_preferredDestinations);
       shuttle.Shuttle("manual_order_entry_destination",
         value.m_manualOrderEntryDestination);
+      if(IsReceiver<Shuttler>::value) {
+        value.Index();
+      }
     }
   };
 }
@@ -1,8 +1,12 @@
 #ifndef NEXUS_EXCHANGE_RATE_TABLE_HPP
 #define NEXUS_EXCHANGE_RATE_TABLE_HPP
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <stdexcept>
 #include <vector>
+#include <boost/noncopyable.hpp>
 #include <boost/optional/optional.hpp>
 #include <boost/throw_exception.hpp>
 #include <boost/thread/locks.hpp>
@@ -13,10 +17,19 @@
 
 namespace Nexus {
 
-  /** Stores a table of ExchangeRates. */
-  class ExchangeRateTable {
+  /**
+   * Stores a table of ExchangeRates. Lookups read an immutable snapshot through
+   * a single atomic load, each Add publishes a new snapshot and the replaced
+   * ones are kept until the table is destroyed. Exchange rates change rarely,
+   * so retaining every snapshot costs little compared to reference counting
+   * on each lookup.
+   */
+  class ExchangeRateTable : private boost::noncopyable {
     public:
 
+      /** Constructs an empty ExchangeRateTable. */
+      ExchangeRateTable();
+
       /**
        * Finds an ExchangeRate.
        * @param pair The ExchangeRate's CurrencyPair.
@@ -41,42 +54,79 @@ namespace Nexus {
       void Add(const ExchangeRate& exchangeRate);
 
     private:
-      mutable boost::mutex m_mutex;
-      mutable std::vector<ExchangeRate> m_exchangeRates;
+      struct Snapshot {
+        std::vector<std::uint16_t> m_indexes;
+        std::size_t m_size;
+        std::vector<boost::optional<ExchangeRate>> m_rates;
 
-      void ImmutableAdd(const ExchangeRate& exchangeRate) const;
+        Snapshot();
+        const boost::optional<ExchangeRate>* Find(CurrencyPair pair) const;
+        std::size_t GetIndex(CurrencyId currency);
+        void Set(const ExchangeRate& exchangeRate);
+      };
+      boost::mutex m_mutex;
+      std::atomic<const Snapshot*> m_snapshot;
+      std::vector<std::unique_ptr<const Snapshot>> m_snapshots;
   };
 
+  inline ExchangeRateTable::Snapshot::Snapshot()
+    : m_size(0) {}
+
+  inline const boost::optional<ExchangeRate>*
+      ExchangeRateTable::Snapshot::Find(CurrencyPair pair) const {
+    auto base = static_cast<std::uint16_t>(pair.m_base);
+    auto counter = static_cast<std::uint16_t>(pair.m_counter);
+    if(base >= m_indexes.size() || counter >= m_indexes.size() ||
+        m_indexes[base] == 0 || m_indexes[counter] == 0) {
+      return nullptr;
+    }
+    return &m_rates[(m_indexes[base] - 1) * m_size + m_indexes[counter] - 1];
+  }
+
+  inline std::size_t ExchangeRateTable::Snapshot::GetIndex(
+      CurrencyId currency) {
+    auto id = static_cast<std::uint16_t>(currency);
+    if(id >= m_indexes.size()) {
+      m_indexes.resize(id + 1, 0);
+    }
+    if(m_indexes[id] == 0) {
+      auto rates = std::vector<boost::optional<ExchangeRate>>(
+        (m_size + 1) * (m_size + 1));
+      for(auto i = std::size_t(0); i != m_size; ++i) {
+        std::copy(m_rates.begin() + i * m_size,
+          m_rates.begin() + (i + 1) * m_size,
+          rates.begin() + i * (m_size + 1));
+      }
+      m_rates = std::move(rates);
+      ++m_size;
+      m_indexes[id] = static_cast<std::uint16_t>(m_size);
+    }
+    return m_indexes[id] - 1;
+  }
+
+  inline void ExchangeRateTable::Snapshot::Set(
+      const ExchangeRate& exchangeRate) {
+    auto base = GetIndex(exchangeRate.m_pair.m_base);
+    auto counter = GetIndex(exchangeRate.m_pair.m_counter);
+    m_rates[base * m_size + counter] = exchangeRate;
+  }
+
+  inline ExchangeRateTable::ExchangeRateTable()
+    : m_snapshot(nullptr) {}
+
   inline boost::optional<ExchangeRate> ExchangeRateTable::Find(
       CurrencyPair pair) const {
     if(pair.m_base == pair.m_counter) {
       return ExchangeRate(pair, 1);
     }
-    auto ExchangeRateSearch =
-      [&] (CurrencyPair pair) {
-        auto exchangeRateIterator = std::lower_bound(m_exchangeRates.begin(),
-          m_exchangeRates.end(), pair,
-          [] (auto& lhs, auto& rhs) {
-            return lhs.m_pair < rhs;
-          });
-        if(exchangeRateIterator == m_exchangeRates.end() ||
-            exchangeRateIterator->m_pair != pair) {
-          return m_exchangeRates.end();
-        }
-        return exchangeRateIterator;
-      };
-    auto lock = boost::lock_guard(m_mutex);
-    auto exchangeRateIterator = ExchangeRateSearch(pair);
-    if(exchangeRateIterator == m_exchangeRates.end()) {
-      exchangeRateIterator = ExchangeRateSearch(Invert(pair));
-      if(exchangeRateIterator == m_exchangeRates.end()) {
-        return boost::none;
-      }
-      auto invertedExchangeRate = Invert(*exchangeRateIterator);
-      ImmutableAdd(invertedExchangeRate);
-      return invertedExchangeRate;
+    auto snapshot = m_snapshot.load(std::memory_order_acquire);
+    if(!snapshot) {
+      return boost::none;
     }
-    return *exchangeRateIterator;
+    if(auto exchangeRate = snapshot->Find(pair)) {
+      return *exchangeRate;
+    }
+    return boost::none;
   }
 
   inline Money ExchangeRateTable::Convert(Money value, CurrencyId base,
@@ -93,24 +143,16 @@ namespace Nexus {
       return;
     }
     auto lock = boost::lock_guard(m_mutex);
-    ImmutableAdd(exchangeRate);
-    ImmutableAdd(Invert(exchangeRate));
-  }
-
-  inline void ExchangeRateTable::ImmutableAdd(
-      const ExchangeRate& exchangeRate) const {
-    auto exchangeRateIterator = std::lower_bound(m_exchangeRates.begin(),
-        m_exchangeRates.end(), exchangeRate,
-      [] (auto& lhs, auto& rhs) {
-        return lhs.m_pair < rhs.m_pair;
-      });
-    if(exchangeRateIterator == m_exchangeRates.end()) {
-      m_exchangeRates.push_back(exchangeRate);
-    } else if(exchangeRateIterator->m_pair == exchangeRate.m_pair) {
-      *exchangeRateIterator = exchangeRate;
-    } else {
-      m_exchangeRates.insert(exchangeRateIterator, exchangeRate);
-    }
+    auto snapshot = [&] {
+      if(m_snapshots.empty()) {
+        return std::make_unique<Snapshot>();
+      }
+      return std::make_unique<Snapshot>(*m_snapshots.back());
+    }();
+    snapshot->Set(exchangeRate);
+    snapshot->Set(Invert(exchangeRate));
+    m_snapshot.store(snapshot.get(), std::memory_order_release);
+    m_snapshots.push_back(std::move(snapshot));
   }
 }
 
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <ostream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <Beam/Serialization/DataShuttle.hpp>
 #include <Beam/TimeService/ToLocalTime.hpp>
@@ -92,6 +93,10 @@ namespace Nexus {
       friend struct Beam::Serialization::Shuttle<MarketDatabase>;
       static Entry MakeNoneEntry();
       std::vector<Entry> m_entries;
+      std::unordered_map<MarketCode, std::size_t> m_codeIndex;
+      std::unordered_map<std::string, std::size_t> m_displayNameIndex;
+
+      void Index();
   };
 
   /**
@@ -247,29 +252,20 @@ namespace Nexus {
 
   inline const MarketDatabase::Entry& MarketDatabase::FromCode(
       MarketCode code) const {
-    auto comparator = Entry();
-    comparator.m_code = code;
-    auto i = std::lower_bound(m_entries.begin(), m_entries.end(),
-      comparator,
-      [] (auto& lhs, auto& rhs) {
-        return lhs.m_code < rhs.m_code;
-      });
-    if(i != m_entries.end() && i->m_code == code) {
-      return *i;
+    auto i = m_codeIndex.find(code);
+    if(i == m_codeIndex.end()) {
+      return GetNoneEntry();
     }
-    return GetNoneEntry();
+    return m_entries[i->second];
   }
 
   inline const MarketDatabase::Entry& MarketDatabase::FromDisplayName(
       const std::string& displayName) const {
-    auto i = std::find_if(m_entries.begin(), m_entries.end(),
-      [&] (auto& entry) {
-        return entry.m_displayName == displayName;
-      });
-    if(i == m_entries.end()) {
+    auto i = m_displayNameIndex.find(displayName);
+    if(i == m_displayNameIndex.end()) {
       return GetNoneEntry();
     }
-    return *i;
+    return m_entries[i->second];
   }
 
   inline std::vector<MarketDatabase::Entry> MarketDatabase::FromCountry(
@@ -291,6 +287,7 @@ namespace Nexus {
       });
     if(i == m_entries.end() || i->m_code != entry.m_code) {
       m_entries.insert(i, entry);
+      Index();
     }
   }
 
@@ -303,6 +300,7 @@ namespace Nexus {
       return;
     }
     m_entries.erase(i);
+    Index();
   }
 
   inline MarketDatabase::Entry MarketDatabase::MakeNoneEntry() {
@@ -314,6 +312,15 @@ namespace Nexus {
     return entry;
   }
 
+  inline void MarketDatabase::Index() {
+    m_codeIndex.clear();
+    m_displayNameIndex.clear();
+    for(auto i = std::size_t(0); i != m_entries.size(); ++i) {
+      m_codeIndex.emplace(m_entries[i].m_code, i);
+      m_displayNameIndex.emplace(m_entries[i].m_displayName, i);
+    }
+  }
+
   inline std::ostream& operator <<(std::ostream& out,
       const MarketDatabase::Entry& entry) {
     return out << '(' << entry.m_code << ' ' << entry.m_countryCode << ' ' <<
@@ -343,6 +350,9 @@ namespace Beam::Serialization {
     void operator ()(Shuttler& shuttle, Nexus::MarketDatabase& value,
         unsigned int version) {
       shuttle.Shuttle("entries", value.m_entries);
+      if(IsReceiver<Shuttler>::value) {
+        value.Index();
+      }
     }
   };
 }
@@ -1,9 +1,14 @@
 #ifndef NEXUS_TRADING_SCHEDULE_HPP
 #define NEXUS_TRADING_SCHEDULE_HPP
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <ostream>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 #include <Beam/Parsers/Parse.hpp>
 #include <Beam/Parsers/TimeDurationParser.hpp>
@@ -75,7 +80,7 @@ namespace Nexus {
       };
 
       /** Constructs an empty TradingSchedule. */
-      TradingSchedule() = default;
+      TradingSchedule();
 
       /**
        * Constructs a TradingSchedule.
@@ -84,14 +89,16 @@ namespace Nexus {
       explicit TradingSchedule(std::vector<Rule> rules);
 
       /**
-       * Returns a list of events matching a date and market.
+       * Returns a list of events matching a date and market. The lists of the
+       * most recently looked up dates are cached per market, and a cached
+       * list is returned without locking or copying.
        * @param date The date to match.
        * @param market The market to match.
        * @return A list of events taking place on the specified <i>date</i> and
        *         <i>market</i>.
        */
-      std::vector<Event> Find(boost::gregorian::date date,
-        MarketCode market) const;
+      std::shared_ptr<const std::vector<Event>> Find(
+        boost::gregorian::date date, MarketCode market) const;
 
       /**
        * Returns a list of events matching a date, market, and predicate.
@@ -107,7 +114,39 @@ namespace Nexus {
 
     private:
       friend struct Beam::Serialization::Shuttle<TradingSchedule>;
+      static constexpr auto CACHED_DAYS = std::size_t(4);
+      struct CachedDay {
+        long m_day;
+        std::shared_ptr<const std::vector<Event>> m_events;
+      };
+      struct MarketIndex {
+        std::array<std::vector<std::size_t>, 7> m_rules;
+        std::array<std::atomic<CachedDay*>, CACHED_DAYS> m_days;
+        std::size_t m_nextDay;
+
+        MarketIndex();
+        ~MarketIndex();
+      };
+      struct Index {
+        std::mutex m_mutex;
+        std::atomic_int m_readers;
+        std::unordered_map<MarketCode, std::unique_ptr<MarketIndex>>
+          m_markets;
+        MarketIndex m_otherMarkets;
+        std::vector<std::unique_ptr<CachedDay>> m_retiredDays;
+
+        Index();
+      };
       std::vector<Rule> m_rules;
+      std::shared_ptr<Index> m_index;
+
+      static std::shared_ptr<Index> MakeIndex(const std::vector<Rule>& rules);
+      static void BuildMarketIndex(const std::vector<Rule>& rules,
+        MarketCode market, MarketIndex& index);
+      std::shared_ptr<const std::vector<Event>> Load(
+        boost::gregorian::date date, MarketCode market) const;
+      std::vector<Event> MakeEvents(boost::gregorian::date date,
+        const Rule& rule) const;
   };
 
   /**
@@ -270,31 +309,162 @@ namespace Nexus {
     return !(*this == rule);
   }
 
+  inline TradingSchedule::TradingSchedule()
+    : m_index(MakeIndex(m_rules)) {}
+
   inline TradingSchedule::TradingSchedule(std::vector<Rule> rules)
-    : m_rules(std::move(rules)) {}
+    : m_rules(std::move(rules)),
+      m_index(MakeIndex(m_rules)) {}
 
-  inline std::vector<TradingSchedule::Event> TradingSchedule::Find(
-      boost::gregorian::date date, MarketCode market) const {
-    return Find(date, market, [] (const auto&) { return true; });
+  inline std::shared_ptr<const std::vector<TradingSchedule::Event>>
+      TradingSchedule::Find(boost::gregorian::date date,
+      MarketCode market) const {
+    return Load(date, market);
   }
 
   template<typename F>
   std::vector<TradingSchedule::Event> TradingSchedule::Find(
       boost::gregorian::date date, MarketCode market, F&& f) const {
-    for(auto& rule : m_rules) {
-      if(IsMatch(market, date, rule)) {
-        auto events = std::vector<TradingSchedule::Event>();
-        for(auto& event : rule.m_events) {
-          if(f(event)) {
-            events.push_back(event);
-            events.back().m_timestamp = boost::posix_time::ptime(date,
-              event.m_timestamp.time_of_day());
-          }
+    auto events = std::vector<TradingSchedule::Event>();
+    for(auto& event : *Load(date, market)) {
+      if(f(event)) {
+        events.push_back(event);
+      }
+    }
+    return events;
+  }
+
+  inline std::shared_ptr<const std::vector<TradingSchedule::Event>>
+      TradingSchedule::Load(boost::gregorian::date date,
+      MarketCode market) const {
+    static const auto NO_EVENTS =
+      std::make_shared<const std::vector<Event>>();
+    if(date.is_special()) {
+      return NO_EVENTS;
+    }
+
+    // A moved-from schedule has no index, so resolve the date directly.
+    if(!m_index) {
+      for(auto& rule : m_rules) {
+        if(IsMatch(market, date, rule)) {
+          return std::make_shared<const std::vector<Event>>(
+            MakeEvents(date, rule));
         }
+      }
+      return NO_EVENTS;
+    }
+    auto day = date.day_number();
+    auto& marketIndex = [&] () -> MarketIndex& {
+      auto marketIterator = m_index->m_markets.find(market);
+      if(marketIterator == m_index->m_markets.end()) {
+        return m_index->m_otherMarkets;
+      }
+      return *marketIterator->second;
+    }();
+
+    // Readers are counted so that a writer knows when no reader can still
+    // hold a day it evicted. The counter and the slots are accessed with
+    // sequentially consistent operations for that handshake to hold.
+    ++m_index->m_readers;
+    for(auto& slot : marketIndex.m_days) {
+      auto cachedDay = slot.load();
+      if(cachedDay && cachedDay->m_day == day) {
+        auto events = cachedDay->m_events;
+        --m_index->m_readers;
         return events;
       }
     }
-    return {};
+    --m_index->m_readers;
+    auto events = NO_EVENTS;
+    for(auto ruleIndex : marketIndex.m_rules[date.day_of_week()]) {
+      auto& rule = m_rules[ruleIndex];
+      if(IsMatch(market, date, rule)) {
+        events = std::make_shared<const std::vector<Event>>(
+          MakeEvents(date, rule));
+        break;
+      }
+    }
+    auto lock = std::lock_guard(m_index->m_mutex);
+    for(auto& slot : marketIndex.m_days) {
+      auto cachedDay = slot.load();
+      if(cachedDay && cachedDay->m_day == day) {
+        return cachedDay->m_events;
+      }
+    }
+    auto evictedDay = std::unique_ptr<CachedDay>(
+      marketIndex.m_days[marketIndex.m_nextDay].exchange(
+      new CachedDay{day, events}));
+    marketIndex.m_nextDay = (marketIndex.m_nextDay + 1) % CACHED_DAYS;
+    if(evictedDay) {
+      m_index->m_retiredDays.push_back(std::move(evictedDay));
+    }
+    if(m_index->m_readers == 0) {
+      m_index->m_retiredDays.clear();
+    }
+    return events;
+  }
+
+  inline std::shared_ptr<TradingSchedule::Index> TradingSchedule::MakeIndex(
+      const std::vector<Rule>& rules) {
+    auto index = std::make_shared<Index>();
+    for(auto& rule : rules) {
+      for(auto market : rule.m_markets) {
+        if(index->m_markets.find(market) == index->m_markets.end()) {
+          auto marketIndex = std::make_unique<MarketIndex>();
+          BuildMarketIndex(rules, market, *marketIndex);
+          index->m_markets.emplace(market, std::move(marketIndex));
+        }
+      }
+    }
+    BuildMarketIndex(rules, MarketCode(), index->m_otherMarkets);
+    return index;
+  }
+
+  inline void TradingSchedule::BuildMarketIndex(const std::vector<Rule>& rules,
+      MarketCode market, MarketIndex& index) {
+    for(auto i = std::size_t(0); i != rules.size(); ++i) {
+      auto& rule = rules[i];
+      if(!rule.m_markets.empty() && std::find(rule.m_markets.begin(),
+          rule.m_markets.end(), market) == rule.m_markets.end()) {
+        continue;
+      }
+      for(auto weekday = std::size_t(0); weekday != index.m_rules.size();
+          ++weekday) {
+        if(rule.m_weekdays.empty() || std::find(rule.m_weekdays.begin(),
+            rule.m_weekdays.end(), boost::gregorian::greg_weekday(
+            static_cast<unsigned short>(weekday))) != rule.m_weekdays.end()) {
+          index.m_rules[weekday].push_back(i);
+        }
+      }
+    }
+  }
+
+  inline TradingSchedule::MarketIndex::MarketIndex()
+      : m_nextDay(0) {
+    for(auto& day : m_days) {
+      day = nullptr;
+    }
+  }
+
+  inline TradingSchedule::MarketIndex::~MarketIndex() {
+    for(auto& day : m_days) {
+      delete day.load();
+    }
+  }
+
+  inline TradingSchedule::Index::Index()
+    : m_readers(0) {}
+
+  inline std::vector<TradingSchedule::Event> TradingSchedule::MakeEvents(
+      boost::gregorian::date date, const Rule& rule) const {
+    auto events = std::vector<Event>();
+    events.reserve(rule.m_events.size());
+    for(auto& event : rule.m_events) {
+      events.push_back(event);
+      events.back().m_timestamp = boost::posix_time::ptime(date,
+        event.m_timestamp.time_of_day());
+    }
+    return events;
   }
 }
 
@@ -329,6 +499,9 @@ namespace Beam::Serialization {
     void operator ()(Shuttler& shuttle, Nexus::TradingSchedule& value,
         unsigned int version) {
       shuttle.Shuttle("rules", value.m_rules);
+      if(IsReceiver<Shuttler>::value) {
+        value.m_index = Nexus::TradingSchedule::MakeIndex(value.m_rules);
+      }
     }
   };
 }
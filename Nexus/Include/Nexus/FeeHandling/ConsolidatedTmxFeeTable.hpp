@@ -2,7 +2,9 @@
 #define NEXUS_CONSOLIDATED_TMX_FEE_TABLE_HPP
 #include <exception>
 #include <sstream>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 #include <Beam/Collections/SynchronizedMap.hpp>
 #include <Beam/Utilities/Algorithm.hpp>
 #include <Beam/Utilities/YamlConfig.hpp>
@@ -22,6 +24,7 @@
 #include "Nexus/FeeHandling/XatsFeeTable.hpp"
 #include "Nexus/FeeHandling/Xcx2FeeTable.hpp"
 #include "Nexus/OrderExecutionService/Order.hpp"
+#include "Nexus/OrderExecutionService/OrderInfo.hpp"
 #include "Nexus/OrderExecutionService/ExecutionReport.hpp"
 
 namespace Nexus {
@@ -259,24 +262,62 @@ namespace Nexus {
     return feeTable;
   }
 
+  /**
+   * Returns the market that a TMX destination routes to.
+   * @param destination The destination to lookup.
+   * @return The code of the market the <i>destination</i> routes to, or an
+   *         empty string if the <i>destination</i> is not a TMX destination.
+   */
+  inline std::string GetTmxDestinationMarket(const Destination& destination) {
+    if(destination == DefaultDestinations::ALPHA()) {
+      return boost::lexical_cast<std::string>(DefaultMarkets::XATS());
+    } else if(destination == DefaultDestinations::CHIX()) {
+      return boost::lexical_cast<std::string>(DefaultMarkets::CHIC());
+    } else if(destination == DefaultDestinations::CSE()) {
+      return boost::lexical_cast<std::string>(DefaultMarkets::CSE());
+    } else if(destination == DefaultDestinations::CX2()) {
+      return boost::lexical_cast<std::string>(DefaultMarkets::XCX2());
+    } else if(destination == DefaultDestinations::LYNX()) {
+      return boost::lexical_cast<std::string>(DefaultMarkets::LYNX());
+    } else if(destination == DefaultDestinations::MATNLP()) {
+      return boost::lexical_cast<std::string>(DefaultMarkets::MATN());
+    } else if(destination == DefaultDestinations::MATNMF()) {
+      return boost::lexical_cast<std::string>(DefaultMarkets::MATN());
+    } else if(destination == DefaultDestinations::NEOE()) {
+      return boost::lexical_cast<std::string>(DefaultMarkets::NEOE());
+    } else if(destination == DefaultDestinations::OMEGA()) {
+      return boost::lexical_cast<std::string>(DefaultMarkets::OMGA());
+    } else if(destination == DefaultDestinations::PURE()) {
+      return boost::lexical_cast<std::string>(DefaultMarkets::PURE());
+    } else if(destination == DefaultDestinations::TSX()) {
+      return boost::lexical_cast<std::string>(DefaultMarkets::TSX());
+    } else {
+      return std::string();
+    }
+  }
+
   /**
    * Calculates the fee on a trade executed on a TMX market.
    * @param feeTable The ConsolidatedTmxFeeTable used to calculate the fee.
    * @param state The historical State of fee calculations.
-   * @param order The Order that was traded against.
+   * @param orderId The id of the Order that was traded against.
+   * @param fields The OrderFields of the Order that was traded against.
+   * @param destinationMarket The market the Order's destination routes to,
+   *        used when the <i>executionReport</i> has no last market.
    * @param executionReport The ExecutionReport to calculate the fee for.
    * @return The fee calculated for the specified trade.
    */
   inline OrderExecutionService::ExecutionReport CalculateFee(
       const ConsolidatedTmxFeeTable& feeTable,
       ConsolidatedTmxFeeTable::State& state,
-      const OrderExecutionService::Order& order,
+      OrderExecutionService::OrderId orderId, const OrderFields& fields,
+      const std::string& destinationMarket,
       const OrderExecutionService::ExecutionReport& executionReport) {
     auto feesReport = executionReport;
     feesReport.m_processingFee += feesReport.m_lastQuantity *
       feeTable.m_clearingFee;
     if(feesReport.m_lastQuantity != 0) {
-      auto& fillCount = state.m_fillCount.Get(order.GetInfo().m_orderId);
+      auto& fillCount = state.m_fillCount.Get(orderId);
       ++fillCount;
       feesReport.m_processingFee += feeTable.m_iirocFee;
       if(fillCount <= feeTable.m_cdsCap) {
@@ -284,8 +325,7 @@ namespace Nexus {
       }
     }
     feesReport.m_commission += feesReport.m_lastQuantity * feeTable.m_spireFee;
-    auto& perOrderCharge = state.m_perOrderCharges.Get(
-      order.GetInfo().m_orderId);
+    auto& perOrderCharge = state.m_perOrderCharges.Get(orderId);
     auto perOrderDelta = executionReport.m_lastQuantity *
       feeTable.m_perOrderFee;
     if(perOrderCharge + perOrderDelta > feeTable.m_perOrderCap) {
@@ -294,56 +334,27 @@ namespace Nexus {
     perOrderCharge += perOrderDelta;
     feesReport.m_processingFee += perOrderDelta;
     feesReport.m_executionFee += [&] {
-      auto lastMarket = [&] {
+      auto& lastMarket = [&] () -> const std::string& {
         if(!executionReport.m_lastMarket.empty()) {
-          return std::string{executionReport.m_lastMarket};
-        } else {
-          auto& destination = order.GetInfo().m_fields.m_destination;
-          if(destination == DefaultDestinations::ALPHA()) {
-            return boost::lexical_cast<std::string>(DefaultMarkets::XATS());
-          } else if(destination == DefaultDestinations::CHIX()) {
-            return boost::lexical_cast<std::string>(DefaultMarkets::CHIC());
-          } else if(destination == DefaultDestinations::CSE()) {
-            return boost::lexical_cast<std::string>(DefaultMarkets::CSE());
-          } else if(destination == DefaultDestinations::CX2()) {
-            return boost::lexical_cast<std::string>(DefaultMarkets::XCX2());
-          } else if(destination == DefaultDestinations::LYNX()) {
-            return boost::lexical_cast<std::string>(DefaultMarkets::LYNX());
-          } else if(destination == DefaultDestinations::MATNLP()) {
-            return boost::lexical_cast<std::string>(DefaultMarkets::MATN());
-          } else if(destination == DefaultDestinations::MATNMF()) {
-            return boost::lexical_cast<std::string>(DefaultMarkets::MATN());
-          } else if(destination == DefaultDestinations::NEOE()) {
-            return boost::lexical_cast<std::string>(DefaultMarkets::NEOE());
-          } else if(destination == DefaultDestinations::OMEGA()) {
-            return boost::lexical_cast<std::string>(DefaultMarkets::OMGA());
-          } else if(destination == DefaultDestinations::PURE()) {
-            return boost::lexical_cast<std::string>(DefaultMarkets::PURE());
-          } else if(destination == DefaultDestinations::TSX()) {
-            return boost::lexical_cast<std::string>(DefaultMarkets::TSX());
-          } else {
-            return std::string();
-          }
+          return executionReport.m_lastMarket;
         }
+        return destinationMarket;
       }();
       if(lastMarket == DefaultMarkets::XATS()) {
-        auto isEtf = Beam::Contains(feeTable.m_etfs,
-          order.GetInfo().m_fields.m_security);
+        auto isEtf = Beam::Contains(feeTable.m_etfs, fields.m_security);
         return CalculateFee(feeTable.m_xatsFeeTable, isEtf, executionReport);
       } else if(lastMarket == DefaultMarkets::CHIC()) {
-        return CalculateFee(feeTable.m_chicFeeTable, order.GetInfo().m_fields,
-          executionReport);
+        return CalculateFee(feeTable.m_chicFeeTable, fields, executionReport);
       } else if(lastMarket == DefaultMarkets::CSE()) {
         return CalculateFee(feeTable.m_cseFeeTable, executionReport);
       } else if(lastMarket == DefaultMarkets::XCX2()) {
-        return CalculateFee(feeTable.m_xcx2FeeTable, order.GetInfo().m_fields,
+        return CalculateFee(feeTable.m_xcx2FeeTable, fields,
           executionReport);
       } else if(lastMarket == DefaultMarkets::LYNX()) {
         return CalculateFee(feeTable.m_lynxFeeTable, executionReport);
       } else if(lastMarket == DefaultMarkets::MATN()) {
         auto classification = [&] {
-          if(Beam::Contains(feeTable.m_etfs,
-              order.GetInfo().m_fields.m_security)) {
+          if(Beam::Contains(feeTable.m_etfs, fields.m_security)) {
             return MatnFeeTable::Classification::ETF;
           } else {
             return MatnFeeTable::Classification::DEFAULT;
@@ -353,47 +364,43 @@ namespace Nexus {
           executionReport);
       } else if(lastMarket == DefaultMarkets::NEOE()) {
         auto isInterlisted = Beam::Contains(feeTable.m_interlisted,
-          order.GetInfo().m_fields.m_security);
+          fields.m_security);
         return CalculateFee(feeTable.m_neoeFeeTable, isInterlisted,
-          order.GetInfo().m_fields, executionReport);
+          fields, executionReport);
       } else if(lastMarket == DefaultMarkets::OMGA()) {
-        auto isEtf = Beam::Contains(feeTable.m_etfs,
-          order.GetInfo().m_fields.m_security);
+        auto isEtf = Beam::Contains(feeTable.m_etfs, fields.m_security);
         return CalculateFee(feeTable.m_omgaFeeTable, isEtf,
-          order.GetInfo().m_fields, executionReport);
+          fields, executionReport);
       } else if(lastMarket == DefaultMarkets::PURE()) {
         return CalculateFee(feeTable.m_pureFeeTable,
-          order.GetInfo().m_fields.m_security, executionReport);
+          fields.m_security, executionReport);
       } else if(lastMarket == DefaultMarkets::TSX() ||
           lastMarket == DefaultMarkets::TSXV()) {
         if(lastMarket == DefaultMarkets::TSXV() && feeTable.m_nexListed.count(
-            order.GetInfo().m_fields.m_security) != 0) {
+            fields.m_security) != 0) {
           return CalculateFee(feeTable.m_nexFeeTable, executionReport);
         }
         auto classification = [&] {
-          if(Beam::Contains(feeTable.m_etfs,
-              order.GetInfo().m_fields.m_security)) {
+          if(Beam::Contains(feeTable.m_etfs, fields.m_security)) {
             return TsxFeeTable::Classification::ETF;
           } else if(Beam::Contains(feeTable.m_interlisted,
-              order.GetInfo().m_fields.m_security)) {
+              fields.m_security)) {
             return TsxFeeTable::Classification::INTERLISTED;
           } else {
             return TsxFeeTable::Classification::DEFAULT;
           }
         }();
-        if(order.GetInfo().m_fields.m_security.GetMarket() ==
-            DefaultMarkets::TSX()) {
+        if(fields.m_security.GetMarket() == DefaultMarkets::TSX()) {
           return CalculateFee(feeTable.m_tsxFeeTable, classification,
-            order.GetInfo().m_fields, executionReport);
-        } else if(order.GetInfo().m_fields.m_security.GetMarket() ==
-            DefaultMarkets::TSXV()) {
+            fields, executionReport);
+        } else if(fields.m_security.GetMarket() == DefaultMarkets::TSXV()) {
           return CalculateFee(feeTable.m_tsxVentureTable, classification,
-            order.GetInfo().m_fields, executionReport);
+            fields, executionReport);
         } else {
           std::cout << "Unknown market [TMX]: \"" <<
-            order.GetInfo().m_fields.m_security.GetMarket() << "\"\n";
+            fields.m_security.GetMarket() << "\"\n";
           return CalculateFee(feeTable.m_tsxFeeTable, classification,
-            order.GetInfo().m_fields, executionReport);
+            fields, executionReport);
         }
       } else {
         std::cout << "Unknown last market [TMX]: \"" << lastMarket << "\"\n";
@@ -402,6 +409,64 @@ namespace Nexus {
     }();
     return feesReport;
   }
+
+  /**
+   * Calculates the fee on a trade executed on a TMX market.
+   * @param feeTable The ConsolidatedTmxFeeTable used to calculate the fee.
+   * @param state The historical State of fee calculations.
+   * @param order The Order that was traded against.
+   * @param executionReport The ExecutionReport to calculate the fee for.
+   * @return The fee calculated for the specified trade.
+   */
+  inline OrderExecutionService::ExecutionReport CalculateFee(
+      const ConsolidatedTmxFeeTable& feeTable,
+      ConsolidatedTmxFeeTable::State& state,
+      const OrderExecutionService::Order& order,
+      const OrderExecutionService::ExecutionReport& executionReport) {
+    return CalculateFee(feeTable, state, order.GetInfo().m_orderId,
+      order.GetInfo().m_fields, GetTmxDestinationMarket(
+      order.GetInfo().m_fields.m_destination), executionReport);
+  }
+
+  /**
+   * Calculates the fees on a batch of trades executed on TMX markets. The
+   * destination of each Order is resolved once no matter how many of its
+   * ExecutionReports are in the batch.
+   * @param feeTable The ConsolidatedTmxFeeTable used to calculate the fees.
+   * @param state The historical State of fee calculations.
+   * @param orders The Orders referenced by the <i>executionReports</i>.
+   * @param executionReports The ExecutionReports to calculate the fees for,
+   *        in the order they were executed.
+   * @return The <i>executionReports</i> with their calculated fees added.
+   */
+  inline std::vector<OrderExecutionService::ExecutionReport> CalculateFees(
+      const ConsolidatedTmxFeeTable& feeTable,
+      ConsolidatedTmxFeeTable::State& state,
+      const std::vector<OrderExecutionService::OrderInfo>& orders,
+      const std::vector<OrderExecutionService::ExecutionReport>&
+        executionReports) {
+    auto destinationMarkets = std::vector<std::string>();
+    destinationMarkets.reserve(orders.size());
+    auto orderIndexes =
+      std::unordered_map<OrderExecutionService::OrderId, std::size_t>();
+    for(auto i = std::size_t(0); i != orders.size(); ++i) {
+      destinationMarkets.push_back(GetTmxDestinationMarket(
+        orders[i].m_fields.m_destination));
+      orderIndexes.emplace(orders[i].m_orderId, i);
+    }
+    auto feesReports = std::vector<OrderExecutionService::ExecutionReport>();
+    feesReports.reserve(executionReports.size());
+    for(auto& executionReport : executionReports) {
+      auto i = orderIndexes.find(executionReport.m_id);
+      if(i == orderIndexes.end()) {
+        BOOST_THROW_EXCEPTION(std::runtime_error("Order not found."));
+      }
+      feesReports.push_back(CalculateFee(feeTable, state, executionReport.m_id,
+        orders[i->second].m_fields, destinationMarkets[i->second],
+        executionReport));
+    }
+    return feesReports;
+  }
 }
 
 #endif
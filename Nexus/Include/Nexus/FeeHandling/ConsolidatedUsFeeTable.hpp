@@ -2,7 +2,9 @@
 #define NEXUS_CONSOLIDATED_US_FEE_TABLE_HPP
 #include <exception>
 #include <sstream>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 #include <Beam/Utilities/Algorithm.hpp>
 #include <Beam/Utilities/YamlConfig.hpp>
 #include <boost/throw_exception.hpp>
@@ -18,6 +20,7 @@
 #include "Nexus/FeeHandling/NsdqFeeTable.hpp"
 #include "Nexus/FeeHandling/NyseFeeTable.hpp"
 #include "Nexus/OrderExecutionService/Order.hpp"
+#include "Nexus/OrderExecutionService/OrderInfo.hpp"
 #include "Nexus/OrderExecutionService/ExecutionReport.hpp"
 
 namespace Nexus {
@@ -133,47 +136,52 @@ namespace Nexus {
     return feeTable;
   }
 
+  /**
+   * Returns the market that a U.S. destination routes to.
+   * @param destination The destination to lookup.
+   * @return The code of the market the <i>destination</i> routes to, or an
+   *         empty string if the <i>destination</i> is not a U.S. destination.
+   */
+  inline std::string GetUsDestinationMarket(const Destination& destination) {
+    if(destination == DefaultDestinations::AMEX()) {
+      return boost::lexical_cast<std::string>(DefaultMarkets::ASEX());
+    } else if(destination == DefaultDestinations::ARCA()) {
+      return boost::lexical_cast<std::string>(DefaultMarkets::ARCX());
+    } else if(destination == DefaultDestinations::BATS()) {
+      return boost::lexical_cast<std::string>(DefaultMarkets::BATS());
+    } else if(destination == DefaultDestinations::BATY()) {
+      return boost::lexical_cast<std::string>(DefaultMarkets::BATY());
+    } else if(destination == DefaultDestinations::EDGA()) {
+      return boost::lexical_cast<std::string>(DefaultMarkets::EDGA());
+    } else if(destination == DefaultDestinations::EDGX()) {
+      return boost::lexical_cast<std::string>(DefaultMarkets::EDGX());
+    } else if(destination == DefaultDestinations::NASDAQ()) {
+      return boost::lexical_cast<std::string>(DefaultMarkets::NASDAQ());
+    } else if(destination == DefaultDestinations::NYSE()) {
+      return boost::lexical_cast<std::string>(DefaultMarkets::NYSE());
+    } else {
+      return std::string();
+    }
+  }
+
   /**
    * Calculates the fee on a trade executed on a U.S. market.
    * @param feeTable The ConsolidatedUsFeeTable used to calculate the fee.
-   * @param order The Order that was traded against.
+   * @param fields The OrderFields of the Order that was traded against.
+   * @param lastMarket The market the Order's destination routes to.
    * @param executionReport The ExecutionReport to calculate the fee for.
    * @return An ExecutionReport containing the calculated fees.
    */
   inline OrderExecutionService::ExecutionReport CalculateFee(
-      const ConsolidatedUsFeeTable& feeTable,
-      const OrderExecutionService::Order& order,
+      const ConsolidatedUsFeeTable& feeTable, const OrderFields& fields,
+      const std::string& lastMarket,
       const OrderExecutionService::ExecutionReport& executionReport) {
     auto feesReport = executionReport;
-    auto lastMarket = [&] {
-      auto& destination = order.GetInfo().m_fields.m_destination;
-      if(destination == DefaultDestinations::AMEX()) {
-        return boost::lexical_cast<std::string>(DefaultMarkets::ASEX());
-      } else if(destination == DefaultDestinations::ARCA()) {
-        return boost::lexical_cast<std::string>(DefaultMarkets::ARCX());
-      } else if(destination == DefaultDestinations::BATS()) {
-        return boost::lexical_cast<std::string>(DefaultMarkets::BATS());
-      } else if(destination == DefaultDestinations::BATY()) {
-        return boost::lexical_cast<std::string>(DefaultMarkets::BATY());
-      } else if(destination == DefaultDestinations::EDGA()) {
-        return boost::lexical_cast<std::string>(DefaultMarkets::EDGA());
-      } else if(destination == DefaultDestinations::EDGX()) {
-        return boost::lexical_cast<std::string>(DefaultMarkets::EDGX());
-      } else if(destination == DefaultDestinations::NASDAQ()) {
-        return boost::lexical_cast<std::string>(DefaultMarkets::NASDAQ());
-      } else if(destination == DefaultDestinations::NYSE()) {
-        return boost::lexical_cast<std::string>(DefaultMarkets::NYSE());
-      } else {
-        return std::string();
-      }
-    }();
     feesReport.m_executionFee += [&] {
       if(lastMarket == DefaultMarkets::ASEX()) {
-        return CalculateFee(feeTable.m_amexFeeTable, order.GetInfo().m_fields,
-          executionReport);
+        return CalculateFee(feeTable.m_amexFeeTable, fields, executionReport);
       } else if(lastMarket == DefaultMarkets::ARCX()) {
-        return CalculateFee(feeTable.m_arcaFeeTable, order.GetInfo().m_fields,
-          executionReport);
+        return CalculateFee(feeTable.m_arcaFeeTable, fields, executionReport);
       } else if(lastMarket == DefaultMarkets::BATS()) {
         return CalculateFee(feeTable.m_batsFeeTable, executionReport);
       } else if(lastMarket == DefaultMarkets::BATY()) {
@@ -185,11 +193,10 @@ namespace Nexus {
       } else if(lastMarket == DefaultMarkets::NASDAQ()) {
         return CalculateFee(feeTable.m_nsdqFeeTable, executionReport);
       } else if(lastMarket == DefaultMarkets::NYSE()) {
-        return CalculateFee(feeTable.m_nyseFeeTable, order.GetInfo().m_fields,
-          executionReport);
+        return CalculateFee(feeTable.m_nyseFeeTable, fields, executionReport);
       } else {
-        std::cout << "Unknown last market [US]: \"" <<
-          order.GetInfo().m_fields.m_destination << "\"\n";
+        std::cout << "Unknown last market [US]: \"" << fields.m_destination <<
+          "\"\n";
         return Money::ZERO;
       }
     }();
@@ -197,7 +204,7 @@ namespace Nexus {
       if(feesReport.m_lastQuantity != 0) {
         auto processingFee = feesReport.m_lastQuantity *
           (feeTable.m_clearingFee + feeTable.m_tafFee);
-        if(order.GetInfo().m_fields.m_side == Side::BID) {
+        if(fields.m_side == Side::BID) {
           processingFee += feeTable.m_secRate *
             (feesReport.m_lastQuantity * feesReport.m_lastPrice);
         }
@@ -211,6 +218,58 @@ namespace Nexus {
     feesReport.m_commission += feesReport.m_lastQuantity * feeTable.m_spireFee;
     return feesReport;
   }
+
+  /**
+   * Calculates the fee on a trade executed on a U.S. market.
+   * @param feeTable The ConsolidatedUsFeeTable used to calculate the fee.
+   * @param order The Order that was traded against.
+   * @param executionReport The ExecutionReport to calculate the fee for.
+   * @return An ExecutionReport containing the calculated fees.
+   */
+  inline OrderExecutionService::ExecutionReport CalculateFee(
+      const ConsolidatedUsFeeTable& feeTable,
+      const OrderExecutionService::Order& order,
+      const OrderExecutionService::ExecutionReport& executionReport) {
+    return CalculateFee(feeTable, order.GetInfo().m_fields,
+      GetUsDestinationMarket(order.GetInfo().m_fields.m_destination),
+      executionReport);
+  }
+
+  /**
+   * Calculates the fees on a batch of trades executed on U.S. markets. The
+   * destination of each Order is resolved once no matter how many of its
+   * ExecutionReports are in the batch.
+   * @param feeTable The ConsolidatedUsFeeTable used to calculate the fees.
+   * @param orders The Orders referenced by the <i>executionReports</i>.
+   * @param executionReports The ExecutionReports to calculate the fees for.
+   * @return The <i>executionReports</i> with their calculated fees added.
+   */
+  inline std::vector<OrderExecutionService::ExecutionReport> CalculateFees(
+      const ConsolidatedUsFeeTable& feeTable,
+      const std::vector<OrderExecutionService::OrderInfo>& orders,
+      const std::vector<OrderExecutionService::ExecutionReport>&
+        executionReports) {
+    auto destinationMarkets = std::vector<std::string>();
+    destinationMarkets.reserve(orders.size());
+    auto orderIndexes =
+      std::unordered_map<OrderExecutionService::OrderId, std::size_t>();
+    for(auto i = std::size_t(0); i != orders.size(); ++i) {
+      destinationMarkets.push_back(GetUsDestinationMarket(
+        orders[i].m_fields.m_destination));
+      orderIndexes.emplace(orders[i].m_orderId, i);
+    }
+    auto feesReports = std::vector<OrderExecutionService::ExecutionReport>();
+    feesReports.reserve(executionReports.size());
+    for(auto& executionReport : executionReports) {
+      auto i = orderIndexes.find(executionReport.m_id);
+      if(i == orderIndexes.end()) {
+        BOOST_THROW_EXCEPTION(std::runtime_error("Order not found."));
+      }
+      feesReports.push_back(CalculateFee(feeTable, orders[i->second].m_fields,
+        destinationMarkets[i->second], executionReport));
+    }
+    return feesReports;
+  }
 }
 
 #endif
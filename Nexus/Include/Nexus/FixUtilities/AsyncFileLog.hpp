@@ -0,0 +1,152 @@
+#ifndef NEXUS_ASYNC_FILE_LOG_HPP
+#define NEXUS_ASYNC_FILE_LOG_HPP
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <Beam/Utilities/ReportException.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <quickfix/Log.h>
+#include <quickfix/SessionID.h>
+#include <quickfix/SessionSettings.h>
+#include <quickfix/Utility.h>
+#include "Nexus/FixUtilities/AsyncFileStore.hpp"
+#include "Nexus/FixUtilities/FixJournal.hpp"
+#include "Nexus/FixUtilities/FixUtilities.hpp"
+
+namespace Nexus::FixUtilities {
+
+  /**
+   * A FIX Log that writes messages and events to FixJournals so that logging
+   * never blocks the session thread on disk writes. Journal failures are
+   * reported once and otherwise ignored so that they never end the session.
+   */
+  class AsyncFileLog : public FIX::Log {
+    public:
+
+      /**
+       * Constructs an AsyncFileLog.
+       * @param path The directory to write the log files to.
+       * @param prefix The prefix used to name the log files.
+       */
+      AsyncFileLog(const std::string& path, const std::string& prefix);
+
+      void clear() override;
+
+      void backup() override;
+
+      void onIncoming(const std::string& message) override;
+
+      void onOutgoing(const std::string& message) override;
+
+      void onEvent(const std::string& event) override;
+
+    private:
+      FixJournal m_messages;
+      FixJournal m_events;
+      std::atomic_bool m_isFailed;
+
+      template<typename F>
+      void Log(F&& f);
+      static std::string Format(const std::string& value);
+  };
+
+  /** Builds AsyncFileLogs using the FileLogPath session setting. */
+  class AsyncFileLogFactory : public FIX::LogFactory {
+    public:
+
+      /**
+       * Constructs an AsyncFileLogFactory.
+       * @param settings The settings used to find each session's log path.
+       */
+      explicit AsyncFileLogFactory(const FIX::SessionSettings& settings);
+
+      FIX::Log* create() override;
+
+      FIX::Log* create(const FIX::SessionID& sessionId) override;
+
+      void destroy(FIX::Log* log) override;
+
+    private:
+      FIX::SessionSettings m_settings;
+  };
+
+  inline AsyncFileLog::AsyncFileLog(const std::string& path,
+    const std::string& prefix)
+    : m_messages(FIX::file_appendpath(path, prefix + ".messages.current.log"),
+        false),
+      m_events(FIX::file_appendpath(path, prefix + ".event.current.log"),
+        false),
+      m_isFailed(false) {}
+
+  inline void AsyncFileLog::clear() {
+    Log([&] {
+      m_messages.Reset({});
+      m_events.Reset({});
+    });
+  }
+
+  inline void AsyncFileLog::backup() {
+    Log([&] {
+      m_messages.Backup();
+      m_events.Backup();
+    });
+  }
+
+  inline void AsyncFileLog::onIncoming(const std::string& message) {
+    Log([&] {
+      m_messages.Append(Format(message));
+    });
+  }
+
+  inline void AsyncFileLog::onOutgoing(const std::string& message) {
+    Log([&] {
+      m_messages.Append(Format(message));
+    });
+  }
+
+  inline void AsyncFileLog::onEvent(const std::string& event) {
+    Log([&] {
+      m_events.Append(Format(event));
+    });
+  }
+
+  template<typename F>
+  void AsyncFileLog::Log(F&& f) {
+    try {
+      f();
+    } catch(const std::exception&) {
+      if(!m_isFailed.exchange(true)) {
+        std::cout << BEAM_REPORT_CURRENT_EXCEPTION() << std::flush;
+      }
+    }
+  }
+
+  inline std::string AsyncFileLog::Format(const std::string& value) {
+    return boost::posix_time::to_iso_string(
+      boost::posix_time::microsec_clock::universal_time()) + " : " + value +
+      "\n";
+  }
+
+  inline AsyncFileLogFactory::AsyncFileLogFactory(
+    const FIX::SessionSettings& settings)
+    : m_settings(settings) {}
+
+  inline FIX::Log* AsyncFileLogFactory::create() {
+    auto path = m_settings.get().getString(FIX::FILE_LOG_PATH);
+    FIX::file_mkdir(path.c_str());
+    return new AsyncFileLog(path, "GLOBAL");
+  }
+
+  inline FIX::Log* AsyncFileLogFactory::create(
+      const FIX::SessionID& sessionId) {
+    auto path = m_settings.get(sessionId).getString(FIX::FILE_LOG_PATH);
+    FIX::file_mkdir(path.c_str());
+    return new AsyncFileLog(path, GetFileSessionPrefix(sessionId));
+  }
+
+  inline void AsyncFileLogFactory::destroy(FIX::Log* log) {
+    delete log;
+  }
+}
+
+#endif
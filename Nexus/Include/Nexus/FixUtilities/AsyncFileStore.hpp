@@ -0,0 +1,346 @@
+#ifndef NEXUS_ASYNC_FILE_STORE_HPP
+#define NEXUS_ASYNC_FILE_STORE_HPP
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <quickfix/FieldConvertors.h>
+#include <quickfix/MessageStore.h>
+#include <quickfix/SessionID.h>
+#include <quickfix/SessionSettings.h>
+#include <quickfix/Utility.h>
+#include "Nexus/FixUtilities/FixConversions.hpp"
+#include "Nexus/FixUtilities/FixJournal.hpp"
+#include "Nexus/FixUtilities/FixUtilities.hpp"
+
+namespace Nexus::FixUtilities {
+
+  /**
+   * A FIX MessageStore that serves all reads from memory and persists writes
+   * to a FixJournal. The journal is replayed on construction and refresh to
+   * recover messages and sequence numbers. Messages and sequence numbers are
+   * both committed in the background, a sender sequence number lost in a
+   * crash is recovered from the highest message journaled. Only the most
+   * recent messages are kept, older messages are gap filled on resend.
+   */
+  class AsyncFileStore : public FIX::MessageStore {
+    public:
+
+      /** The default number of messages kept for resend requests. */
+      static constexpr auto DEFAULT_MESSAGE_LIMIT = std::size_t(100000);
+
+      /**
+       * Constructs an AsyncFileStore.
+       * @param path The path to the journal file.
+       * @param now The creation time to use if no journal exists.
+       */
+      AsyncFileStore(std::string path, const FIX::UtcTimeStamp& now);
+
+      /**
+       * Constructs an AsyncFileStore, importing the state of a quickfix
+       * FileStore if no journal exists yet.
+       * @param path The path to the journal file.
+       * @param now The creation time to use if no journal or FileStore
+       *        exists.
+       * @param fileStorePrefix The path and prefix of the FileStore's files.
+       * @param messageLimit The number of messages kept for resend requests.
+       */
+      AsyncFileStore(std::string path, const FIX::UtcTimeStamp& now,
+        const std::string& fileStorePrefix,
+        std::size_t messageLimit = DEFAULT_MESSAGE_LIMIT);
+
+      bool set(FIX::SEQNUM sequence, const std::string& message) override;
+
+      void get(FIX::SEQNUM begin, FIX::SEQNUM end,
+        std::vector<std::string>& messages) const override;
+
+      FIX::SEQNUM getNextSenderMsgSeqNum() const override;
+
+      FIX::SEQNUM getNextTargetMsgSeqNum() const override;
+
+      void setNextSenderMsgSeqNum(FIX::SEQNUM sequence) override;
+
+      void setNextTargetMsgSeqNum(FIX::SEQNUM sequence) override;
+
+      void incrNextSenderMsgSeqNum() override;
+
+      void incrNextTargetMsgSeqNum() override;
+
+      FIX::UtcTimeStamp getCreationTime() const override;
+
+      void reset(const FIX::UtcTimeStamp& now) override;
+
+      void refresh() override;
+
+    private:
+      FixJournal m_journal;
+      std::size_t m_messageLimit;
+      std::map<FIX::SEQNUM, std::string> m_messages;
+      FIX::SEQNUM m_nextSenderMsgSeqNum;
+      FIX::SEQNUM m_nextTargetMsgSeqNum;
+      boost::posix_time::ptime m_creationTime;
+
+      bool Load();
+      bool ReadJournal();
+      bool Trim();
+      void Import(const std::string& fileStorePrefix);
+      std::string MakeSnapshot() const;
+  };
+
+  /** Builds AsyncFileStores using the FileStorePath session setting. */
+  class AsyncFileStoreFactory : public FIX::MessageStoreFactory {
+    public:
+
+      /**
+       * Constructs an AsyncFileStoreFactory.
+       * @param settings The settings used to find each session's store path.
+       */
+      explicit AsyncFileStoreFactory(const FIX::SessionSettings& settings);
+
+      FIX::MessageStore* create(const FIX::UtcTimeStamp& now,
+        const FIX::SessionID& sessionId) override;
+
+      void destroy(FIX::MessageStore* store) override;
+
+    private:
+      FIX::SessionSettings m_settings;
+  };
+
+  /**
+   * Returns the prefix used to name the files belonging to a FIX session.
+   * @param sessionId The id of the session.
+   */
+  inline std::string GetFileSessionPrefix(const FIX::SessionID& sessionId) {
+    auto prefix = sessionId.getBeginString().getValue() + "-" +
+      sessionId.getSenderCompID().getValue() + "-" +
+      sessionId.getTargetCompID().getValue();
+    if(!sessionId.getSessionQualifier().empty()) {
+      prefix += "-" + sessionId.getSessionQualifier();
+    }
+    return prefix;
+  }
+
+  inline AsyncFileStore::AsyncFileStore(std::string path,
+    const FIX::UtcTimeStamp& now)
+    : AsyncFileStore(std::move(path), now, {}) {}
+
+  inline AsyncFileStore::AsyncFileStore(std::string path,
+      const FIX::UtcTimeStamp& now, const std::string& fileStorePrefix,
+      std::size_t messageLimit)
+      : m_journal(std::move(path), true),
+        m_messageLimit(std::max<std::size_t>(messageLimit, 1)),
+        m_nextSenderMsgSeqNum(1),
+        m_nextTargetMsgSeqNum(1),
+        m_creationTime(GetTimestamp(now)) {
+    auto isNew = std::ifstream(m_journal.GetPath()).peek() ==
+      std::ifstream::traits_type::eof();
+    if(!Load()) {
+      if(isNew && !fileStorePrefix.empty()) {
+        Import(fileStorePrefix);
+        Trim();
+      }
+      m_journal.Reset(MakeSnapshot());
+    } else if(Trim()) {
+      m_journal.Reset(MakeSnapshot());
+    }
+  }
+
+  inline bool AsyncFileStore::set(FIX::SEQNUM sequence,
+      const std::string& message) {
+    m_messages[sequence] = message;
+    Trim();
+    m_journal.Append("M " + std::to_string(sequence) + " " +
+      std::to_string(message.size()) + "\n" + message + "\n");
+    return true;
+  }
+
+  inline void AsyncFileStore::get(FIX::SEQNUM begin, FIX::SEQNUM end,
+      std::vector<std::string>& messages) const {
+    messages.clear();
+    for(auto i = m_messages.lower_bound(begin);
+        i != m_messages.end() && i->first <= end; ++i) {
+      messages.push_back(i->second);
+    }
+  }
+
+  inline FIX::SEQNUM AsyncFileStore::getNextSenderMsgSeqNum() const {
+    return m_nextSenderMsgSeqNum;
+  }
+
+  inline FIX::SEQNUM AsyncFileStore::getNextTargetMsgSeqNum() const {
+    return m_nextTargetMsgSeqNum;
+  }
+
+  inline void AsyncFileStore::setNextSenderMsgSeqNum(FIX::SEQNUM sequence) {
+    m_nextSenderMsgSeqNum = sequence;
+    m_journal.Append("S " + std::to_string(sequence) + "\n");
+  }
+
+  inline void AsyncFileStore::setNextTargetMsgSeqNum(FIX::SEQNUM sequence) {
+    m_nextTargetMsgSeqNum = sequence;
+    m_journal.Append("T " + std::to_string(sequence) + "\n");
+  }
+
+  inline void AsyncFileStore::incrNextSenderMsgSeqNum() {
+    setNextSenderMsgSeqNum(m_nextSenderMsgSeqNum + 1);
+  }
+
+  inline void AsyncFileStore::incrNextTargetMsgSeqNum() {
+    setNextTargetMsgSeqNum(m_nextTargetMsgSeqNum + 1);
+  }
+
+  inline FIX::UtcTimeStamp AsyncFileStore::getCreationTime() const {
+    return GetUtcTimestamp(m_creationTime);
+  }
+
+  inline void AsyncFileStore::reset(const FIX::UtcTimeStamp& now) {
+    m_messages.clear();
+    m_nextSenderMsgSeqNum = 1;
+    m_nextTargetMsgSeqNum = 1;
+    m_creationTime = GetTimestamp(now);
+    m_journal.Reset(MakeSnapshot());
+  }
+
+  inline void AsyncFileStore::refresh() {
+    m_journal.Flush();
+    m_messages.clear();
+    m_nextSenderMsgSeqNum = 1;
+    m_nextTargetMsgSeqNum = 1;
+    if(!Load() || Trim()) {
+      m_journal.Reset(MakeSnapshot());
+    }
+  }
+
+  inline bool AsyncFileStore::Load() {
+    auto isLoaded = ReadJournal();
+    if(!m_messages.empty()) {
+      m_nextSenderMsgSeqNum = std::max(m_nextSenderMsgSeqNum,
+        m_messages.rbegin()->first + 1);
+    }
+    return isLoaded;
+  }
+
+  inline bool AsyncFileStore::ReadJournal() {
+    auto source = std::ifstream(m_journal.GetPath(), std::ios::binary);
+    auto header = std::string();
+    auto recordCount = 0;
+    while(std::getline(source, header)) {
+      if(source.eof()) {
+        return false;
+      }
+      auto stream = std::istringstream(header);
+      auto type = char();
+      stream >> type;
+      if(type == 'C') {
+        auto timestamp = std::string();
+        if(!(stream >> timestamp)) {
+          return false;
+        }
+        m_creationTime = boost::posix_time::from_iso_string(timestamp);
+      } else if(type == 'S' || type == 'T') {
+        auto sequence = FIX::SEQNUM();
+        if(!(stream >> sequence)) {
+          return false;
+        }
+        if(type == 'S') {
+          m_nextSenderMsgSeqNum = sequence;
+        } else {
+          m_nextTargetMsgSeqNum = sequence;
+        }
+      } else if(type == 'M') {
+        auto sequence = FIX::SEQNUM();
+        auto size = std::size_t();
+        if(!(stream >> sequence >> size)) {
+          return false;
+        }
+        auto message = std::string(size, '\0');
+        if(!source.read(message.data(), size) || source.get() != '\n') {
+          return false;
+        }
+        m_messages[sequence] = std::move(message);
+      } else {
+        return false;
+      }
+      ++recordCount;
+    }
+    return recordCount != 0 && source.eof();
+  }
+
+  inline bool AsyncFileStore::Trim() {
+    if(m_messages.size() <= m_messageLimit) {
+      return false;
+    }
+    auto end = std::next(m_messages.begin(),
+      m_messages.size() - m_messageLimit);
+    m_messages.erase(m_messages.begin(), end);
+    return true;
+  }
+
+  inline void AsyncFileStore::Import(const std::string& fileStorePrefix) {
+    auto seqNums = std::ifstream(fileStorePrefix + ".seqnums");
+    auto sender = FIX::SEQNUM();
+    auto target = FIX::SEQNUM();
+    auto separator = char();
+    if(!(seqNums >> sender >> separator >> target) || separator != ':') {
+      return;
+    }
+    m_nextSenderMsgSeqNum = sender;
+    m_nextTargetMsgSeqNum = target;
+    auto session = std::ifstream(fileStorePrefix + ".session");
+    auto creationTime = std::string();
+    if(std::getline(session, creationTime) && !creationTime.empty()) {
+      try {
+        m_creationTime = GetTimestamp(
+          FIX::UtcTimeStampConvertor::convert(creationTime));
+      } catch(const FIX::FieldConvertError&) {}
+    }
+    auto header = std::ifstream(fileStorePrefix + ".header");
+    auto body = std::ifstream(fileStorePrefix + ".body", std::ios::binary);
+    auto sequence = FIX::SEQNUM();
+    auto offset = std::streamoff();
+    auto size = std::size_t();
+    auto offsetSeparator = char();
+    auto sizeSeparator = char();
+    while(header >> sequence >> offsetSeparator >> offset >> sizeSeparator >>
+        size) {
+      auto message = std::string(size, '\0');
+      if(!body.seekg(offset) || !body.read(message.data(), size)) {
+        break;
+      }
+      m_messages[sequence] = std::move(message);
+    }
+  }
+
+  inline std::string AsyncFileStore::MakeSnapshot() const {
+    auto snapshot = "C " + boost::posix_time::to_iso_string(m_creationTime) +
+      "\nS " + std::to_string(m_nextSenderMsgSeqNum) + "\nT " +
+      std::to_string(m_nextTargetMsgSeqNum) + "\n";
+    for(auto& message : m_messages) {
+      snapshot += "M " + std::to_string(message.first) + " " +
+        std::to_string(message.second.size()) + "\n" + message.second + "\n";
+    }
+    return snapshot;
+  }
+
+  inline AsyncFileStoreFactory::AsyncFileStoreFactory(
+    const FIX::SessionSettings& settings)
+    : m_settings(settings) {}
+
+  inline FIX::MessageStore* AsyncFileStoreFactory::create(
+      const FIX::UtcTimeStamp& now, const FIX::SessionID& sessionId) {
+    auto path = m_settings.get(sessionId).getString(FIX::FILE_STORE_PATH);
+    FIX::file_mkdir(path.c_str());
+    auto prefix = FIX::file_appendpath(path, GetFileSessionPrefix(sessionId));
+    return new AsyncFileStore(prefix + ".journal", now, prefix);
+  }
+
+  inline void AsyncFileStoreFactory::destroy(FIX::MessageStore* store) {
+    delete store;
+  }
+}
+
+#endif
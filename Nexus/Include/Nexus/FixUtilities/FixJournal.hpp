@@ -0,0 +1,240 @@
+#ifndef NEXUS_FIX_JOURNAL_HPP
+#define NEXUS_FIX_JOURNAL_HPP
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/throw_exception.hpp>
+#ifdef _WIN32
+  #include <io.h>
+#else
+  #include <unistd.h>
+#endif
+#include "Nexus/FixUtilities/FixUtilities.hpp"
+
+namespace Nexus::FixUtilities {
+
+  /**
+   * An append-only file whose writes are batched together and committed by a
+   * background thread, keeping disk latency off of the calling thread. Once a
+   * commit fails the journal is broken and every subsequent operation throws
+   * the failure.
+   */
+  class FixJournal : private boost::noncopyable {
+    public:
+
+      /**
+       * Constructs a FixJournal.
+       * @param path The path to the file to append to.
+       * @param isSynchronized Whether each commit is synchronized to disk
+       *        rather than only flushed to the operating system.
+       */
+      FixJournal(std::string path, bool isSynchronized);
+
+      ~FixJournal();
+
+      /** Returns the path to the file. */
+      const std::string& GetPath() const;
+
+      /**
+       * Appends data to the journal, returning before it is committed.
+       * @param data The data to append.
+       */
+      void Append(const std::string& data);
+
+      /** Blocks until all data appended so far is committed. */
+      void Flush();
+
+      /**
+       * Replaces the contents of the journal.
+       * @param data The data to replace the contents with.
+       */
+      void Reset(const std::string& data);
+
+      /**
+       * Moves the contents of the journal to the first unused path of the
+       * form <i>path.n</i> and starts a new empty journal.
+       */
+      void Backup();
+
+      void Close();
+
+    private:
+      std::string m_path;
+      bool m_isSynchronized;
+      std::FILE* m_file;
+      mutable boost::mutex m_mutex;
+      boost::condition_variable m_pendingCondition;
+      boost::condition_variable m_commitCondition;
+      std::string m_pending;
+      std::uint64_t m_appendCount;
+      std::uint64_t m_commitCount;
+      std::exception_ptr m_error;
+      bool m_isOpen;
+      boost::thread m_commitThread;
+
+      void Open(const char* mode);
+      void Write(const std::string& data);
+      void WaitForCommit(boost::unique_lock<boost::mutex>& lock);
+      void CommitLoop();
+  };
+
+  inline FixJournal::FixJournal(std::string path, bool isSynchronized)
+      : m_path(std::move(path)),
+        m_isSynchronized(isSynchronized),
+        m_file(nullptr),
+        m_appendCount(0),
+        m_commitCount(0),
+        m_isOpen(true) {
+    Open("ab");
+    m_commitThread = boost::thread(&FixJournal::CommitLoop, this);
+  }
+
+  inline FixJournal::~FixJournal() {
+    Close();
+  }
+
+  inline const std::string& FixJournal::GetPath() const {
+    return m_path;
+  }
+
+  inline void FixJournal::Append(const std::string& data) {
+    auto lock = boost::lock_guard(m_mutex);
+    if(m_error) {
+      std::rethrow_exception(m_error);
+    }
+    m_pending += data;
+    ++m_appendCount;
+    m_pendingCondition.notify_one();
+  }
+
+  inline void FixJournal::Flush() {
+    auto lock = boost::unique_lock(m_mutex);
+    WaitForCommit(lock);
+  }
+
+  inline void FixJournal::Reset(const std::string& data) {
+    auto lock = boost::unique_lock(m_mutex);
+    WaitForCommit(lock);
+    try {
+      std::fclose(m_file);
+      m_file = nullptr;
+      Open("wb");
+      Write(data);
+    } catch(const std::exception&) {
+      m_error = std::current_exception();
+      throw;
+    }
+  }
+
+  inline void FixJournal::Backup() {
+    auto lock = boost::unique_lock(m_mutex);
+    WaitForCommit(lock);
+    try {
+      std::fclose(m_file);
+      m_file = nullptr;
+      for(auto i = 1;; ++i) {
+        auto backupPath = m_path + "." + std::to_string(i);
+        if(auto file = std::fopen(backupPath.c_str(), "rb")) {
+          std::fclose(file);
+          continue;
+        }
+        std::rename(m_path.c_str(), backupPath.c_str());
+        break;
+      }
+      Open("ab");
+    } catch(const std::exception&) {
+      m_error = std::current_exception();
+      throw;
+    }
+  }
+
+  inline void FixJournal::Close() {
+    {
+      auto lock = boost::lock_guard(m_mutex);
+      if(!m_isOpen) {
+        return;
+      }
+      m_isOpen = false;
+      m_pendingCondition.notify_one();
+    }
+    m_commitThread.join();
+    if(m_file) {
+      std::fclose(m_file);
+      m_file = nullptr;
+    }
+  }
+
+  inline void FixJournal::Open(const char* mode) {
+    m_file = std::fopen(m_path.c_str(), mode);
+    if(m_file == nullptr) {
+      BOOST_THROW_EXCEPTION(std::runtime_error(
+        "Unable to open journal: " + m_path));
+    }
+  }
+
+  inline void FixJournal::Write(const std::string& data) {
+    if(!m_file || std::fwrite(data.data(), 1, data.size(), m_file) !=
+        data.size() || std::fflush(m_file) != 0) {
+      BOOST_THROW_EXCEPTION(std::runtime_error(
+        "Unable to write journal: " + m_path));
+    }
+    if(m_isSynchronized) {
+#ifdef _WIN32
+      auto result = _commit(_fileno(m_file));
+#else
+      auto result = fsync(fileno(m_file));
+#endif
+      if(result != 0) {
+        BOOST_THROW_EXCEPTION(std::runtime_error(
+          "Unable to synchronize journal: " + m_path));
+      }
+    }
+  }
+
+  inline void FixJournal::WaitForCommit(
+      boost::unique_lock<boost::mutex>& lock) {
+    while(m_commitCount != m_appendCount) {
+      m_commitCondition.wait(lock);
+    }
+    if(m_error) {
+      std::rethrow_exception(m_error);
+    }
+  }
+
+  inline void FixJournal::CommitLoop() {
+    auto lock = boost::unique_lock(m_mutex);
+    while(true) {
+      while(m_pending.empty() && m_isOpen) {
+        m_pendingCondition.wait(lock);
+      }
+      if(m_pending.empty()) {
+        return;
+      }
+      auto batch = std::string();
+      batch.swap(m_pending);
+      auto appendCount = m_appendCount;
+      lock.unlock();
+      auto error = std::exception_ptr();
+      try {
+        Write(batch);
+      } catch(const std::exception&) {
+        error = std::current_exception();
+      }
+      lock.lock();
+      if(error && !m_error) {
+        m_error = error;
+      }
+      m_commitCount = appendCount;
+      m_commitCondition.notify_all();
+    }
+  }
+}
+
+#endif
@@ -9,11 +9,11 @@
 #include <Beam/Threading/Sync.hpp>
 #include <boost/noncopyable.hpp>
 #include <quickfix/Application.h>
-#include <quickfix/FileStore.h>
-#include <quickfix/FileLog.h>
 #include <quickfix/Session.h>
 #include <quickfix/SessionSettings.h>
 #include <quickfix/SocketInitiator.h>
+#include "Nexus/FixUtilities/AsyncFileLog.hpp"
+#include "Nexus/FixUtilities/AsyncFileStore.hpp"
 #include "Nexus/FixUtilities/FixApplication.hpp"
 #include "Nexus/OrderExecutionService/AccountQuery.hpp"
 #include "Nexus/OrderExecutionService/OrderExecutionService.hpp"
@@ -74,8 +74,8 @@ namespace Nexus::FixUtilities {
         std::string m_configPath;
         bool m_isConnected;
         std::optional<FIX::SessionSettings> m_settings;
-        std::optional<FIX::FileStoreFactory> m_storeFactory;
-        std::optional<FIX::FileLogFactory> m_logFactory;
+        std::optional<AsyncFileStoreFactory> m_storeFactory;
+        std::optional<AsyncFileLogFactory> m_logFactory;
         std::optional<FIX::SocketInitiator> m_initiator;
 
         Application(std::shared_ptr<FixApplication> application,
@@ -2,8 +2,13 @@
 #define NEXUS_FIX_UTILITIES_HPP
 
 namespace Nexus::FixUtilities {
+  class AsyncFileLog;
+  class AsyncFileLogFactory;
+  class AsyncFileStore;
+  class AsyncFileStoreFactory;
   class FixApplication;
   struct FixApplicationEntry;
+  class FixJournal;
   class FixOrder;
   class FixOrderLog;
   class FixOrderRejectedException;
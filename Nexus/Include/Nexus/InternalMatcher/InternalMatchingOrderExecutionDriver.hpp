@@ -1,5 +1,11 @@
 #ifndef NEXUS_INTERNAL_MATCHING_ORDER_EXECUTION_DRIVER_HPP
 #define NEXUS_INTERNAL_MATCHING_ORDER_EXECUTION_DRIVER_HPP
+#include <algorithm>
+#include <list>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 #include <Beam/Collections/SynchronizedMap.hpp>
 #include <Beam/Collections/SynchronizedSet.hpp>
 #include <Beam/IO/OpenState.hpp>
@@ -13,6 +19,8 @@
 #include <Beam/Utilities/Algorithm.hpp>
 #include <boost/atomic/atomic.hpp>
 #include <boost/noncopyable.hpp>
+#include <boost/optional/optional.hpp>
+#include <boost/thread/thread.hpp>
 #include "Nexus/Definitions/BboQuote.hpp"
 #include "Nexus/Definitions/OrderStatus.hpp"
 #include "Nexus/InternalMatcher/InternalMatcher.hpp"
@@ -33,6 +41,17 @@ namespace Details {
     }
     return std::numeric_limits<Money>::max();
   }
+
+  /** Orders price levels from the best offer to the worst. */
+  struct PriceLevelComparator {
+
+    /** The Side of the offers being ordered. */
+    Side m_side;
+
+    bool operator ()(Money lhs, Money rhs) const {
+      return OfferComparator(m_side, lhs, rhs) < 0;
+    }
+  };
 }
 
   /**
@@ -104,6 +123,10 @@ namespace Details {
       void Close();
 
     private:
+      struct OrderEntry;
+      using PriceLevel = std::list<std::shared_ptr<OrderEntry>>;
+      using PriceLevels =
+        std::map<Money, PriceLevel, Details::PriceLevelComparator>;
       struct OrderEntry {
         OrderExecutionService::OrderInfo m_orderInfo;
         const OrderExecutionService::Order* m_driverOrder;
@@ -115,17 +138,23 @@ namespace Details {
         Beam::Threading::Sync<bool> m_isTerminal;
         Beam::Threading::TimedConditionVariable m_isLiveCondition;
         Beam::Threading::TimedConditionVariable m_isTerminalCondition;
+        boost::optional<typename PriceLevel::iterator> m_position;
 
         OrderEntry(const OrderExecutionService::OrderInfo& orderInfo,
           Beam::Ref<Beam::Threading::TimerThreadPool> timerThreadPool);
       };
       struct SecurityEntry {
-        std::vector<std::shared_ptr<OrderEntry>> m_asks;
-        std::vector<std::shared_ptr<OrderEntry>> m_bids;
+        PriceLevels m_asks;
+        PriceLevels m_bids;
         std::shared_ptr<Beam::StateQueue<BboQuote>> m_bboQuote;
 
         SecurityEntry();
       };
+      struct Shard {
+        std::unordered_map<Security, std::shared_ptr<SecurityEntry>>
+          m_securityEntries;
+        Beam::RoutineTaskQueue m_tasks;
+      };
       Beam::GetOptionalLocalPtr<B> m_matchReportBuilder;
       Beam::GetOptionalLocalPtr<M> m_marketDataClient;
       Beam::GetOptionalLocalPtr<T> m_timeClient;
@@ -135,15 +164,18 @@ namespace Details {
       OrderExecutionService::OrderExecutionSession m_rootSession;
       Beam::SynchronizedUnorderedMap<OrderExecutionService::OrderId,
         OrderExecutionService::OrderId> m_orderIds;
+      Beam::SynchronizedUnorderedMap<OrderExecutionService::OrderId, Shard*>
+        m_orderShards;
       Beam::SynchronizedUnorderedSet<
         std::shared_ptr<OrderExecutionService::Order>> m_orders;
-      std::unordered_map<Security, std::shared_ptr<SecurityEntry>>
-        m_securityEntries;
+      std::vector<std::unique_ptr<Shard>> m_shards;
       Beam::IO::OpenState m_openState;
-      Beam::RoutineTaskQueue m_submissionTasks;
       Beam::RoutineTaskQueue m_executionReportTasks;
 
-      void Submit(const std::shared_ptr<OrderEntry>& orderEntry);
+      Shard& GetShard(const Security& security);
+      Shard& GetShard(OrderExecutionService::OrderId orderId);
+      void Submit(Shard& shard, const std::shared_ptr<OrderEntry>& orderEntry);
+      void Remove(Shard& shard, const std::shared_ptr<OrderEntry>& orderEntry);
       void SubmitToDriver(
         const Beam::ServiceLocator::DirectoryEntry submissionAccount,
         const OrderExecutionService::OrderFields& fields,
@@ -179,7 +211,9 @@ namespace Details {
   template<typename B, typename M, typename T, typename U, typename D>
   InternalMatchingOrderExecutionDriver<B, M, T, U, D>::
     SecurityEntry::SecurityEntry()
-    : m_bboQuote(std::make_shared<Beam::StateQueue<BboQuote>>()) {}
+    : m_asks(Details::PriceLevelComparator{Side::ASK}),
+      m_bids(Details::PriceLevelComparator{Side::BID}),
+      m_bboQuote(std::make_shared<Beam::StateQueue<BboQuote>>()) {}
 
   template<typename B, typename M, typename T, typename U, typename D>
   template<typename BF, typename MF, typename TF, typename UF, typename DF>
@@ -196,6 +230,11 @@ namespace Details {
         m_orderExecutionDriver(std::forward<DF>(orderExecutionDriver)),
         m_timerThreadPool(timerThreadPool.Get()) {
     m_rootSession.SetAccount(rootSessionAccount);
+    auto shardCount =
+      std::max<std::size_t>(1, boost::thread::hardware_concurrency());
+    for(auto i = std::size_t(0); i != shardCount; ++i) {
+      m_shards.push_back(std::make_unique<Shard>());
+    }
   }
 
   template<typename B, typename M, typename T, typename U, typename D>
@@ -230,8 +269,10 @@ namespace Details {
     }
     auto orderEntry = std::make_shared<OrderEntry>(orderInfo,
       Beam::Ref(*m_timerThreadPool));
-    m_submissionTasks.Push([=] {
-      Submit(orderEntry);
+    auto& shard = GetShard(fields.m_security);
+    m_orderShards.Insert(orderInfo.m_orderId, &shard);
+    shard.m_tasks.Push([=, &shard] {
+      Submit(shard, orderEntry);
     });
     m_orders.Insert(orderEntry->m_order);
     return *orderEntry->m_order;
@@ -241,7 +282,7 @@ namespace Details {
   void InternalMatchingOrderExecutionDriver<B, M, T, U, D>::Cancel(
       const OrderExecutionService::OrderExecutionSession& session,
       OrderExecutionService::OrderId orderId) {
-    m_submissionTasks.Push([=] {
+    GetShard(orderId).m_tasks.Push([=] {
       if(auto driverOrderId = m_orderIds.FindValue(orderId)) {
         m_orderExecutionDriver->Cancel(session, *driverOrderId);
       } else {
@@ -255,7 +296,7 @@ namespace Details {
       const OrderExecutionService::OrderExecutionSession& session,
       OrderExecutionService::OrderId orderId,
       const OrderExecutionService::ExecutionReport& executionReport) {
-    m_submissionTasks.Push([=] {
+    GetShard(orderId).m_tasks.Push([=] {
       auto driverOrderId = m_orderIds.FindValue(orderId);
       if(driverOrderId) {
         auto sanitizedExecutionReport = executionReport;
@@ -274,17 +315,36 @@ namespace Details {
       return;
     }
     m_executionReportTasks.Break();
-    m_submissionTasks.Break();
+    for(auto& shard : m_shards) {
+      shard->m_tasks.Break();
+    }
     m_orderExecutionDriver->Close();
     m_openState.Close();
   }
 
+  template<typename B, typename M, typename T, typename U, typename D>
+  typename InternalMatchingOrderExecutionDriver<B, M, T, U, D>::Shard&
+      InternalMatchingOrderExecutionDriver<B, M, T, U, D>::GetShard(
+      const Security& security) {
+    return *m_shards[std::hash<Security>()(security) % m_shards.size()];
+  }
+
+  template<typename B, typename M, typename T, typename U, typename D>
+  typename InternalMatchingOrderExecutionDriver<B, M, T, U, D>::Shard&
+      InternalMatchingOrderExecutionDriver<B, M, T, U, D>::GetShard(
+      OrderExecutionService::OrderId orderId) {
+    if(auto shard = m_orderShards.FindValue(orderId)) {
+      return **shard;
+    }
+    return *m_shards[orderId % m_shards.size()];
+  }
+
   template<typename B, typename M, typename T, typename U, typename D>
   void InternalMatchingOrderExecutionDriver<B, M, T, U, D>::Submit(
-      const std::shared_ptr<OrderEntry>& orderEntry) {
+      Shard& shard, const std::shared_ptr<OrderEntry>& orderEntry) {
     auto& fields = orderEntry->m_order->GetInfo().m_fields;
-    auto securityEntry = Beam::GetOrInsert(m_securityEntries, fields.m_security,
-      [&] {
+    auto securityEntry = Beam::GetOrInsert(shard.m_securityEntries,
+      fields.m_security, [&] {
         auto securityEntry = std::make_shared<SecurityEntry>();
         MarketDataService::QueryRealTimeWithSnapshot(fields.m_security,
           *m_marketDataClient, securityEntry->m_bboQuote);
@@ -294,7 +354,15 @@ namespace Details {
       try {
         return securityEntry->m_bboQuote->Peek();
       } catch(const Beam::PipeBrokenException&) {
-        m_securityEntries.erase(fields.m_security);
+        for(auto& priceLevels :
+            {&securityEntry->m_asks, &securityEntry->m_bids}) {
+          for(auto& priceLevel : *priceLevels) {
+            for(auto& restingOrderEntry : priceLevel.second) {
+              restingOrderEntry->m_position = boost::none;
+            }
+          }
+        }
+        shard.m_securityEntries.erase(fields.m_security);
         return boost::none;
       }
     }();
@@ -305,9 +373,10 @@ namespace Details {
           m_timeClient->GetTime());
         orderEntry->m_order->Update(newReport);
       });
+      m_orderShards.Erase(orderEntry->m_orderInfo.m_orderId);
       return;
     }
-    auto [orderEntries, passiveOrderEntries, bboThresholdPrice] = [&] {
+    auto [priceLevels, passivePriceLevels, bboThresholdPrice] = [&] {
       if(fields.m_side == Side::ASK) {
         return std::tuple(&securityEntry->m_asks, &securityEntry->m_bids,
           bboQuote->m_bid.m_price);
@@ -318,17 +387,18 @@ namespace Details {
     auto internalMatchReports =
       std::vector<OrderExecutionService::ExecutionReport>();
     auto matchedQuantityRemaining = fields.m_quantity;
-    auto passiveOrderEntryIterator = passiveOrderEntries->begin();
-    while(passiveOrderEntryIterator != passiveOrderEntries->end() &&
-        matchedQuantityRemaining > 0) {
-      auto& passiveOrderEntry = *passiveOrderEntryIterator;
-      auto& orderEntryFields =
-        passiveOrderEntry->m_driverOrder->GetInfo().m_fields;
-      auto fieldsPrice = Details::GetOfferPrice(fields);
-      auto orderEntryPrice = Details::GetOfferPrice(orderEntryFields);
-      if(OfferComparator(fields.m_side, fieldsPrice, orderEntryPrice) <= 0 &&
-          OfferComparator(fields.m_side, orderEntryPrice,
-          bboThresholdPrice) >= 0) {
+    auto fieldsPrice = Details::GetOfferPrice(fields);
+    auto priceLevel = passivePriceLevels->begin();
+    while(priceLevel != passivePriceLevels->end() &&
+        matchedQuantityRemaining > 0 &&
+        OfferComparator(fields.m_side, fieldsPrice, priceLevel->first) <= 0 &&
+        OfferComparator(fields.m_side, priceLevel->first,
+        bboThresholdPrice) >= 0) {
+      auto& passiveOrderEntries = priceLevel->second;
+      auto passiveOrderEntryIterator = passiveOrderEntries.begin();
+      while(passiveOrderEntryIterator != passiveOrderEntries.end() &&
+          matchedQuantityRemaining > 0) {
+        auto passiveOrderEntry = *passiveOrderEntryIterator;
         auto passiveOrderRemaining = bool();
         auto matchReport = OrderExecutionService::ExecutionReport();
         try {
@@ -345,11 +415,15 @@ namespace Details {
         if(passiveOrderRemaining) {
           ++passiveOrderEntryIterator;
         } else {
-          passiveOrderEntryIterator = passiveOrderEntries->erase(
+          passiveOrderEntry->m_position = boost::none;
+          passiveOrderEntryIterator = passiveOrderEntries.erase(
             passiveOrderEntryIterator);
         }
+      }
+      if(passiveOrderEntries.empty()) {
+        priceLevel = passivePriceLevels->erase(priceLevel);
       } else {
-        ++passiveOrderEntryIterator;
+        ++priceLevel;
       }
     }
     if(!internalMatchReports.empty()) {
@@ -368,29 +442,12 @@ namespace Details {
         }
       });
     }
-    if(matchedQuantityRemaining != 0) {
-      auto insertIterator = std::lower_bound(orderEntries->begin(),
-        orderEntries->end(), orderEntry,
-        [&] (auto& lhs, auto& rhs) {
-          auto lhsPrice = Details::GetOfferPrice(
-            lhs->m_order->GetInfo().m_fields);
-          auto rhsPrice = Details::GetOfferPrice(
-            rhs->m_order->GetInfo().m_fields);
-          auto offerComparison = OfferComparator(
-            lhs->m_order->GetInfo().m_fields.m_side, lhsPrice, rhsPrice);
-          if(offerComparison < 0) {
-            return true;
-          } else if(offerComparison > 0) {
-            return false;
-          }
-          if(lhs->m_order->GetInfo().m_timestamp <
-              rhs->m_order->GetInfo().m_timestamp) {
-            return true;
-          }
-          return lhs->m_order->GetInfo().m_orderId <
-            rhs->m_order->GetInfo().m_orderId;
-        });
-      orderEntries->insert(insertIterator, orderEntry);
+    if(matchedQuantityRemaining == 0) {
+      m_orderShards.Erase(orderEntry->m_orderInfo.m_orderId);
+    } else {
+      auto& orderEntries = (*priceLevels)[fieldsPrice];
+      orderEntry->m_position = orderEntries.insert(orderEntries.end(),
+        orderEntry);
       auto matchedFields = fields;
       matchedFields.m_quantity = matchedQuantityRemaining;
       SubmitToDriver(orderEntry->m_orderInfo.m_submissionAccount, matchedFields,
@@ -398,6 +455,32 @@ namespace Details {
     }
   }
 
+  template<typename B, typename M, typename T, typename U, typename D>
+  void InternalMatchingOrderExecutionDriver<B, M, T, U, D>::Remove(
+      Shard& shard, const std::shared_ptr<OrderEntry>& orderEntry) {
+    if(!orderEntry->m_position) {
+      return;
+    }
+    auto& fields = orderEntry->m_orderInfo.m_fields;
+    auto securityEntry = shard.m_securityEntries.find(fields.m_security);
+    if(securityEntry == shard.m_securityEntries.end()) {
+      orderEntry->m_position = boost::none;
+      return;
+    }
+    auto& priceLevels = [&] () -> PriceLevels& {
+      if(fields.m_side == Side::ASK) {
+        return securityEntry->second->m_asks;
+      }
+      return securityEntry->second->m_bids;
+    }();
+    auto priceLevel = priceLevels.find(Details::GetOfferPrice(fields));
+    priceLevel->second.erase(*orderEntry->m_position);
+    orderEntry->m_position = boost::none;
+    if(priceLevel->second.empty()) {
+      priceLevels.erase(priceLevel);
+    }
+  }
+
   template<typename B, typename M, typename T, typename U, typename D>
   void InternalMatchingOrderExecutionDriver<B, M, T, U, D>::SubmitToDriver(
       const Beam::ServiceLocator::DirectoryEntry submissionAccount,
@@ -481,7 +564,9 @@ namespace Details {
       passiveMatchReport.m_sequence = executionReports.back().m_sequence + 1;
       passiveOrderEntry->m_order->Update(passiveMatchReport);
     });
-    if(passiveOrderEntry->m_remainingQuantity != 0) {
+    if(passiveOrderEntry->m_remainingQuantity == 0) {
+      m_orderShards.Erase(passiveOrderEntry->m_orderInfo.m_orderId);
+    } else {
       auto matchedFields = passiveOrderEntry->m_order->GetInfo().m_fields;
       matchedFields.m_quantity = passiveOrderEntry->m_remainingQuantity;
       SubmitToDriver(m_rootSession.GetAccount(), matchedFields,
@@ -574,6 +659,14 @@ namespace Details {
     if(IsTerminal(executionReport.m_status)) {
       orderEntry->m_remainingQuantity = 0;
       SetOrderToTerminal(*orderEntry);
+      auto& shard = GetShard(orderEntry->m_orderInfo.m_fields.m_security);
+      shard.m_tasks.Push([=, &shard] {
+        Remove(shard, orderEntry);
+
+        // Once terminal, requests for the order no longer need to be ordered
+        // with its book, so they can fall back to the default shard.
+        m_orderShards.Erase(orderEntry->m_orderInfo.m_orderId);
+      });
     }
   }
 }
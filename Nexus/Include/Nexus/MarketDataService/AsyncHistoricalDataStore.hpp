@@ -34,6 +34,12 @@ namespace Nexus::MarketDataService {
 
       std::vector<SecurityInfo> LoadAllSecurityInfo();
 
+      std::unordered_map<Security, SecurityEntry::InitialSequences>
+        LoadAllInitialSequences();
+
+      std::unordered_map<Security, std::unordered_map<std::string, Money>>
+        LoadAllLastPrices();
+
       std::vector<SequencedOrderImbalance> LoadOrderImbalances(
         const MarketWideDataQuery& query);
 
@@ -115,6 +121,18 @@ namespace Nexus::MarketDataService {
     return m_dataStore->LoadAllSecurityInfo();
   }
 
+  template<typename D>
+  std::unordered_map<Security, SecurityEntry::InitialSequences>
+      AsyncHistoricalDataStore<D>::LoadAllInitialSequences() {
+    return m_dataStore->LoadAllInitialSequences();
+  }
+
+  template<typename D>
+  std::unordered_map<Security, std::unordered_map<std::string, Money>>
+      AsyncHistoricalDataStore<D>::LoadAllLastPrices() {
+    return m_dataStore->LoadAllLastPrices();
+  }
+
   template<typename D>
   std::vector<SequencedOrderImbalance> AsyncHistoricalDataStore<D>::
       LoadOrderImbalances(const MarketWideDataQuery& query) {
@@ -34,6 +34,12 @@ namespace Nexus::MarketDataService {
 
       std::vector<SecurityInfo> LoadAllSecurityInfo();
 
+      std::unordered_map<Security, SecurityEntry::InitialSequences>
+        LoadAllInitialSequences();
+
+      std::unordered_map<Security, std::unordered_map<std::string, Money>>
+        LoadAllLastPrices();
+
       std::vector<SequencedOrderImbalance> LoadOrderImbalances(
         const MarketWideDataQuery& query);
 
@@ -106,6 +112,18 @@ namespace Nexus::MarketDataService {
     return {};
   }
 
+  template<typename C>
+  std::unordered_map<Security, SecurityEntry::InitialSequences>
+      ClientHistoricalDataStore<C>::LoadAllInitialSequences() {
+    return {};
+  }
+
+  template<typename C>
+  std::unordered_map<Security, std::unordered_map<std::string, Money>>
+      ClientHistoricalDataStore<C>::LoadAllLastPrices() {
+    return {};
+  }
+
   template<typename C>
   std::vector<SequencedOrderImbalance> ClientHistoricalDataStore<C>::
       LoadOrderImbalances(const MarketWideDataQuery& query) {
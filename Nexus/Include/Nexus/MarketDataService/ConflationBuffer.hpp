@@ -0,0 +1,656 @@
+#ifndef NEXUS_MARKET_DATA_CONFLATION_BUFFER_HPP
+#define NEXUS_MARKET_DATA_CONFLATION_BUFFER_HPP
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <Beam/Pointers/Out.hpp>
+#include <Beam/Services/RecordMessage.hpp>
+#include <Beam/Threading/Mutex.hpp>
+#include <Beam/Threading/Sync.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/optional/optional.hpp>
+#include "Nexus/MarketDataService/ConflationPolicy.hpp"
+#include "Nexus/MarketDataService/MarketDataRegistryServices.hpp"
+#include "Nexus/MarketDataService/MarketDataService.hpp"
+
+namespace Nexus::MarketDataService {
+
+  /**
+   * Buffers the real-time market data published to a single client. Each
+   * Security, and each market's OrderImbalances, is conflated independently
+   * and only once updates arrive faster than its policy's update interval.
+   * While backlogged only the latest value of each BboQuote, MarketQuote and
+   * book level is kept along with a bounded queue of TimeAndSales and
+   * OrderImbalances.
+   */
+  class ConflationBuffer : private boost::noncopyable {
+    public:
+
+      /** Stores the values taken from a ConflationBuffer by a flush. */
+      struct Batch {
+
+        /** The buffered OrderImbalances in the order they were published. */
+        std::deque<SequencedMarketOrderImbalance> m_orderImbalances;
+
+        /** The latest BboQuote of each Security. */
+        std::vector<SequencedSecurityBboQuote> m_bboQuotes;
+
+        /** The latest MarketQuote of each Security and market. */
+        std::vector<SequencedSecurityMarketQuote> m_marketQuotes;
+
+        /** The latest BookQuote of each book level. */
+        std::vector<SequencedSecurityBookQuote> m_bookQuotes;
+
+        /** The buffered TimeAndSales in the order they were published. */
+        std::deque<SequencedSecurityTimeAndSale> m_timeAndSales;
+
+        /** Returns <code>true</code> iff the batch contains no values. */
+        bool IsEmpty() const;
+
+        /**
+         * Calls a function with each value in the batch.
+         * @param f The function called with each value.
+         */
+        template<typename F>
+        void ForEach(F&& f) const;
+      };
+
+      /** Constructs a ConflationBuffer that doesn't conflate. */
+      ConflationBuffer();
+
+      /** Returns the policy used by subscriptions without their own. */
+      ConflationPolicy GetPolicy() const;
+
+      /**
+       * Returns the policy used to conflate a Security's market data.
+       * @param security The Security whose policy is returned.
+       */
+      ConflationPolicy GetPolicy(const Security& security) const;
+
+      /**
+       * Sets the policy used by subscriptions without their own, values
+       * buffered under the previous policy remain until the next flush.
+       * @param policy The policy to use.
+       */
+      void SetPolicy(const ConflationPolicy& policy);
+
+      /**
+       * Sets the policy used to conflate a Security's market data, overriding
+       * the default policy.
+       * @param security The Security whose policy is set.
+       * @param policy The policy to use.
+       */
+      void SetPolicy(const Security& security, const ConflationPolicy& policy);
+
+      /**
+       * Returns <code>true</code> iff any policy conflates market data, this
+       * can be tested without acquiring a lock.
+       */
+      bool IsEnabled() const;
+
+      /** Returns <code>true</code> iff any values are buffered. */
+      bool IsBacklogged() const;
+
+      /**
+       * Marks this buffer as scheduled to be flushed, the mark is cleared
+       * once a flush leaves no values buffered.
+       * @return <code>true</code> iff this buffer wasn't already scheduled.
+       */
+      bool Schedule();
+
+      /**
+       * Returns the number of TimeAndSales and OrderImbalances discarded due
+       * to the queue limit.
+       */
+      int GetDiscardCount() const;
+
+      /**
+       * Returns the mutex held while buffered values are sent to the client,
+       * closing the client acquires it so that no send outlives the client.
+       */
+      Beam::Threading::Mutex& GetSendMutex();
+
+      /**
+       * Buffers an OrderImbalance if its market is backlogged.
+       * @param orderImbalance The OrderImbalance to buffer.
+       * @param timestamp The current time.
+       * @return <code>false</code> iff the value must be sent immediately.
+       */
+      bool Push(const SequencedMarketOrderImbalance& orderImbalance,
+        boost::posix_time::ptime timestamp);
+
+      /**
+       * Buffers a BboQuote if its Security is backlogged, replacing any
+       * previously buffered BboQuote.
+       * @param bboQuote The BboQuote to buffer.
+       * @param timestamp The current time.
+       * @return <code>false</code> iff the value must be sent immediately.
+       */
+      bool Push(const SequencedSecurityBboQuote& bboQuote,
+        boost::posix_time::ptime timestamp);
+
+      /**
+       * Buffers a BookQuote if its Security is backlogged, replacing any
+       * previously buffered BookQuote for the same Side, price, market and
+       * MPID.
+       * @param bookQuote The BookQuote to buffer.
+       * @param timestamp The current time.
+       * @return <code>false</code> iff the value must be sent immediately.
+       */
+      bool Push(const SequencedSecurityBookQuote& bookQuote,
+        boost::posix_time::ptime timestamp);
+
+      /**
+       * Buffers a MarketQuote if its Security is backlogged, replacing any
+       * previously buffered MarketQuote for the same market.
+       * @param marketQuote The MarketQuote to buffer.
+       * @param timestamp The current time.
+       * @return <code>false</code> iff the value must be sent immediately.
+       */
+      bool Push(const SequencedSecurityMarketQuote& marketQuote,
+        boost::posix_time::ptime timestamp);
+
+      /**
+       * Buffers a TimeAndSale if its Security is backlogged.
+       * @param timeAndSale The TimeAndSale to buffer.
+       * @param timestamp The current time.
+       * @return <code>false</code> iff the value must be sent immediately.
+       */
+      bool Push(const SequencedSecurityTimeAndSale& timeAndSale,
+        boost::posix_time::ptime timestamp);
+
+      /**
+       * Flushes the values of every backlogged subscription whose update
+       * interval has elapsed.
+       * @param timestamp The current time.
+       * @param f The function called with each flushed value.
+       * @return <code>true</code> iff values remain buffered.
+       */
+      template<typename F>
+      bool Flush(boost::posix_time::ptime timestamp, F&& f);
+
+      /**
+       * Flushes all buffered values regardless of the update interval.
+       * @param f The function called with each buffered value.
+       */
+      template<typename F>
+      void Flush(F&& f);
+
+      /**
+       * Takes the values of every backlogged subscription whose update
+       * interval has elapsed, without calling into the client. This lets the
+       * values be sent after any locks held by the caller are released.
+       * @param timestamp The current time.
+       * @param batch Stores the values taken.
+       * @return <code>true</code> iff values remain buffered.
+       */
+      bool Take(boost::posix_time::ptime timestamp, Beam::Out<Batch> batch);
+
+    private:
+      using BookQuoteKey = std::tuple<Side, Money, MarketCode, std::string>;
+      struct Entry {
+        boost::posix_time::ptime m_lastSend;
+        bool m_isBacklogged = false;
+      };
+      struct SecurityEntry : Entry {
+        boost::optional<SequencedSecurityBboQuote> m_bboQuote;
+        std::map<MarketCode, SequencedSecurityMarketQuote> m_marketQuotes;
+        std::map<BookQuoteKey, SequencedSecurityBookQuote> m_bookQuotes;
+        std::deque<SequencedSecurityTimeAndSale> m_timeAndSales;
+      };
+      struct MarketEntry : Entry {
+        std::deque<SequencedMarketOrderImbalance> m_orderImbalances;
+      };
+      mutable Beam::Threading::Mutex m_mutex;
+      Beam::Threading::Mutex m_sendMutex;
+      std::atomic_bool m_isEnabled;
+      ConflationPolicy m_policy;
+      std::unordered_map<Security, ConflationPolicy> m_securityPolicies;
+      int m_discardCount;
+      bool m_isScheduled;
+      std::unordered_map<Security, SecurityEntry> m_securityEntries;
+      std::map<MarketCode, MarketEntry> m_marketEntries;
+      std::vector<Security> m_backloggedSecurities;
+      std::vector<MarketCode> m_backloggedMarkets;
+
+      const ConflationPolicy& FindPolicy(const Security& security) const;
+      void UpdateEnabled();
+      template<typename K, typename E, typename F>
+      bool Buffer(const K& key, E& entry, const ConflationPolicy& policy,
+        boost::posix_time::ptime timestamp, std::vector<K>& backlog,
+        F&& buffer);
+      template<typename T>
+      void Enqueue(std::deque<T>& queue, const T& value,
+        const ConflationPolicy& policy);
+      bool Take(boost::posix_time::ptime timestamp, bool isForced,
+        Batch& batch);
+      void Drain(SecurityEntry& entry, Batch& batch);
+      void Drain(MarketEntry& entry, Batch& batch);
+  };
+
+  /**
+   * Broadcasts a market data update to a list of clients, buffering it for
+   * every client whose subscription is backlogged.
+   * @param <M> The type of record message used to send the update.
+   * @param clients The clients to send the update to.
+   * @param value The update to send.
+   * @param backloggedClients The set of clients to flush, clients that buffer
+   *        the update are added to it.
+   */
+  template<typename M, typename Clients, typename T,
+    typename ServiceProtocolClient>
+  void BroadcastMarketDataMessage(const Clients& clients, const T& value,
+      Beam::Threading::Sync<std::unordered_set<ServiceProtocolClient*>>&
+      backloggedClients) {
+    auto isConflated = false;
+    for(auto& client : clients) {
+      if(client->GetSession().m_conflationBuffer.IsEnabled()) {
+        isConflated = true;
+        break;
+      }
+    }
+    if(!isConflated) {
+      Beam::Services::BroadcastRecordMessage<M>(clients, value);
+      return;
+    }
+    auto timestamp = boost::posix_time::microsec_clock::universal_time();
+    auto immediateClients =
+      std::vector<std::decay_t<decltype(*clients.begin())>>();
+    for(auto& client : clients) {
+      auto& buffer = client->GetSession().m_conflationBuffer;
+      if(!buffer.IsEnabled()) {
+        immediateClients.push_back(client);
+        continue;
+      }
+      if(!buffer.Push(value, timestamp)) {
+        immediateClients.push_back(client);
+      } else if(buffer.Schedule()) {
+        Beam::Threading::With(backloggedClients, [&] (auto& clients) {
+          clients.insert(&*client);
+        });
+      }
+    }
+    if(!immediateClients.empty()) {
+      Beam::Services::BroadcastRecordMessage<M>(immediateClients, value);
+    }
+  }
+
+  /**
+   * Sends a buffered market data update to a client.
+   * @param client The client to send the update to.
+   * @param value The update to send.
+   */
+  template<typename ServiceProtocolClient, typename T>
+  void SendConflatedMarketDataMessage(ServiceProtocolClient& client,
+      const T& value) {
+    using Value = typename T::Value::Value;
+    Beam::Services::SendRecordMessage<GetMarketDataMessageType<Value>>(client,
+      value);
+  }
+
+  /**
+   * Removes a closing client from the set of clients to flush, waiting for
+   * any flush in progress to finish sending to it.
+   * @param clients The set of clients to flush.
+   * @param client The client to remove.
+   */
+  template<typename ServiceProtocolClient>
+  void RemoveConflatedClient(Beam::Threading::Sync<
+      std::unordered_set<ServiceProtocolClient*>>& clients,
+      ServiceProtocolClient& client) {
+    Beam::Threading::With(clients, [&] (auto& clients) {
+      clients.erase(&client);
+    });
+    auto lock = std::lock_guard(
+      client.GetSession().m_conflationBuffer.GetSendMutex());
+  }
+
+  /**
+   * Sends the values of every backlogged subscription whose update interval
+   * has elapsed. Each client's send mutex is held from the time its values
+   * are taken until they are sent, but the set of clients is only locked
+   * while the values are taken.
+   * @param clients The set of clients to flush, clients left with no
+   *        buffered values are removed.
+   * @param timestamp The current time.
+   */
+  template<typename ServiceProtocolClient>
+  void FlushConflatedClients(Beam::Threading::Sync<
+      std::unordered_set<ServiceProtocolClient*>>& clients,
+      boost::posix_time::ptime timestamp) {
+    struct Flush {
+      ServiceProtocolClient* m_client;
+      ConflationBuffer::Batch m_batch;
+      std::unique_lock<Beam::Threading::Mutex> m_lock;
+    };
+    auto flushes = std::vector<Flush>();
+    Beam::Threading::With(clients, [&] (auto& clients) {
+      for(auto i = clients.begin(); i != clients.end();) {
+        auto client = *i;
+        auto& buffer = client->GetSession().m_conflationBuffer;
+        auto flush = Flush{client, {},
+          std::unique_lock(buffer.GetSendMutex())};
+        if(buffer.Take(timestamp, Beam::Store(flush.m_batch))) {
+          ++i;
+        } else {
+          i = clients.erase(i);
+        }
+        if(!flush.m_batch.IsEmpty()) {
+          flushes.push_back(std::move(flush));
+        }
+      }
+    });
+    for(auto& flush : flushes) {
+      flush.m_batch.ForEach([&] (const auto& value) {
+        SendConflatedMarketDataMessage(*flush.m_client, value);
+      });
+    }
+  }
+
+  inline bool ConflationBuffer::Batch::IsEmpty() const {
+    return m_orderImbalances.empty() && m_bboQuotes.empty() &&
+      m_marketQuotes.empty() && m_bookQuotes.empty() && m_timeAndSales.empty();
+  }
+
+  template<typename F>
+  void ConflationBuffer::Batch::ForEach(F&& f) const {
+    for(auto& orderImbalance : m_orderImbalances) {
+      f(orderImbalance);
+    }
+    for(auto& bboQuote : m_bboQuotes) {
+      f(bboQuote);
+    }
+    for(auto& marketQuote : m_marketQuotes) {
+      f(marketQuote);
+    }
+    for(auto& bookQuote : m_bookQuotes) {
+      f(bookQuote);
+    }
+    for(auto& timeAndSale : m_timeAndSales) {
+      f(timeAndSale);
+    }
+  }
+
+  inline ConflationBuffer::ConflationBuffer()
+    : m_isEnabled(false),
+      m_discardCount(0),
+      m_isScheduled(false) {}
+
+  inline ConflationPolicy ConflationBuffer::GetPolicy() const {
+    auto lock = std::lock_guard(m_mutex);
+    return m_policy;
+  }
+
+  inline ConflationPolicy ConflationBuffer::GetPolicy(
+      const Security& security) const {
+    auto lock = std::lock_guard(m_mutex);
+    return FindPolicy(security);
+  }
+
+  inline void ConflationBuffer::SetPolicy(const ConflationPolicy& policy) {
+    auto lock = std::lock_guard(m_mutex);
+    m_policy = policy;
+    UpdateEnabled();
+  }
+
+  inline void ConflationBuffer::SetPolicy(const Security& security,
+      const ConflationPolicy& policy) {
+    auto lock = std::lock_guard(m_mutex);
+    m_securityPolicies.insert_or_assign(security, policy);
+    UpdateEnabled();
+  }
+
+  inline bool ConflationBuffer::IsEnabled() const {
+    return m_isEnabled;
+  }
+
+  inline bool ConflationBuffer::IsBacklogged() const {
+    auto lock = std::lock_guard(m_mutex);
+    return !m_backloggedSecurities.empty() || !m_backloggedMarkets.empty();
+  }
+
+  inline bool ConflationBuffer::Schedule() {
+    auto lock = std::lock_guard(m_mutex);
+    if(m_isScheduled) {
+      return false;
+    }
+    m_isScheduled = true;
+    return true;
+  }
+
+  inline int ConflationBuffer::GetDiscardCount() const {
+    auto lock = std::lock_guard(m_mutex);
+    return m_discardCount;
+  }
+
+  inline Beam::Threading::Mutex& ConflationBuffer::GetSendMutex() {
+    return m_sendMutex;
+  }
+
+  inline bool ConflationBuffer::Push(
+      const SequencedMarketOrderImbalance& orderImbalance,
+      boost::posix_time::ptime timestamp) {
+    auto lock = std::lock_guard(m_mutex);
+    if(!m_policy.IsEnabled()) {
+      return false;
+    }
+    auto& market = orderImbalance.GetValue().GetIndex();
+    auto& entry = m_marketEntries[market];
+    return Buffer(market, entry, m_policy, timestamp, m_backloggedMarkets,
+      [&] {
+        Enqueue(entry.m_orderImbalances, orderImbalance, m_policy);
+      });
+  }
+
+  inline bool ConflationBuffer::Push(
+      const SequencedSecurityBboQuote& bboQuote,
+      boost::posix_time::ptime timestamp) {
+    auto lock = std::lock_guard(m_mutex);
+    auto& security = bboQuote.GetValue().GetIndex();
+    auto& policy = FindPolicy(security);
+    if(!policy.IsEnabled()) {
+      return false;
+    }
+    auto& entry = m_securityEntries[security];
+    return Buffer(security, entry, policy, timestamp, m_backloggedSecurities,
+      [&] {
+        entry.m_bboQuote = bboQuote;
+      });
+  }
+
+  inline bool ConflationBuffer::Push(
+      const SequencedSecurityBookQuote& bookQuote,
+      boost::posix_time::ptime timestamp) {
+    auto lock = std::lock_guard(m_mutex);
+    auto& security = bookQuote.GetValue().GetIndex();
+    auto& policy = FindPolicy(security);
+    if(!policy.IsEnabled()) {
+      return false;
+    }
+    auto& entry = m_securityEntries[security];
+    return Buffer(security, entry, policy, timestamp, m_backloggedSecurities,
+      [&] {
+        auto& quote = bookQuote.GetValue().GetValue();
+        entry.m_bookQuotes.insert_or_assign(BookQuoteKey(quote.m_quote.m_side,
+          quote.m_quote.m_price, quote.m_market, quote.m_mpid), bookQuote);
+      });
+  }
+
+  inline bool ConflationBuffer::Push(
+      const SequencedSecurityMarketQuote& marketQuote,
+      boost::posix_time::ptime timestamp) {
+    auto lock = std::lock_guard(m_mutex);
+    auto& security = marketQuote.GetValue().GetIndex();
+    auto& policy = FindPolicy(security);
+    if(!policy.IsEnabled()) {
+      return false;
+    }
+    auto& entry = m_securityEntries[security];
+    return Buffer(security, entry, policy, timestamp, m_backloggedSecurities,
+      [&] {
+        entry.m_marketQuotes.insert_or_assign(
+          marketQuote.GetValue().GetValue().m_market, marketQuote);
+      });
+  }
+
+  inline bool ConflationBuffer::Push(
+      const SequencedSecurityTimeAndSale& timeAndSale,
+      boost::posix_time::ptime timestamp) {
+    auto lock = std::lock_guard(m_mutex);
+    auto& security = timeAndSale.GetValue().GetIndex();
+    auto& policy = FindPolicy(security);
+    if(!policy.IsEnabled()) {
+      return false;
+    }
+    auto& entry = m_securityEntries[security];
+    return Buffer(security, entry, policy, timestamp, m_backloggedSecurities,
+      [&] {
+        Enqueue(entry.m_timeAndSales, timeAndSale, policy);
+      });
+  }
+
+  template<typename F>
+  bool ConflationBuffer::Flush(boost::posix_time::ptime timestamp, F&& f) {
+    auto batch = Batch();
+    auto isBacklogged = Take(timestamp, Beam::Store(batch));
+    batch.ForEach(f);
+    return isBacklogged;
+  }
+
+  template<typename F>
+  void ConflationBuffer::Flush(F&& f) {
+    auto batch = Batch();
+    {
+      auto lock = std::lock_guard(m_mutex);
+      Take(boost::posix_time::microsec_clock::universal_time(), true, batch);
+    }
+    batch.ForEach(f);
+  }
+
+  inline bool ConflationBuffer::Take(boost::posix_time::ptime timestamp,
+      Beam::Out<Batch> batch) {
+    auto lock = std::lock_guard(m_mutex);
+    return Take(timestamp, false, *batch);
+  }
+
+  inline const ConflationPolicy& ConflationBuffer::FindPolicy(
+      const Security& security) const {
+    auto policy = m_securityPolicies.find(security);
+    if(policy == m_securityPolicies.end()) {
+      return m_policy;
+    }
+    return policy->second;
+  }
+
+  inline void ConflationBuffer::UpdateEnabled() {
+    m_isEnabled = m_policy.IsEnabled() || std::any_of(
+      m_securityPolicies.begin(), m_securityPolicies.end(),
+      [] (const auto& policy) {
+        return policy.second.IsEnabled();
+      });
+  }
+
+  template<typename K, typename E, typename F>
+  bool ConflationBuffer::Buffer(const K& key, E& entry,
+      const ConflationPolicy& policy, boost::posix_time::ptime timestamp,
+      std::vector<K>& backlog, F&& buffer) {
+    if(!entry.m_isBacklogged && (entry.m_lastSend.is_special() ||
+        timestamp - entry.m_lastSend >= policy.m_updateInterval)) {
+      entry.m_lastSend = timestamp;
+      return false;
+    }
+    buffer();
+    if(!entry.m_isBacklogged) {
+      entry.m_isBacklogged = true;
+      backlog.push_back(key);
+    }
+    return true;
+  }
+
+  template<typename T>
+  void ConflationBuffer::Enqueue(std::deque<T>& queue, const T& value,
+      const ConflationPolicy& policy) {
+    if(policy.m_queueLimit <= 0) {
+      ++m_discardCount;
+      return;
+    }
+    while(static_cast<int>(queue.size()) >= policy.m_queueLimit) {
+      queue.pop_front();
+      ++m_discardCount;
+    }
+    queue.push_back(value);
+  }
+
+  inline bool ConflationBuffer::Take(boost::posix_time::ptime timestamp,
+      bool isForced, Batch& batch) {
+    auto isDue = [&] (const Entry& entry, const ConflationPolicy& policy) {
+      return isForced || !policy.IsEnabled() ||
+        timestamp - entry.m_lastSend >= policy.m_updateInterval;
+    };
+    auto securities = std::move(m_backloggedSecurities);
+    m_backloggedSecurities.clear();
+    for(auto& security : securities) {
+      auto& entry = m_securityEntries[security];
+      if(isDue(entry, FindPolicy(security))) {
+        Drain(entry, batch);
+        entry.m_lastSend = timestamp;
+        entry.m_isBacklogged = false;
+      } else {
+        m_backloggedSecurities.push_back(security);
+      }
+    }
+    auto markets = std::move(m_backloggedMarkets);
+    m_backloggedMarkets.clear();
+    for(auto& market : markets) {
+      auto& entry = m_marketEntries[market];
+      if(isDue(entry, m_policy)) {
+        Drain(entry, batch);
+        entry.m_lastSend = timestamp;
+        entry.m_isBacklogged = false;
+      } else {
+        m_backloggedMarkets.push_back(market);
+      }
+    }
+    if(m_backloggedSecurities.empty() && m_backloggedMarkets.empty()) {
+      m_isScheduled = false;
+      return false;
+    }
+    return true;
+  }
+
+  inline void ConflationBuffer::Drain(SecurityEntry& entry, Batch& batch) {
+    if(entry.m_bboQuote) {
+      batch.m_bboQuotes.push_back(std::move(*entry.m_bboQuote));
+      entry.m_bboQuote = boost::none;
+    }
+    for(auto& marketQuote : entry.m_marketQuotes) {
+      batch.m_marketQuotes.push_back(std::move(marketQuote.second));
+    }
+    entry.m_marketQuotes.clear();
+    for(auto& bookQuote : entry.m_bookQuotes) {
+      batch.m_bookQuotes.push_back(std::move(bookQuote.second));
+    }
+    entry.m_bookQuotes.clear();
+    std::move(entry.m_timeAndSales.begin(), entry.m_timeAndSales.end(),
+      std::back_inserter(batch.m_timeAndSales));
+    entry.m_timeAndSales.clear();
+  }
+
+  inline void ConflationBuffer::Drain(MarketEntry& entry, Batch& batch) {
+    std::move(entry.m_orderImbalances.begin(), entry.m_orderImbalances.end(),
+      std::back_inserter(batch.m_orderImbalances));
+    entry.m_orderImbalances.clear();
+  }
+}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef NEXUS_MARKET_DATA_CONFLATION_POLICY_HPP
+#define NEXUS_MARKET_DATA_CONFLATION_POLICY_HPP
+#include <Beam/Serialization/DataShuttle.hpp>
+#include <Beam/Serialization/ShuttleDateTime.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include "Nexus/MarketDataService/MarketDataService.hpp"
+
+namespace Nexus::MarketDataService {
+
+  /** Specifies how real-time market data is conflated for a client. */
+  struct ConflationPolicy {
+
+    /**
+     * The minimum amount of time between updates sent to the client, a
+     * non-positive interval disables conflation.
+     */
+    boost::posix_time::time_duration m_updateInterval;
+
+    /**
+     * The maximum number of TimeAndSales and OrderImbalances to queue between
+     * updates, once reached the oldest queued values are discarded.
+     */
+    int m_queueLimit;
+
+    /** Constructs a ConflationPolicy that disables conflation. */
+    ConflationPolicy();
+
+    /**
+     * Constructs a ConflationPolicy.
+     * @param updateInterval The minimum amount of time between updates.
+     * @param queueLimit The maximum number of TimeAndSales and OrderImbalances
+     *        to queue between updates.
+     */
+    ConflationPolicy(boost::posix_time::time_duration updateInterval,
+      int queueLimit);
+
+    /** Returns <code>true</code> iff this policy conflates market data. */
+    bool IsEnabled() const;
+
+    /** Tests if two ConflationPolicies are equal. */
+    bool operator ==(const ConflationPolicy& policy) const;
+
+    /** Tests if two ConflationPolicies are not equal. */
+    bool operator !=(const ConflationPolicy& policy) const;
+  };
+
+  inline ConflationPolicy::ConflationPolicy()
+    : ConflationPolicy(boost::posix_time::seconds(0), 0) {}
+
+  inline ConflationPolicy::ConflationPolicy(
+    boost::posix_time::time_duration updateInterval, int queueLimit)
+    : m_updateInterval(updateInterval),
+      m_queueLimit(queueLimit) {}
+
+  inline bool ConflationPolicy::IsEnabled() const {
+    return m_updateInterval > boost::posix_time::seconds(0);
+  }
+
+  inline bool ConflationPolicy::operator ==(
+      const ConflationPolicy& policy) const {
+    return m_updateInterval == policy.m_updateInterval &&
+      m_queueLimit == policy.m_queueLimit;
+  }
+
+  inline bool ConflationPolicy::operator !=(
+      const ConflationPolicy& policy) const {
+    return !(*this == policy);
+  }
+}
+
+namespace Beam::Serialization {
+  template<>
+  struct Shuttle<Nexus::MarketDataService::ConflationPolicy> {
+    template<typename Shuttler>
+    void operator ()(Shuttler& shuttle,
+        Nexus::MarketDataService::ConflationPolicy& value,
+        unsigned int version) {
+      shuttle.Shuttle("update_interval", value.m_updateInterval);
+      shuttle.Shuttle("queue_limit", value.m_queueLimit);
+    }
+  };
+}
+
+#endif
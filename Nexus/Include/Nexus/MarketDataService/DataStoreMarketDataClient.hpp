@@ -70,10 +70,16 @@ namespace Nexus::MarketDataService {
 
       SecurityTechnicals LoadSecurityTechnicals(const Security& security);
 
+      std::vector<SecuritySnapshot> LoadSecuritySnapshots(
+        const std::vector<Security>& securities);
+
+      std::vector<SecurityTechnicals> LoadSecurityTechnicalsList(
+        const std::vector<Security>& securities);
+
       boost::optional<SecurityInfo> LoadSecurityInfo(const Security& security);
 
       std::vector<SecurityInfo> LoadSecurityInfoFromPrefix(
-        const std::string& prefix);
+        const std::string& prefix, const Security& start, int count);
 
       void Close();
 
@@ -204,6 +210,18 @@ namespace Nexus::MarketDataService {
     return {};
   }
 
+  template<typename D>
+  std::vector<SecuritySnapshot> DataStoreMarketDataClient<D>::
+      LoadSecuritySnapshots(const std::vector<Security>& securities) {
+    return std::vector<SecuritySnapshot>(securities.size());
+  }
+
+  template<typename D>
+  std::vector<SecurityTechnicals> DataStoreMarketDataClient<D>::
+      LoadSecurityTechnicalsList(const std::vector<Security>& securities) {
+    return std::vector<SecurityTechnicals>(securities.size());
+  }
+
   template<typename D>
   boost::optional<SecurityInfo> DataStoreMarketDataClient<D>::LoadSecurityInfo(
       const Security& security) {
@@ -212,7 +230,8 @@ namespace Nexus::MarketDataService {
 
   template<typename D>
   std::vector<SecurityInfo> DataStoreMarketDataClient<D>::
-      LoadSecurityInfoFromPrefix(const std::string& prefix) {
+      LoadSecurityInfoFromPrefix(const std::string& prefix,
+      const Security& start, int count) {
     return {};
   }
 
@@ -1,11 +1,16 @@
 #ifndef NEXUS_DISTRIBUTED_MARKET_DATA_CLIENT_HPP
 #define NEXUS_DISTRIBUTED_MARKET_DATA_CLIENT_HPP
+#include <algorithm>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 #include <boost/noncopyable.hpp>
 #include <boost/range/adaptor/map.hpp>
 #include <Beam/IO/OpenState.hpp>
 #include "Nexus/Definitions/Country.hpp"
+#include "Nexus/MarketDataService/MarketDataRegistryServices.hpp"
 #include "Nexus/MarketDataService/MarketDataService.hpp"
+#include "Nexus/MarketDataService/SecuritySearchIndex.hpp"
 #include "Nexus/MarketDataService/VirtualMarketDataClient.hpp"
 
 namespace Nexus::MarketDataService {
@@ -65,10 +70,16 @@ namespace Nexus::MarketDataService {
 
       SecurityTechnicals LoadSecurityTechnicals(const Security& security);
 
+      std::vector<SecuritySnapshot> LoadSecuritySnapshots(
+        const std::vector<Security>& securities);
+
+      std::vector<SecurityTechnicals> LoadSecurityTechnicalsList(
+        const std::vector<Security>& securities);
+
       boost::optional<SecurityInfo> LoadSecurityInfo(const Security& security);
 
       std::vector<SecurityInfo> LoadSecurityInfoFromPrefix(
-        const std::string& prefix);
+        const std::string& prefix, const Security& start, int count);
 
       void Close();
 
@@ -79,6 +90,9 @@ namespace Nexus::MarketDataService {
         m_marketToMarketDataClients;
       VirtualMarketDataClient* FindMarketDataClient(MarketCode market);
       VirtualMarketDataClient* FindMarketDataClient(const Security& security);
+      template<typename T, typename F>
+      std::vector<T> LoadBatch(const std::vector<Security>& securities,
+        const F& load);
       Beam::IO::OpenState m_openState;
   };
 
@@ -211,6 +225,22 @@ namespace Nexus::MarketDataService {
     return marketDataClient->LoadSecurityTechnicals(security);
   }
 
+  inline std::vector<SecuritySnapshot> DistributedMarketDataClient::
+      LoadSecuritySnapshots(const std::vector<Security>& securities) {
+    return LoadBatch<SecuritySnapshot>(securities,
+      [] (auto& client, auto& securities) {
+        return client.LoadSecuritySnapshots(securities);
+      });
+  }
+
+  inline std::vector<SecurityTechnicals> DistributedMarketDataClient::
+      LoadSecurityTechnicalsList(const std::vector<Security>& securities) {
+    return LoadBatch<SecurityTechnicals>(securities,
+      [] (auto& client, auto& securities) {
+        return client.LoadSecurityTechnicalsList(securities);
+      });
+  }
+
   inline boost::optional<SecurityInfo>
       DistributedMarketDataClient::LoadSecurityInfo(const Security& security) {
     auto marketDataClient = FindMarketDataClient(security);
@@ -221,17 +251,107 @@ namespace Nexus::MarketDataService {
   }
 
   inline std::vector<SecurityInfo> DistributedMarketDataClient::
-      LoadSecurityInfoFromPrefix(const std::string& prefix) {
-    auto securityInfos = std::vector<SecurityInfo>();
-    auto clients =
-      std::unordered_set<std::shared_ptr<VirtualMarketDataClient>>();
-    for(auto& client :
-        m_countryToMarketDataClients | boost::adaptors::map_values) {
-      clients.insert(client);
+      LoadSecurityInfoFromPrefix(const std::string& prefix,
+      const Security& start, int count) {
+    if(count <= 0) {
+      return {};
+    }
+    struct Results {
+      VirtualMarketDataClient* m_client;
+      Security m_cursor;
+      std::vector<SecurityInfo> m_securityInfos;
+      std::vector<std::pair<int, Quantity>> m_ranks;
+      std::size_t m_position;
+      bool m_isExhausted;
+    };
+    auto countries = std::vector<CountryCode>();
+    for(auto& country :
+        m_countryToMarketDataClients | boost::adaptors::map_keys) {
+      countries.push_back(country);
     }
-    for(auto& client : clients) {
-      auto result = client->LoadSecurityInfoFromPrefix(prefix);
-      securityInfos.insert(securityInfos.end(), result.begin(), result.end());
+    std::sort(countries.begin(), countries.end());
+    auto results = std::vector<Results>();
+    for(auto& country : countries) {
+      auto client = m_countryToMarketDataClients.at(country).get();
+      if(std::none_of(results.begin(), results.end(), [&] (auto& result) {
+          return result.m_client == client;
+        })) {
+        results.push_back({client, Security(), {}, {}, 0, false});
+      }
+    }
+
+    // The cursor only identifies the last Security returned, so the merge is
+    // replayed from the first page of every server up to the cursor.
+    auto pageSize = std::min(count, MAX_SECURITY_INFO_PAGE_SIZE);
+    if(start != Security()) {
+      pageSize = MAX_SECURITY_INFO_PAGE_SIZE;
+    }
+    auto load = [&] (Results& result) {
+      if(result.m_position != result.m_securityInfos.size()) {
+        return true;
+      } else if(result.m_isExhausted) {
+        return false;
+      }
+      result.m_securityInfos = result.m_client->LoadSecurityInfoFromPrefix(
+        prefix, result.m_cursor, pageSize);
+      result.m_position = 0;
+      result.m_isExhausted =
+        static_cast<int>(result.m_securityInfos.size()) < pageSize;
+      if(result.m_securityInfos.empty()) {
+        return false;
+      }
+      result.m_cursor = result.m_securityInfos.back().m_security;
+      auto securities = std::vector<Security>();
+      for(auto& securityInfo : result.m_securityInfos) {
+        securities.push_back(securityInfo.m_security);
+      }
+      auto technicals = result.m_client->LoadSecurityTechnicalsList(
+        securities);
+      result.m_ranks.clear();
+      for(auto i = std::size_t(0); i != securities.size(); ++i) {
+        auto volume = [&] {
+          if(i < technicals.size()) {
+            return technicals[i].m_volume;
+          }
+          return Quantity(0);
+        }();
+        result.m_ranks.emplace_back(SecuritySearchIndex::GetMatchGroup(prefix,
+          result.m_securityInfos[i]), volume);
+      }
+      return true;
+    };
+
+    // Each server's results are taken in the server's order, the next result
+    // is the one from the earliest match group with the greatest volume.
+    auto isStartFound = start == Security();
+    auto securityInfos = std::vector<SecurityInfo>();
+    while(static_cast<int>(securityInfos.size()) < count) {
+      auto next = static_cast<Results*>(nullptr);
+      for(auto& result : results) {
+        if(!load(result)) {
+          continue;
+        }
+        if(next == nullptr) {
+          next = &result;
+          continue;
+        }
+        auto& rank = result.m_ranks[result.m_position];
+        auto& nextRank = next->m_ranks[next->m_position];
+        if(rank.first < nextRank.first ||
+            (rank.first == nextRank.first && rank.second > nextRank.second)) {
+          next = &result;
+        }
+      }
+      if(next == nullptr) {
+        break;
+      }
+      auto& securityInfo = next->m_securityInfos[next->m_position];
+      ++next->m_position;
+      if(isStartFound) {
+        securityInfos.push_back(securityInfo);
+      } else if(securityInfo.m_security == start) {
+        isStartFound = true;
+      }
     }
     return securityInfos;
   }
@@ -258,6 +378,32 @@ namespace Nexus::MarketDataService {
     }
     return marketDataClientIterator->second.get();
   }
+
+  template<typename T, typename F>
+  std::vector<T> DistributedMarketDataClient::LoadBatch(
+      const std::vector<Security>& securities, const F& load) {
+    struct Batch {
+      std::vector<Security> m_securities;
+      std::vector<std::size_t> m_positions;
+    };
+    auto batches = std::unordered_map<VirtualMarketDataClient*, Batch>();
+    for(auto i = std::size_t(0); i != securities.size(); ++i) {
+      if(auto marketDataClient = FindMarketDataClient(securities[i])) {
+        auto& batch = batches[marketDataClient];
+        batch.m_securities.push_back(securities[i]);
+        batch.m_positions.push_back(i);
+      }
+    }
+    auto result = std::vector<T>(securities.size());
+    for(auto& [marketDataClient, batch] : batches) {
+      auto values = load(*marketDataClient, batch.m_securities);
+      for(auto i = std::size_t(0);
+          i != std::min(values.size(), batch.m_positions.size()); ++i) {
+        result[batch.m_positions[i]] = std::move(values[i]);
+      }
+    }
+    return result;
+  }
 }
 
 #endif
@@ -0,0 +1,127 @@
+#ifndef NEXUS_MARKET_DATA_ENTITLEMENT_GROUPS_HPP
+#define NEXUS_MARKET_DATA_ENTITLEMENT_GROUPS_HPP
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <Beam/Collections/SynchronizedMap.hpp>
+#include <Beam/ServiceLocator/DirectoryEntry.hpp>
+#include <boost/noncopyable.hpp>
+#include "Nexus/MarketDataService/EntitlementDatabase.hpp"
+#include "Nexus/MarketDataService/MarketDataRegistrySession.hpp"
+
+namespace Nexus::MarketDataService {
+
+  /**
+   * Grants sessions their entitlements and assigns the same group to every
+   * session granted an identical set of entitlements.
+   */
+  class EntitlementGroups : private boost::noncopyable {
+    public:
+
+      /**
+       * Constructs EntitlementGroups.
+       * @param database The database of all market data entitlements.
+       */
+      explicit EntitlementGroups(EntitlementDatabase database);
+
+      /**
+       * Grants a session the entitlements of every database entry it belongs
+       * to and assigns the session's entitlement group. The session's roles
+       * must be loaded beforehand since the service and administrator bypass
+       * is part of the group.
+       * @param session The session to grant.
+       * @param entries The entitlement group entries the session's account
+       *        belongs to.
+       */
+      void Grant(MarketDataRegistrySession& session,
+        const std::vector<Beam::ServiceLocator::DirectoryEntry>& entries);
+
+    private:
+      EntitlementDatabase m_database;
+      Beam::SynchronizedUnorderedMap<std::vector<bool>, int> m_groups;
+      std::atomic_int m_nextGroup;
+  };
+
+  /**
+   * Evaluates an entitlement check at most once per entitlement group, used
+   * when a single update is filtered for every subscribed session.
+   */
+  class EntitlementGroupCache {
+    public:
+
+      /**
+       * Constructs an EntitlementGroupCache.
+       * @param key The entitlement to check.
+       * @param type The type of market data to check.
+       */
+      EntitlementGroupCache(EntitlementKey key, MarketDataType type);
+
+      /**
+       * Tests if a session has been granted the entitlement, reusing the
+       * result of any earlier session in the same group.
+       * @param session The session to test.
+       * @return <code>true</code> iff the session has been granted the
+       *         entitlement.
+       */
+      bool HasEntitlement(const MarketDataRegistrySession& session);
+
+    private:
+      EntitlementKey m_key;
+      MarketDataType m_type;
+      std::vector<std::int8_t> m_results;
+  };
+
+  inline EntitlementGroups::EntitlementGroups(EntitlementDatabase database)
+    : m_database(std::move(database)),
+      m_nextGroup(0) {}
+
+  inline void EntitlementGroups::Grant(MarketDataRegistrySession& session,
+      const std::vector<Beam::ServiceLocator::DirectoryEntry>& entries) {
+    auto& databaseEntries = m_database.GetEntries();
+    auto key = std::vector<bool>();
+    key.reserve(databaseEntries.size() + 1);
+    key.push_back(
+      session.m_roles.Test(AdministrationService::AccountRole::SERVICE) ||
+      session.m_roles.Test(AdministrationService::AccountRole::ADMINISTRATOR));
+    for(auto& databaseEntry : databaseEntries) {
+      if(std::find(entries.begin(), entries.end(),
+          databaseEntry.m_groupEntry) != entries.end()) {
+        for(auto& applicability : databaseEntry.m_applicability) {
+          session.m_entitlements.GrantEntitlement(applicability.first,
+            applicability.second);
+        }
+        key.push_back(true);
+      } else {
+        key.push_back(false);
+      }
+    }
+    session.m_entitlementGroup = m_groups.GetOrInsert(key, [&] {
+      return m_nextGroup++;
+    });
+  }
+
+  inline EntitlementGroupCache::EntitlementGroupCache(EntitlementKey key,
+    MarketDataType type)
+    : m_key(key),
+      m_type(type) {}
+
+  inline bool EntitlementGroupCache::HasEntitlement(
+      const MarketDataRegistrySession& session) {
+    if(session.m_entitlementGroup < 0) {
+      return MarketDataService::HasEntitlement(session, m_key, m_type);
+    }
+    auto group = static_cast<std::size_t>(session.m_entitlementGroup);
+    if(group >= m_results.size()) {
+      m_results.resize(group + 1, -1);
+    }
+    auto& result = m_results[group];
+    if(result == -1) {
+      result = MarketDataService::HasEntitlement(session, m_key, m_type);
+    }
+    return result == 1;
+  }
+}
+
+#endif
@@ -1,5 +1,7 @@
 #ifndef NEXUS_MARKET_DATA_HISTORICAL_DATA_STORE_HPP
 #define NEXUS_MARKET_DATA_HISTORICAL_DATA_STORE_HPP
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include <Beam/IO/Connection.hpp>
 #include <Beam/Utilities/Concept.hpp>
@@ -25,6 +27,23 @@ namespace Nexus::MarketDataService {
     /** Loads all SecurityInfos. */
     std::vector<SecurityInfo> LoadAllSecurityInfo();
 
+    /**
+     * Loads the InitialSequences of every Security with stored market data.
+     * @return The next Sequences to use for each Security's market data,
+     *         keyed by the Security's symbol and country.
+     */
+    std::unordered_map<Security, SecurityEntry::InitialSequences>
+      LoadAllInitialSequences();
+
+    /**
+     * Loads the price of every Security's last TimeAndSale at each market
+     * center.
+     * @return The last price at each market center, keyed by the Security's
+     *         symbol and country.
+     */
+    std::unordered_map<Security, std::unordered_map<std::string, Money>>
+      LoadAllLastPrices();
+
     /**
      * Executes a search query over a Market's OrderImbalances.
      * @param query The search query to execute.
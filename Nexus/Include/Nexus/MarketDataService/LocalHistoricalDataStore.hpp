@@ -1,5 +1,8 @@
 #ifndef NEXUS_MARKET_DATA_LOCAL_HISTORICAL_DATA_STORE_HPP
 #define NEXUS_MARKET_DATA_LOCAL_HISTORICAL_DATA_STORE_HPP
+#include <algorithm>
+#include <string>
+#include <unordered_map>
 #include <Beam/Collections/SynchronizedMap.hpp>
 #include <Beam/Queries/LocalDataStore.hpp>
 #include <boost/noncopyable.hpp>
@@ -35,6 +38,12 @@ namespace Nexus::MarketDataService {
 
       std::vector<SecurityInfo> LoadAllSecurityInfo();
 
+      std::unordered_map<Security, SecurityEntry::InitialSequences>
+        LoadAllInitialSequences();
+
+      std::unordered_map<Security, std::unordered_map<std::string, Money>>
+        LoadAllLastPrices();
+
       std::vector<SequencedOrderImbalance> LoadOrderImbalances(
         const MarketWideDataQuery& query);
 
@@ -85,6 +94,12 @@ namespace Nexus::MarketDataService {
       DataStore<MarketQuote, SecurityMarketDataQuery> m_marketQuoteDataStore;
       DataStore<BookQuote, SecurityMarketDataQuery> m_bookQuoteDataStore;
       DataStore<TimeAndSale, SecurityMarketDataQuery> m_timeAndSaleDataStore;
+
+      template<typename T>
+      static void UpdateInitialSequence(
+        std::unordered_map<Security, SecurityEntry::InitialSequences>&
+          initialSequences, const std::vector<T>& values,
+        Beam::Queries::Sequence SecurityEntry::InitialSequences::* sequence);
   };
 
   inline boost::optional<SecurityInfo> LocalHistoricalDataStore::
@@ -133,6 +148,42 @@ namespace Nexus::MarketDataService {
     return result;
   }
 
+  inline std::unordered_map<Security, SecurityEntry::InitialSequences>
+      LocalHistoricalDataStore::LoadAllInitialSequences() {
+    auto initialSequences =
+      std::unordered_map<Security, SecurityEntry::InitialSequences>();
+    UpdateInitialSequence(initialSequences, m_bboQuoteDataStore.LoadAll(),
+      &SecurityEntry::InitialSequences::m_nextBboQuoteSequence);
+    UpdateInitialSequence(initialSequences, m_bookQuoteDataStore.LoadAll(),
+      &SecurityEntry::InitialSequences::m_nextBookQuoteSequence);
+    UpdateInitialSequence(initialSequences, m_marketQuoteDataStore.LoadAll(),
+      &SecurityEntry::InitialSequences::m_nextMarketQuoteSequence);
+    UpdateInitialSequence(initialSequences, m_timeAndSaleDataStore.LoadAll(),
+      &SecurityEntry::InitialSequences::m_nextTimeAndSaleSequence);
+    return initialSequences;
+  }
+
+  inline std::unordered_map<Security, std::unordered_map<std::string, Money>>
+      LocalHistoricalDataStore::LoadAllLastPrices() {
+    auto lastPrices =
+      std::unordered_map<Security, std::unordered_map<std::string, Money>>();
+    auto lastSequences = std::unordered_map<Security,
+      std::unordered_map<std::string, Beam::Queries::Sequence>>();
+    for(auto& timeAndSale : m_timeAndSaleDataStore.LoadAll()) {
+      auto security = Security(timeAndSale->GetIndex().GetSymbol(),
+        timeAndSale->GetIndex().GetCountry());
+      auto& marketCenter = timeAndSale->GetValue().m_marketCenter;
+      auto lastSequence = lastSequences[security].try_emplace(marketCenter,
+        timeAndSale.GetSequence());
+      if(lastSequence.second ||
+          timeAndSale.GetSequence() >= lastSequence.first->second) {
+        lastSequence.first->second = timeAndSale.GetSequence();
+        lastPrices[security][marketCenter] = timeAndSale->GetValue().m_price;
+      }
+    }
+    return lastPrices;
+  }
+
   inline std::vector<SequencedOrderImbalance> LocalHistoricalDataStore::
       LoadOrderImbalances(const MarketWideDataQuery& query) {
     return m_orderImbalanceDataStore.Load(query);
@@ -213,6 +264,20 @@ namespace Nexus::MarketDataService {
   }
 
   inline void LocalHistoricalDataStore::Close() {}
+
+  template<typename T>
+  void LocalHistoricalDataStore::UpdateInitialSequence(
+      std::unordered_map<Security, SecurityEntry::InitialSequences>&
+        initialSequences, const std::vector<T>& values,
+      Beam::Queries::Sequence SecurityEntry::InitialSequences::* sequence) {
+    for(auto& value : values) {
+      auto& nextSequence = initialSequences[Security(
+        value->GetIndex().GetSymbol(), value->GetIndex().GetCountry())].*
+        sequence;
+      nextSequence = std::max(nextSequence,
+        Beam::Queries::Increment(value.GetSequence()));
+    }
+  }
 }
 
 #endif
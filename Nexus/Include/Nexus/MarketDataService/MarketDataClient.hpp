@@ -1,10 +1,12 @@
 #ifndef NEXUS_MARKET_DATA_CLIENT_HPP
 #define NEXUS_MARKET_DATA_CLIENT_HPP
+#include <unordered_map>
 #include <vector>
 #include <Beam/IO/Connection.hpp>
 #include <Beam/IO/OpenState.hpp>
 #include <Beam/Queries/QueryClientPublisher.hpp>
 #include <Beam/Services/ServiceProtocolClientHandler.hpp>
+#include <Beam/Threading/Sync.hpp>
 #include <boost/noncopyable.hpp>
 #include "Nexus/Definitions/SecurityInfo.hpp"
 #include "Nexus/MarketDataService/SecuritySnapshot.hpp"
@@ -130,6 +132,28 @@ namespace Nexus::MarketDataService {
        */
       SecurityTechnicals LoadSecurityTechnicals(const Security& security);
 
+      /**
+       * Loads the real-time snapshots of a list of Securities in a single
+       * request.
+       * @param securities The Securities whose SecuritySnapshots are to be
+       *        loaded.
+       * @return The real-time snapshot of each of the <i>securities</i>, in the
+       *         same order.
+       */
+      std::vector<SecuritySnapshot> LoadSecuritySnapshots(
+        const std::vector<Security>& securities);
+
+      /**
+       * Loads the SecurityTechnicals for a list of Securities in a single
+       * request.
+       * @param securities The Securities whose SecurityTechnicals are to be
+       *        loaded.
+       * @return The SecurityTechnicals for each of the <i>securities</i>, in
+       *         the same order.
+       */
+      std::vector<SecurityTechnicals> LoadSecurityTechnicalsList(
+        const std::vector<Security>& securities);
+
       /**
        * Loads the SecurityInfo for a specified Security.
        * @param security The Security whose SecurityInfo is to be loaded.
@@ -138,12 +162,32 @@ namespace Nexus::MarketDataService {
       boost::optional<SecurityInfo> LoadSecurityInfo(const Security& security);
 
       /**
-       * Loads SecurityInfo objects that match a prefix.
+       * Loads a page of SecurityInfo objects that match a prefix.
        * @param prefix The prefix to search for.
+       * @param start The last Security returned by the previous page, or an
+       *        empty Security to load the first page.
+       * @param count The maximum number of SecurityInfo objects to load.
        * @return The list of SecurityInfo objects that match the <i>prefix</i>.
        */
       std::vector<SecurityInfo> LoadSecurityInfoFromPrefix(
-        const std::string& prefix);
+        const std::string& prefix, const Security& start, int count);
+
+      /**
+       * Sets the policy used to conflate real-time market data sent to this
+       * client, the policy is restored upon reconnecting.
+       * @param policy The policy to use.
+       */
+      void SetConflationPolicy(const ConflationPolicy& policy);
+
+      /**
+       * Sets the policy used to conflate a Security's real-time market data
+       * sent to this client, overriding the client's policy. The policy is
+       * restored upon reconnecting.
+       * @param security The Security whose policy is set.
+       * @param policy The policy to use.
+       */
+      void SetConflationPolicy(const Security& security,
+        const ConflationPolicy& policy);
 
       void Close();
 
@@ -170,6 +214,9 @@ namespace Nexus::MarketDataService {
       QueryClientPublisher<TimeAndSale, SecurityMarketDataQuery,
         QueryTimeAndSalesService, EndTimeAndSaleQueryMessage>
         m_timeAndSalePublisher;
+      Beam::Threading::Sync<ConflationPolicy> m_conflationPolicy;
+      Beam::Threading::Sync<std::unordered_map<Security, ConflationPolicy>>
+        m_securityConflationPolicies;
       Beam::IO::OpenState m_openState;
 
       void OnReconnect(const std::shared_ptr<ServiceProtocolClient>& client);
@@ -286,6 +333,28 @@ namespace Nexus::MarketDataService {
       security);
   }
 
+  template<typename B>
+  std::vector<SecuritySnapshot> MarketDataClient<B>::LoadSecuritySnapshots(
+      const std::vector<Security>& securities) {
+    if(securities.empty()) {
+      return {};
+    }
+    auto client = m_clientHandler.GetClient();
+    return client->template SendRequest<LoadSecuritySnapshotsService>(
+      securities);
+  }
+
+  template<typename B>
+  std::vector<SecurityTechnicals> MarketDataClient<B>::
+      LoadSecurityTechnicalsList(const std::vector<Security>& securities) {
+    if(securities.empty()) {
+      return {};
+    }
+    auto client = m_clientHandler.GetClient();
+    return client->template SendRequest<LoadSecurityTechnicalsListService>(
+      securities);
+  }
+
   template<typename B>
   boost::optional<SecurityInfo> MarketDataClient<B>::LoadSecurityInfo(
       const Security& security) {
@@ -295,10 +364,32 @@ namespace Nexus::MarketDataService {
 
   template<typename B>
   std::vector<SecurityInfo> MarketDataClient<B>::LoadSecurityInfoFromPrefix(
-      const std::string& prefix) {
+      const std::string& prefix, const Security& start, int count) {
+    auto client = m_clientHandler.GetClient();
+    return client->template SendRequest<LoadSecurityInfoPageFromPrefixService>(
+      prefix, start, count);
+  }
+
+  template<typename B>
+  void MarketDataClient<B>::SetConflationPolicy(
+      const ConflationPolicy& policy) {
+    auto client = m_clientHandler.GetClient();
+    client->template SendRequest<SetConflationPolicyService>(policy);
+    Beam::Threading::With(m_conflationPolicy, [&] (auto& conflationPolicy) {
+      conflationPolicy = policy;
+    });
+  }
+
+  template<typename B>
+  void MarketDataClient<B>::SetConflationPolicy(const Security& security,
+      const ConflationPolicy& policy) {
     auto client = m_clientHandler.GetClient();
-    return client->template SendRequest<LoadSecurityInfoFromPrefixService>(
-      prefix);
+    client->template SendRequest<SetSecurityConflationPolicyService>(security,
+      policy);
+    Beam::Threading::With(m_securityConflationPolicies,
+      [&] (auto& policies) {
+        policies.insert_or_assign(security, policy);
+      });
   }
 
   template<typename B>
@@ -318,6 +409,21 @@ namespace Nexus::MarketDataService {
     m_bookQuotePublisher.Recover(*client);
     m_marketQuotePublisher.Recover(*client);
     m_timeAndSalePublisher.Recover(*client);
+    auto policy = Beam::Threading::With(m_conflationPolicy,
+      [] (const auto& policy) {
+        return policy;
+      });
+    if(policy.IsEnabled()) {
+      client->template SendRequest<SetConflationPolicyService>(policy);
+    }
+    auto securityPolicies = Beam::Threading::With(
+      m_securityConflationPolicies, [] (const auto& policies) {
+        return policies;
+      });
+    for(auto& securityPolicy : securityPolicies) {
+      client->template SendRequest<SetSecurityConflationPolicyService>(
+        securityPolicy.first, securityPolicy.second);
+    }
   }
 }
 
@@ -1,10 +1,12 @@
 #ifndef NEXUS_MARKET_DATA_REGISTRY_HPP
 #define NEXUS_MARKET_DATA_REGISTRY_HPP
+#include <algorithm>
+#include <atomic>
 #include <memory>
-#include <unordered_set>
+#include <string>
+#include <unordered_map>
 #include <Beam/Collections/SynchronizedMap.hpp>
 #include <Beam/Collections/SynchronizedSet.hpp>
-#include <Beam/Collections/Trie.hpp>
 #include <Beam/Threading/Sync.hpp>
 #include <Beam/Utilities/AssertionException.hpp>
 #include <Beam/Utilities/Remote.hpp>
@@ -14,28 +16,42 @@
 #include "Nexus/Definitions/DefaultCountryDatabase.hpp"
 #include "Nexus/Definitions/DefaultMarketDatabase.hpp"
 #include "Nexus/Definitions/SecurityInfo.hpp"
+#include "Nexus/MarketDataService/MarketDataRegistryCheckpoint.hpp"
 #include "Nexus/MarketDataService/MarketDataService.hpp"
 #include "Nexus/MarketDataService/MarketEntry.hpp"
 #include "Nexus/MarketDataService/SecurityEntry.hpp"
+#include "Nexus/MarketDataService/SecuritySearchIndex.hpp"
 #include "Nexus/TechnicalAnalysis/StandardSecurityQueries.hpp"
 
 namespace Nexus::MarketDataService {
 namespace Details {
+  inline std::vector<std::string> GetCloseMarketCenters(
+      const Security& security) {
+    if(security.GetCountry() == DefaultCountries::CA()) {
+      return {"TSE", "CDX", "CNQ"};
+    } else if(security.GetCountry() == DefaultCountries::AU()) {
+      return {"ASX"};
+    } else if(!security.GetMarket().IsEmpty()) {
+      return {std::string{security.GetMarket().GetData()}};
+    } else {
+      return {};
+    }
+  }
+
+  inline Money FindClosePrice(const Security& security,
+      const std::unordered_map<std::string, Money>& lastPrices) {
+    for(auto& marketCenter : GetCloseMarketCenters(security)) {
+      auto price = lastPrices.find(marketCenter);
+      if(price != lastPrices.end()) {
+        return price->second;
+      }
+    }
+    return Money::ZERO;
+  }
+
   template<typename DataStore>
   Money LoadClosePrice(const Security& security, DataStore& dataStore) {
-    auto marketCenters =
-      [&] () -> std::vector<std::string> {
-        if(security.GetCountry() == DefaultCountries::CA()) {
-          return {"TSE", "CDX", "CNQ"};
-        } else if(security.GetCountry() == DefaultCountries::AU()) {
-          return {"ASX"};
-        } else if(!security.GetMarket().IsEmpty()) {
-          return {std::string{security.GetMarket().GetData()}};
-        } else {
-          return {};
-        }
-      }();
-    for(auto& marketCenter : marketCenters) {
+    for(auto& marketCenter : GetCloseMarketCenters(security)) {
       auto queryMarketCode = Beam::Queries::StringValue(marketCenter);
       auto marketCodeExpression = Beam::Queries::ConstantExpression(
         queryMarketCode);
@@ -58,6 +74,60 @@ namespace Details {
     }
     return Money::ZERO;
   }
+
+  inline SecurityMarketDataQuery MakeTailQuery(const Security& security,
+      Beam::Queries::Sequence start,
+      const Beam::Queries::SnapshotLimit& limit) {
+    auto query = SecurityMarketDataQuery();
+    query.SetIndex(security);
+    query.SetRange(start, Beam::Queries::Sequence::Last());
+    query.SetSnapshotLimit(limit);
+    return query;
+  }
+
+  template<typename DataStore>
+  void ReplayTail(SecurityEntry& entry,
+      const SecurityEntry::InitialSequences& checkpointSequences,
+      const SecurityEntry::InitialSequences& storedSequences,
+      DataStore& dataStore) {
+    auto& security = entry.GetSecurity();
+    if(storedSequences.m_nextBboQuoteSequence >
+        checkpointSequences.m_nextBboQuoteSequence) {
+      for(auto& bboQuote : dataStore.LoadBboQuotes(MakeTailQuery(security,
+          checkpointSequences.m_nextBboQuoteSequence,
+          Beam::Queries::SnapshotLimit(
+            Beam::Queries::SnapshotLimit::Type::TAIL, 1)))) {
+        entry.Replay(bboQuote);
+      }
+    }
+    if(storedSequences.m_nextMarketQuoteSequence >
+        checkpointSequences.m_nextMarketQuoteSequence) {
+      for(auto& marketQuote : dataStore.LoadMarketQuotes(MakeTailQuery(
+          security, checkpointSequences.m_nextMarketQuoteSequence,
+          Beam::Queries::SnapshotLimit::Unlimited()))) {
+        entry.Replay(marketQuote);
+      }
+    }
+    if(storedSequences.m_nextBookQuoteSequence <
+        checkpointSequences.m_nextBookQuoteSequence) {
+      entry.ExpireRestoredBook();
+    } else if(storedSequences.m_nextBookQuoteSequence >
+        checkpointSequences.m_nextBookQuoteSequence) {
+      for(auto& bookQuote : dataStore.LoadBookQuotes(MakeTailQuery(security,
+          checkpointSequences.m_nextBookQuoteSequence,
+          Beam::Queries::SnapshotLimit::Unlimited()))) {
+        entry.Replay(bookQuote);
+      }
+    }
+    if(storedSequences.m_nextTimeAndSaleSequence >
+        checkpointSequences.m_nextTimeAndSaleSequence) {
+      for(auto& timeAndSale : dataStore.LoadTimeAndSales(MakeTailQuery(
+          security, checkpointSequences.m_nextTimeAndSaleSequence,
+          Beam::Queries::SnapshotLimit::Unlimited()))) {
+        entry.Replay(timeAndSale);
+      }
+    }
+  }
 }
 
   /** Keeps and updates the registry of market data. */
@@ -74,11 +144,57 @@ namespace Details {
       void Add(const SecurityInfo& securityInfo);
 
       /**
-       * Returns a list of SecurityInfo's matching a prefix.
+       * Loads the InitialSequences and last prices of every Security in bulk
+       * so that SecurityEntries are initialized without querying the
+       * DataStore one Security at a time.
+       * @param dataStore The DataStore to load the market data from.
+       */
+      template<typename DataStore>
+      void Preload(DataStore& dataStore);
+
+      /**
+       * Releases the InitialSequences and last prices cached by Preload that
+       * have not been used, securities loaded afterwards query the DataStore
+       * individually.
+       */
+      void ReleasePreload();
+
+      /**
+       * Restores the state of every SecurityEntry and MarketEntry from a
+       * checkpoint, replaying any market data stored after the checkpoint was
+       * taken. The DataStore is preloaded first if it hasn't been already,
+       * and book levels are dropped for any Security whose stored book is
+       * behind the checkpoint.
+       * @param checkpoint The checkpoint to restore.
+       * @param dataStore The DataStore to replay market data from.
+       */
+      template<typename DataStore>
+      void Restore(const MarketDataRegistryCheckpoint& checkpoint,
+        DataStore& dataStore);
+
+      /** Returns a checkpoint of every SecurityEntry and MarketEntry. */
+      MarketDataRegistryCheckpoint MakeCheckpoint();
+
+      /**
+       * Returns a page of SecurityInfo's matching a prefix, ordered by rank.
+       * Pages requested across a call to UpdateSearchRanks may repeat or skip
+       * securities.
        * @param prefix The prefix to search for.
-       * @return The list of SecurityInfo's that match the <i>prefix</i>.
+       * @param start The last Security returned by the previous page, or an
+       *        empty Security to return the first page.
+       * @param count The maximum number of SecurityInfo's to return.
+       * @return The page of SecurityInfo's that match the <i>prefix</i>, or an
+       *         empty page if the <i>start</i> is unknown.
        */
-      std::vector<SecurityInfo> SearchSecurityInfo(const std::string& prefix);
+      std::vector<SecurityInfo> SearchSecurityInfo(const std::string& prefix,
+        const Security& start, int count);
+
+      /**
+       * Ranks the securities returned by SearchSecurityInfo by their current
+       * trading activity. The ranking is computed without holding the search
+       * index's lock and is discarded if a Security is added in the meantime.
+       */
+      void UpdateSearchRanks();
 
       /**
        * Returns a Security's primary listing.
@@ -152,6 +268,16 @@ namespace Details {
       boost::optional<SecurityTechnicals> FindSecurityTechnicals(
         const Security& security);
 
+      /**
+       * Returns the SecurityTechnicals for a list of Securities.
+       * @param securities The Securities whose SecurityTechnicals are to be
+       *        returned.
+       * @return A snapshot of each Security's SecurityTechnicals, in the same
+       *         order as the <i>securities</i>.
+       */
+      std::vector<boost::optional<SecurityTechnicals>> FindSecurityTechnicals(
+        const std::vector<Security>& securities);
+
       /**
        * Returns a Security's SecurityInfo.
        * @param security The Security whose SecurityInfo is to be returned.
@@ -166,6 +292,15 @@ namespace Details {
        */
       boost::optional<SecuritySnapshot> FindSnapshot(const Security& security);
 
+      /**
+       * Returns the real time snapshots of a list of Securities.
+       * @param securities The Securities whose snapshots are to be returned.
+       * @return The real-time snapshot of each Security, in the same order as
+       *         the <i>securities</i>.
+       */
+      std::vector<boost::optional<SecuritySnapshot>> FindSnapshots(
+        const std::vector<Security>& securities);
+
       /**
        * Clears market data that originated from a specified source.
        * \param sourceId The id of the source to clear.
@@ -177,13 +312,23 @@ namespace Details {
         Beam::Threading::Mutex>;
       using SyncSecurityEntry = Beam::Threading::Sync<SecurityEntry,
         Beam::Threading::Mutex>;
-      Beam::Threading::Sync<rtv::Trie<char, SecurityInfo>> m_securityDatabase;
+      struct PreloadedEntry {
+        SecurityEntry::InitialSequences m_initialSequences;
+        std::unordered_map<std::string, Money> m_lastPrices;
+      };
+      Beam::Threading::Sync<SecuritySearchIndex> m_searchIndex;
       Beam::SynchronizedUnorderedMap<Security, Security> m_verifiedSecurities;
       Beam::SynchronizedUnorderedMap<MarketCode, std::shared_ptr<Beam::Remote<
         SyncMarketEntry, Beam::Threading::Mutex>>> m_marketEntries;
       Beam::SynchronizedUnorderedMap<Security, std::shared_ptr<Beam::Remote<
         SyncSecurityEntry, Beam::Threading::Mutex>>> m_securityEntries;
+      Beam::SynchronizedUnorderedMap<Security, PreloadedEntry>
+        m_preloadedEntries;
+      std::atomic_bool m_isPreloaded;
 
+      std::vector<std::shared_ptr<Beam::Remote<SyncSecurityEntry,
+        Beam::Threading::Mutex>>> FindSecurityEntries(
+        const std::vector<Security>& securities);
       template<typename DataStore>
       boost::optional<SyncMarketEntry&> LoadMarketEntry(MarketCode market,
         DataStore& dataStore);
@@ -193,53 +338,167 @@ namespace Details {
   };
 
   inline MarketDataRegistry::MarketDataRegistry()
-    : m_securityDatabase('\0') {}
+    : m_isPreloaded(false) {}
 
   inline void MarketDataRegistry::Add(const SecurityInfo& securityInfo) {
-    auto key = ToString(securityInfo.m_security, GetDefaultMarketDatabase());
-    auto name = boost::to_upper_copy(securityInfo.m_name);
-    Beam::Threading::With(m_securityDatabase,
-      [&] (auto& securityDatabase) {
-        securityDatabase[key.c_str()] = securityInfo;
-        securityDatabase[name.c_str()] = securityInfo;
+    Beam::Threading::With(m_searchIndex,
+      [&] (auto& searchIndex) {
+        searchIndex.Add(securityInfo);
       });
     m_verifiedSecurities.Update(securityInfo.m_security,
       securityInfo.m_security);
   }
 
-  inline std::vector<SecurityInfo> MarketDataRegistry::SearchSecurityInfo(
-      const std::string& prefix) {
-    static const auto MAX_MATCH_COUNT = 8;
-    auto matches = std::unordered_set<SecurityInfo>();
-    auto uppercasePrefix = boost::to_upper_copy(prefix);
-    Beam::Threading::With(m_securityDatabase,
-      [&] (auto& securityDatabase) {
-        for(auto i = securityDatabase.startsWith(uppercasePrefix.c_str());
-            i != securityDatabase.end(); ++i) {
-          matches.insert(*i->second);
+  template<typename DataStore>
+  void MarketDataRegistry::Preload(DataStore& dataStore) {
+    auto initialSequences = dataStore.LoadAllInitialSequences();
+    auto lastPrices = dataStore.LoadAllLastPrices();
+    m_preloadedEntries.With(
+      [&] (auto& preloadedEntries) {
+        for(auto& entry : initialSequences) {
+          preloadedEntries[entry.first].m_initialSequences = entry.second;
+        }
+        for(auto& entry : lastPrices) {
+          preloadedEntries[entry.first].m_lastPrices = std::move(entry.second);
         }
       });
-    auto i = matches.begin();
-    while(i != matches.end()) {
-      auto entry = m_securityEntries.FindValue(i->m_security);
-      if(!entry.is_initialized() || !(*entry)->IsAvailable()) {
-        i = matches.erase(i);
-      } else {
-        Beam::Threading::With(***entry,
+    m_isPreloaded = true;
+  }
+
+  inline void MarketDataRegistry::ReleasePreload() {
+    m_preloadedEntries.Clear();
+  }
+
+  template<typename DataStore>
+  void MarketDataRegistry::Restore(
+      const MarketDataRegistryCheckpoint& checkpoint, DataStore& dataStore) {
+    if(!m_isPreloaded) {
+      Preload(dataStore);
+    }
+    for(auto& marketCheckpoint : checkpoint.m_marketEntries) {
+      auto restoredCheckpoint = marketCheckpoint;
+      auto storedSequences = LoadInitialSequences(dataStore,
+        marketCheckpoint.m_market);
+      restoredCheckpoint.m_sequences.m_nextOrderImbalanceSequence = std::max(
+        restoredCheckpoint.m_sequences.m_nextOrderImbalanceSequence,
+        storedSequences.m_nextOrderImbalanceSequence);
+      m_marketEntries.GetOrInsert(marketCheckpoint.m_market,
+        [&] {
+          return std::make_shared<
+              Beam::Remote<SyncMarketEntry, Beam::Threading::Mutex>>(
+            [=] (auto& entry) {
+              entry.emplace(restoredCheckpoint);
+            });
+        });
+    }
+    for(auto& securityCheckpoint : checkpoint.m_securityEntries) {
+      auto& security = securityCheckpoint.m_security;
+      if(security.GetSymbol().empty() ||
+          security.GetCountry() == CountryCode::NONE) {
+        continue;
+      }
+      auto storedSequences =
+        [&] {
+          auto preloadedEntry = m_preloadedEntries.Find(security);
+          if(preloadedEntry.is_initialized()) {
+            m_preloadedEntries.Erase(security);
+            return preloadedEntry->m_initialSequences;
+          }
+          return SecurityEntry::InitialSequences();
+        }();
+      auto entry = m_securityEntries.GetOrInsert(security,
+        [&] {
+          return std::make_shared<
+              Beam::Remote<SyncSecurityEntry, Beam::Threading::Mutex>>(
+            [=] (auto& entry) {
+              entry.emplace(securityCheckpoint);
+            });
+        });
+      Beam::Threading::With(**entry,
+        [&] (auto& entry) {
+          Details::ReplayTail(entry, securityCheckpoint.m_sequences,
+            storedSequences, dataStore);
+        });
+    }
+  }
+
+  inline MarketDataRegistryCheckpoint MarketDataRegistry::MakeCheckpoint() {
+    auto checkpoint = MarketDataRegistryCheckpoint();
+    auto securityEntries = std::vector<std::shared_ptr<
+      Beam::Remote<SyncSecurityEntry, Beam::Threading::Mutex>>>();
+    m_securityEntries.With(
+      [&] (auto& entries) {
+        for(auto& entry : entries | boost::adaptors::map_values) {
+          securityEntries.push_back(entry);
+        }
+      });
+    checkpoint.m_securityEntries.reserve(securityEntries.size());
+    for(auto& entry : securityEntries) {
+      if(entry->IsAvailable()) {
+        checkpoint.m_securityEntries.push_back(Beam::Threading::With(**entry,
           [&] (auto& entry) {
-            if((*entry.GetBboQuote())->m_ask.m_price == Money::ZERO) {
-              i = matches.erase(i);
-            } else {
-              ++i;
-            }
-          });
+            return entry.MakeCheckpoint();
+          }));
+      }
+    }
+    auto marketEntries = std::vector<std::shared_ptr<
+      Beam::Remote<SyncMarketEntry, Beam::Threading::Mutex>>>();
+    m_marketEntries.With(
+      [&] (auto& entries) {
+        for(auto& entry : entries | boost::adaptors::map_values) {
+          marketEntries.push_back(entry);
+        }
+      });
+    for(auto& entry : marketEntries) {
+      if(entry->IsAvailable()) {
+        checkpoint.m_marketEntries.push_back(Beam::Threading::With(**entry,
+          [&] (auto& entry) {
+            return entry.MakeCheckpoint();
+          }));
       }
     }
-    auto result = std::vector<SecurityInfo>(matches.begin(), matches.end());
-    if(result.size() > MAX_MATCH_COUNT) {
-      result.erase(result.begin() + MAX_MATCH_COUNT, result.end());
+    return checkpoint;
+  }
+
+  inline std::vector<SecurityInfo> MarketDataRegistry::SearchSecurityInfo(
+      const std::string& prefix, const Security& start, int count) {
+    return Beam::Threading::With(m_searchIndex,
+      [&] (auto& searchIndex) {
+        return searchIndex.Search(prefix, start, count);
+      });
+  }
+
+  inline void MarketDataRegistry::UpdateSearchRanks() {
+    auto securityEntries = std::vector<std::shared_ptr<
+      Beam::Remote<SyncSecurityEntry, Beam::Threading::Mutex>>>();
+    m_securityEntries.With(
+      [&] (auto& entries) {
+        for(auto& entry : entries | boost::adaptors::map_values) {
+          securityEntries.push_back(entry);
+        }
+      });
+    auto activity = std::unordered_map<Security, Quantity>();
+    for(auto& entry : securityEntries) {
+      if(!entry->IsAvailable()) {
+        continue;
+      }
+      Beam::Threading::With(**entry,
+        [&] (auto& entry) {
+          if((*entry.GetBboQuote())->m_ask.m_price != Money::ZERO) {
+            activity[entry.GetSecurity()] =
+              entry.GetSecurityTechnicals().m_volume + 1;
+          }
+        });
     }
-    return result;
+    auto ranking = Beam::Threading::With(m_searchIndex,
+      [&] (auto& searchIndex) {
+        return searchIndex.MakeRanking();
+      });
+    ranking.Rank(activity);
+    Beam::Threading::With(m_searchIndex,
+      [&] (auto& searchIndex) {
+        searchIndex.Apply(std::move(ranking));
+      });
   }
 
   inline Security MarketDataRegistry::GetPrimaryListing(
@@ -325,10 +584,12 @@ namespace Details {
           }
           auto key = ToString(entry.GetSecurity(), GetDefaultMarketDatabase());
           auto info = SecurityInfo(entry.GetSecurity(), key, "", 0);
-          Beam::Threading::With(m_securityDatabase,
-            [&] (auto& securityDatabase) {
-              securityDatabase.insert(key.c_str(), info);
-          });
+          Beam::Threading::With(m_searchIndex,
+            [&] (auto& searchIndex) {
+              if(!searchIndex.Contains(info.m_security)) {
+                searchIndex.Add(info);
+              }
+            });
         }
         auto sequencedBboQuote = entry.PublishBboQuote(std::move(bboQuote),
           sourceId);
@@ -403,6 +664,24 @@ namespace Details {
       });
   }
 
+  inline std::vector<boost::optional<SecurityTechnicals>>
+      MarketDataRegistry::FindSecurityTechnicals(
+        const std::vector<Security>& securities) {
+    auto technicals = std::vector<boost::optional<SecurityTechnicals>>();
+    technicals.reserve(securities.size());
+    for(auto& entry : FindSecurityEntries(securities)) {
+      if(!entry || !entry->IsAvailable()) {
+        technicals.push_back(boost::none);
+      } else {
+        technicals.push_back(Beam::Threading::With(**entry,
+          [&] (auto& entry) {
+            return entry.GetSecurityTechnicals();
+          }));
+      }
+    }
+    return technicals;
+  }
+
   inline boost::optional<SecurityInfo> MarketDataRegistry::FindSecurityInfo(
       const Security& security) {
     return boost::none;
@@ -420,6 +699,24 @@ namespace Details {
       });
   }
 
+  inline std::vector<boost::optional<SecuritySnapshot>>
+      MarketDataRegistry::FindSnapshots(
+        const std::vector<Security>& securities) {
+    auto snapshots = std::vector<boost::optional<SecuritySnapshot>>();
+    snapshots.reserve(securities.size());
+    for(auto& entry : FindSecurityEntries(securities)) {
+      if(!entry || !entry->IsAvailable()) {
+        snapshots.push_back(boost::none);
+      } else {
+        snapshots.push_back(Beam::Threading::With(**entry,
+          [&] (auto& entry) {
+            return entry.LoadSnapshot();
+          }));
+      }
+    }
+    return snapshots;
+  }
+
   inline void MarketDataRegistry::Clear(int sourceId) {
     auto entries = std::vector<std::shared_ptr<Beam::Remote<SyncSecurityEntry,
       Beam::Threading::Mutex>>>();
@@ -439,6 +736,27 @@ namespace Details {
     }
   }
 
+  inline std::vector<std::shared_ptr<Beam::Remote<
+      MarketDataRegistry::SyncSecurityEntry, Beam::Threading::Mutex>>>
+      MarketDataRegistry::FindSecurityEntries(
+        const std::vector<Security>& securities) {
+    auto entries = std::vector<std::shared_ptr<Beam::Remote<SyncSecurityEntry,
+      Beam::Threading::Mutex>>>();
+    entries.reserve(securities.size());
+    m_securityEntries.With(
+      [&] (auto& securityEntries) {
+        for(auto& security : securities) {
+          auto entry = securityEntries.find(security);
+          if(entry == securityEntries.end()) {
+            entries.push_back(nullptr);
+          } else {
+            entries.push_back(entry->second);
+          }
+        }
+      });
+    return entries;
+  }
+
   template<typename DataStore>
   inline boost::optional<MarketDataRegistry::SyncMarketEntry&>
       MarketDataRegistry::LoadMarketEntry(MarketCode market,
@@ -472,6 +790,15 @@ namespace Details {
             Beam::Remote<SyncSecurityEntry, Beam::Threading::Mutex>>(
           [&] (auto& entry) {
             auto sanitizedSecurity = GetPrimaryListing(security);
+            auto preloadedEntry = m_preloadedEntries.Find(sanitizedSecurity);
+            if(preloadedEntry.is_initialized()) {
+              m_preloadedEntries.Erase(sanitizedSecurity);
+              auto closePrice = Details::FindClosePrice(sanitizedSecurity,
+                preloadedEntry->m_lastPrices);
+              entry.emplace(sanitizedSecurity, closePrice,
+                preloadedEntry->m_initialSequences);
+              return;
+            }
             auto initialSequences = LoadInitialSequences(dataStore,
               sanitizedSecurity);
             auto closePrice = Details::LoadClosePrice(sanitizedSecurity,
@@ -0,0 +1,249 @@
+#ifndef NEXUS_MARKET_DATA_REGISTRY_CHECKPOINT_HPP
+#define NEXUS_MARKET_DATA_REGISTRY_CHECKPOINT_HPP
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <Beam/IO/BasicIStreamReader.hpp>
+#include <Beam/IO/SharedBuffer.hpp>
+#include <Beam/Serialization/BinaryReceiver.hpp>
+#include <Beam/Serialization/BinarySender.hpp>
+#include <Beam/Serialization/DataShuttle.hpp>
+#include <Beam/Serialization/ShuttleDateTime.hpp>
+#include <Beam/Serialization/ShuttleVector.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/optional/optional.hpp>
+#include <boost/range/adaptor/reversed.hpp>
+#include <boost/throw_exception.hpp>
+#ifdef _WIN32
+  #include <io.h>
+#else
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+#include "Nexus/MarketDataService/MarketDataService.hpp"
+#include "Nexus/MarketDataService/MarketEntry.hpp"
+#include "Nexus/MarketDataService/SecurityEntry.hpp"
+
+namespace Nexus::MarketDataService {
+
+  /** Stores the state of a MarketDataRegistry at a point in time. */
+  struct MarketDataRegistryCheckpoint {
+
+    /** The time the checkpoint was taken. */
+    boost::posix_time::ptime m_timestamp;
+
+    /** The state of every SecurityEntry. */
+    std::vector<SecurityEntry::Checkpoint> m_securityEntries;
+
+    /** The state of every MarketEntry. */
+    std::vector<MarketEntry::Checkpoint> m_marketEntries;
+  };
+
+  /** The version of the checkpoint file format. */
+  static constexpr auto MARKET_DATA_REGISTRY_CHECKPOINT_VERSION = 1;
+}
+
+namespace Beam::Serialization {
+  template<>
+  struct Shuttle<Nexus::MarketDataService::SecurityEntry::InitialSequences> {
+    template<typename Shuttler>
+    void operator ()(Shuttler& shuttle,
+        Nexus::MarketDataService::SecurityEntry::InitialSequences& value,
+        unsigned int version) {
+      shuttle.Shuttle("next_bbo_quote_sequence", value.m_nextBboQuoteSequence);
+      shuttle.Shuttle("next_book_quote_sequence",
+        value.m_nextBookQuoteSequence);
+      shuttle.Shuttle("next_market_quote_sequence",
+        value.m_nextMarketQuoteSequence);
+      shuttle.Shuttle("next_time_and_sale_sequence",
+        value.m_nextTimeAndSaleSequence);
+    }
+  };
+
+  template<>
+  struct Shuttle<Nexus::MarketDataService::SecurityEntry::Checkpoint> {
+    template<typename Shuttler>
+    void operator ()(Shuttler& shuttle,
+        Nexus::MarketDataService::SecurityEntry::Checkpoint& value,
+        unsigned int version) {
+      shuttle.Shuttle("security", value.m_security);
+      shuttle.Shuttle("technicals", value.m_technicals);
+      shuttle.Shuttle("sequences", value.m_sequences);
+      shuttle.Shuttle("bbo_quote", value.m_bboQuote);
+      shuttle.Shuttle("time_and_sale", value.m_timeAndSale);
+      shuttle.Shuttle("market_quotes", value.m_marketQuotes);
+      shuttle.Shuttle("ask_book", value.m_askBook);
+      shuttle.Shuttle("bid_book", value.m_bidBook);
+    }
+  };
+
+  template<>
+  struct Shuttle<Nexus::MarketDataService::MarketEntry::InitialSequences> {
+    template<typename Shuttler>
+    void operator ()(Shuttler& shuttle,
+        Nexus::MarketDataService::MarketEntry::InitialSequences& value,
+        unsigned int version) {
+      shuttle.Shuttle("next_order_imbalance_sequence",
+        value.m_nextOrderImbalanceSequence);
+    }
+  };
+
+  template<>
+  struct Shuttle<Nexus::MarketDataService::MarketEntry::Checkpoint> {
+    template<typename Shuttler>
+    void operator ()(Shuttler& shuttle,
+        Nexus::MarketDataService::MarketEntry::Checkpoint& value,
+        unsigned int version) {
+      shuttle.Shuttle("market", value.m_market);
+      shuttle.Shuttle("sequences", value.m_sequences);
+    }
+  };
+
+  template<>
+  struct Shuttle<Nexus::MarketDataService::MarketDataRegistryCheckpoint> {
+    template<typename Shuttler>
+    void operator ()(Shuttler& shuttle,
+        Nexus::MarketDataService::MarketDataRegistryCheckpoint& value,
+        unsigned int version) {
+      shuttle.Shuttle("timestamp", value.m_timestamp);
+      shuttle.Shuttle("security_entries", value.m_securityEntries);
+      shuttle.Shuttle("market_entries", value.m_marketEntries);
+    }
+  };
+}
+
+namespace Nexus::MarketDataService {
+namespace Details {
+  inline std::vector<std::filesystem::path> ListCheckpoints(
+      const std::filesystem::path& directory) {
+    auto paths = std::vector<std::filesystem::path>();
+    for(auto& entry : std::filesystem::directory_iterator(directory)) {
+      auto fileName = entry.path().filename().string();
+      if(fileName.rfind("checkpoint-", 0) == 0 &&
+          entry.path().extension() == ".dat") {
+        paths.push_back(entry.path());
+      }
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths;
+  }
+
+  inline void WriteDurably(const std::filesystem::path& path,
+      const Beam::IO::SharedBuffer& buffer) {
+    auto file = std::fopen(path.string().c_str(), "wb");
+    if(file == nullptr) {
+      BOOST_THROW_EXCEPTION(std::runtime_error(
+        "Unable to open checkpoint: " + path.string()));
+    }
+    auto isWritten = std::fwrite(buffer.GetData(), 1, buffer.GetSize(),
+      file) == buffer.GetSize() && std::fflush(file) == 0;
+#ifdef _WIN32
+    isWritten = isWritten && _commit(_fileno(file)) == 0;
+#else
+    isWritten = isWritten && fsync(fileno(file)) == 0;
+#endif
+    isWritten = std::fclose(file) == 0 && isWritten;
+    if(!isWritten) {
+      BOOST_THROW_EXCEPTION(std::runtime_error(
+        "Unable to write checkpoint: " + path.string()));
+    }
+  }
+
+  inline void SynchronizeDirectory(const std::filesystem::path& directory) {
+#ifndef _WIN32
+    auto descriptor = open(directory.string().c_str(), O_RDONLY);
+    if(descriptor == -1) {
+      BOOST_THROW_EXCEPTION(std::runtime_error(
+        "Unable to open checkpoint directory: " + directory.string()));
+    }
+    auto result = fsync(descriptor);
+    close(descriptor);
+    if(result != 0) {
+      BOOST_THROW_EXCEPTION(std::runtime_error(
+        "Unable to synchronize checkpoint directory: " + directory.string()));
+    }
+#endif
+  }
+}
+
+  /**
+   * Writes a MarketDataRegistryCheckpoint to a directory. The file is written
+   * under a temporary name, synchronized to disk and then renamed, and the
+   * directory is synchronized before older checkpoints are removed, so that
+   * neither a crash nor a power loss leaves a truncated checkpoint as the
+   * only one retained. On Windows the directory itself is not synchronized.
+   * @param checkpoint The checkpoint to write.
+   * @param directory The directory to write the checkpoint to.
+   * @param retentionCount The number of most recent checkpoints to keep.
+   */
+  inline void SaveCheckpoint(const MarketDataRegistryCheckpoint& checkpoint,
+      const std::filesystem::path& directory, int retentionCount = 2) {
+    auto buffer = Beam::IO::SharedBuffer();
+    auto sender = Beam::Serialization::BinarySender<Beam::IO::SharedBuffer>();
+    sender.SetSink(Beam::Ref(buffer));
+    sender.Shuttle(MARKET_DATA_REGISTRY_CHECKPOINT_VERSION);
+    sender.Shuttle(checkpoint);
+    std::filesystem::create_directories(directory);
+    auto name = "checkpoint-" +
+      boost::posix_time::to_iso_string(checkpoint.m_timestamp) + ".dat";
+    auto temporaryPath = directory / (name + ".tmp");
+    Details::WriteDurably(temporaryPath, buffer);
+    std::filesystem::rename(temporaryPath, directory / name);
+    Details::SynchronizeDirectory(directory);
+    auto paths = Details::ListCheckpoints(directory);
+    auto removeCount = static_cast<int>(paths.size()) -
+      std::max(1, retentionCount);
+    for(auto i = 0; i < removeCount; ++i) {
+      std::filesystem::remove(paths[i]);
+    }
+  }
+
+  /**
+   * Loads the most recent readable MarketDataRegistryCheckpoint from a
+   * directory.
+   * @param directory The directory containing the checkpoints.
+   * @param sessionStart The start of the current trading session, checkpoints
+   *        taken before it are rejected.
+   * @return The most recent checkpoint, or <code>boost::none</code> if none
+   *         could be read.
+   */
+  inline boost::optional<MarketDataRegistryCheckpoint> LoadLatestCheckpoint(
+      const std::filesystem::path& directory,
+      boost::posix_time::ptime sessionStart) {
+    if(!std::filesystem::is_directory(directory)) {
+      return boost::none;
+    }
+    auto paths = Details::ListCheckpoints(directory);
+    for(auto& path : boost::adaptors::reverse(paths)) {
+      try {
+        auto reader = Beam::IO::BasicIStreamReader<std::ifstream>(
+          Beam::Initialize(path, std::ios::binary));
+        auto buffer = Beam::IO::SharedBuffer();
+        reader.Read(Beam::Store(buffer));
+        auto receiver =
+          Beam::Serialization::BinaryReceiver<Beam::IO::SharedBuffer>();
+        receiver.SetSource(Beam::Ref(buffer));
+        auto version = int();
+        receiver.Shuttle(version);
+        if(version != MARKET_DATA_REGISTRY_CHECKPOINT_VERSION) {
+          continue;
+        }
+        auto checkpoint = MarketDataRegistryCheckpoint();
+        receiver.Shuttle(checkpoint);
+        if(checkpoint.m_timestamp < sessionStart) {
+          return boost::none;
+        }
+        return checkpoint;
+      } catch(const std::exception&) {
+        continue;
+      }
+    }
+    return boost::none;
+  }
+}
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef NEXUS_MARKET_DATA_REGISTRY_CHECKPOINTER_HPP
+#define NEXUS_MARKET_DATA_REGISTRY_CHECKPOINTER_HPP
+#include <filesystem>
+#include <iostream>
+#include <Beam/IO/OpenState.hpp>
+#include <Beam/Pointers/Dereference.hpp>
+#include <Beam/Pointers/LocalPtr.hpp>
+#include <Beam/Queues/RoutineTaskQueue.hpp>
+#include <Beam/Threading/Timer.hpp>
+#include <Beam/Utilities/ReportException.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/noncopyable.hpp>
+#include "Nexus/MarketDataService/MarketDataRegistryCheckpoint.hpp"
+#include "Nexus/MarketDataService/MarketDataService.hpp"
+
+namespace Nexus::MarketDataService {
+
+  /**
+   * Periodically writes checkpoints of a MarketDataRegistry to disk.
+   * @param <R> The type of registry to checkpoint.
+   * @param <T> The type of Timer used to schedule checkpoints.
+   */
+  template<typename R, typename T>
+  class MarketDataRegistryCheckpointer : private boost::noncopyable {
+    public:
+
+      /** The type of registry to checkpoint. */
+      using Registry = Beam::GetTryDereferenceType<R>;
+
+      /** The type of Timer used to schedule checkpoints. */
+      using Timer = Beam::GetTryDereferenceType<T>;
+
+      /**
+       * Constructs a MarketDataRegistryCheckpointer.
+       * @param registry The registry to checkpoint.
+       * @param directory The directory to write the checkpoints to.
+       * @param timer The Timer used to schedule checkpoints.
+       */
+      template<typename RF, typename TF>
+      MarketDataRegistryCheckpointer(RF&& registry,
+        std::filesystem::path directory, TF&& timer);
+
+      ~MarketDataRegistryCheckpointer();
+
+      /** Writes a checkpoint immediately. */
+      void Checkpoint();
+
+      void Close();
+
+    private:
+      Beam::GetOptionalLocalPtr<R> m_registry;
+      std::filesystem::path m_directory;
+      Beam::GetOptionalLocalPtr<T> m_timer;
+      Beam::IO::OpenState m_openState;
+      Beam::RoutineTaskQueue m_tasks;
+
+      void OnTimer(Beam::Threading::Timer::Result result);
+  };
+
+  template<typename R, typename T>
+  template<typename RF, typename TF>
+  MarketDataRegistryCheckpointer<R, T>::MarketDataRegistryCheckpointer(
+      RF&& registry, std::filesystem::path directory, TF&& timer)
+      : m_registry(std::forward<RF>(registry)),
+        m_directory(std::move(directory)),
+        m_timer(std::forward<TF>(timer)) {
+    m_timer->GetPublisher().Monitor(
+      m_tasks.GetSlot<Beam::Threading::Timer::Result>(
+      std::bind(&MarketDataRegistryCheckpointer::OnTimer, this,
+      std::placeholders::_1)));
+    m_timer->Start();
+  }
+
+  template<typename R, typename T>
+  MarketDataRegistryCheckpointer<R, T>::~MarketDataRegistryCheckpointer() {
+    Close();
+  }
+
+  template<typename R, typename T>
+  void MarketDataRegistryCheckpointer<R, T>::Checkpoint() {
+    auto checkpoint = m_registry->MakeCheckpoint();
+    checkpoint.m_timestamp =
+      boost::posix_time::microsec_clock::universal_time();
+    SaveCheckpoint(checkpoint, m_directory);
+  }
+
+  template<typename R, typename T>
+  void MarketDataRegistryCheckpointer<R, T>::Close() {
+    if(m_openState.SetClosing()) {
+      return;
+    }
+    m_timer->Cancel();
+    m_tasks.Break();
+    m_tasks.Wait();
+    m_openState.Close();
+  }
+
+  template<typename R, typename T>
+  void MarketDataRegistryCheckpointer<R, T>::OnTimer(
+      Beam::Threading::Timer::Result result) {
+    if(result != Beam::Threading::Timer::Result::EXPIRED) {
+      return;
+    }
+    try {
+      Checkpoint();
+    } catch(const std::exception&) {
+      std::cout << BEAM_REPORT_CURRENT_EXCEPTION() << std::flush;
+    }
+    m_timer->Start();
+  }
+}
+
+#endif
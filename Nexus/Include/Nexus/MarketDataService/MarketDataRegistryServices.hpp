@@ -6,6 +6,7 @@
 #include <Beam/Services/Service.hpp>
 #include "Nexus/Definitions/SecurityInfo.hpp"
 #include "Nexus/Definitions/SecurityTechnicals.hpp"
+#include "Nexus/MarketDataService/ConflationPolicy.hpp"
 #include "Nexus/MarketDataService/MarketWideDataQuery.hpp"
 #include "Nexus/MarketDataService/SecurityMarketDataQuery.hpp"
 #include "Nexus/MarketDataService/SecuritySnapshot.hpp"
@@ -20,6 +21,12 @@ namespace Nexus::MarketDataService {
   using TimeAndSaleQueryResult =
     Beam::Queries::QueryResult<SequencedTimeAndSale>;
 
+  /** The number of SecurityInfo objects in a page by default. */
+  static constexpr auto DEFAULT_SECURITY_INFO_PAGE_SIZE = 8;
+
+  /** The maximum number of SecurityInfo objects a page may contain. */
+  static constexpr auto MAX_SECURITY_INFO_PAGE_SIZE = 100;
+
   BEAM_DEFINE_SERVICES(MarketDataRegistryServices,
 
     /*! \interface Nexus::MarketDataService::QueryOrderImbalancesService
@@ -106,6 +113,34 @@ namespace Nexus::MarketDataService {
       SecurityTechnicals, Security, security),
     //! \endcond
 
+    /*! \interface Nexus::MarketDataService::LoadSecuritySnapshotsService
+        \brief Loads the real-time snapshots of a list of Securities.
+        \param securities <code>std::vector\<Security\></code> The Securities
+               whose snapshots are to be loaded.
+        \return <code>std::vector\<SecuritySnapshot\></code> The
+                SecuritySnapshot for each of the <i>securities</i>, in the same
+                order.
+    */
+    //! \cond
+    (LoadSecuritySnapshotsService,
+      "Nexus.MarketDataService.LoadSecuritySnapshotsService",
+      std::vector<SecuritySnapshot>, std::vector<Security>, securities),
+    //! \endcond
+
+    /*! \interface Nexus::MarketDataService::LoadSecurityTechnicalsListService
+        \brief Loads the SecurityTechnicals for a list of Securities.
+        \param securities <code>std::vector\<Security\></code> The Securities
+               whose SecurityTechnicals are to be loaded.
+        \return <code>std::vector\<SecurityTechnicals\></code> The
+                SecurityTechnicals for each of the <i>securities</i>, in the
+                same order.
+    */
+    //! \cond
+    (LoadSecurityTechnicalsListService,
+      "Nexus.MarketDataService.LoadSecurityTechnicalsListService",
+      std::vector<SecurityTechnicals>, std::vector<Security>, securities),
+    //! \endcond
+
     /*! \interface Nexus::MarketDataService::LoadSecurityInfoService
         \brief Loads the SecurityInfo for a specified Security.
         \param security <code>Security</code> The Security whose SecurityInfo is
@@ -118,7 +153,8 @@ namespace Nexus::MarketDataService {
       boost::optional<SecurityInfo>, Security, security),
 
     /*! \interface Nexus::MarketDataService::LoadSecurityInfoFromPrefixService
-        \brief Loads all SecurityInfo objects that match a prefix.
+        \brief Loads the first page of SecurityInfo objects that match a
+               prefix.
         \param prefix <code>std::string</code> The prefix to search for.
         \return <code>std::vector\<SecurityInfo\></code> The list of
                 SecurityInfo objects that match the <i>prefix</i>.
@@ -126,7 +162,48 @@ namespace Nexus::MarketDataService {
     //! \cond
     (LoadSecurityInfoFromPrefixService,
       "Nexus.MarketDataService.LoadSecurityInfoFromPrefixService",
-      std::vector<SecurityInfo>, std::string, prefix));
+      std::vector<SecurityInfo>, std::string, prefix),
+    //! \endcond
+
+    /*! \interface Nexus::MarketDataService::LoadSecurityInfoPageFromPrefixService
+        \brief Loads a page of SecurityInfo objects that match a prefix.
+        \param prefix <code>std::string</code> The prefix to search for.
+        \param start <code>Security</code> The last Security returned by the
+               previous page, or an empty Security to load the first page.
+        \param count <code>int</code> The maximum number of SecurityInfo
+               objects to load.
+        \return <code>std::vector\<SecurityInfo\></code> The list of
+                SecurityInfo objects that match the <i>prefix</i>.
+    */
+    //! \cond
+    (LoadSecurityInfoPageFromPrefixService,
+      "Nexus.MarketDataService.LoadSecurityInfoPageFromPrefixService",
+      std::vector<SecurityInfo>, std::string, prefix, Security, start, int,
+      count),
+    //! \endcond
+
+    /*! \interface Nexus::MarketDataService::SetConflationPolicyService
+        \brief Sets the policy used to conflate the client's real-time market
+               data.
+        \param policy <code>ConflationPolicy</code> The policy to use.
+    */
+    //! \cond
+    (SetConflationPolicyService,
+      "Nexus.MarketDataService.SetConflationPolicyService", void,
+      ConflationPolicy, policy),
+    //! \endcond
+
+    /*! \interface Nexus::MarketDataService::SetSecurityConflationPolicyService
+        \brief Sets the policy used to conflate a Security's real-time market
+               data, overriding the client's policy.
+        \param security <code>Security</code> The Security whose policy is
+               set.
+        \param policy <code>ConflationPolicy</code> The policy to use.
+    */
+    //! \cond
+    (SetSecurityConflationPolicyService,
+      "Nexus.MarketDataService.SetSecurityConflationPolicyService", void,
+      Security, security, ConflationPolicy, policy));
     //! \endcond
 
   BEAM_DEFINE_MESSAGES(MarketDataRegistryMessages,
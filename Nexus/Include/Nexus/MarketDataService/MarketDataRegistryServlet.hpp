@@ -1,13 +1,22 @@
 #ifndef NEXUS_MARKET_DATA_REGISTRY_SERVLET_HPP
 #define NEXUS_MARKET_DATA_REGISTRY_SERVLET_HPP
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 #include <Beam/Collections/SynchronizedMap.hpp>
 #include <Beam/IO/OpenState.hpp>
 #include <Beam/Pointers/Dereference.hpp>
 #include <Beam/Pointers/LocalPtr.hpp>
 #include <Beam/Queries/IndexedSubscriptions.hpp>
+#include <Beam/Queues/RoutineTaskQueue.hpp>
 #include <Beam/Services/ServiceProtocolServlet.hpp>
+#include <Beam/Threading/Sync.hpp>
+#include <Beam/Threading/Timer.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/noncopyable.hpp>
 #include "Nexus/AdministrationService/AdministrationClient.hpp"
+#include "Nexus/MarketDataService/ConflationBuffer.hpp"
 #include "Nexus/MarketDataService/EntitlementDatabase.hpp"
 #include "Nexus/MarketDataService/MarketDataRegistry.hpp"
 #include "Nexus/MarketDataService/MarketDataRegistryServices.hpp"
@@ -26,8 +35,10 @@ namespace Nexus::MarketDataService {
    *        servlet.
    * @param <D> The type of data store storing historical market data.
    * @param <A> The type of AdministrationClient to use.
+   * @param <T> The type of Timer used to flush conflated market data and to
+   *        schedule maintenance.
    */
-  template<typename C, typename R, typename D, typename A>
+  template<typename C, typename R, typename D, typename A, typename T>
   class MarketDataRegistryServlet : private boost::noncopyable {
     public:
 
@@ -42,16 +53,33 @@ namespace Nexus::MarketDataService {
       /** The type of AdministrationClient to use. */
       using AdministrationClient = Beam::GetTryDereferenceType<A>;
 
+      /**
+       * The type of Timer used to flush conflated market data and to schedule
+       * maintenance.
+       */
+      using Timer = Beam::GetTryDereferenceType<T>;
+
+      /** How long the registry keeps preloaded market data after startup. */
+      static inline const auto PRELOAD_RETENTION =
+        boost::posix_time::minutes(5);
+
       /**
        * Constructs a MarketDataRegistryServlet.
        * @param administrationClient Used to check for entitlements.
        * @param marketDataRegistry The registry storing all market data
        *        originating from this servlet.
        * @param dataStore Initializes the historical market data store.
+       * @param flushTimer The Timer used to flush conflated market data, its
+       *        period bounds the finest update interval a client can request.
+       * @param maintenanceTimer The Timer used to update the search ranks and
+       *        release the preloaded market data, its period is the interval
+       *        between search rank updates.
        */
-      template<typename AF, typename RF, typename DF>
+      template<typename AF, typename RF, typename DF, typename TF,
+        typename MF>
       MarketDataRegistryServlet(AF&& administrationClient,
-        RF&& marketDataRegistry, DF&& dataStore);
+        RF&& marketDataRegistry, DF&& dataStore, TF&& flushTimer,
+        MF&& maintenanceTimer);
 
       void Add(const SecurityInfo& securityInfo);
 
@@ -90,13 +118,22 @@ namespace Nexus::MarketDataService {
       Beam::GetOptionalLocalPtr<A> m_administrationClient;
       Beam::GetOptionalLocalPtr<R> m_registry;
       Beam::GetOptionalLocalPtr<D> m_dataStore;
+      Beam::GetOptionalLocalPtr<T> m_flushTimer;
+      Beam::GetOptionalLocalPtr<T> m_maintenanceTimer;
+      boost::posix_time::ptime m_preloadExpiry;
+      Beam::Threading::Sync<std::unordered_set<ServiceProtocolClient*>>
+        m_backloggedClients;
       MarketSubscriptions<OrderImbalance> m_orderImbalanceSubscriptions;
       SecuritySubscriptions<BboQuote> m_bboQuoteSubscriptions;
       SecuritySubscriptions<BookQuote> m_bookQuoteSubscriptions;
       SecuritySubscriptions<MarketQuote> m_marketQuoteSubscriptions;
       SecuritySubscriptions<TimeAndSale> m_timeAndSaleSubscriptions;
       Beam::IO::OpenState m_openState;
+      Beam::RoutineTaskQueue m_flushTasks;
+      Beam::RoutineTaskQueue m_maintenanceTasks;
 
+      void OnFlushTimer(Beam::Threading::Timer::Result result);
+      void OnMaintenanceTimer(Beam::Threading::Timer::Result result);
       void OnQueryOrderImbalances(Beam::Services::RequestToken<
         ServiceProtocolClient, QueryOrderImbalancesService>& request,
         const MarketWideDataQuery& query);
@@ -126,90 +163,117 @@ namespace Nexus::MarketDataService {
         const Security& security);
       SecurityTechnicals OnLoadSecurityTechnicals(
         ServiceProtocolClient& client, const Security& security);
+      std::vector<SecuritySnapshot> OnLoadSecuritySnapshots(
+        ServiceProtocolClient& client, const std::vector<Security>& securities);
+      std::vector<SecurityTechnicals> OnLoadSecurityTechnicalsList(
+        ServiceProtocolClient& client, const std::vector<Security>& securities);
       boost::optional<SecurityInfo> OnLoadSecurityInfo(
         ServiceProtocolClient& client, const Security& security);
       std::vector<SecurityInfo> OnLoadSecurityInfoFromPrefix(
         ServiceProtocolClient& client, const std::string& prefix);
+      std::vector<SecurityInfo> OnLoadSecurityInfoPageFromPrefix(
+        ServiceProtocolClient& client, const std::string& prefix,
+        const Security& start, int count);
+      void OnSetConflationPolicy(ServiceProtocolClient& client,
+        const ConflationPolicy& policy);
+      void OnSetSecurityConflationPolicy(ServiceProtocolClient& client,
+        const Security& security, const ConflationPolicy& policy);
   };
 
-  template<typename R, typename D, typename A>
+  template<typename R, typename D, typename A, typename T>
   struct MetaMarketDataRegistryServlet {
     using Session = MarketDataRegistrySession;
     template<typename C>
     struct apply {
-      using type = MarketDataRegistryServlet<C, R, D, A>;
+      using type = MarketDataRegistryServlet<C, R, D, A, T>;
     };
   };
 
-  template<typename C, typename R, typename D, typename A>
-  template<typename AF, typename RF, typename DF>
-  MarketDataRegistryServlet<C, R, D, A>::MarketDataRegistryServlet(
-      AF&& administrationClient, RF&& registry, DF&& dataStore)
+  template<typename C, typename R, typename D, typename A, typename T>
+  template<typename AF, typename RF, typename DF, typename TF, typename MF>
+  MarketDataRegistryServlet<C, R, D, A, T>::MarketDataRegistryServlet(
+      AF&& administrationClient, RF&& registry, DF&& dataStore,
+      TF&& flushTimer, MF&& maintenanceTimer)
       : m_administrationClient(std::forward<AF>(administrationClient)),
         m_registry(std::forward<RF>(registry)),
-        m_dataStore(std::forward<DF>(dataStore)) {
+        m_dataStore(std::forward<DF>(dataStore)),
+        m_flushTimer(std::forward<TF>(flushTimer)),
+        m_maintenanceTimer(std::forward<MF>(maintenanceTimer)),
+        m_preloadExpiry(boost::posix_time::microsec_clock::universal_time() +
+          PRELOAD_RETENTION) {
     try {
       auto securityInfo = m_dataStore->LoadAllSecurityInfo();
       for(auto& entry : securityInfo) {
         m_registry->Add(entry);
       }
+      m_registry->Preload(*m_dataStore);
       m_entitlementDatabase = m_administrationClient->LoadEntitlements();
     } catch(const std::exception&) {
       Close();
       BOOST_RETHROW;
     }
+    m_flushTimer->GetPublisher().Monitor(
+      m_flushTasks.GetSlot<Beam::Threading::Timer::Result>(
+      std::bind(&MarketDataRegistryServlet::OnFlushTimer, this,
+      std::placeholders::_1)));
+    m_flushTimer->Start();
+    m_maintenanceTimer->GetPublisher().Monitor(
+      m_maintenanceTasks.GetSlot<Beam::Threading::Timer::Result>(
+      std::bind(&MarketDataRegistryServlet::OnMaintenanceTimer, this,
+      std::placeholders::_1)));
+    m_maintenanceTimer->Start();
   }
 
-  template<typename C, typename R, typename D, typename A>
-  void MarketDataRegistryServlet<C, R, D, A>::Add(
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::Add(
       const SecurityInfo& securityInfo) {
     m_dataStore->Store(securityInfo);
     m_registry->Add(securityInfo);
   }
 
-  template<typename C, typename R, typename D, typename A>
-  void MarketDataRegistryServlet<C, R, D, A>::PublishOrderImbalance(
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::PublishOrderImbalance(
       const MarketOrderImbalance& orderImbalance, int sourceId) {
     m_registry->PublishOrderImbalance(orderImbalance, sourceId, *m_dataStore,
       [&] (const auto& orderImbalance) {
         m_dataStore->Store(orderImbalance);
         m_orderImbalanceSubscriptions.Publish(orderImbalance,
           [&] (const auto& clients) {
-            Beam::Services::BroadcastRecordMessage<OrderImbalanceMessage>(
-              clients, orderImbalance);
+            BroadcastMarketDataMessage<OrderImbalanceMessage>(
+              clients, orderImbalance, m_backloggedClients);
           });
       });
   }
 
-  template<typename C, typename R, typename D, typename A>
-  void MarketDataRegistryServlet<C, R, D, A>::PublishBboQuote(
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::PublishBboQuote(
       const SecurityBboQuote& bboQuote, int sourceId) {
     m_registry->PublishBboQuote(bboQuote, sourceId, *m_dataStore,
       [&] (const auto& bboQuote) {
         m_dataStore->Store(bboQuote);
         m_bboQuoteSubscriptions.Publish(bboQuote, [&] (const auto& clients) {
-          Beam::Services::BroadcastRecordMessage<BboQuoteMessage>(clients,
-            bboQuote);
+          BroadcastMarketDataMessage<BboQuoteMessage>(clients, bboQuote,
+            m_backloggedClients);
         });
       });
   }
 
-  template<typename C, typename R, typename D, typename A>
-  void MarketDataRegistryServlet<C, R, D, A>::PublishMarketQuote(
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::PublishMarketQuote(
       const SecurityMarketQuote& marketQuote, int sourceId) {
     m_registry->PublishMarketQuote(marketQuote, sourceId, *m_dataStore,
       [&] (const auto& marketQuote) {
         m_dataStore->Store(marketQuote);
         m_marketQuoteSubscriptions.Publish(marketQuote,
           [&] (const auto& clients) {
-            Beam::Services::BroadcastRecordMessage<MarketQuoteMessage>(clients,
-              marketQuote);
+            BroadcastMarketDataMessage<MarketQuoteMessage>(clients,
+              marketQuote, m_backloggedClients);
           });
       });
   }
 
-  template<typename C, typename R, typename D, typename A>
-  void MarketDataRegistryServlet<C, R, D, A>::UpdateBookQuote(
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::UpdateBookQuote(
       const SecurityBookQuote& delta, int sourceId) {
     auto security = m_registry->GetPrimaryListing(delta.GetIndex());
     auto key = EntitlementKey(security.GetMarket(), delta.GetValue().m_market);
@@ -225,33 +289,33 @@ namespace Nexus::MarketDataService {
               MarketDataType::BOOK_QUOTE);
           },
           [&] (const auto& clients) {
-            Beam::Services::BroadcastRecordMessage<BookQuoteMessage>(clients,
-              bookQuote);
+            BroadcastMarketDataMessage<BookQuoteMessage>(clients, bookQuote,
+              m_backloggedClients);
           });
       });
   }
 
-  template<typename C, typename R, typename D, typename A>
-  void MarketDataRegistryServlet<C, R, D, A>::PublishTimeAndSale(
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::PublishTimeAndSale(
       const SecurityTimeAndSale& timeAndSale, int sourceId) {
     m_registry->PublishTimeAndSale(timeAndSale, sourceId, *m_dataStore,
       [&] (const auto& timeAndSale) {
         m_dataStore->Store(timeAndSale);
         m_timeAndSaleSubscriptions.Publish(timeAndSale,
           [&] (const auto& clients) {
-            Beam::Services::BroadcastRecordMessage<TimeAndSaleMessage>(clients,
-              timeAndSale);
+            BroadcastMarketDataMessage<TimeAndSaleMessage>(clients,
+              timeAndSale, m_backloggedClients);
           });
       });
   }
 
-  template<typename C, typename R, typename D, typename A>
-  void MarketDataRegistryServlet<C, R, D, A>::Clear(int sourceId) {
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::Clear(int sourceId) {
     m_registry->Clear(sourceId);
   }
 
-  template<typename C, typename R, typename D, typename A>
-  void MarketDataRegistryServlet<C, R, D, A>::RegisterServices(
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::RegisterServices(
       Beam::Out<Beam::Services::ServiceSlots<ServiceProtocolClient>> slots) {
     Queries::RegisterQueryTypes(Beam::Store(slots->GetRegistry()));
     RegisterMarketDataRegistryServices(Beam::Store(slots));
@@ -292,16 +356,32 @@ namespace Nexus::MarketDataService {
     LoadSecurityTechnicalsService::AddSlot(Store(slots), std::bind(
       &MarketDataRegistryServlet::OnLoadSecurityTechnicals, this,
       std::placeholders::_1, std::placeholders::_2));
+    LoadSecuritySnapshotsService::AddSlot(Store(slots), std::bind(
+      &MarketDataRegistryServlet::OnLoadSecuritySnapshots, this,
+      std::placeholders::_1, std::placeholders::_2));
+    LoadSecurityTechnicalsListService::AddSlot(Store(slots), std::bind(
+      &MarketDataRegistryServlet::OnLoadSecurityTechnicalsList, this,
+      std::placeholders::_1, std::placeholders::_2));
     LoadSecurityInfoService::AddSlot(Store(slots), std::bind(
       &MarketDataRegistryServlet::OnLoadSecurityInfo, this,
       std::placeholders::_1, std::placeholders::_2));
     LoadSecurityInfoFromPrefixService::AddSlot(Store(slots), std::bind(
       &MarketDataRegistryServlet::OnLoadSecurityInfoFromPrefix, this,
       std::placeholders::_1, std::placeholders::_2));
+    LoadSecurityInfoPageFromPrefixService::AddSlot(Store(slots), std::bind(
+      &MarketDataRegistryServlet::OnLoadSecurityInfoPageFromPrefix, this,
+      std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
+      std::placeholders::_4));
+    SetConflationPolicyService::AddSlot(Store(slots), std::bind(
+      &MarketDataRegistryServlet::OnSetConflationPolicy, this,
+      std::placeholders::_1, std::placeholders::_2));
+    SetSecurityConflationPolicyService::AddSlot(Store(slots), std::bind(
+      &MarketDataRegistryServlet::OnSetSecurityConflationPolicy, this,
+      std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
   }
 
-  template<typename C, typename R, typename D, typename A>
-  void MarketDataRegistryServlet<C, R, D, A>::HandleClientAccepted(
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::HandleClientAccepted(
       ServiceProtocolClient& client) {
     auto& session = client.GetSession();
     session.m_roles = m_administrationClient->LoadAccountRoles(
@@ -321,27 +401,60 @@ namespace Nexus::MarketDataService {
     }
   }
 
-  template<typename C, typename R, typename D, typename A>
-  void MarketDataRegistryServlet<C, R, D, A>::HandleClientClosed(
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::HandleClientClosed(
       ServiceProtocolClient& client) {
     m_orderImbalanceSubscriptions.RemoveAll(client);
     m_bboQuoteSubscriptions.RemoveAll(client);
     m_marketQuoteSubscriptions.RemoveAll(client);
     m_bookQuoteSubscriptions.RemoveAll(client);
     m_timeAndSaleSubscriptions.RemoveAll(client);
+    RemoveConflatedClient(m_backloggedClients, client);
   }
 
-  template<typename C, typename R, typename D, typename A>
-  void MarketDataRegistryServlet<C, R, D, A>::Close() {
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::Close() {
     if(m_openState.SetClosing()) {
       return;
     }
+    m_flushTimer->Cancel();
+    m_maintenanceTimer->Cancel();
+    m_flushTasks.Break();
+    m_flushTasks.Wait();
+    m_maintenanceTasks.Break();
+    m_maintenanceTasks.Wait();
     m_dataStore->Close();
     m_openState.Close();
   }
 
-  template<typename C, typename R, typename D, typename A>
-  void MarketDataRegistryServlet<C, R, D, A>::OnQueryOrderImbalances(
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::OnFlushTimer(
+      Beam::Threading::Timer::Result result) {
+    if(result != Beam::Threading::Timer::Result::EXPIRED) {
+      return;
+    }
+    FlushConflatedClients(m_backloggedClients,
+      boost::posix_time::microsec_clock::universal_time());
+    m_flushTimer->Start();
+  }
+
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::OnMaintenanceTimer(
+      Beam::Threading::Timer::Result result) {
+    if(result != Beam::Threading::Timer::Result::EXPIRED) {
+      return;
+    }
+    m_registry->UpdateSearchRanks();
+    if(boost::posix_time::microsec_clock::universal_time() >=
+        m_preloadExpiry) {
+      m_registry->ReleasePreload();
+      m_preloadExpiry = boost::posix_time::pos_infin;
+    }
+    m_maintenanceTimer->Start();
+  }
+
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::OnQueryOrderImbalances(
       Beam::Services::RequestToken<ServiceProtocolClient,
       QueryOrderImbalancesService>& request, const MarketWideDataQuery& query) {
     auto& session = request.GetSession();
@@ -364,14 +477,14 @@ namespace Nexus::MarketDataService {
       });
   }
 
-  template<typename C, typename R, typename D, typename A>
-  void MarketDataRegistryServlet<C, R, D, A>::OnEndOrderImbalanceQuery(
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::OnEndOrderImbalanceQuery(
       ServiceProtocolClient& client, MarketCode market, int id) {
     m_orderImbalanceSubscriptions.End(market, id);
   }
 
-  template<typename C, typename R, typename D, typename A>
-  void MarketDataRegistryServlet<C, R, D, A>::OnQueryBboQuotes(
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::OnQueryBboQuotes(
       Beam::Services::RequestToken<ServiceProtocolClient,
       QueryBboQuotesService>& request, const SecurityMarketDataQuery& query) {
     auto& session = request.GetSession();
@@ -393,14 +506,14 @@ namespace Nexus::MarketDataService {
       });
   }
 
-  template<typename C, typename R, typename D, typename A>
-  void MarketDataRegistryServlet<C, R, D, A>::OnEndBboQuoteQuery(
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::OnEndBboQuoteQuery(
       ServiceProtocolClient& client, const Security& security, int id) {
     m_bboQuoteSubscriptions.End(security, id);
   }
 
-  template<typename C, typename R, typename D, typename A>
-  void MarketDataRegistryServlet<C, R, D, A>::OnQueryBookQuotes(
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::OnQueryBookQuotes(
       Beam::Services::RequestToken<ServiceProtocolClient,
       QueryBookQuotesService>& request, const SecurityMarketDataQuery& query) {
     auto& session = request.GetSession();
@@ -422,14 +535,14 @@ namespace Nexus::MarketDataService {
       });
   }
 
-  template<typename C, typename R, typename D, typename A>
-  void MarketDataRegistryServlet<C, R, D, A>::OnEndBookQuoteQuery(
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::OnEndBookQuoteQuery(
       ServiceProtocolClient& client, const Security& security, int id) {
     m_bookQuoteSubscriptions.End(security, id);
   }
 
-  template<typename C, typename R, typename D, typename A>
-  void MarketDataRegistryServlet<C, R, D, A>::OnQueryMarketQuotes(
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::OnQueryMarketQuotes(
       Beam::Services::RequestToken<ServiceProtocolClient,
       QueryMarketQuotesService>& request,
       const SecurityMarketDataQuery& query) {
@@ -452,14 +565,14 @@ namespace Nexus::MarketDataService {
       });
   }
 
-  template<typename C, typename R, typename D, typename A>
-  void MarketDataRegistryServlet<C, R, D, A>::OnEndMarketQuoteQuery(
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::OnEndMarketQuoteQuery(
       ServiceProtocolClient& client, const Security& security, int id) {
     m_marketQuoteSubscriptions.End(security, id);
   }
 
-  template<typename C, typename R, typename D, typename A>
-  void MarketDataRegistryServlet<C, R, D, A>::OnQueryTimeAndSales(
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::OnQueryTimeAndSales(
       Beam::Services::RequestToken<ServiceProtocolClient,
       QueryTimeAndSalesService>& request,
       const SecurityMarketDataQuery& query) {
@@ -482,56 +595,26 @@ namespace Nexus::MarketDataService {
       });
   }
 
-  template<typename C, typename R, typename D, typename A>
-  void MarketDataRegistryServlet<C, R, D, A>::OnEndTimeAndSaleQuery(
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::OnEndTimeAndSaleQuery(
       ServiceProtocolClient& client, const Security& security, int id) {
     m_timeAndSaleSubscriptions.End(security, id);
   }
 
-  template<typename C, typename R, typename D, typename A>
-  SecuritySnapshot MarketDataRegistryServlet<C, R, D, A>::
+  template<typename C, typename R, typename D, typename A, typename T>
+  SecuritySnapshot MarketDataRegistryServlet<C, R, D, A, T>::
       OnLoadSecuritySnapshot(ServiceProtocolClient& client,
       const Security& security) {
-    auto& session = client.GetSession();
     auto securitySnapshot = m_registry->FindSnapshot(security);
     if(!securitySnapshot.is_initialized()) {
       return SecuritySnapshot();
     }
-    if(!HasEntitlement(session, security.GetMarket(),
-        MarketDataType::BBO_QUOTE)) {
-      securitySnapshot->m_bboQuote = SequencedBboQuote();
-    }
-    if(!HasEntitlement(session, security.GetMarket(),
-        MarketDataType::TIME_AND_SALE)) {
-      securitySnapshot->m_timeAndSale = SequencedTimeAndSale();
-    }
-    if(!HasEntitlement(session, security.GetMarket(),
-        MarketDataType::MARKET_QUOTE)) {
-      securitySnapshot->m_marketQuotes.clear();
-    }
-    auto askEndRange = std::remove_if(securitySnapshot->m_askBook.begin(),
-      securitySnapshot->m_askBook.end(),
-      [&] (auto& bookQuote) {
-        return !HasEntitlement(session,
-          EntitlementKey(security.GetMarket(), bookQuote->m_market),
-          MarketDataType::BOOK_QUOTE);
-      });
-    securitySnapshot->m_askBook.erase(askEndRange,
-      securitySnapshot->m_askBook.end());
-    auto bidEndRange = std::remove_if(securitySnapshot->m_bidBook.begin(),
-      securitySnapshot->m_bidBook.end(),
-      [&] (auto& bookQuote) {
-        return !HasEntitlement(session,
-          EntitlementKey(security.GetMarket(), bookQuote->m_market),
-          MarketDataType::BOOK_QUOTE);
-      });
-    securitySnapshot->m_bidBook.erase(bidEndRange,
-      securitySnapshot->m_bidBook.end());
+    FilterSnapshot(client.GetSession(), security, *securitySnapshot);
     return *securitySnapshot;
   }
 
-  template<typename C, typename R, typename D, typename A>
-  SecurityTechnicals MarketDataRegistryServlet<C, R, D, A>::
+  template<typename C, typename R, typename D, typename A, typename T>
+  SecurityTechnicals MarketDataRegistryServlet<C, R, D, A, T>::
       OnLoadSecurityTechnicals(ServiceProtocolClient& client,
       const Security& security) {
     if(auto securityTechnicals = m_registry->FindSecurityTechnicals(security)) {
@@ -540,19 +623,89 @@ namespace Nexus::MarketDataService {
     return {};
   }
 
-  template<typename C, typename R, typename D, typename A>
-  boost::optional<SecurityInfo> MarketDataRegistryServlet<C, R, D, A>::
+  template<typename C, typename R, typename D, typename A, typename T>
+  std::vector<SecuritySnapshot> MarketDataRegistryServlet<C, R, D, A, T>::
+      OnLoadSecuritySnapshots(ServiceProtocolClient& client,
+      const std::vector<Security>& securities) {
+    auto& session = client.GetSession();
+    auto snapshots = std::vector<SecuritySnapshot>();
+    snapshots.reserve(securities.size());
+    auto i = securities.begin();
+    for(auto& securitySnapshot : m_registry->FindSnapshots(securities)) {
+      if(securitySnapshot.is_initialized()) {
+        FilterSnapshot(session, *i, *securitySnapshot);
+        snapshots.push_back(std::move(*securitySnapshot));
+      } else {
+        snapshots.emplace_back();
+      }
+      ++i;
+    }
+    return snapshots;
+  }
+
+  template<typename C, typename R, typename D, typename A, typename T>
+  std::vector<SecurityTechnicals> MarketDataRegistryServlet<C, R, D, A, T>::
+      OnLoadSecurityTechnicalsList(ServiceProtocolClient& client,
+      const std::vector<Security>& securities) {
+    auto technicals = std::vector<SecurityTechnicals>();
+    technicals.reserve(securities.size());
+    for(auto& securityTechnicals :
+        m_registry->FindSecurityTechnicals(securities)) {
+      technicals.push_back(securityTechnicals.value_or(SecurityTechnicals()));
+    }
+    return technicals;
+  }
+
+  template<typename C, typename R, typename D, typename A, typename T>
+  boost::optional<SecurityInfo> MarketDataRegistryServlet<C, R, D, A, T>::
       OnLoadSecurityInfo(ServiceProtocolClient& client,
       const Security& security) {
     return m_dataStore->LoadSecurityInfo(security);
   }
 
-  template<typename C, typename R, typename D, typename A>
-  std::vector<SecurityInfo> MarketDataRegistryServlet<C, R, D, A>::
+  template<typename C, typename R, typename D, typename A, typename T>
+  std::vector<SecurityInfo> MarketDataRegistryServlet<C, R, D, A, T>::
       OnLoadSecurityInfoFromPrefix(ServiceProtocolClient& client,
       const std::string& prefix) {
-    return m_registry->SearchSecurityInfo(prefix);
+    return m_registry->SearchSecurityInfo(prefix, Security(),
+      DEFAULT_SECURITY_INFO_PAGE_SIZE);
   }
+
+  template<typename C, typename R, typename D, typename A, typename T>
+  std::vector<SecurityInfo> MarketDataRegistryServlet<C, R, D, A, T>::
+      OnLoadSecurityInfoPageFromPrefix(ServiceProtocolClient& client,
+      const std::string& prefix, const Security& start, int count) {
+    return m_registry->SearchSecurityInfo(prefix, start,
+      std::min(count, MAX_SECURITY_INFO_PAGE_SIZE));
+  }
+
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::OnSetConflationPolicy(
+      ServiceProtocolClient& client, const ConflationPolicy& policy) {
+    auto& buffer = client.GetSession().m_conflationBuffer;
+    buffer.SetPolicy(policy);
+    if(!policy.IsEnabled()) {
+      auto lock = std::lock_guard(buffer.GetSendMutex());
+      buffer.Flush([&] (const auto& value) {
+        SendConflatedMarketDataMessage(client, value);
+      });
+    }
+  }
+
+  template<typename C, typename R, typename D, typename A, typename T>
+  void MarketDataRegistryServlet<C, R, D, A, T>::OnSetSecurityConflationPolicy(
+      ServiceProtocolClient& client, const Security& security,
+      const ConflationPolicy& policy) {
+    auto& buffer = client.GetSession().m_conflationBuffer;
+    buffer.SetPolicy(security, policy);
+    if(!policy.IsEnabled()) {
+      auto lock = std::lock_guard(buffer.GetSendMutex());
+      buffer.Flush([&] (const auto& value) {
+        SendConflatedMarketDataMessage(client, value);
+      });
+    }
+  }
+
 }
 
 #endif
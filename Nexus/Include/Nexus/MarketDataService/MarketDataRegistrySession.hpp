@@ -1,9 +1,13 @@
 #ifndef NEXUS_MARKET_DATA_REGISTRY_SESSION_HPP
 #define NEXUS_MARKET_DATA_REGISTRY_SESSION_HPP
+#include <algorithm>
+#include <functional>
 #include <Beam/ServiceLocator/AuthenticatedSession.hpp>
 #include "Nexus/AdministrationService/AccountRoles.hpp"
+#include "Nexus/MarketDataService/ConflationBuffer.hpp"
 #include "Nexus/MarketDataService/EntitlementSet.hpp"
 #include "Nexus/MarketDataService/MarketDataService.hpp"
+#include "Nexus/MarketDataService/SecuritySnapshot.hpp"
 
 namespace Nexus::MarketDataService {
 
@@ -17,6 +21,15 @@ namespace Nexus::MarketDataService {
 
       /** The entitlements granted to the session. */
       EntitlementSet m_entitlements;
+
+      /**
+       * Identifies the sessions that were granted identical entitlements, or
+       * -1 if the session has not been assigned to a group.
+       */
+      int m_entitlementGroup = -1;
+
+      /** Buffers real-time market data when the session requests conflation. */
+      ConflationBuffer m_conflationBuffer;
   };
 
   /**
@@ -60,6 +73,39 @@ namespace Nexus::MarketDataService {
       session.m_roles.Test(AdministrationService::AccountRole::ADMINISTRATOR) ||
       HasEntitlement<T>(session.m_entitlements, query);
   }
+
+  /**
+   * Removes the market data a session is not entitled to from a snapshot.
+   * @param session The session receiving the snapshot.
+   * @param security The Security the snapshot belongs to.
+   * @param snapshot The snapshot to filter.
+   */
+  inline void FilterSnapshot(const MarketDataRegistrySession& session,
+      const Security& security, SecuritySnapshot& snapshot) {
+    if(!HasEntitlement(session, security.GetMarket(),
+        MarketDataType::BBO_QUOTE)) {
+      snapshot.m_bboQuote = SequencedBboQuote();
+    }
+    if(!HasEntitlement(session, security.GetMarket(),
+        MarketDataType::TIME_AND_SALE)) {
+      snapshot.m_timeAndSale = SequencedTimeAndSale();
+    }
+    if(!HasEntitlement(session, security.GetMarket(),
+        MarketDataType::MARKET_QUOTE)) {
+      snapshot.m_marketQuotes.clear();
+    }
+    auto isEntitled = [&] (const auto& bookQuote) {
+      return HasEntitlement(session,
+        EntitlementKey(security.GetMarket(), bookQuote->m_market),
+        MarketDataType::BOOK_QUOTE);
+    };
+    snapshot.m_askBook.erase(std::remove_if(snapshot.m_askBook.begin(),
+      snapshot.m_askBook.end(), std::not_fn(isEntitled)),
+      snapshot.m_askBook.end());
+    snapshot.m_bidBook.erase(std::remove_if(snapshot.m_bidBook.begin(),
+      snapshot.m_bidBook.end(), std::not_fn(isEntitled)),
+      snapshot.m_bidBook.end());
+  }
 }
 
 #endif
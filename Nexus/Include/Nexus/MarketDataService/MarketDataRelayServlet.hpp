@@ -1,17 +1,32 @@
 #ifndef NEXUS_MARKET_DATA_RELAY_SERVLET_HPP
 #define NEXUS_MARKET_DATA_RELAY_SERVLET_HPP
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 #include <Beam/Collections/SynchronizedSet.hpp>
 #include <Beam/IO/OpenState.hpp>
 #include <Beam/Pointers/Dereference.hpp>
 #include <Beam/Pointers/LocalPtr.hpp>
 #include <Beam/Queries/IndexedSubscriptions.hpp>
+#include <Beam/Queues/ConverterQueueWriter.hpp>
 #include <Beam/Queues/RoutineTaskQueue.hpp>
 #include <Beam/Services/ServiceProtocolServlet.hpp>
+#include <Beam/Threading/LiveTimer.hpp>
+#include <Beam/Threading/Sync.hpp>
+#include <Beam/Threading/Timer.hpp>
 #include <Beam/Utilities/ResourcePool.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/noncopyable.hpp>
 #include "Nexus/AdministrationService/AdministrationClient.hpp"
+#include "Nexus/MarketDataService/ConflationBuffer.hpp"
 #include "Nexus/MarketDataService/EntitlementDatabase.hpp"
+#include "Nexus/MarketDataService/EntitlementGroups.hpp"
 #include "Nexus/MarketDataService/MarketDataClientUtilities.hpp"
 #include "Nexus/MarketDataService/MarketDataRegistryServices.hpp"
 #include "Nexus/MarketDataService/MarketDataRegistrySession.hpp"
@@ -28,8 +43,9 @@ namespace Nexus::MarketDataService {
    * @param M The type of MarketDataClient connected to the source providing
    *          market data queries.
    * @param A The type of AdministrationClient to use.
+   * @param T The type of Timer used to flush conflated market data.
    */
-  template<typename C, typename M, typename A>
+  template<typename C, typename M, typename A, typename T>
   class MarketDataRelayServlet : private boost::noncopyable {
     public:
       using Container = C;
@@ -44,10 +60,29 @@ namespace Nexus::MarketDataService {
       /** The type of AdministrationClient to use. */
       using AdministrationClient = Beam::GetTryDereferenceType<A>;
 
+      /** The type of Timer used to flush conflated market data. */
+      using Timer = Beam::GetTryDereferenceType<T>;
+
       /** The type of function used to builds MarketDataClients. */
       using MarketDataClientBuilder =
         typename Beam::ResourcePool<MarketDataClient>::ObjectBuilder;
 
+      /** Stores the load observed on one of the upstream real-time clients. */
+      struct RealTimeQueryEntryMetrics {
+
+        /** The number of real-time subscriptions assigned to the client. */
+        int m_subscriptionCount;
+
+        /** The total number of updates published from the client. */
+        std::uint64_t m_messageCount;
+
+        /** The updates per second measured as of the last rebalance. */
+        double m_messageRate;
+
+        /** The number of updates received but not yet published. */
+        int m_queueDepth;
+      };
+
       /**
        * Constructs a MarketDataRelayServlet.
        * @param entitlementDatabase The database of all market data
@@ -60,17 +95,34 @@ namespace Nexus::MarketDataService {
        *        pool.
        * @param maxMarketDataClients The maximum number of MarketDataClients to
        *        pool.
+       * @param rebalanceInterval The interval at which real-time
+       *        subscriptions are rebalanced among the upstream
+       *        MarketDataClients.
+       * @param flushTimer The Timer used to flush conflated market data, its
+       *        period bounds the finest update interval a client can request.
        * @param administrationClient Used to check for entitlements.
        * @param timerThreadPool The thread pool used for timed operations.
        */
-      template<typename AF>
+      template<typename TF, typename AF>
       MarketDataRelayServlet(EntitlementDatabase entitlementDatabase,
         boost::posix_time::time_duration clientTimeout,
         MarketDataClientBuilder marketDataClientBuilder,
         std::size_t minMarketDataClients, std::size_t maxMarketDataClients,
+        boost::posix_time::time_duration rebalanceInterval, TF&& flushTimer,
         AF&& administrationClient,
         Beam::Ref<Beam::Threading::TimerThreadPool> timerThreadPool);
 
+      /** Returns the load observed on each upstream real-time client. */
+      std::vector<RealTimeQueryEntryMetrics>
+        GetRealTimeQueryEntryMetrics() const;
+
+      /**
+       * Moves real-time subscriptions from the most heavily loaded upstream
+       * clients to the least loaded ones based on the message rates observed
+       * since the previous rebalance.
+       */
+      void Rebalance();
+
       void RegisterServices(Beam::Out<Beam::Services::ServiceSlots<
         ServiceProtocolClient>> slots);
 
@@ -84,9 +136,30 @@ namespace Nexus::MarketDataService {
       struct RealTimeQueryEntry {
         std::unique_ptr<MarketDataClient> m_marketDataClient;
         Beam::RoutineTaskQueue m_tasks;
+        std::atomic_int m_subscriptionCount;
+        std::atomic<std::uint64_t> m_messageCount;
+        std::atomic_int m_queueDepth;
+        std::uint64_t m_lastMessageCount;
+        double m_messageRate;
 
         RealTimeQueryEntry(std::unique_ptr<MarketDataClient> marketDataClient);
       };
+      struct RealTimeSubscription {
+        Beam::Threading::Mutex m_mutex;
+        Beam::Threading::Mutex m_publishMutex;
+        RealTimeQueryEntry* m_entry;
+        std::atomic_int m_generation;
+        Beam::Queries::Sequence m_sequence;
+        std::atomic<std::uint64_t> m_messageCount;
+        std::uint64_t m_lastMessageCount;
+        double m_messageRate;
+        std::function<void (RealTimeQueryEntry&, Beam::Queries::Sequence,
+          int)> m_query;
+        std::function<void ()> m_breakQuery;
+
+        RealTimeSubscription(RealTimeQueryEntry& entry,
+          Beam::Queries::Sequence sequence);
+      };
       template<typename T>
       using MarketSubscriptions = Beam::Queries::IndexedSubscriptions<
         T, MarketCode, ServiceProtocolClient>;
@@ -106,14 +179,34 @@ namespace Nexus::MarketDataService {
       RealTimeSubscriptionSet<Security> m_bookQuoteRealTimeSubscriptions;
       RealTimeSubscriptionSet<Security> m_marketQuoteRealTimeSubscriptions;
       RealTimeSubscriptionSet<Security> m_timeAndSaleRealTimeSubscriptions;
-      EntitlementDatabase m_entitlementDatabase;
+      EntitlementGroups m_entitlementGroups;
       Beam::ResourcePool<MarketDataClient> m_marketDataClients;
       Beam::GetOptionalLocalPtr<A> m_administrationClient;
       Beam::IO::OpenState m_openState;
       std::vector<std::unique_ptr<RealTimeQueryEntry>> m_realTimeQueryEntries;
+      Beam::Threading::Sync<std::vector<std::unique_ptr<RealTimeSubscription>>>
+        m_realTimeSubscriptions;
+      mutable Beam::Threading::Mutex m_rebalanceMutex;
+      boost::posix_time::ptime m_lastRebalance;
+      Beam::Threading::LiveTimer m_rebalanceTimer;
+      Beam::RoutineTaskQueue m_rebalanceTasks;
+      Beam::Threading::Sync<std::unordered_set<ServiceProtocolClient*>>
+        m_backloggedClients;
+      Beam::GetOptionalLocalPtr<T> m_flushTimer;
+      Beam::RoutineTaskQueue m_flushTasks;
 
-      template<typename T>
-      RealTimeQueryEntry& GetRealTimeQueryEntry(const T& index);
+      RealTimeQueryEntry& GetRealTimeQueryEntry();
+      std::vector<std::pair<RealTimeSubscription*, RealTimeQueryEntry*>>
+        PlanRebalance();
+      template<typename MarketDataType, typename Query, typename Subscriptions>
+      void QueryRealTime(const typename Query::Index& index,
+        Subscriptions& subscriptions, RealTimeSubscription& subscription,
+        RealTimeQueryEntry& entry, Beam::Queries::Sequence sequence,
+        int generation);
+      void Migrate(RealTimeSubscription& subscription,
+        RealTimeQueryEntry& entry);
+      void OnRebalanceTimer(Beam::Threading::Timer::Result result);
+      void OnFlushTimer(Beam::Threading::Timer::Result result);
       template<typename Service, typename Query, typename Subscriptions,
         typename RealTimeSubscriptions>
       void HandleQueryRequest(Beam::Services::RequestToken<
@@ -128,10 +221,25 @@ namespace Nexus::MarketDataService {
         const Security& security);
       SecurityTechnicals OnLoadSecurityTechnicals(ServiceProtocolClient& client,
         const Security& security);
+      std::vector<SecuritySnapshot> OnLoadSecuritySnapshots(
+        ServiceProtocolClient& client, const std::vector<Security>& securities);
+      std::vector<SecurityTechnicals> OnLoadSecurityTechnicalsList(
+        ServiceProtocolClient& client, const std::vector<Security>& securities);
       boost::optional<SecurityInfo> OnLoadSecurityInfo(
         ServiceProtocolClient& client, const Security& security);
       std::vector<SecurityInfo> OnLoadSecurityInfoFromPrefix(
         ServiceProtocolClient& client, const std::string& prefix);
+      std::vector<SecurityInfo> OnLoadSecurityInfoPageFromPrefix(
+        ServiceProtocolClient& client, const std::string& prefix,
+        const Security& start, int count);
+      void OnSetConflationPolicy(ServiceProtocolClient& client,
+        const ConflationPolicy& policy);
+      void OnSetSecurityConflationPolicy(ServiceProtocolClient& client,
+        const Security& security, const ConflationPolicy& policy);
+      template<typename Index, typename Value, typename Subscriptions>
+      void OnRealTimeQueryUpdate(const Index& index, const Value& value,
+        Subscriptions& subscriptions, RealTimeQueryEntry& entry,
+        RealTimeSubscription& subscription, int generation);
       template<typename Index, typename Value, typename Subscriptions>
       std::enable_if_t<!std::is_same_v<Value, SequencedBookQuote>>
         OnRealTimeUpdate(const Index& index, const Value& value,
@@ -142,45 +250,165 @@ namespace Nexus::MarketDataService {
         Subscriptions& subscriptions);
   };
 
-  template<typename M, typename A>
+  template<typename M, typename A, typename T>
   struct MetaMarketDataRelayServlet {
     using Session = MarketDataRegistrySession;
     static constexpr auto SupportsParallelism = true;
 
     template<typename C>
     struct apply {
-      using type = MarketDataRelayServlet<C, M, A>;
+      using type = MarketDataRelayServlet<C, M, A, T>;
     };
   };
 
-  template<typename C, typename M, typename A>
-  MarketDataRelayServlet<C, M, A>::RealTimeQueryEntry::RealTimeQueryEntry(
+  template<typename C, typename M, typename A, typename T>
+  MarketDataRelayServlet<C, M, A, T>::RealTimeQueryEntry::RealTimeQueryEntry(
     std::unique_ptr<MarketDataClient> marketDataClient)
-    : m_marketDataClient(std::move(marketDataClient)) {}
+    : m_marketDataClient(std::move(marketDataClient)),
+      m_subscriptionCount(0),
+      m_messageCount(0),
+      m_queueDepth(0),
+      m_lastMessageCount(0),
+      m_messageRate(0) {}
+
+  template<typename C, typename M, typename A, typename T>
+  MarketDataRelayServlet<C, M, A, T>::RealTimeSubscription::
+    RealTimeSubscription(RealTimeQueryEntry& entry,
+      Beam::Queries::Sequence sequence)
+    : m_entry(&entry),
+      m_generation(0),
+      m_sequence(sequence),
+      m_messageCount(0),
+      m_lastMessageCount(0),
+      m_messageRate(0) {}
 
-  template<typename C, typename M, typename A>
-  template<typename AF>
-  MarketDataRelayServlet<C, M, A>::MarketDataRelayServlet(
+  template<typename C, typename M, typename A, typename T>
+  template<typename TF, typename AF>
+  MarketDataRelayServlet<C, M, A, T>::MarketDataRelayServlet(
       EntitlementDatabase entitlementDatabase,
       boost::posix_time::time_duration clientTimeout,
       MarketDataClientBuilder marketDataClientBuilder,
       std::size_t minMarketDataClients, std::size_t maxMarketDataClients,
+      boost::posix_time::time_duration rebalanceInterval, TF&& flushTimer,
       AF&& administrationClient,
       Beam::Ref<Beam::Threading::TimerThreadPool> timerThreadPool)
-      : m_entitlementDatabase(entitlementDatabase),
+      : m_entitlementGroups(std::move(entitlementDatabase)),
         m_marketDataClients(clientTimeout, marketDataClientBuilder,
           Beam::Ref(timerThreadPool), minMarketDataClients,
           maxMarketDataClients),
-        m_administrationClient(std::forward<AF>(administrationClient)) {
+        m_administrationClient(std::forward<AF>(administrationClient)),
+        m_lastRebalance(boost::posix_time::microsec_clock::universal_time()),
+        m_rebalanceTimer(rebalanceInterval, Beam::Ref(timerThreadPool)),
+        m_flushTimer(std::forward<TF>(flushTimer)) {
     for(auto i = std::size_t(0); i < boost::thread::hardware_concurrency();
         ++i) {
       m_realTimeQueryEntries.emplace_back(
         std::make_unique<RealTimeQueryEntry>(marketDataClientBuilder()));
     }
+    m_rebalanceTimer.GetPublisher().Monitor(
+      m_rebalanceTasks.GetSlot<Beam::Threading::Timer::Result>(
+      std::bind(&MarketDataRelayServlet::OnRebalanceTimer, this,
+      std::placeholders::_1)));
+    m_rebalanceTimer.Start();
+    m_flushTimer->GetPublisher().Monitor(
+      m_flushTasks.GetSlot<Beam::Threading::Timer::Result>(
+      std::bind(&MarketDataRelayServlet::OnFlushTimer, this,
+      std::placeholders::_1)));
+    m_flushTimer->Start();
+  }
+
+  template<typename C, typename M, typename A, typename T>
+  std::vector<typename MarketDataRelayServlet<C, M, A, T>::
+      RealTimeQueryEntryMetrics> MarketDataRelayServlet<C, M, A, T>::
+      GetRealTimeQueryEntryMetrics() const {
+    auto metrics = std::vector<RealTimeQueryEntryMetrics>();
+    auto lock = std::lock_guard(m_rebalanceMutex);
+    for(auto& entry : m_realTimeQueryEntries) {
+      metrics.push_back({entry->m_subscriptionCount.load(),
+        entry->m_messageCount.load(), entry->m_messageRate,
+        entry->m_queueDepth.load()});
+    }
+    return metrics;
+  }
+
+  template<typename C, typename M, typename A, typename T>
+  void MarketDataRelayServlet<C, M, A, T>::Rebalance() {
+    auto migrations = PlanRebalance();
+    for(auto& migration : migrations) {
+      Migrate(*migration.first, *migration.second);
+    }
   }
 
-  template<typename C, typename M, typename A>
-  void MarketDataRelayServlet<C, M, A>::RegisterServices(
+  template<typename C, typename M, typename A, typename T>
+  std::vector<std::pair<
+      typename MarketDataRelayServlet<C, M, A, T>::RealTimeSubscription*,
+      typename MarketDataRelayServlet<C, M, A, T>::RealTimeQueryEntry*>>
+      MarketDataRelayServlet<C, M, A, T>::PlanRebalance() {
+    auto migrations = std::vector<
+      std::pair<RealTimeSubscription*, RealTimeQueryEntry*>>();
+    auto lock = std::lock_guard(m_rebalanceMutex);
+    auto currentTime = boost::posix_time::microsec_clock::universal_time();
+    auto elapsed = std::max(1.0, static_cast<double>(
+      (currentTime - m_lastRebalance).total_milliseconds())) / 1000;
+    m_lastRebalance = currentTime;
+    for(auto& entry : m_realTimeQueryEntries) {
+      auto messageCount = entry->m_messageCount.load();
+      entry->m_messageRate =
+        (messageCount - entry->m_lastMessageCount) / elapsed;
+      entry->m_lastMessageCount = messageCount;
+    }
+    auto loads = std::unordered_map<RealTimeQueryEntry*, double>();
+    auto assignments = std::unordered_map<RealTimeQueryEntry*,
+      std::vector<RealTimeSubscription*>>();
+    for(auto& entry : m_realTimeQueryEntries) {
+      loads[entry.get()] = 0;
+    }
+    Beam::Threading::With(m_realTimeSubscriptions, [&] (auto& subscriptions) {
+      for(auto& subscription : subscriptions) {
+        auto messageCount = subscription->m_messageCount.load();
+        subscription->m_messageRate =
+          (messageCount - subscription->m_lastMessageCount) / elapsed;
+        subscription->m_lastMessageCount = messageCount;
+        auto subscriptionLock = std::lock_guard(subscription->m_mutex);
+        loads[subscription->m_entry] += subscription->m_messageRate;
+        assignments[subscription->m_entry].push_back(subscription.get());
+      }
+    });
+    for(auto i = std::size_t(0); i != m_realTimeQueryEntries.size(); ++i) {
+      auto [lightest, heaviest] = std::minmax_element(loads.begin(),
+        loads.end(), [] (const auto& left, const auto& right) {
+          return left.second < right.second;
+        });
+      auto imbalance = heaviest->second - lightest->second;
+      if(imbalance <= 0) {
+        break;
+      }
+      auto& candidates = assignments[heaviest->first];
+      auto candidate = std::max_element(candidates.begin(), candidates.end(),
+        [&] (auto left, auto right) {
+          auto leftRate = left->m_messageRate < imbalance ?
+            left->m_messageRate : 0;
+          auto rightRate = right->m_messageRate < imbalance ?
+            right->m_messageRate : 0;
+          return leftRate < rightRate;
+        });
+      if(candidate == candidates.end() ||
+          (*candidate)->m_messageRate >= imbalance ||
+          (*candidate)->m_messageRate <= 0) {
+        break;
+      }
+      auto subscription = *candidate;
+      candidates.erase(candidate);
+      heaviest->second -= subscription->m_messageRate;
+      lightest->second += subscription->m_messageRate;
+      assignments[lightest->first].push_back(subscription);
+      migrations.emplace_back(subscription, lightest->first);
+    }
+    return migrations;
+  }
+
+  template<typename C, typename M, typename A, typename T>
+  void MarketDataRelayServlet<C, M, A, T>::RegisterServices(
       Beam::Out<Beam::Services::ServiceSlots<ServiceProtocolClient>> slots) {
     Queries::RegisterQueryTypes(Beam::Store(slots->GetRegistry()));
     RegisterMarketDataRegistryServices(Beam::Store(slots));
@@ -251,68 +479,172 @@ namespace Nexus::MarketDataService {
     LoadSecurityTechnicalsService::AddSlot(Store(slots), std::bind(
       &MarketDataRelayServlet::OnLoadSecurityTechnicals, this,
       std::placeholders::_1, std::placeholders::_2));
+    LoadSecuritySnapshotsService::AddSlot(Store(slots), std::bind(
+      &MarketDataRelayServlet::OnLoadSecuritySnapshots, this,
+      std::placeholders::_1, std::placeholders::_2));
+    LoadSecurityTechnicalsListService::AddSlot(Store(slots), std::bind(
+      &MarketDataRelayServlet::OnLoadSecurityTechnicalsList, this,
+      std::placeholders::_1, std::placeholders::_2));
     LoadSecurityInfoService::AddSlot(Store(slots), std::bind(
       &MarketDataRelayServlet::OnLoadSecurityInfo, this, std::placeholders::_1,
       std::placeholders::_2));
     LoadSecurityInfoFromPrefixService::AddSlot(Store(slots), std::bind(
       &MarketDataRelayServlet::OnLoadSecurityInfoFromPrefix, this,
       std::placeholders::_1, std::placeholders::_2));
+    LoadSecurityInfoPageFromPrefixService::AddSlot(Store(slots), std::bind(
+      &MarketDataRelayServlet::OnLoadSecurityInfoPageFromPrefix, this,
+      std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
+      std::placeholders::_4));
+    SetConflationPolicyService::AddSlot(Store(slots), std::bind(
+      &MarketDataRelayServlet::OnSetConflationPolicy, this,
+      std::placeholders::_1, std::placeholders::_2));
+    SetSecurityConflationPolicyService::AddSlot(Store(slots), std::bind(
+      &MarketDataRelayServlet::OnSetSecurityConflationPolicy, this,
+      std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
   }
 
-  template<typename C, typename M, typename A>
-  void MarketDataRelayServlet<C, M, A>::HandleClientAccepted(
+  template<typename C, typename M, typename A, typename T>
+  void MarketDataRelayServlet<C, M, A, T>::HandleClientAccepted(
       ServiceProtocolClient& client) {
     auto& session = client.GetSession();
     session.m_roles = m_administrationClient->LoadAccountRoles(
       session.GetAccount());
-    auto& entitlements = m_entitlementDatabase.GetEntries();
-    auto accountEntitlements = m_administrationClient->LoadEntitlements(
-      session.GetAccount());
-    for(auto& entitlement : entitlements) {
-      auto entryIterator = std::find(accountEntitlements.begin(),
-        accountEntitlements.end(), entitlement.m_groupEntry);
-      if(entryIterator != accountEntitlements.end()) {
-        for(auto& applicability : entitlement.m_applicability) {
-          session.m_entitlements.GrantEntitlement(applicability.first,
-            applicability.second);
-        }
-      }
-    }
+    m_entitlementGroups.Grant(session,
+      m_administrationClient->LoadEntitlements(session.GetAccount()));
   }
 
-  template<typename C, typename M, typename A>
-  void MarketDataRelayServlet<C, M, A>::HandleClientClosed(
+  template<typename C, typename M, typename A, typename T>
+  void MarketDataRelayServlet<C, M, A, T>::HandleClientClosed(
       ServiceProtocolClient& client) {
     m_orderImbalanceSubscriptions.RemoveAll(client);
     m_bboQuoteSubscriptions.RemoveAll(client);
     m_marketQuoteSubscriptions.RemoveAll(client);
     m_bookQuoteSubscriptions.RemoveAll(client);
     m_timeAndSaleSubscriptions.RemoveAll(client);
+    RemoveConflatedClient(m_backloggedClients, client);
   }
 
-  template<typename C, typename M, typename A>
-  void MarketDataRelayServlet<C, M, A>::Close() {
+  template<typename C, typename M, typename A, typename T>
+  void MarketDataRelayServlet<C, M, A, T>::Close() {
     if(m_openState.SetClosing()) {
       return;
     }
+    m_rebalanceTimer.Cancel();
+    m_flushTimer->Cancel();
+    m_rebalanceTasks.Break();
+    m_rebalanceTasks.Wait();
+    m_flushTasks.Break();
+    m_flushTasks.Wait();
     for(auto& entry : m_realTimeQueryEntries) {
       entry->m_marketDataClient->Close();
     }
     m_openState.Close();
   }
 
-  template<typename C, typename M, typename A>
-  template<typename T>
-  typename MarketDataRelayServlet<C, M, A>::RealTimeQueryEntry&
-      MarketDataRelayServlet<C, M, A>::GetRealTimeQueryEntry(const T& index) {
-    auto i = std::hash<T>()(index) % m_realTimeQueryEntries.size();
-    return *m_realTimeQueryEntries[i];
+  template<typename C, typename M, typename A, typename T>
+  typename MarketDataRelayServlet<C, M, A, T>::RealTimeQueryEntry&
+      MarketDataRelayServlet<C, M, A, T>::GetRealTimeQueryEntry() {
+    auto lock = std::lock_guard(m_rebalanceMutex);
+    auto entry = std::min_element(m_realTimeQueryEntries.begin(),
+      m_realTimeQueryEntries.end(), [] (auto& left, auto& right) {
+        if(left->m_messageRate != right->m_messageRate) {
+          return left->m_messageRate < right->m_messageRate;
+        }
+        return left->m_subscriptionCount.load() <
+          right->m_subscriptionCount.load();
+      });
+    return **entry;
   }
 
-  template<typename C, typename M, typename A>
+  template<typename C, typename M, typename A, typename T>
+  template<typename MarketDataType, typename Query, typename Subscriptions>
+  void MarketDataRelayServlet<C, M, A, T>::QueryRealTime(
+      const typename Query::Index& index, Subscriptions& subscriptions,
+      RealTimeSubscription& subscription, RealTimeQueryEntry& queryEntry,
+      Beam::Queries::Sequence sequence, int generation) {
+    auto realTimeQuery = Query();
+    realTimeQuery.SetIndex(index);
+    realTimeQuery.SetInterruptionPolicy(
+      Beam::Queries::InterruptionPolicy::RECOVER_DATA);
+    realTimeQuery.SetRange(sequence, Beam::Queries::Sequence::Last());
+    auto queue = Beam::MakeConverterQueueWriter<MarketDataType>(
+      queryEntry.m_tasks.template GetSlot<MarketDataType>(
+      std::bind(&MarketDataRelayServlet::OnRealTimeQueryUpdate<
+      typename Query::Index, MarketDataType, Subscriptions>, this, index,
+      std::placeholders::_1, std::ref(subscriptions), std::ref(queryEntry),
+      std::ref(subscription), generation)),
+      [&queryEntry, &subscription, generation] (const MarketDataType& value) {
+        if(subscription.m_generation != generation) {
+          BOOST_THROW_EXCEPTION(Beam::PipeBrokenException());
+        }
+        ++queryEntry.m_queueDepth;
+        return value;
+      });
+    {
+      auto lock = std::lock_guard(subscription.m_mutex);
+      subscription.m_breakQuery = [=] {
+        queue->Break();
+      };
+    }
+    QueryMarketDataClient(*queryEntry.m_marketDataClient, realTimeQuery,
+      queue);
+  }
+
+  template<typename C, typename M, typename A, typename T>
+  void MarketDataRelayServlet<C, M, A, T>::Migrate(
+      RealTimeSubscription& subscription, RealTimeQueryEntry& entry) {
+    auto sequence = Beam::Queries::Sequence();
+    auto generation = 0;
+    auto breakQuery = std::function<void ()>();
+    {
+      auto lock = std::lock_guard(subscription.m_mutex);
+      if(subscription.m_entry == &entry) {
+        return;
+      }
+      --subscription.m_entry->m_subscriptionCount;
+      ++entry.m_subscriptionCount;
+      subscription.m_entry = &entry;
+      generation = ++subscription.m_generation;
+      sequence = subscription.m_sequence;
+      breakQuery = std::move(subscription.m_breakQuery);
+    }
+
+    // Breaking the previous query's queue stops it from forwarding updates
+    // and has the upstream client end that query on its next publish, any
+    // updates it already queued are discarded by the generation check. The
+    // new query resumes from the sequence captured above and is issued
+    // without holding the subscription's lock.
+    if(breakQuery) {
+      breakQuery();
+    }
+    subscription.m_query(entry, sequence, generation);
+  }
+
+  template<typename C, typename M, typename A, typename T>
+  void MarketDataRelayServlet<C, M, A, T>::OnRebalanceTimer(
+      Beam::Threading::Timer::Result result) {
+    if(result != Beam::Threading::Timer::Result::EXPIRED) {
+      return;
+    }
+    Rebalance();
+    m_rebalanceTimer.Start();
+  }
+
+  template<typename C, typename M, typename A, typename T>
+  void MarketDataRelayServlet<C, M, A, T>::OnFlushTimer(
+      Beam::Threading::Timer::Result result) {
+    if(result != Beam::Threading::Timer::Result::EXPIRED) {
+      return;
+    }
+    FlushConflatedClients(m_backloggedClients,
+      boost::posix_time::microsec_clock::universal_time());
+    m_flushTimer->Start();
+  }
+
+  template<typename C, typename M, typename A, typename T>
   template<typename Service, typename Query, typename Subscriptions,
     typename RealTimeSubscriptions>
-  void MarketDataRelayServlet<C, M, A>::HandleQueryRequest(
+  void MarketDataRelayServlet<C, M, A, T>::HandleQueryRequest(
       Beam::Services::RequestToken<ServiceProtocolClient, Service>& request,
       const Query& query, Subscriptions& subscriptions,
       RealTimeSubscriptions& realTimeSubscriptions) {
@@ -331,7 +663,7 @@ namespace Nexus::MarketDataService {
         request.GetClient(), Beam::Queries::Range::Total(), std::move(filter));
       realTimeSubscriptions.TestAndSet(query.GetIndex(),
         [&] {
-          auto& queryEntry = GetRealTimeQueryEntry(query.GetIndex());
+          auto& queryEntry = GetRealTimeQueryEntry();
           auto initialValueQuery = Query();
           initialValueQuery.SetIndex(query.GetIndex());
           initialValueQuery.SetRange(Beam::Queries::Sequence::First(),
@@ -351,17 +683,23 @@ namespace Nexus::MarketDataService {
             initialSequence = Beam::Queries::Increment(
               initialValues.back().GetSequence());
           }
-          auto realTimeQuery = Query();
-          realTimeQuery.SetIndex(query.GetIndex());
-          realTimeQuery.SetInterruptionPolicy(
-            Beam::Queries::InterruptionPolicy::RECOVER_DATA);
-          realTimeQuery.SetRange(initialSequence,
-            Beam::Queries::Sequence::Last());
-          QueryMarketDataClient(*queryEntry.m_marketDataClient, realTimeQuery,
-            queryEntry.m_tasks.template GetSlot<MarketDataType>(
-            std::bind(&MarketDataRelayServlet::OnRealTimeUpdate<
-            typename Query::Index, MarketDataType, Subscriptions>, this,
-            query.GetIndex(), std::placeholders::_1, std::ref(subscriptions))));
+          auto subscription = std::make_unique<RealTimeSubscription>(
+            queryEntry, initialSequence);
+          auto& realTimeSubscription = *subscription;
+          realTimeSubscription.m_query =
+            [=, &subscriptions, &realTimeSubscription] (
+                RealTimeQueryEntry& entry, Beam::Queries::Sequence sequence,
+                int generation) {
+              QueryRealTime<MarketDataType, Query>(query.GetIndex(),
+                subscriptions, realTimeSubscription, entry, sequence,
+                generation);
+            };
+          ++queryEntry.m_subscriptionCount;
+          realTimeSubscription.m_query(queryEntry, initialSequence, 0);
+          Beam::Threading::With(m_realTimeSubscriptions,
+            [&] (auto& subscriptions) {
+              subscriptions.push_back(std::move(subscription));
+            });
         });
       auto queue = std::make_shared<Beam::Queue<MarketDataType>>();
       auto client = m_marketDataClients.Acquire();
@@ -385,108 +723,163 @@ namespace Nexus::MarketDataService {
     }
   }
 
-  template<typename C, typename M, typename A>
+  template<typename C, typename M, typename A, typename T>
   template<typename Subscriptions>
-  void MarketDataRelayServlet<C, M, A>::OnEndQuery(
+  void MarketDataRelayServlet<C, M, A, T>::OnEndQuery(
       ServiceProtocolClient& client, const typename Subscriptions::Index& index,
       int id, Subscriptions& subscriptions) {
     subscriptions.End(index, id);
   }
 
-  template<typename C, typename M, typename A>
-  SecuritySnapshot MarketDataRelayServlet<C, M, A>::OnLoadSecuritySnapshot(
+  template<typename C, typename M, typename A, typename T>
+  SecuritySnapshot MarketDataRelayServlet<C, M, A, T>::OnLoadSecuritySnapshot(
       ServiceProtocolClient& client, const Security& security) {
-    auto& session = client.GetSession();
     auto marketDataClient = m_marketDataClients.Acquire();
     auto securitySnapshot = marketDataClient->LoadSecuritySnapshot(security);
-    if(!HasEntitlement(session, security.GetMarket(),
-        MarketDataType::BBO_QUOTE)) {
-      securitySnapshot.m_bboQuote = SequencedBboQuote();
-    }
-    if(!HasEntitlement(session, security.GetMarket(),
-        MarketDataType::TIME_AND_SALE)) {
-      securitySnapshot.m_timeAndSale = SequencedTimeAndSale();
-    }
-    if(!HasEntitlement(session, security.GetMarket(),
-        MarketDataType::MARKET_QUOTE)) {
-      securitySnapshot.m_marketQuotes.clear();
-    }
-    auto askEndRange = std::remove_if(securitySnapshot.m_askBook.begin(),
-      securitySnapshot.m_askBook.end(),
-      [&] (auto& bookQuote) {
-        return !HasEntitlement(session,
-          EntitlementKey(security.GetMarket(), bookQuote->m_market),
-          MarketDataType::BOOK_QUOTE);
-      });
-    securitySnapshot.m_askBook.erase(askEndRange,
-      securitySnapshot.m_askBook.end());
-    auto bidEndRange = std::remove_if(securitySnapshot.m_bidBook.begin(),
-      securitySnapshot.m_bidBook.end(),
-      [&] (auto& bookQuote) {
-        return !HasEntitlement(session,
-          EntitlementKey(security.GetMarket(), bookQuote->m_market),
-          MarketDataType::BOOK_QUOTE);
-      });
-    securitySnapshot.m_bidBook.erase(bidEndRange,
-      securitySnapshot.m_bidBook.end());
+    FilterSnapshot(client.GetSession(), security, securitySnapshot);
     return securitySnapshot;
   }
 
-  template<typename C, typename M, typename A>
-  SecurityTechnicals MarketDataRelayServlet<C, M, A>::OnLoadSecurityTechnicals(
-      ServiceProtocolClient& client, const Security& security) {
+  template<typename C, typename M, typename A, typename T>
+  SecurityTechnicals MarketDataRelayServlet<C, M, A, T>::
+      OnLoadSecurityTechnicals(ServiceProtocolClient& client,
+      const Security& security) {
     auto marketDataClient = m_marketDataClients.Acquire();
     return marketDataClient->LoadSecurityTechnicals(security);
   }
 
-  template<typename C, typename M, typename A>
-  boost::optional<SecurityInfo> MarketDataRelayServlet<C, M, A>::
+  template<typename C, typename M, typename A, typename T>
+  std::vector<SecuritySnapshot> MarketDataRelayServlet<C, M, A, T>::
+      OnLoadSecuritySnapshots(ServiceProtocolClient& client,
+      const std::vector<Security>& securities) {
+    auto& session = client.GetSession();
+    auto marketDataClient = m_marketDataClients.Acquire();
+    auto snapshots = marketDataClient->LoadSecuritySnapshots(securities);
+    for(auto i = std::size_t(0); i != snapshots.size(); ++i) {
+      FilterSnapshot(session, securities[i], snapshots[i]);
+    }
+    return snapshots;
+  }
+
+  template<typename C, typename M, typename A, typename T>
+  std::vector<SecurityTechnicals> MarketDataRelayServlet<C, M, A, T>::
+      OnLoadSecurityTechnicalsList(ServiceProtocolClient& client,
+      const std::vector<Security>& securities) {
+    auto marketDataClient = m_marketDataClients.Acquire();
+    return marketDataClient->LoadSecurityTechnicalsList(securities);
+  }
+
+  template<typename C, typename M, typename A, typename T>
+  boost::optional<SecurityInfo> MarketDataRelayServlet<C, M, A, T>::
       OnLoadSecurityInfo(ServiceProtocolClient& client,
       const Security& security) {
     auto marketDataClient = m_marketDataClients.Acquire();
     return marketDataClient->LoadSecurityInfo(security);
   }
 
-  template<typename C, typename M, typename A>
-  std::vector<SecurityInfo> MarketDataRelayServlet<C, M, A>::
+  template<typename C, typename M, typename A, typename T>
+  std::vector<SecurityInfo> MarketDataRelayServlet<C, M, A, T>::
       OnLoadSecurityInfoFromPrefix(ServiceProtocolClient& client,
       const std::string& prefix) {
     auto marketDataClient = m_marketDataClients.Acquire();
-    return marketDataClient->LoadSecurityInfoFromPrefix(prefix);
+    return marketDataClient->LoadSecurityInfoFromPrefix(prefix, Security(),
+      DEFAULT_SECURITY_INFO_PAGE_SIZE);
+  }
+
+  template<typename C, typename M, typename A, typename T>
+  std::vector<SecurityInfo> MarketDataRelayServlet<C, M, A, T>::
+      OnLoadSecurityInfoPageFromPrefix(ServiceProtocolClient& client,
+      const std::string& prefix, const Security& start, int count) {
+    auto marketDataClient = m_marketDataClients.Acquire();
+    return marketDataClient->LoadSecurityInfoFromPrefix(prefix, start,
+      std::min(count, MAX_SECURITY_INFO_PAGE_SIZE));
+  }
+
+  template<typename C, typename M, typename A, typename T>
+  void MarketDataRelayServlet<C, M, A, T>::OnSetConflationPolicy(
+      ServiceProtocolClient& client, const ConflationPolicy& policy) {
+    auto& buffer = client.GetSession().m_conflationBuffer;
+    buffer.SetPolicy(policy);
+    if(!policy.IsEnabled()) {
+      auto lock = std::lock_guard(buffer.GetSendMutex());
+      buffer.Flush([&] (const auto& value) {
+        SendConflatedMarketDataMessage(client, value);
+      });
+    }
+  }
+
+  template<typename C, typename M, typename A, typename T>
+  void MarketDataRelayServlet<C, M, A, T>::OnSetSecurityConflationPolicy(
+      ServiceProtocolClient& client, const Security& security,
+      const ConflationPolicy& policy) {
+    auto& buffer = client.GetSession().m_conflationBuffer;
+    buffer.SetPolicy(security, policy);
+    if(!policy.IsEnabled()) {
+      auto lock = std::lock_guard(buffer.GetSendMutex());
+      buffer.Flush([&] (const auto& value) {
+        SendConflatedMarketDataMessage(client, value);
+      });
+    }
+  }
+
+  template<typename C, typename M, typename A, typename T>
+  template<typename Index, typename Value, typename Subscriptions>
+  void MarketDataRelayServlet<C, M, A, T>::OnRealTimeQueryUpdate(
+      const Index& index, const Value& value, Subscriptions& subscriptions,
+      RealTimeQueryEntry& entry, RealTimeSubscription& subscription,
+      int generation) {
+    --entry.m_queueDepth;
+
+    // Broadcasts are ordered by the publish mutex so that an update from a
+    // migrated query is never sent ahead of one still being sent from the
+    // previous query, while rebalancing only waits on the state lock.
+    auto publishLock = std::lock_guard(subscription.m_publishMutex);
+    {
+      auto lock = std::lock_guard(subscription.m_mutex);
+      if(subscription.m_generation != generation ||
+          value.GetSequence() < subscription.m_sequence) {
+        return;
+      }
+      subscription.m_sequence = Beam::Queries::Increment(value.GetSequence());
+    }
+    ++subscription.m_messageCount;
+    ++entry.m_messageCount;
+    OnRealTimeUpdate(index, value, subscriptions);
   }
 
-  template<typename C, typename M, typename A>
+  template<typename C, typename M, typename A, typename T>
   template<typename Index, typename Value, typename Subscriptions>
   std::enable_if_t<!std::is_same_v<Value, SequencedBookQuote>>
-      MarketDataRelayServlet<C, M, A>::OnRealTimeUpdate(const Index& index,
+      MarketDataRelayServlet<C, M, A, T>::OnRealTimeUpdate(const Index& index,
       const Value& value, Subscriptions& subscriptions) {
     auto indexedValue = Beam::Queries::SequencedValue(
       Beam::Queries::IndexedValue(*value, index), value.GetSequence());
     subscriptions.Publish(indexedValue,
       [&] (auto& clients) {
-        Beam::Services::BroadcastRecordMessage<
+        BroadcastMarketDataMessage<
           GetMarketDataMessageType<typename Value::Value>>(
-          clients, indexedValue);
+          clients, indexedValue, m_backloggedClients);
       });
   }
 
-  template<typename C, typename M, typename A>
+  template<typename C, typename M, typename A, typename T>
   template<typename Index, typename Value, typename Subscriptions>
   std::enable_if_t<std::is_same_v<Value, SequencedBookQuote>>
-      MarketDataRelayServlet<C, M, A>::OnRealTimeUpdate(const Index& index,
+      MarketDataRelayServlet<C, M, A, T>::OnRealTimeUpdate(const Index& index,
       const Value& value, Subscriptions& subscriptions) {
     auto key = EntitlementKey{index.GetMarket(), value.GetValue().m_market};
     auto indexedValue = Beam::Queries::SequencedValue(
       Beam::Queries::IndexedValue(*value, index), value.GetSequence());
+    auto entitlements = EntitlementGroupCache(key,
+      MarketDataType::BOOK_QUOTE);
     subscriptions.Publish(indexedValue,
       [&] (auto& client) {
-        return HasEntitlement(client.GetSession(), key,
-          MarketDataType::BOOK_QUOTE);
+        return entitlements.HasEntitlement(client.GetSession());
       },
       [&] (auto& clients) {
-        Beam::Services::BroadcastRecordMessage<
+        BroadcastMarketDataMessage<
           GetMarketDataMessageType<typename Value::Value>>(
-          clients, indexedValue);
+          clients, indexedValue, m_backloggedClients);
       });
   }
 }
@@ -7,6 +7,8 @@ namespace Nexus::MarketDataService {
   template<typename D> class AsyncHistoricalDataStore;
   template<typename D> class CachedHistoricalDataStore;
   template<typename C> class ClientHistoricalDataStore;
+  class ConflationBuffer;
+  struct ConflationPolicy;
   template<typename D> class DataStoreMarketDataClient;
   template<typename MarketExpressionType> class DefaultCurrencyExpression;
   class DistributedMarketDataClient;
@@ -25,11 +27,13 @@ namespace Nexus::MarketDataService {
     class MarketDataFeedServlet;
   template<typename MarketDataType> struct MarketDataQueryType;
   class MarketDataRegistry;
-  template<typename C, typename R, typename D, typename A>
+  struct MarketDataRegistryCheckpoint;
+  template<typename R, typename T> class MarketDataRegistryCheckpointer;
+  template<typename C, typename R, typename D, typename A, typename T>
     class MarketDataRegistryServlet;
   class MarketDataRegistrySession;
-  template<typename ContainerType, typename MarketDataClientType,
-    typename AdministrationClientType> class MarketDataRelayServlet;
+  template<typename C, typename M, typename A, typename T>
+    class MarketDataRelayServlet;
   class MarketEntry;
   template<typename MarketDataClientType, typename MarketExpressionType,
     typename TimeRangeExpressionType> class MarketOrderImbalanceExpression;
@@ -25,6 +25,18 @@ namespace MarketDataService {
         Beam::Queries::Sequence m_nextOrderImbalanceSequence;
       };
 
+      /*! \struct Checkpoint
+          \brief Stores the state of a MarketEntry so that it can be restored.
+       */
+      struct Checkpoint {
+
+        //! The market represented.
+        MarketCode m_market;
+
+        //! The next Sequences to use.
+        InitialSequences m_sequences;
+      };
+
       //! Constructs a MarketEntry.
       /*!
         \param market The market represented.
@@ -32,6 +44,12 @@ namespace MarketDataService {
       */
       MarketEntry(MarketCode market, const InitialSequences& initialSequences);
 
+      //! Constructs a MarketEntry from a Checkpoint.
+      /*!
+        \param checkpoint The Checkpoint to restore.
+      */
+      explicit MarketEntry(const Checkpoint& checkpoint);
+
       //! Clears market data that originated from a specified source.
       /*!
         \param sourceId The id of the source to clear.
@@ -47,8 +65,12 @@ namespace MarketDataService {
       boost::optional<SequencedMarketOrderImbalance> PublishOrderImbalance(
         const OrderImbalance& orderImbalance, int sourceId);
 
+      //! Returns a Checkpoint of this entry's state.
+      Checkpoint MakeCheckpoint() const;
+
     private:
       MarketCode m_market;
+      InitialSequences m_nextSequences;
       Beam::Queries::Sequencer m_orderImbalanceSequencer;
   };
 
@@ -80,16 +102,27 @@ namespace MarketDataService {
   inline MarketEntry::MarketEntry(MarketCode market,
       const InitialSequences& initialSequences)
       : m_market{market},
+        m_nextSequences{initialSequences},
         m_orderImbalanceSequencer{
           initialSequences.m_nextOrderImbalanceSequence} {}
 
+  inline MarketEntry::MarketEntry(const Checkpoint& checkpoint)
+    : MarketEntry(checkpoint.m_market, checkpoint.m_sequences) {}
+
   inline void MarketEntry::Clear(int sourceId) {}
 
   inline boost::optional<SequencedMarketOrderImbalance> MarketEntry::
       PublishOrderImbalance(const OrderImbalance& orderImbalance,
       int sourceId) {
-    return m_orderImbalanceSequencer.MakeSequencedValue(orderImbalance,
+    auto value = m_orderImbalanceSequencer.MakeSequencedValue(orderImbalance,
       m_market);
+    m_nextSequences.m_nextOrderImbalanceSequence =
+      Beam::Queries::Increment(value.GetSequence());
+    return value;
+  }
+
+  inline MarketEntry::Checkpoint MarketEntry::MakeCheckpoint() const {
+    return Checkpoint{m_market, m_nextSequences};
   }
 }
 }
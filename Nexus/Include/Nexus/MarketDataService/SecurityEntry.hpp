@@ -26,16 +26,51 @@ namespace MarketDataService {
       struct InitialSequences {
 
         //! The next Sequence to use for a BboQuote.
-        Beam::Queries::Sequence m_nextBboQuoteSequence;
+        Beam::Queries::Sequence m_nextBboQuoteSequence =
+          Beam::Queries::Sequence::First();
 
         //! The next Sequence to use for a BookQuote.
-        Beam::Queries::Sequence m_nextBookQuoteSequence;
+        Beam::Queries::Sequence m_nextBookQuoteSequence =
+          Beam::Queries::Sequence::First();
 
         //! The next Sequence to use for a MarketQuote.
-        Beam::Queries::Sequence m_nextMarketQuoteSequence;
+        Beam::Queries::Sequence m_nextMarketQuoteSequence =
+          Beam::Queries::Sequence::First();
 
         //! The next Sequence to use for a TimeAndSale.
-        Beam::Queries::Sequence m_nextTimeAndSaleSequence;
+        Beam::Queries::Sequence m_nextTimeAndSaleSequence =
+          Beam::Queries::Sequence::First();
+      };
+
+      /*! \struct Checkpoint
+          \brief Stores the state of a SecurityEntry so that it can be
+                 restored.
+       */
+      struct Checkpoint {
+
+        //! The Security represented.
+        Security m_security;
+
+        //! The SecurityTechnicals.
+        SecurityTechnicals m_technicals;
+
+        //! The next Sequences to use.
+        InitialSequences m_sequences;
+
+        //! The most recently published BboQuote.
+        SequencedSecurityBboQuote m_bboQuote;
+
+        //! The most recently published TimeAndSale.
+        SequencedSecurityTimeAndSale m_timeAndSale;
+
+        //! The most recently published MarketQuote of each market.
+        std::vector<SequencedSecurityMarketQuote> m_marketQuotes;
+
+        //! The BookQuotes that are ASKs.
+        std::vector<SequencedSecurityBookQuote> m_askBook;
+
+        //! The BookQuotes that are BIDs.
+        std::vector<SequencedSecurityBookQuote> m_bidBook;
       };
 
       //! Constructs a SecurityEntry.
@@ -47,6 +82,12 @@ namespace MarketDataService {
       SecurityEntry(const Security& security, Money closePrice,
         const InitialSequences& initialSequences);
 
+      //! Constructs a SecurityEntry from a Checkpoint.
+      /*!
+        \param checkpoint The Checkpoint to restore.
+      */
+      explicit SecurityEntry(const Checkpoint& checkpoint);
+
       //! Returns the Security.
       const Security& GetSecurity() const;
 
@@ -106,10 +147,42 @@ namespace MarketDataService {
 
       //! Clears market data that originated from a specified source.
       /*!
-        \param sourceId The id of the source to clear.
+        \param sourceId The id of the source to clear, book levels restored
+               from a Checkpoint are cleared along with it.
       */
       void Clear(int sourceId);
 
+      //! Returns a Checkpoint of this entry's state.
+      Checkpoint MakeCheckpoint() const;
+
+      //! Replays a BboQuote that was published prior to a restart.
+      /*!
+        \param bboQuote The BboQuote to replay.
+      */
+      void Replay(const SequencedBboQuote& bboQuote);
+
+      //! Replays a MarketQuote that was published prior to a restart.
+      /*!
+        \param marketQuote The MarketQuote to replay.
+      */
+      void Replay(const SequencedMarketQuote& marketQuote);
+
+      //! Replays a BookQuote that was published prior to a restart.
+      /*!
+        \param bookQuote The BookQuote to replay, its size is the total
+               size at its price level.
+      */
+      void Replay(const SequencedBookQuote& bookQuote);
+
+      //! Removes every book level restored from a Checkpoint.
+      void ExpireRestoredBook();
+
+      //! Replays a TimeAndSale that was published prior to a restart.
+      /*!
+        \param timeAndSale The TimeAndSale to replay.
+      */
+      void Replay(const SequencedTimeAndSale& timeAndSale);
+
     private:
       struct BookQuoteEntry {
         SequencedSecurityBookQuote m_quote;
@@ -117,7 +190,9 @@ namespace MarketDataService {
 
         BookQuoteEntry(const SequencedSecurityBookQuote& quote, int sourceId);
       };
+      static constexpr auto RESTORED_SOURCE_ID = -1;
       Security m_security;
+      InitialSequences m_nextSequences;
       Beam::Queries::Sequencer m_bboSequencer;
       Beam::Queries::Sequencer m_marketQuoteSequencer;
       Beam::Queries::Sequencer m_bookQuoteSequencer;
@@ -129,6 +204,12 @@ namespace MarketDataService {
         m_marketQuotes;
       std::vector<BookQuoteEntry> m_askBook;
       std::vector<BookQuoteEntry> m_bidBook;
+      bool m_hasRestoredBook;
+
+      static void Advance(Beam::Queries::Sequencer& sequencer,
+        Beam::Queries::Sequence& nextSequence,
+        Beam::Queries::Sequence sequence);
+      void UpdateTechnicals(const TimeAndSale& timeAndSale);
   };
 
   //! Returns the InitialSequences for a SecurityEntry.
@@ -196,13 +277,40 @@ namespace MarketDataService {
   inline SecurityEntry::SecurityEntry(const Security& security,
       Money closePrice, const InitialSequences& initialSequences)
       : m_security{security},
+        m_nextSequences{initialSequences},
         m_bboSequencer{initialSequences.m_nextBboQuoteSequence},
         m_marketQuoteSequencer{initialSequences.m_nextMarketQuoteSequence},
         m_bookQuoteSequencer{initialSequences.m_nextBookQuoteSequence},
-        m_timeAndSaleSequencer{initialSequences.m_nextTimeAndSaleSequence} {
+        m_timeAndSaleSequencer{initialSequences.m_nextTimeAndSaleSequence},
+        m_hasRestoredBook{false} {
     m_technicals.m_close = closePrice;
   }
 
+  inline SecurityEntry::SecurityEntry(const Checkpoint& checkpoint)
+      : m_security{checkpoint.m_security},
+        m_nextSequences{checkpoint.m_sequences},
+        m_bboSequencer{checkpoint.m_sequences.m_nextBboQuoteSequence},
+        m_marketQuoteSequencer{
+          checkpoint.m_sequences.m_nextMarketQuoteSequence},
+        m_bookQuoteSequencer{checkpoint.m_sequences.m_nextBookQuoteSequence},
+        m_timeAndSaleSequencer{
+          checkpoint.m_sequences.m_nextTimeAndSaleSequence},
+        m_technicals{checkpoint.m_technicals},
+        m_bboQuote{checkpoint.m_bboQuote},
+        m_timeAndSale{checkpoint.m_timeAndSale},
+        m_hasRestoredBook{false} {
+    for(auto& marketQuote : checkpoint.m_marketQuotes) {
+      m_marketQuotes[marketQuote->GetValue().m_market] = marketQuote;
+    }
+    for(auto& bookQuote : checkpoint.m_askBook) {
+      m_askBook.emplace_back(bookQuote, RESTORED_SOURCE_ID);
+    }
+    for(auto& bookQuote : checkpoint.m_bidBook) {
+      m_bidBook.emplace_back(bookQuote, RESTORED_SOURCE_ID);
+    }
+    m_hasRestoredBook = !m_askBook.empty() || !m_bidBook.empty();
+  }
+
   inline const Security& SecurityEntry::GetSecurity() const {
     return m_security;
   }
@@ -218,6 +326,8 @@ namespace MarketDataService {
   inline boost::optional<SequencedSecurityBboQuote> SecurityEntry::
       PublishBboQuote(const BboQuote& bboQuote, int sourceId) {
     auto value = m_bboSequencer.MakeSequencedValue(bboQuote, m_security);
+    m_nextSequences.m_nextBboQuoteSequence =
+      Beam::Queries::Increment(value.GetSequence());
     m_bboQuote = value;
     return value;
   }
@@ -226,12 +336,15 @@ namespace MarketDataService {
       PublishMarketQuote(const MarketQuote& marketQuote, int sourceId) {
     auto value = m_marketQuoteSequencer.MakeSequencedValue(marketQuote,
       m_security);
+    m_nextSequences.m_nextMarketQuoteSequence =
+      Beam::Queries::Increment(value.GetSequence());
     m_marketQuotes[marketQuote.m_market] = value;
     return value;
   }
 
   inline boost::optional<SequencedSecurityBookQuote> SecurityEntry::
       UpdateBookQuote(const BookQuote& delta, int sourceId) {
+    ExpireRestoredBook();
     std::vector<BookQuoteEntry>* book;
     if(delta.m_quote.m_side == Side::ASK) {
       book = &m_askBook;
@@ -277,25 +390,18 @@ namespace MarketDataService {
         entry.m_sourceId = sourceId;
       }
     }
+    m_nextSequences.m_nextBookQuoteSequence =
+      Beam::Queries::Increment(entryIterator->m_quote.GetSequence());
     return entryIterator->m_quote;
   }
 
   inline boost::optional<SequencedSecurityTimeAndSale> SecurityEntry::
       PublishTimeAndSale(const TimeAndSale& timeAndSale, int sourceId) {
-    if(m_technicals.m_open == Money::ZERO) {
-      m_technicals.m_open = timeAndSale.m_price;
-    }
-    if(m_technicals.m_high == Money::ZERO ||
-        timeAndSale.m_price > m_technicals.m_high) {
-      m_technicals.m_high = timeAndSale.m_price;
-    }
-    if(m_technicals.m_low == Money::ZERO ||
-        timeAndSale.m_price < m_technicals.m_low) {
-      m_technicals.m_low = timeAndSale.m_price;
-    }
-    m_technicals.m_volume += timeAndSale.m_size;
+    UpdateTechnicals(timeAndSale);
     auto value = m_timeAndSaleSequencer.MakeSequencedValue(
       timeAndSale, m_security);
+    m_nextSequences.m_nextTimeAndSaleSequence =
+      Beam::Queries::Increment(value.GetSequence());
     m_timeAndSale = value;
     return value;
   }
@@ -332,6 +438,7 @@ namespace MarketDataService {
   }
 
   inline void SecurityEntry::Clear(int sourceId) {
+    ExpireRestoredBook();
     auto askRange = std::remove_if(m_askBook.begin(), m_askBook.end(),
       [&] (auto& bookQuoteEntry) {
         return bookQuoteEntry.m_sourceId == sourceId;
@@ -343,6 +450,111 @@ namespace MarketDataService {
       });
     m_bidBook.erase(bidRange, m_bidBook.end());
   }
+
+  inline SecurityEntry::Checkpoint SecurityEntry::MakeCheckpoint() const {
+    auto checkpoint = Checkpoint();
+    checkpoint.m_security = m_security;
+    checkpoint.m_technicals = m_technicals;
+    checkpoint.m_sequences = m_nextSequences;
+    checkpoint.m_bboQuote = m_bboQuote;
+    checkpoint.m_timeAndSale = m_timeAndSale;
+    for(auto& marketQuote : m_marketQuotes) {
+      checkpoint.m_marketQuotes.push_back(marketQuote.second);
+    }
+    for(auto& entry : m_askBook) {
+      if((*entry.m_quote)->m_quote.m_size > 0) {
+        checkpoint.m_askBook.push_back(entry.m_quote);
+      }
+    }
+    for(auto& entry : m_bidBook) {
+      if((*entry.m_quote)->m_quote.m_size > 0) {
+        checkpoint.m_bidBook.push_back(entry.m_quote);
+      }
+    }
+    return checkpoint;
+  }
+
+  inline void SecurityEntry::Replay(const SequencedBboQuote& bboQuote) {
+    m_bboQuote = Beam::Queries::SequencedValue(Beam::Queries::IndexedValue(
+      *bboQuote, m_security), bboQuote.GetSequence());
+    Advance(m_bboSequencer, m_nextSequences.m_nextBboQuoteSequence,
+      bboQuote.GetSequence());
+  }
+
+  inline void SecurityEntry::Replay(const SequencedMarketQuote& marketQuote) {
+    m_marketQuotes[marketQuote->m_market] = Beam::Queries::SequencedValue(
+      Beam::Queries::IndexedValue(*marketQuote, m_security),
+      marketQuote.GetSequence());
+    Advance(m_marketQuoteSequencer, m_nextSequences.m_nextMarketQuoteSequence,
+      marketQuote.GetSequence());
+  }
+
+  inline void SecurityEntry::Replay(const SequencedBookQuote& bookQuote) {
+    auto& book = [&] () -> std::vector<BookQuoteEntry>& {
+      if(bookQuote->m_quote.m_side == Side::ASK) {
+        return m_askBook;
+      }
+      return m_bidBook;
+    }();
+    auto value = Beam::Queries::SequencedValue(Beam::Queries::IndexedValue(
+      *bookQuote, m_security), bookQuote.GetSequence());
+    auto entry = Beam::LinearLowerBound(book.begin(), book.end(), *bookQuote,
+      [] (auto& lhs, auto& rhs) {
+        return BookQuoteListingComparator(**lhs.m_quote, rhs);
+      });
+    if(entry != book.end() &&
+        (*entry->m_quote)->m_quote.m_price == bookQuote->m_quote.m_price &&
+        (*entry->m_quote)->m_mpid == bookQuote->m_mpid) {
+      entry->m_quote = std::move(value);
+      entry->m_sourceId = RESTORED_SOURCE_ID;
+    } else if(bookQuote->m_quote.m_size > 0) {
+      book.emplace(entry, std::move(value), RESTORED_SOURCE_ID);
+    }
+    m_hasRestoredBook = true;
+    Advance(m_bookQuoteSequencer, m_nextSequences.m_nextBookQuoteSequence,
+      bookQuote.GetSequence());
+  }
+
+  inline void SecurityEntry::ExpireRestoredBook() {
+    if(!m_hasRestoredBook) {
+      return;
+    }
+    m_hasRestoredBook = false;
+    Clear(RESTORED_SOURCE_ID);
+  }
+
+  inline void SecurityEntry::Replay(const SequencedTimeAndSale& timeAndSale) {
+    UpdateTechnicals(*timeAndSale);
+    m_timeAndSale = Beam::Queries::SequencedValue(Beam::Queries::IndexedValue(
+      *timeAndSale, m_security), timeAndSale.GetSequence());
+    Advance(m_timeAndSaleSequencer, m_nextSequences.m_nextTimeAndSaleSequence,
+      timeAndSale.GetSequence());
+  }
+
+  inline void SecurityEntry::Advance(Beam::Queries::Sequencer& sequencer,
+      Beam::Queries::Sequence& nextSequence,
+      Beam::Queries::Sequence sequence) {
+    if(sequence < nextSequence) {
+      return;
+    }
+    nextSequence = Beam::Queries::Increment(sequence);
+    sequencer = Beam::Queries::Sequencer(nextSequence);
+  }
+
+  inline void SecurityEntry::UpdateTechnicals(const TimeAndSale& timeAndSale) {
+    if(m_technicals.m_open == Money::ZERO) {
+      m_technicals.m_open = timeAndSale.m_price;
+    }
+    if(m_technicals.m_high == Money::ZERO ||
+        timeAndSale.m_price > m_technicals.m_high) {
+      m_technicals.m_high = timeAndSale.m_price;
+    }
+    if(m_technicals.m_low == Money::ZERO ||
+        timeAndSale.m_price < m_technicals.m_low) {
+      m_technicals.m_low = timeAndSale.m_price;
+    }
+    m_technicals.m_volume += timeAndSale.m_size;
+  }
 }
 }
 
@@ -0,0 +1,526 @@
+#ifndef NEXUS_SECURITY_SEARCH_INDEX_HPP
+#define NEXUS_SECURITY_SEARCH_INDEX_HPP
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <boost/algorithm/string/case_conv.hpp>
+#include "Nexus/Definitions/DefaultMarketDatabase.hpp"
+#include "Nexus/Definitions/Quantity.hpp"
+#include "Nexus/Definitions/Security.hpp"
+#include "Nexus/Definitions/SecurityInfo.hpp"
+#include "Nexus/MarketDataService/MarketDataService.hpp"
+
+namespace Nexus::MarketDataService {
+
+  /**
+   * Indexes SecurityInfo by the prefixes of their symbols and the words in
+   * their names. Every prefix maps to a list of securities kept sorted by
+   * rank so that a page of matches is found with a hash lookup and a binary
+   * search regardless of how many securities share the prefix.
+   */
+  class SecuritySearchIndex {
+    public:
+
+      /**
+       * Stores a copy of an index's postings so that they can be ranked
+       * without holding the index's lock.
+       */
+      class Ranking {
+        public:
+
+          /**
+           * Ranks every Security by its activity, securities with greater
+           * activity are returned first and ties are broken by symbol.
+           * @param activity The activity of each Security, securities not
+           *        listed have no activity.
+           */
+          void Rank(const std::unordered_map<Security, Quantity>& activity);
+
+        private:
+          friend class SecuritySearchIndex;
+          int m_version;
+          std::vector<Security> m_securities;
+          std::vector<std::string> m_symbols;
+          std::vector<int> m_ranks;
+          std::unordered_map<std::string, std::vector<int>> m_symbolPrefixes;
+          std::unordered_map<std::string, std::vector<int>> m_namePrefixes;
+      };
+
+      /** The number of leading characters indexed for each token. */
+      static constexpr auto INDEXED_PREFIX_LENGTH = std::size_t(4);
+
+      /** The shortest prefix that falls back to fuzzy matching. */
+      static constexpr auto MIN_FUZZY_LENGTH = std::size_t(3);
+
+      /** Constructs an empty SecuritySearchIndex. */
+      SecuritySearchIndex() = default;
+
+      /** Returns the number of securities indexed. */
+      std::size_t GetSize() const;
+
+      /**
+       * Returns <code>true</code> iff a Security is indexed.
+       * @param security The Security to test.
+       */
+      bool Contains(const Security& security) const;
+
+      /**
+       * Adds or updates a SecurityInfo.
+       * @param securityInfo The SecurityInfo to index.
+       */
+      void Add(const SecurityInfo& securityInfo);
+
+      /**
+       * Ranks every Security by its activity, securities with greater
+       * activity are returned first and ties are broken by symbol.
+       * @param activity The activity of each Security, securities not listed
+       *        have no activity.
+       */
+      void Rank(const std::unordered_map<Security, Quantity>& activity);
+
+      /** Returns a copy of this index's postings to be ranked. */
+      Ranking MakeRanking() const;
+
+      /**
+       * Replaces this index's ranks and postings with a Ranking.
+       * @param ranking The Ranking to apply.
+       * @return <code>true</code> iff the Ranking was applied, a Ranking made
+       *         before a Security was added or renamed is discarded.
+       */
+      bool Apply(Ranking ranking);
+
+      /**
+       * Returns which group of a search's results a SecurityInfo belongs to.
+       * @param prefix The prefix searched for.
+       * @param securityInfo A SecurityInfo returned by the search.
+       * @return 0 for a symbol match, 1 for a name match and 2 for a match
+       *         one edit away from the <i>prefix</i>.
+       */
+      static int GetMatchGroup(const std::string& prefix,
+        const SecurityInfo& securityInfo);
+
+      /**
+       * Returns a page of SecurityInfo matching a prefix. Symbol matches are
+       * returned first, followed by name matches and finally matches that are
+       * one edit away from the prefix. A page continues from the current rank
+       * of its <i>start</i>, so a page requested after the index is re-ranked
+       * may repeat or skip securities relative to the pages before it.
+       * @param prefix The prefix to search for.
+       * @param start The last Security returned by the previous page, or an
+       *        empty Security to return the first page.
+       * @param count The maximum number of SecurityInfo to return.
+       * @return The page of SecurityInfo matching the <i>prefix</i>, or an
+       *         empty page if the <i>start</i> is not indexed.
+       */
+      std::vector<SecurityInfo> Search(const std::string& prefix,
+        const Security& start, int count) const;
+
+    private:
+      struct Entry {
+        SecurityInfo m_info;
+        std::string m_symbol;
+        std::vector<std::string> m_nameTokens;
+        int m_rank;
+      };
+      using Postings = std::unordered_map<std::string, std::vector<int>>;
+      std::vector<Entry> m_entries;
+      std::unordered_map<Security, int> m_ids;
+      Postings m_symbolPrefixes;
+      Postings m_namePrefixes;
+      std::string m_alphabet;
+      int m_version = 0;
+
+      static std::vector<std::string> Tokenize(const std::string& name);
+      static std::string GetKey(const std::string& token);
+      static bool IsPrefix(const std::string& prefix, const std::string& token);
+      static bool IsFuzzyPrefix(const std::string& prefix,
+        const std::string& token);
+      bool MatchesSymbol(const Entry& entry, const std::string& prefix) const;
+      bool MatchesName(const Entry& entry, const std::string& prefix) const;
+      bool MatchesFuzzy(const Entry& entry, const std::string& prefix) const;
+      std::vector<std::string> GetFuzzyKeys(const std::string& prefix) const;
+      void Insert(Postings& postings, const std::string& token, int id);
+      void Remove(Postings& postings, const std::string& token, int id);
+      template<typename F>
+      void Collect(const std::vector<int>& postings, int rank,
+        std::size_t count, const F& filter, std::vector<int>& ids) const;
+  };
+
+  inline std::size_t SecuritySearchIndex::GetSize() const {
+    return m_entries.size();
+  }
+
+  inline bool SecuritySearchIndex::Contains(const Security& security) const {
+    return m_ids.find(security) != m_ids.end();
+  }
+
+  inline void SecuritySearchIndex::Add(const SecurityInfo& securityInfo) {
+    auto symbol = ToString(securityInfo.m_security, GetDefaultMarketDatabase());
+    auto nameTokens = Tokenize(securityInfo.m_name);
+    auto id = [&] {
+      auto i = m_ids.find(securityInfo.m_security);
+      if(i != m_ids.end()) {
+        return i->second;
+      }
+      auto id = static_cast<int>(m_entries.size());
+      m_entries.push_back({securityInfo, {}, {}, id});
+      m_ids.insert(std::pair(securityInfo.m_security, id));
+      ++m_version;
+      return id;
+    }();
+    auto& entry = m_entries[id];
+    entry.m_info = securityInfo;
+    if(entry.m_symbol != symbol) {
+      if(!entry.m_symbol.empty()) {
+        Remove(m_symbolPrefixes, entry.m_symbol, id);
+      }
+      Insert(m_symbolPrefixes, symbol, id);
+      entry.m_symbol = std::move(symbol);
+      ++m_version;
+    }
+    if(entry.m_nameTokens != nameTokens) {
+      for(auto& token : entry.m_nameTokens) {
+        Remove(m_namePrefixes, token, id);
+      }
+      for(auto& token : nameTokens) {
+        Insert(m_namePrefixes, token, id);
+      }
+      entry.m_nameTokens = std::move(nameTokens);
+      ++m_version;
+    }
+  }
+
+  inline void SecuritySearchIndex::Ranking::Rank(
+      const std::unordered_map<Security, Quantity>& activity) {
+    auto getActivity = [&] (const Security& security) {
+      auto i = activity.find(security);
+      if(i == activity.end()) {
+        return Quantity(0);
+      }
+      return i->second;
+    };
+    auto ids = std::vector<std::pair<Quantity, int>>();
+    ids.reserve(m_securities.size());
+    for(auto i = std::size_t(0); i != m_securities.size(); ++i) {
+      ids.emplace_back(getActivity(m_securities[i]), static_cast<int>(i));
+    }
+    std::sort(ids.begin(), ids.end(), [&] (auto& lhs, auto& rhs) {
+      if(lhs.first != rhs.first) {
+        return lhs.first > rhs.first;
+      }
+      auto& lhsSymbol = m_symbols[lhs.second];
+      auto& rhsSymbol = m_symbols[rhs.second];
+      if(lhsSymbol.size() != rhsSymbol.size()) {
+        return lhsSymbol.size() < rhsSymbol.size();
+      }
+      return lhsSymbol < rhsSymbol;
+    });
+    m_ranks.resize(ids.size());
+    for(auto i = std::size_t(0); i != ids.size(); ++i) {
+      m_ranks[ids[i].second] = static_cast<int>(i);
+    }
+    auto byRank = [&] (int lhs, int rhs) {
+      return m_ranks[lhs] < m_ranks[rhs];
+    };
+    for(auto& postings : m_symbolPrefixes) {
+      std::sort(postings.second.begin(), postings.second.end(), byRank);
+    }
+    for(auto& postings : m_namePrefixes) {
+      std::sort(postings.second.begin(), postings.second.end(), byRank);
+    }
+  }
+
+  inline void SecuritySearchIndex::Rank(
+      const std::unordered_map<Security, Quantity>& activity) {
+    auto ranking = MakeRanking();
+    ranking.Rank(activity);
+    Apply(std::move(ranking));
+  }
+
+  inline SecuritySearchIndex::Ranking
+      SecuritySearchIndex::MakeRanking() const {
+    auto ranking = Ranking();
+    ranking.m_version = m_version;
+    ranking.m_securities.reserve(m_entries.size());
+    ranking.m_symbols.reserve(m_entries.size());
+    for(auto& entry : m_entries) {
+      ranking.m_securities.push_back(entry.m_info.m_security);
+      ranking.m_symbols.push_back(entry.m_symbol);
+    }
+    ranking.m_symbolPrefixes = m_symbolPrefixes;
+    ranking.m_namePrefixes = m_namePrefixes;
+    return ranking;
+  }
+
+  inline bool SecuritySearchIndex::Apply(Ranking ranking) {
+    if(ranking.m_version != m_version ||
+        ranking.m_ranks.size() != m_entries.size()) {
+      return false;
+    }
+    for(auto i = std::size_t(0); i != m_entries.size(); ++i) {
+      m_entries[i].m_rank = ranking.m_ranks[i];
+    }
+    m_symbolPrefixes = std::move(ranking.m_symbolPrefixes);
+    m_namePrefixes = std::move(ranking.m_namePrefixes);
+    return true;
+  }
+
+  inline int SecuritySearchIndex::GetMatchGroup(const std::string& prefix,
+      const SecurityInfo& securityInfo) {
+    auto query = boost::to_upper_copy(prefix);
+    if(IsPrefix(query,
+        ToString(securityInfo.m_security, GetDefaultMarketDatabase()))) {
+      return 0;
+    }
+    auto nameTokens = Tokenize(securityInfo.m_name);
+    if(std::any_of(nameTokens.begin(), nameTokens.end(), [&] (auto& token) {
+        return IsPrefix(query, token);
+      })) {
+      return 1;
+    }
+    return 2;
+  }
+
+  inline std::vector<SecurityInfo> SecuritySearchIndex::Search(
+      const std::string& prefix, const Security& start, int count) const {
+    auto query = boost::to_upper_copy(prefix);
+    if(query.empty() || count <= 0) {
+      return {};
+    }
+    auto remaining = static_cast<std::size_t>(count);
+    auto section = 0;
+    auto rank = -1;
+    auto cursor = m_ids.find(start);
+    if(cursor != m_ids.end()) {
+      auto& entry = m_entries[cursor->second];
+      rank = entry.m_rank;
+      if(MatchesSymbol(entry, query)) {
+        section = 0;
+      } else if(MatchesName(entry, query)) {
+        section = 1;
+      } else {
+        section = 2;
+      }
+    } else if(start != Security()) {
+      return {};
+    }
+    auto ids = std::vector<int>();
+    auto key = GetKey(query);
+    if(section == 0) {
+      auto postings = m_symbolPrefixes.find(key);
+      if(postings != m_symbolPrefixes.end()) {
+        Collect(postings->second, rank, remaining, [&] (auto& entry) {
+          return MatchesSymbol(entry, query);
+        }, ids);
+      }
+      rank = -1;
+    }
+    if(section <= 1 && ids.size() < remaining) {
+      auto postings = m_namePrefixes.find(key);
+      if(postings != m_namePrefixes.end()) {
+        Collect(postings->second, rank, remaining - ids.size(),
+          [&] (auto& entry) {
+            return !MatchesSymbol(entry, query) && MatchesName(entry, query);
+          }, ids);
+      }
+      rank = -1;
+    }
+    if(query.size() >= MIN_FUZZY_LENGTH && ids.size() < remaining) {
+      auto fuzzyCount = remaining - ids.size();
+      auto fuzzyIds = std::vector<int>();
+      auto filter = [&] (auto& entry) {
+        return !MatchesSymbol(entry, query) && !MatchesName(entry, query) &&
+          MatchesFuzzy(entry, query);
+      };
+      for(auto& fuzzyKey : GetFuzzyKeys(query)) {
+        for(auto postings : {&m_symbolPrefixes, &m_namePrefixes}) {
+          auto i = postings->find(fuzzyKey);
+          if(i != postings->end()) {
+            Collect(i->second, rank, fuzzyCount, filter, fuzzyIds);
+          }
+        }
+      }
+      std::sort(fuzzyIds.begin(), fuzzyIds.end(), [&] (auto lhs, auto rhs) {
+        return m_entries[lhs].m_rank < m_entries[rhs].m_rank;
+      });
+      fuzzyIds.erase(std::unique(fuzzyIds.begin(), fuzzyIds.end()),
+        fuzzyIds.end());
+      if(fuzzyIds.size() > fuzzyCount) {
+        fuzzyIds.resize(fuzzyCount);
+      }
+      ids.insert(ids.end(), fuzzyIds.begin(), fuzzyIds.end());
+    }
+    auto result = std::vector<SecurityInfo>();
+    result.reserve(ids.size());
+    for(auto id : ids) {
+      result.push_back(m_entries[id].m_info);
+    }
+    return result;
+  }
+
+  inline std::vector<std::string> SecuritySearchIndex::Tokenize(
+      const std::string& name) {
+    auto tokens = std::vector<std::string>();
+    auto uppercaseName = boost::to_upper_copy(name);
+    if(uppercaseName.empty()) {
+      return tokens;
+    }
+    tokens.push_back(uppercaseName);
+    auto word = std::string();
+    for(auto c : uppercaseName) {
+      if(std::isalnum(static_cast<unsigned char>(c))) {
+        word += c;
+      } else if(!word.empty()) {
+        tokens.push_back(std::move(word));
+        word.clear();
+      }
+    }
+    if(!word.empty()) {
+      tokens.push_back(std::move(word));
+    }
+    std::sort(tokens.begin(), tokens.end());
+    tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+    return tokens;
+  }
+
+  inline std::string SecuritySearchIndex::GetKey(const std::string& token) {
+    return token.substr(0, INDEXED_PREFIX_LENGTH);
+  }
+
+  inline bool SecuritySearchIndex::IsPrefix(const std::string& prefix,
+      const std::string& token) {
+    return token.compare(0, prefix.size(), prefix) == 0;
+  }
+
+  inline bool SecuritySearchIndex::IsFuzzyPrefix(const std::string& prefix,
+      const std::string& token) {
+    auto size = prefix.size();
+    auto i = std::size_t(0);
+    while(i != size && i != token.size() && prefix[i] == token[i]) {
+      ++i;
+    }
+    if(i == size) {
+      return true;
+    }
+    auto matches = [&] (std::size_t prefixOffset, std::size_t tokenOffset) {
+      auto length = size - prefixOffset;
+      return token.size() >= tokenOffset + length &&
+        token.compare(tokenOffset, length, prefix, prefixOffset, length) == 0;
+    };
+    if(matches(i + 1, i + 1) || matches(i + 1, i) || matches(i, i + 1)) {
+      return true;
+    }
+    return i + 1 < size && i + 1 < token.size() &&
+      prefix[i] == token[i + 1] && prefix[i + 1] == token[i] &&
+      matches(i + 2, i + 2);
+  }
+
+  inline bool SecuritySearchIndex::MatchesSymbol(const Entry& entry,
+      const std::string& prefix) const {
+    return IsPrefix(prefix, entry.m_symbol);
+  }
+
+  inline bool SecuritySearchIndex::MatchesName(const Entry& entry,
+      const std::string& prefix) const {
+    return std::any_of(entry.m_nameTokens.begin(), entry.m_nameTokens.end(),
+      [&] (auto& token) {
+        return IsPrefix(prefix, token);
+      });
+  }
+
+  inline bool SecuritySearchIndex::MatchesFuzzy(const Entry& entry,
+      const std::string& prefix) const {
+    return IsFuzzyPrefix(prefix, entry.m_symbol) ||
+      std::any_of(entry.m_nameTokens.begin(), entry.m_nameTokens.end(),
+        [&] (auto& token) {
+          return IsFuzzyPrefix(prefix, token);
+        });
+  }
+
+  inline std::vector<std::string> SecuritySearchIndex::GetFuzzyKeys(
+      const std::string& prefix) const {
+    auto keys = std::vector<std::string>();
+    keys.push_back(GetKey(prefix));
+    auto edits = std::min(prefix.size(), INDEXED_PREFIX_LENGTH);
+    for(auto i = std::size_t(0); i != edits; ++i) {
+      auto deletion = prefix;
+      deletion.erase(i, 1);
+      keys.push_back(GetKey(deletion));
+      if(i + 1 < prefix.size()) {
+        auto transposition = prefix;
+        std::swap(transposition[i], transposition[i + 1]);
+        keys.push_back(GetKey(transposition));
+      }
+      for(auto c : m_alphabet) {
+        auto substitution = prefix;
+        substitution[i] = c;
+        keys.push_back(GetKey(substitution));
+        auto insertion = prefix;
+        insertion.insert(i, 1, c);
+        keys.push_back(GetKey(insertion));
+      }
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+  }
+
+  inline void SecuritySearchIndex::Insert(Postings& postings,
+      const std::string& token, int id) {
+    for(auto c : token) {
+      if(m_alphabet.find(c) == std::string::npos) {
+        m_alphabet += c;
+      }
+    }
+    auto rank = m_entries[id].m_rank;
+    for(auto length = std::size_t(1);
+        length <= std::min(token.size(), INDEXED_PREFIX_LENGTH); ++length) {
+      auto& ids = postings[token.substr(0, length)];
+      auto i = std::lower_bound(ids.begin(), ids.end(), rank,
+        [&] (auto id, auto rank) {
+          return m_entries[id].m_rank < rank;
+        });
+      if(i == ids.end() || *i != id) {
+        ids.insert(i, id);
+      }
+    }
+  }
+
+  inline void SecuritySearchIndex::Remove(Postings& postings,
+      const std::string& token, int id) {
+    for(auto length = std::size_t(1);
+        length <= std::min(token.size(), INDEXED_PREFIX_LENGTH); ++length) {
+      auto i = postings.find(token.substr(0, length));
+      if(i == postings.end()) {
+        continue;
+      }
+      auto& ids = i->second;
+      ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+      if(ids.empty()) {
+        postings.erase(i);
+      }
+    }
+  }
+
+  template<typename F>
+  void SecuritySearchIndex::Collect(const std::vector<int>& postings,
+      int rank, std::size_t count, const F& filter,
+      std::vector<int>& ids) const {
+    auto i = std::upper_bound(postings.begin(), postings.end(), rank,
+      [&] (auto rank, auto id) {
+        return rank < m_entries[id].m_rank;
+      });
+    auto collected = std::size_t(0);
+    while(i != postings.end() && collected != count) {
+      if(filter(m_entries[*i])) {
+        ids.push_back(*i);
+        ++collected;
+      }
+      ++i;
+    }
+  }
+}
+
+#endif
@@ -1,5 +1,7 @@
 #ifndef NEXUS_MARKET_DATA_SQL_DEFINITIONS_HPP
 #define NEXUS_MARKET_DATA_SQL_DEFINITIONS_HPP
+#include <cstdint>
+#include <string>
 #include <Beam/Sql/Conversions.hpp>
 #include <Viper/Row.hpp>
 #include "Nexus/Definitions/BboQuote.hpp"
@@ -11,9 +13,36 @@
 #include "Nexus/Definitions/SqlDefinitions.hpp"
 #include "Nexus/Definitions/TimeAndSale.hpp"
 #include "Nexus/MarketDataService/MarketDataService.hpp"
+#include "Nexus/MarketDataService/SecurityMarketDataQuery.hpp"
 
 namespace Nexus::MarketDataService {
 
+  /** Stores the last query sequence of a Security's market data. */
+  struct SecuritySequence {
+
+    /** The Security, identified by its symbol and country. */
+    Security m_security;
+
+    /** The highest query sequence stored for the Security. */
+    std::uint64_t m_sequence;
+  };
+
+  /** Stores the price of a Security's last TimeAndSale at a market center. */
+  struct SecurityLastPrice {
+
+    /** The Security, identified by its symbol and country. */
+    Security m_security;
+
+    /** The market center the TimeAndSale was reported on. */
+    std::string m_marketCenter;
+
+    /** The price of the last TimeAndSale. */
+    Money m_price;
+
+    /** The query sequence of the last TimeAndSale. */
+    std::uint64_t m_sequence;
+  };
+
   /** Returns a row representing a market code. */
   inline const auto& GetMarketCodeRow() {
     static auto ROW = Viper::Row<MarketCode>().
@@ -72,6 +101,26 @@ namespace Nexus::MarketDataService {
     return ROW;
   }
 
+  /** Returns a row representing a SecuritySequence. */
+  inline const auto& GetSecuritySequenceRow() {
+    static auto ROW = Viper::Row<SecuritySequence>().
+      extend(GetSecurityRow(), &SecuritySequence::m_security).
+      add_column("query_sequence", &SecuritySequence::m_sequence);
+    return ROW;
+  }
+
+  /** Returns a row representing a SecurityLastPrice. */
+  inline const auto& GetSecurityLastPriceRow() {
+    static auto ROW = Viper::Row<SecurityLastPrice>().
+      extend(GetSecurityRow(), &SecurityLastPrice::m_security).
+      add_column("market", Viper::varchar(16),
+        &SecurityLastPrice::m_marketCenter).
+      add_column("price", &SecurityLastPrice::m_price).
+      add_column("query_sequence", &SecurityLastPrice::m_sequence).
+      set_primary_key({"symbol", "country", "market"});
+    return ROW;
+  }
+
   /** Returns a row representing a SecurityInfo. */
   inline const auto& GetSecurityInfoRow() {
     static auto ROW = Viper::Row<SecurityInfo>().
@@ -155,6 +204,34 @@ namespace Nexus::MarketDataService {
       add_column("market", Viper::varchar(16), &TimeAndSale::m_marketCenter);
     return ROW;
   }
+
+  /**
+   * Returns a row representing a SequencedSecurityTimeAndSale as it is stored
+   * in the time_and_sales table.
+   */
+  inline const auto& GetSequencedSecurityTimeAndSaleRow() {
+    static auto ROW = Viper::Row<SequencedSecurityTimeAndSale>().
+      extend(GetSecurityRow(),
+        [] (auto& row) -> auto& {
+          return row->GetIndex();
+        }).
+      extend(GetTimeAndSaleRow(),
+        [] (auto& row) -> auto& {
+          return **row;
+        }).
+      add_column("timestamp",
+        [] (auto& row) -> auto& {
+          return (*row)->m_timestamp;
+        }).
+      add_column("query_sequence",
+        [] (const auto& row) {
+          return row.GetSequence().GetOrdinal();
+        },
+        [] (auto& row, auto value) {
+          row.GetSequence() = Beam::Queries::Sequence(value);
+        });
+    return ROW;
+  }
 }
 
 #endif
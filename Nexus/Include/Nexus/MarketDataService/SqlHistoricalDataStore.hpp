@@ -1,7 +1,10 @@
 #ifndef NEXUS_SQL_HISTORICAL_DATA_STORE_HPP
 #define NEXUS_SQL_HISTORICAL_DATA_STORE_HPP
 #include <functional>
+#include <string>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 #include <Beam/IO/OpenState.hpp>
 #include <Beam/Queries/SqlDataStore.hpp>
 #include <Beam/Sql/DatabaseConnectionPool.hpp>
@@ -43,6 +46,12 @@ namespace Nexus::MarketDataService {
 
       std::vector<SecurityInfo> LoadAllSecurityInfo();
 
+      std::unordered_map<Security, SecurityEntry::InitialSequences>
+        LoadAllInitialSequences();
+
+      std::unordered_map<Security, std::unordered_map<std::string, Money>>
+        LoadAllLastPrices();
+
       std::vector<SequencedOrderImbalance> LoadOrderImbalances(
         const MarketWideDataQuery& query);
 
@@ -100,6 +109,11 @@ namespace Nexus::MarketDataService {
       DataStore<Viper::Row<TimeAndSale>, Viper::Row<Security>>
         m_timeAndSaleDataStore;
       Beam::IO::OpenState m_openState;
+
+      void LoadInitialSequence(const std::string& table,
+        std::unordered_map<Security, SecurityEntry::InitialSequences>&
+          initialSequences,
+        Beam::Queries::Sequence SecurityEntry::InitialSequences::* sequence);
   };
 
   template<typename C>
@@ -134,6 +148,27 @@ namespace Nexus::MarketDataService {
       auto connection = m_writerPool.Acquire();
       connection->execute(Viper::create_if_not_exists(
         GetSecurityInfoRow(), "security_info"));
+      connection->execute(Viper::create_if_not_exists(
+        GetSecurityLastPriceRow(), "last_prices"));
+      auto lastPrice = std::optional<SecurityLastPrice>();
+      connection->execute(Viper::select(GetSecurityLastPriceRow(),
+        "last_prices", Viper::limit(1), &lastPrice));
+      if(!lastPrice.has_value()) {
+        auto lastPrices = std::vector<SecurityLastPrice>();
+        connection->execute(Viper::select(GetSecurityLastPriceRow(),
+          "(SELECT t.symbol, t.country, t.market, t.price, t.query_sequence "
+          "FROM "
+          "time_and_sales AS t INNER JOIN (SELECT symbol, country, market, "
+          "MAX(query_sequence) AS query_sequence FROM time_and_sales GROUP "
+          "BY symbol, country, market) AS l ON t.symbol = l.symbol AND "
+          "t.country = l.country AND t.market = l.market AND "
+          "t.query_sequence = l.query_sequence) AS latest_prices",
+          std::back_inserter(lastPrices)));
+        if(!lastPrices.empty()) {
+          connection->execute(Viper::upsert(GetSecurityLastPriceRow(),
+            "last_prices", lastPrices.begin(), lastPrices.end()));
+        }
+      }
     } catch(const std::exception&) {
       Close();
       BOOST_RETHROW;
@@ -172,6 +207,39 @@ namespace Nexus::MarketDataService {
     return result;
   }
 
+  template<typename C>
+  std::unordered_map<Security, SecurityEntry::InitialSequences>
+      SqlHistoricalDataStore<C>::LoadAllInitialSequences() {
+    auto initialSequences =
+      std::unordered_map<Security, SecurityEntry::InitialSequences>();
+    LoadInitialSequence("bbo_quotes", initialSequences,
+      &SecurityEntry::InitialSequences::m_nextBboQuoteSequence);
+    LoadInitialSequence("book_quotes", initialSequences,
+      &SecurityEntry::InitialSequences::m_nextBookQuoteSequence);
+    LoadInitialSequence("market_quotes", initialSequences,
+      &SecurityEntry::InitialSequences::m_nextMarketQuoteSequence);
+    LoadInitialSequence("time_and_sales", initialSequences,
+      &SecurityEntry::InitialSequences::m_nextTimeAndSaleSequence);
+    return initialSequences;
+  }
+
+  template<typename C>
+  std::unordered_map<Security, std::unordered_map<std::string, Money>>
+      SqlHistoricalDataStore<C>::LoadAllLastPrices() {
+    auto rows = std::vector<SecurityLastPrice>();
+    {
+      auto reader = m_readerPool.Acquire();
+      reader->execute(Viper::select(GetSecurityLastPriceRow(), "last_prices",
+        std::back_inserter(rows)));
+    }
+    auto lastPrices =
+      std::unordered_map<Security, std::unordered_map<std::string, Money>>();
+    for(auto& row : rows) {
+      lastPrices[row.m_security][row.m_marketCenter] = row.m_price;
+    }
+    return lastPrices;
+  }
+
   template<typename C>
   std::vector<SequencedOrderImbalance> SqlHistoricalDataStore<C>::
       LoadOrderImbalances(const MarketWideDataQuery& query) {
@@ -260,13 +328,58 @@ namespace Nexus::MarketDataService {
   template<typename C>
   void SqlHistoricalDataStore<C>::Store(
       const SequencedSecurityTimeAndSale& timeAndSale) {
-    m_timeAndSaleDataStore.Store(timeAndSale);
+    Store(std::vector{timeAndSale});
   }
 
   template<typename C>
   void SqlHistoricalDataStore<C>::Store(
       const std::vector<SequencedSecurityTimeAndSale>& timeAndSales) {
-    m_timeAndSaleDataStore.Store(timeAndSales);
+    if(timeAndSales.empty()) {
+      return;
+    }
+    auto latestPrices = std::unordered_map<Security,
+      std::unordered_map<std::string, SecurityLastPrice>>();
+    for(auto& timeAndSale : timeAndSales) {
+      auto& prices = latestPrices[timeAndSale->GetIndex()];
+      auto sequence = timeAndSale.GetSequence().GetOrdinal();
+      auto price = prices.find((*timeAndSale)->m_marketCenter);
+      if(price == prices.end() || sequence > price->second.m_sequence) {
+        prices[(*timeAndSale)->m_marketCenter] = SecurityLastPrice{
+          timeAndSale->GetIndex(), (*timeAndSale)->m_marketCenter,
+          (*timeAndSale)->m_price, sequence};
+      }
+    }
+
+    // The time and sales are inserted directly rather than through the
+    // SqlDataStore so that the last prices are updated in the same
+    // transaction, and only by a later sequence than the one stored.
+    auto writer = m_writerPool.Acquire();
+    Viper::transaction(*writer, [&] {
+      writer->execute(Viper::insert(GetSequencedSecurityTimeAndSaleRow(),
+        "time_and_sales", timeAndSales.begin(), timeAndSales.end()));
+      auto lastPrices = std::vector<SecurityLastPrice>();
+      for(auto& prices : latestPrices) {
+        auto storedPrices = std::vector<SecurityLastPrice>();
+        writer->execute(Viper::select(GetSecurityLastPriceRow(),
+          "last_prices", Viper::sym("symbol") == prices.first.GetSymbol() &&
+          Viper::sym("country") == prices.first.GetCountry(),
+          std::back_inserter(storedPrices)));
+        for(auto& storedPrice : storedPrices) {
+          auto price = prices.second.find(storedPrice.m_marketCenter);
+          if(price != prices.second.end() &&
+              price->second.m_sequence <= storedPrice.m_sequence) {
+            prices.second.erase(price);
+          }
+        }
+        for(auto& price : prices.second) {
+          lastPrices.push_back(price.second);
+        }
+      }
+      if(!lastPrices.empty()) {
+        writer->execute(Viper::upsert(GetSecurityLastPriceRow(),
+          "last_prices", lastPrices.begin(), lastPrices.end()));
+      }
+    });
   }
 
   template<typename C>
@@ -283,6 +396,25 @@ namespace Nexus::MarketDataService {
     m_readerPool.Close();
     m_openState.Close();
   }
+
+  template<typename C>
+  void SqlHistoricalDataStore<C>::LoadInitialSequence(const std::string& table,
+      std::unordered_map<Security, SecurityEntry::InitialSequences>&
+        initialSequences,
+      Beam::Queries::Sequence SecurityEntry::InitialSequences::* sequence) {
+    auto rows = std::vector<SecuritySequence>();
+    {
+      auto reader = m_readerPool.Acquire();
+      reader->execute(Viper::select(GetSecuritySequenceRow(),
+        "(SELECT symbol, country, MAX(query_sequence) AS query_sequence FROM " +
+        table + " GROUP BY symbol, country) AS last_sequences",
+        std::back_inserter(rows)));
+    }
+    for(auto& row : rows) {
+      initialSequences[row.m_security].*sequence =
+        Beam::Queries::Increment(Beam::Queries::Sequence(row.m_sequence));
+    }
+  }
 }
 
 #endif
@@ -17,6 +17,12 @@ namespace Nexus::MarketDataService {
 
       virtual std::vector<SecurityInfo> LoadAllSecurityInfo() = 0;
 
+      virtual std::unordered_map<Security, SecurityEntry::InitialSequences>
+        LoadAllInitialSequences() = 0;
+
+      virtual std::unordered_map<Security,
+        std::unordered_map<std::string, Money>> LoadAllLastPrices() = 0;
+
       virtual std::vector<SequencedOrderImbalance> LoadOrderImbalances(
         const MarketWideDataQuery& query) = 0;
 
@@ -91,6 +97,12 @@ namespace Nexus::MarketDataService {
 
       std::vector<SecurityInfo> LoadAllSecurityInfo() override;
 
+      std::unordered_map<Security, SecurityEntry::InitialSequences>
+        LoadAllInitialSequences() override;
+
+      std::unordered_map<Security, std::unordered_map<std::string, Money>>
+        LoadAllLastPrices() override;
+
       std::vector<SequencedOrderImbalance> LoadOrderImbalances(
         const MarketWideDataQuery& query) override;
 
@@ -167,6 +179,18 @@ namespace Nexus::MarketDataService {
     return m_dataStore->LoadAllSecurityInfo();
   }
 
+  template<typename C>
+  std::unordered_map<Security, SecurityEntry::InitialSequences>
+      WrapperHistoricalDataStore<C>::LoadAllInitialSequences() {
+    return m_dataStore->LoadAllInitialSequences();
+  }
+
+  template<typename C>
+  std::unordered_map<Security, std::unordered_map<std::string, Money>>
+      WrapperHistoricalDataStore<C>::LoadAllLastPrices() {
+    return m_dataStore->LoadAllLastPrices();
+  }
+
   template<typename C>
   std::vector<SequencedOrderImbalance>
       WrapperHistoricalDataStore<C>::LoadOrderImbalances(
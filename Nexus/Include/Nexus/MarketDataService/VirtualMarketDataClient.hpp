@@ -57,11 +57,17 @@ namespace Nexus::MarketDataService {
       virtual SecurityTechnicals LoadSecurityTechnicals(
         const Security& security) = 0;
 
+      virtual std::vector<SecuritySnapshot> LoadSecuritySnapshots(
+        const std::vector<Security>& securities) = 0;
+
+      virtual std::vector<SecurityTechnicals> LoadSecurityTechnicalsList(
+        const std::vector<Security>& securities) = 0;
+
       virtual boost::optional<SecurityInfo> LoadSecurityInfo(
         const Security& security) = 0;
 
       virtual std::vector<SecurityInfo> LoadSecurityInfoFromPrefix(
-        const std::string& prefix) = 0;
+        const std::string& prefix, const Security& start, int count) = 0;
 
       virtual void Close() = 0;
 
@@ -124,11 +130,17 @@ namespace Nexus::MarketDataService {
       SecurityTechnicals LoadSecurityTechnicals(
         const Security& security) override;
 
+      std::vector<SecuritySnapshot> LoadSecuritySnapshots(
+        const std::vector<Security>& securities) override;
+
+      std::vector<SecurityTechnicals> LoadSecurityTechnicalsList(
+        const std::vector<Security>& securities) override;
+
       boost::optional<SecurityInfo> LoadSecurityInfo(
         const Security& security) override;
 
       std::vector<SecurityInfo> LoadSecurityInfoFromPrefix(
-        const std::string& prefix) override;
+        const std::string& prefix, const Security& start, int count) override;
 
       void Close() override;
 
@@ -345,6 +357,18 @@ namespace Nexus::MarketDataService {
     return m_client->LoadSecurityTechnicals(security);
   }
 
+  template<typename C>
+  std::vector<SecuritySnapshot> WrapperMarketDataClient<C>::
+      LoadSecuritySnapshots(const std::vector<Security>& securities) {
+    return m_client->LoadSecuritySnapshots(securities);
+  }
+
+  template<typename C>
+  std::vector<SecurityTechnicals> WrapperMarketDataClient<C>::
+      LoadSecurityTechnicalsList(const std::vector<Security>& securities) {
+    return m_client->LoadSecurityTechnicalsList(securities);
+  }
+
   template<typename C>
   boost::optional<SecurityInfo> WrapperMarketDataClient<C>::LoadSecurityInfo(
       const Security& security) {
@@ -353,8 +377,9 @@ namespace Nexus::MarketDataService {
 
   template<typename C>
   std::vector<SecurityInfo> WrapperMarketDataClient<C>::
-      LoadSecurityInfoFromPrefix(const std::string& prefix) {
-    return m_client->LoadSecurityInfoFromPrefix(prefix);
+      LoadSecurityInfoFromPrefix(const std::string& prefix,
+      const Security& start, int count) {
+    return m_client->LoadSecurityInfoFromPrefix(prefix, start, count);
   }
 
   template<typename C>
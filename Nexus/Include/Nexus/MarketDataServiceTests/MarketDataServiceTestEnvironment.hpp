@@ -69,6 +69,12 @@ namespace Nexus::MarketDataService::Tests {
       /** Returns the MarketDataRegistry. */
       const MarketDataRegistry& GetRegistry() const;
 
+      /**
+       * Adds a SecurityInfo.
+       * @param securityInfo The SecurityInfo to add.
+       */
+      void Add(const SecurityInfo& securityInfo);
+
       /**
        * Publishes an OrderImbalance.
        * @param market The market to publish to.
@@ -137,14 +143,16 @@ namespace Nexus::MarketDataService::Tests {
         Beam::Services::ServiceProtocolServletContainer<
         Beam::ServiceLocator::MetaAuthenticationServletAdapter<
         MetaMarketDataRegistryServlet<MarketDataRegistry*,
-        VirtualHistoricalDataStore*, std::shared_ptr<AdministrationClient>>,
+        VirtualHistoricalDataStore*, std::shared_ptr<AdministrationClient>,
+        std::unique_ptr<Beam::Threading::TriggerTimer>>,
         ServiceLocatorClient*, Beam::NativePointerPolicy>, ServerConnection*,
         Beam::Serialization::BinarySender<Beam::IO::SharedBuffer>,
         Beam::Codecs::NullEncoder,
         std::shared_ptr<Beam::Threading::TriggerTimer>>;
       using BaseRegistryServlet = MarketDataRegistryServlet<
         ServiceProtocolServletContainer, MarketDataRegistry*,
-        VirtualHistoricalDataStore*, std::shared_ptr<AdministrationClient>>;
+        VirtualHistoricalDataStore*, std::shared_ptr<AdministrationClient>,
+        std::unique_ptr<Beam::Threading::TriggerTimer>>;
       using RegistryServlet =
         Beam::ServiceLocator::AuthenticationServletAdapter<
         ServiceProtocolServletContainer, BaseRegistryServlet*,
@@ -193,7 +201,9 @@ namespace Nexus::MarketDataService::Tests {
     : m_serviceLocatorClient(std::move(serviceLocatorClient)),
       m_administrationClient(std::move(administrationClient)),
       m_dataStore(std::move(dataStore)),
-      m_registryServlet(m_administrationClient, &m_registry, &*m_dataStore),
+      m_registryServlet(m_administrationClient, &m_registry, &*m_dataStore,
+        std::make_unique<Beam::Threading::TriggerTimer>(),
+        std::make_unique<Beam::Threading::TriggerTimer>()),
       m_container(Beam::Initialize(m_serviceLocatorClient.get(),
         &m_registryServlet), &m_serverConnection,
         boost::factory<std::shared_ptr<Beam::Threading::TriggerTimer>>()),
@@ -215,6 +225,11 @@ namespace Nexus::MarketDataService::Tests {
     return m_registry;
   }
 
+  inline void MarketDataServiceTestEnvironment::Add(
+      const SecurityInfo& securityInfo) {
+    m_registryServlet.Add(securityInfo);
+  }
+
   inline void MarketDataServiceTestEnvironment::Publish(
       MarketCode market, const OrderImbalance& orderImbalance) {
     m_registryServlet.PublishOrderImbalance(
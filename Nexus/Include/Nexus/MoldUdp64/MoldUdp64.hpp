@@ -3,8 +3,9 @@
 
 namespace Nexus {
 namespace MoldUdp64 {
-  template<typename ChannelType> class MoldUdp64Client;
+  template<typename C, typename R> class MoldUdp64Client;
   struct MoldUdp64Message;
+  struct MoldUdp64MessageBatch;
   struct MoldUdp64Packet;
   class MoldUdp64ParserException;
 }
@@ -0,0 +1,25 @@
+#ifndef NEXUS_MOLD_UDP_64_MESSAGE_BATCH_HPP
+#define NEXUS_MOLD_UDP_64_MESSAGE_BATCH_HPP
+#include <cstdint>
+#include <vector>
+#include "Nexus/MoldUdp64/MoldUdp64.hpp"
+#include "Nexus/MoldUdp64/MoldUdp64Message.hpp"
+
+namespace Nexus::MoldUdp64 {
+
+  /**
+   * Stores the messages contained in one or more consecutive packets. Each
+   * message refers directly to the memory the packet was received into and
+   * remains valid until the next batch is read.
+   */
+  struct MoldUdp64MessageBatch {
+
+    /** The sequence number of the first message in the batch. */
+    std::uint64_t m_sequenceNumber;
+
+    /** The messages in order of increasing sequence number. */
+    std::vector<MoldUdp64Message> m_messages;
+  };
+}
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef NEXUS_MOLD_UDP_64_REQUEST_PACKET_HPP
+#define NEXUS_MOLD_UDP_64_REQUEST_PACKET_HPP
+#include <cstdint>
+#include <Beam/Pointers/Out.hpp>
+#include <Beam/Utilities/Endian.hpp>
+#include <Beam/Utilities/FixedString.hpp>
+#include "Nexus/MoldUdp64/MoldUdp64.hpp"
+#include "Nexus/MoldUdp64/MoldUdp64Packet.hpp"
+
+namespace Nexus::MoldUdp64 {
+
+  /**
+   * Builds a packet requesting the retransmission of a range of messages.
+   * @param session The session the messages belong to.
+   * @param sequenceNumber The sequence number of the first message requested.
+   * @param count The number of messages requested.
+   * @param buffer The buffer to store the packet in.
+   */
+  template<typename Buffer>
+  void BuildRequestPacket(
+      const Beam::FixedString<MoldUdp64Packet::SESSION_FIELD_LENGTH>& session,
+      std::uint64_t sequenceNumber, std::uint16_t count,
+      Beam::Out<Buffer> buffer) {
+    buffer->Append(session.GetData(), MoldUdp64Packet::SESSION_FIELD_LENGTH);
+    buffer->Append(Beam::ToBigEndian(sequenceNumber));
+    buffer->Append(Beam::ToBigEndian(count));
+  }
+}
+
+#endif
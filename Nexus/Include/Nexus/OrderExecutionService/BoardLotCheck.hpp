@@ -40,6 +40,8 @@ namespace OrderExecutionService {
         const MarketDatabase& marketDatabase,
         const boost::local_time::tz_database& timeZoneDatabase);
 
+      virtual bool IsIndependent() const;
+
       virtual void Submit(const OrderInfo& orderInfo);
 
     private:
@@ -87,6 +89,11 @@ namespace OrderExecutionService {
         m_marketDatabase{marketDatabase},
         m_timeZoneDatabase{timeZoneDatabase} {}
 
+  template<typename MarketDataClientType>
+  bool BoardLotCheck<MarketDataClientType>::IsIndependent() const {
+    return true;
+  }
+
   template<typename MarketDataClientType>
   void BoardLotCheck<MarketDataClientType>::Submit(const OrderInfo& orderInfo) {
     if(orderInfo.m_fields.m_security.GetMarket() != DefaultMarkets::TSX() &&
@@ -0,0 +1,192 @@
+#ifndef NEXUS_EXECUTION_REPORT_WRITE_LOG_HPP
+#define NEXUS_EXECUTION_REPORT_WRITE_LOG_HPP
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include <boost/optional/optional.hpp>
+#include "Nexus/OrderExecutionService/ExecutionReport.hpp"
+#include "Nexus/OrderExecutionService/OrderExecutionService.hpp"
+
+namespace Nexus::OrderExecutionService {
+
+  /**
+   * Buffers ExecutionReports received out of sequence in a ring indexed by
+   * their sequence number, giving constant time insertion, lookup and removal
+   * from the front.
+   */
+  class ExecutionReportWriteLog {
+    public:
+
+      /** The default number of sequence numbers the log may span. */
+      static constexpr auto DEFAULT_CAPACITY = std::size_t(4096);
+
+      /** Constructs an empty ExecutionReportWriteLog. */
+      ExecutionReportWriteLog();
+
+      /**
+       * Constructs an empty ExecutionReportWriteLog.
+       * @param capacity The maximum number of sequence numbers the log may
+       *        span, reports that would exceed it are rejected.
+       */
+      explicit ExecutionReportWriteLog(std::size_t capacity);
+
+      /** Returns <code>true</code> iff the log is empty. */
+      bool IsEmpty() const;
+
+      /** Returns the number of reports stored. */
+      std::size_t GetSize() const;
+
+      /** Returns the maximum number of sequence numbers the log may span. */
+      std::size_t GetCapacity() const;
+
+      /**
+       * Returns the report with the lowest sequence number, or
+       * <code>nullptr</code> if the log is empty.
+       */
+      const ExecutionReport* GetFront() const;
+
+      /**
+       * Finds a report by its sequence number.
+       * @param sequence The sequence number to find.
+       * @return The report with the specified <i>sequence</i> or
+       *         <code>nullptr</code> if it is not stored.
+       */
+      const ExecutionReport* Find(int sequence) const;
+
+      /**
+       * Inserts a report, duplicates are ignored.
+       * @param executionReport The report to insert.
+       * @return <code>true</code> iff the report was stored.
+       */
+      bool Insert(const ExecutionReport& executionReport);
+
+      /** Removes the report with the lowest sequence number. */
+      void PopFront();
+
+      /**
+       * Removes all reports up to and including a sequence number.
+       * @param sequence The last sequence number to remove.
+       */
+      void Discard(int sequence);
+
+    private:
+      std::size_t m_capacity;
+      std::vector<boost::optional<ExecutionReport>> m_slots;
+      std::size_t m_size;
+      int m_first;
+      int m_last;
+
+      std::size_t GetIndex(int sequence) const;
+      void Reserve(std::size_t span);
+  };
+
+  inline ExecutionReportWriteLog::ExecutionReportWriteLog()
+    : ExecutionReportWriteLog(DEFAULT_CAPACITY) {}
+
+  inline ExecutionReportWriteLog::ExecutionReportWriteLog(std::size_t capacity)
+    : m_capacity(std::max<std::size_t>(1, capacity)),
+      m_size(0),
+      m_first(0),
+      m_last(0) {}
+
+  inline bool ExecutionReportWriteLog::IsEmpty() const {
+    return m_size == 0;
+  }
+
+  inline std::size_t ExecutionReportWriteLog::GetSize() const {
+    return m_size;
+  }
+
+  inline std::size_t ExecutionReportWriteLog::GetCapacity() const {
+    return m_capacity;
+  }
+
+  inline const ExecutionReport* ExecutionReportWriteLog::GetFront() const {
+    if(m_size == 0) {
+      return nullptr;
+    }
+    return &*m_slots[GetIndex(m_first)];
+  }
+
+  inline const ExecutionReport* ExecutionReportWriteLog::Find(
+      int sequence) const {
+    if(m_size == 0 || sequence < m_first || sequence > m_last) {
+      return nullptr;
+    }
+    auto& slot = m_slots[GetIndex(sequence)];
+    if(!slot || slot->m_sequence != sequence) {
+      return nullptr;
+    }
+    return &*slot;
+  }
+
+  inline bool ExecutionReportWriteLog::Insert(
+      const ExecutionReport& executionReport) {
+    auto sequence = executionReport.m_sequence;
+    if(m_size == 0) {
+      Reserve(1);
+      m_first = sequence;
+      m_last = sequence;
+    } else {
+      auto first = std::min(m_first, sequence);
+      auto last = std::max(m_last, sequence);
+      auto span = static_cast<std::size_t>(last - first) + 1;
+      if(span > m_capacity) {
+        return false;
+      }
+      Reserve(span);
+      if(Find(sequence) != nullptr) {
+        return false;
+      }
+      m_first = first;
+      m_last = last;
+    }
+    m_slots[GetIndex(sequence)] = executionReport;
+    ++m_size;
+    return true;
+  }
+
+  inline void ExecutionReportWriteLog::PopFront() {
+    if(m_size == 0) {
+      return;
+    }
+    m_slots[GetIndex(m_first)] = boost::none;
+    --m_size;
+    if(m_size == 0) {
+      return;
+    }
+    do {
+      ++m_first;
+    } while(!m_slots[GetIndex(m_first)]);
+  }
+
+  inline void ExecutionReportWriteLog::Discard(int sequence) {
+    while(m_size != 0 && m_first <= sequence) {
+      PopFront();
+    }
+  }
+
+  inline std::size_t ExecutionReportWriteLog::GetIndex(int sequence) const {
+    return static_cast<std::size_t>(sequence) & (m_slots.size() - 1);
+  }
+
+  inline void ExecutionReportWriteLog::Reserve(std::size_t span) {
+    if(span <= m_slots.size()) {
+      return;
+    }
+    auto size = std::max<std::size_t>(8, m_slots.size());
+    while(size < span) {
+      size *= 2;
+    }
+    auto slots = std::vector<boost::optional<ExecutionReport>>(size);
+    for(auto& slot : m_slots) {
+      if(slot) {
+        slots[static_cast<std::size_t>(slot->m_sequence) & (size - 1)] =
+          std::move(slot);
+      }
+    }
+    m_slots = std::move(slots);
+  }
+}
+
+#endif
@@ -1,5 +1,6 @@
 #ifndef NEXUS_LOCALORDEREXECUTIONDATASTORE_HPP
 #define NEXUS_LOCALORDEREXECUTIONDATASTORE_HPP
+#include <algorithm>
 #include <Beam/Collections/SynchronizedList.hpp>
 #include <Beam/Collections/SynchronizedMap.hpp>
 #include <Beam/Collections/SynchronizedSet.hpp>
@@ -33,6 +34,11 @@ namespace OrderExecutionService {
       std::vector<SequencedExecutionReport> LoadExecutionReports(
         const AccountQuery& query);
 
+      std::vector<OrderRecord> LoadOrderRecords(
+        const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts,
+        boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+        OrderId startId, int maxCount);
+
       void Store(const SequencedAccountOrderInfo& orderInfo);
 
       void Store(const std::vector<SequencedAccountOrderInfo>& orderInfo);
@@ -96,6 +102,38 @@ namespace OrderExecutionService {
     return m_executionReportDataStore.Load(query);
   }
 
+  inline std::vector<OrderRecord> LocalOrderExecutionDataStore::
+      LoadOrderRecords(
+      const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts,
+      boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+      OrderId startId, int maxCount) {
+    auto submissions = m_orderSubmissionDataStore.LoadAll();
+    auto orderInfo = std::vector<OrderInfo>();
+    for(auto& submission : submissions) {
+      auto& info = **submission;
+      if(info.m_orderId > startId && info.m_timestamp >= startTime &&
+          info.m_timestamp <= endTime && std::find(accounts.begin(),
+          accounts.end(), submission->GetIndex()) != accounts.end()) {
+        orderInfo.push_back(info);
+      }
+    }
+    std::sort(orderInfo.begin(), orderInfo.end(),
+      [] (const auto& lhs, const auto& rhs) {
+        return lhs.m_orderId < rhs.m_orderId;
+      });
+    if(static_cast<int>(orderInfo.size()) > maxCount) {
+      orderInfo.resize(std::max(maxCount, 0));
+    }
+    auto orderRecords = std::vector<OrderRecord>();
+    for(auto& info : orderInfo) {
+      auto executionReports =
+        m_executionReports.Get(info.m_orderId).Acquire();
+      orderRecords.push_back(OrderRecord{std::move(info),
+        std::move(executionReports)});
+    }
+    return orderRecords;
+  }
+
   inline void LocalOrderExecutionDataStore::Store(
       const SequencedAccountOrderInfo& orderInfo) {
     m_orderSubmissionDataStore.Store(orderInfo);
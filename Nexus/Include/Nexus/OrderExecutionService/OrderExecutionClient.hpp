@@ -1,5 +1,6 @@
 #ifndef NEXUS_ORDER_EXECUTION_CLIENT_HPP
 #define NEXUS_ORDER_EXECUTION_CLIENT_HPP
+#include <iostream>
 #include <vector>
 #include <Beam/Collections/SynchronizedMap.hpp>
 #include <Beam/Collections/SynchronizedSet.hpp>
@@ -14,6 +15,7 @@
 #include <boost/noncopyable.hpp>
 #include <boost/range/adaptor/map.hpp>
 #include "Nexus/OrderExecutionService/AccountQuery.hpp"
+#include "Nexus/OrderExecutionService/ExecutionReportWriteLog.hpp"
 #include "Nexus/OrderExecutionService/OrderExecutionService.hpp"
 #include "Nexus/OrderExecutionService/OrderExecutionServices.hpp"
 #include "Nexus/OrderExecutionService/PrimitiveOrder.hpp"
@@ -40,6 +42,15 @@ namespace Nexus::OrderExecutionService {
       template<typename BF>
       explicit OrderExecutionClient(BF&& clientBuilder);
 
+      /**
+       * Constructs an OrderExecutionClient.
+       * @param clientBuilder Initializes the ServiceProtocolClientBuilder.
+       * @param writeLogCapacity The maximum number of sequence numbers that
+       *        out of order ExecutionReports are buffered across per Order.
+       */
+      template<typename BF>
+      OrderExecutionClient(BF&& clientBuilder, std::size_t writeLogCapacity);
+
       ~OrderExecutionClient();
 
       /**
@@ -74,6 +85,23 @@ namespace Nexus::OrderExecutionService {
       void QueryExecutionReports(const AccountQuery& query,
         Beam::ScopedQueueWriter<ExecutionReport> queue);
 
+      /**
+       * Loads a page of the OrderRecords submitted by a set of accounts over a
+       * time range, ordered by OrderId.
+       * @param accounts The accounts and trading group directories to load the
+       *        OrderRecords of.
+       * @param startTime The start of the time range to load.
+       * @param endTime The end of the time range to load.
+       * @param startId Only Orders with an id greater than this are loaded.
+       * @param maxCount The maximum number of OrderRecords to load.
+       * @return The OrderRecords loaded, fewer than <i>maxCount</i> iff no
+       *         further pages remain.
+       */
+      std::vector<OrderRecord> LoadOrderRecords(
+        const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts,
+        boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+        OrderId startId, int maxCount);
+
       /**
        * Submits a new single Order.
        * @param fields The OrderFields to submit.
@@ -99,7 +127,10 @@ namespace Nexus::OrderExecutionService {
     private:
       struct OrderEntry {
         std::shared_ptr<PrimitiveOrder> m_order;
-        std::vector<ExecutionReport> m_writeLog;
+        ExecutionReportWriteLog m_writeLog;
+        bool m_isRecovering;
+
+        explicit OrderEntry(std::size_t writeLogCapacity);
       };
       template<typename Value, typename Query, typename QueryService,
         typename EndQueryMessage>
@@ -121,24 +152,41 @@ namespace Nexus::OrderExecutionService {
         m_orders;
       Beam::SynchronizedUnorderedSet<Beam::ServiceLocator::DirectoryEntry,
         Beam::Threading::Mutex> m_realTimeSubscriptions;
+      std::size_t m_writeLogCapacity;
       std::unordered_map<OrderId, OrderEntry> m_orderEntries;
       Beam::IO::OpenState m_openState;
       Beam::RoutineTaskQueue m_executionReportTasks;
 
       std::shared_ptr<PrimitiveOrder> LoadOrder(const OrderRecord& orderRecord);
+      OrderEntry& GetOrderEntry(OrderId id);
       void OnReconnect(const std::shared_ptr<ServiceProtocolClient>& client);
       void RecoverOrders(ServiceProtocolClient& client);
+      void RecoverOrders(const Beam::ServiceLocator::DirectoryEntry& account,
+        const std::vector<OrderId>& orderIds);
       void Publish(const ExecutionReport& executionReport);
       void OnOrderUpdate(ServiceProtocolClient& sender,
         const ExecutionReport& executionReport);
   };
 
+  template<typename B>
+  OrderExecutionClient<B>::OrderEntry::OrderEntry(std::size_t writeLogCapacity)
+    : m_writeLog(writeLogCapacity),
+      m_isRecovering(false) {}
+
   template<typename B>
   template<typename BF>
   OrderExecutionClient<B>::OrderExecutionClient(BF&& clientBuilder)
+    : OrderExecutionClient(std::forward<BF>(clientBuilder),
+        ExecutionReportWriteLog::DEFAULT_CAPACITY) {}
+
+  template<typename B>
+  template<typename BF>
+  OrderExecutionClient<B>::OrderExecutionClient(BF&& clientBuilder,
+      std::size_t writeLogCapacity)
       : m_clientHandler(std::forward<BF>(clientBuilder)),
         m_orderSubmissionPublisher(Beam::Ref(m_clientHandler)),
-        m_executionReportPublisher(Beam::Ref(m_clientHandler)) {
+        m_executionReportPublisher(Beam::Ref(m_clientHandler)),
+        m_writeLogCapacity(writeLogCapacity) {
     m_clientHandler.SetReconnectHandler(
       std::bind(&OrderExecutionClient::OnReconnect, this,
       std::placeholders::_1));
@@ -198,6 +246,16 @@ namespace Nexus::OrderExecutionService {
     m_executionReportPublisher.SubmitQuery(query, std::move(queue));
   }
 
+  template<typename B>
+  std::vector<OrderRecord> OrderExecutionClient<B>::LoadOrderRecords(
+      const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts,
+      boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+      OrderId startId, int maxCount) {
+    auto client = m_clientHandler.GetClient();
+    return client->template SendRequest<LoadOrderRecordsService>(accounts,
+      startTime, endTime, startId, maxCount);
+  }
+
   template<typename B>
   const Order& OrderExecutionClient<B>::Submit(const OrderFields& fields) {
     auto client = m_clientHandler.GetClient();
@@ -254,19 +312,24 @@ namespace Nexus::OrderExecutionService {
     return m_orders.GetOrInsert(orderRecord.m_info.m_orderId, [&] {
       auto order = std::make_shared<PrimitiveOrder>(orderRecord);
       m_executionReportTasks.Push([=] {
-        auto& orderEntry = m_orderEntries[orderRecord.m_info.m_orderId];
+        auto& orderEntry = GetOrderEntry(orderRecord.m_info.m_orderId);
         orderEntry.m_order = order;
-        if(orderEntry.m_writeLog.empty() ||
-            orderEntry.m_writeLog.front().m_sequence != 0) {
+        if(orderEntry.m_isRecovering) {
+          RecoverOrders(order->GetInfo().m_fields.m_account,
+            {order->GetInfo().m_orderId});
+        }
+        if(orderEntry.m_writeLog.Find(0) == nullptr) {
           return;
         }
         orderEntry.m_order->With(
           [&] (auto orderStatus, const auto& executionReports) {
-            while(!orderEntry.m_writeLog.empty() && (executionReports.empty() ||
-                orderEntry.m_writeLog.front().m_sequence ==
-                executionReports.back().m_sequence + 1)) {
-              orderEntry.m_order->Update(orderEntry.m_writeLog.front());
-              orderEntry.m_writeLog.erase(orderEntry.m_writeLog.begin());
+            while(auto front = orderEntry.m_writeLog.GetFront()) {
+              if(!executionReports.empty() && front->m_sequence !=
+                  executionReports.back().m_sequence + 1) {
+                break;
+              }
+              orderEntry.m_order->Update(*front);
+              orderEntry.m_writeLog.PopFront();
             }
           });
       });
@@ -277,6 +340,12 @@ namespace Nexus::OrderExecutionService {
     });
   }
 
+  template<typename B>
+  typename OrderExecutionClient<B>::OrderEntry&
+      OrderExecutionClient<B>::GetOrderEntry(OrderId id) {
+    return m_orderEntries.try_emplace(id, m_writeLogCapacity).first->second;
+  }
+
   template<typename B>
   void OrderExecutionClient<B>::OnReconnect(
       const std::shared_ptr<ServiceProtocolClient>& client) {
@@ -300,43 +369,55 @@ namespace Nexus::OrderExecutionService {
       }
     });
     for(auto& orderEntry : orderEntries) {
-      auto orderIdExpressions = std::vector<Beam::Queries::Expression>();
-      for(auto& orderId : orderEntry.second) {
-        auto parameterExpression = Beam::Queries::ParameterExpression(
-          0, Queries::OrderInfoType());
-        auto memberExpression = Beam::Queries::MemberAccessExpression(
-          "order_id", Beam::Queries::IdType(), parameterExpression);
-        auto orderIdExpression = Beam::Queries::ConstantExpression(orderId);
-        auto equalsExpression = Beam::Queries::MakeEqualsExpression(
-          memberExpression, orderIdExpression);
-        orderIdExpressions.push_back(equalsExpression);
+      RecoverOrders(orderEntry.first, orderEntry.second);
+    }
+  }
+
+  template<typename B>
+  void OrderExecutionClient<B>::RecoverOrders(
+      const Beam::ServiceLocator::DirectoryEntry& account,
+      const std::vector<OrderId>& orderIds) {
+    auto orderIdExpressions = std::vector<Beam::Queries::Expression>();
+    for(auto& orderId : orderIds) {
+      auto parameterExpression = Beam::Queries::ParameterExpression(
+        0, Queries::OrderInfoType());
+      auto memberExpression = Beam::Queries::MemberAccessExpression(
+        "order_id", Beam::Queries::IdType(), parameterExpression);
+      auto orderIdExpression = Beam::Queries::ConstantExpression(orderId);
+      auto equalsExpression = Beam::Queries::MakeEqualsExpression(
+        memberExpression, orderIdExpression);
+      orderIdExpressions.push_back(equalsExpression);
+    }
+    auto filter = Beam::Queries::MakeOrExpression(orderIdExpressions.begin(),
+      orderIdExpressions.end());
+    auto query = AccountQuery();
+    query.SetIndex(account);
+    query.SetRange(Beam::Queries::Sequence::First(),
+      Beam::Queries::Sequence::Present());
+    query.SetSnapshotLimit(Beam::Queries::SnapshotLimit::Unlimited());
+    query.SetFilter(filter);
+    m_executionReportTasks.Push([=] {
+      auto client = m_clientHandler.GetClient();
+      auto queryResult = client->template SendRequest<
+        QueryOrderSubmissionsService>(query);
+      for(auto& orderRecord : queryResult.m_snapshot) {
+        for(auto& executionReport : orderRecord->m_executionReports) {
+          Publish(executionReport);
+        }
       }
-      auto filter = Beam::Queries::MakeOrExpression(orderIdExpressions.begin(),
-        orderIdExpressions.end());
-      auto query = AccountQuery();
-      query.SetIndex(orderEntry.first);
-      query.SetRange(Beam::Queries::Sequence::First(),
-        Beam::Queries::Sequence::Present());
-      query.SetSnapshotLimit(Beam::Queries::SnapshotLimit::Unlimited());
-      query.SetFilter(filter);
       m_executionReportTasks.Push([=] {
-        auto client = m_clientHandler.GetClient();
-        auto queryResult = client->template SendRequest<
-          QueryOrderSubmissionsService>(query);
-        for(auto& orderRecord : queryResult.m_snapshot) {
-          for(auto& executionReport : orderRecord->m_executionReports) {
-            Publish(executionReport);
-          }
+        for(auto& orderId : orderIds) {
+          GetOrderEntry(orderId).m_isRecovering = false;
         }
       });
-    }
+    });
   }
 
   template<typename B>
   void OrderExecutionClient<B>::Publish(
       const ExecutionReport& executionReport) {
     m_executionReportTasks.Push([=] {
-      auto& orderEntry = m_orderEntries[executionReport.m_id];
+      auto& orderEntry = GetOrderEntry(executionReport.m_id);
       auto addToLog = false;
       if(orderEntry.m_order != nullptr) {
         orderEntry.m_order->With(
@@ -346,16 +427,14 @@ namespace Nexus::OrderExecutionService {
                 (!executionReports.empty() && executionReport.m_sequence ==
                 executionReports.back().m_sequence + 1)) {
               orderEntry.m_order->Update(executionReport);
-              while(!orderEntry.m_writeLog.empty() &&
-                  orderEntry.m_writeLog.front().m_sequence <=
-                  executionReport.m_sequence) {
-                orderEntry.m_writeLog.erase(orderEntry.m_writeLog.begin());
-              }
-              while(!orderEntry.m_writeLog.empty() &&
-                  orderEntry.m_writeLog.front().m_sequence ==
-                  executionReports.back().m_sequence + 1) {
-                orderEntry.m_order->Update(orderEntry.m_writeLog.front());
-                orderEntry.m_writeLog.erase(orderEntry.m_writeLog.begin());
+              orderEntry.m_writeLog.Discard(executionReport.m_sequence);
+              while(auto front = orderEntry.m_writeLog.GetFront()) {
+                if(front->m_sequence !=
+                    executionReports.back().m_sequence + 1) {
+                  break;
+                }
+                orderEntry.m_order->Update(*front);
+                orderEntry.m_writeLog.PopFront();
               }
             } else if(!executionReports.empty() &&
                 executionReport.m_sequence >
@@ -366,16 +445,16 @@ namespace Nexus::OrderExecutionService {
       } else {
         addToLog = true;
       }
-      if(addToLog) {
-        auto insertIterator = Beam::LinearLowerBound(
-          orderEntry.m_writeLog.begin(), orderEntry.m_writeLog.end(),
-          executionReport,
-          [] (const auto& lhs, const auto& rhs) {
-            return lhs.m_sequence < rhs.m_sequence;
-          });
-        if(insertIterator == orderEntry.m_writeLog.end() ||
-            insertIterator->m_sequence != executionReport.m_sequence) {
-          orderEntry.m_writeLog.insert(insertIterator, executionReport);
+      if(addToLog && !orderEntry.m_writeLog.Insert(executionReport) &&
+          orderEntry.m_writeLog.Find(executionReport.m_sequence) == nullptr) {
+        if(!orderEntry.m_isRecovering) {
+          std::cout << "Execution report write log overflow on order " <<
+            executionReport.m_id << ", recovering.\n" << std::flush;
+          orderEntry.m_isRecovering = true;
+          if(orderEntry.m_order != nullptr) {
+            RecoverOrders(orderEntry.m_order->GetInfo().m_fields.m_account,
+              {executionReport.m_id});
+          }
         }
       }
     });
@@ -3,9 +3,11 @@
 #include <vector>
 #include <Beam/IO/Connection.hpp>
 #include <Beam/Utilities/Concept.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 #include "Nexus/OrderExecutionService/AccountOrderSubmissionEntry.hpp"
 #include "Nexus/OrderExecutionService/AccountQuery.hpp"
 #include "Nexus/OrderExecutionService/OrderExecutionService.hpp"
+#include "Nexus/OrderExecutionService/OrderRecord.hpp"
 
 namespace Nexus {
 namespace OrderExecutionService {
@@ -31,6 +33,21 @@ namespace OrderExecutionService {
     std::vector<SequencedExecutionReport> LoadExecutionReports(
       const AccountQuery& query);
 
+    //! Loads the OrderRecords submitted by a set of accounts over a time
+    //! range, ordered by OrderId.
+    /*!
+      \param accounts The accounts to load the OrderRecords of.
+      \param startTime The start of the time range to load.
+      \param endTime The end of the time range to load.
+      \param startId Only Orders with an id greater than this are loaded.
+      \param maxCount The maximum number of OrderRecords to load.
+      \return The OrderRecords satisfying the above criteria.
+    */
+    std::vector<OrderRecord> LoadOrderRecords(
+      const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts,
+      boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+      OrderId startId, int maxCount);
+
     //! Stores a SequencedAccountOrderInfo.
     /*!
       \param orderInfo The SequencedAccountOrderInfo to store.
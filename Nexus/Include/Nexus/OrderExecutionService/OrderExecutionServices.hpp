@@ -1,9 +1,14 @@
 #ifndef NEXUS_ORDEREXECUTIONSERVICES_HPP
 #define NEXUS_ORDEREXECUTIONSERVICES_HPP
+#include <vector>
 #include <Beam/Queries/QueryResult.hpp>
+#include <Beam/Serialization/ShuttleDateTime.hpp>
+#include <Beam/Serialization/ShuttleVector.hpp>
 #include <Beam/Services/Service.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 #include "Nexus/OrderExecutionService/AccountQuery.hpp"
 #include "Nexus/OrderExecutionService/OrderExecutionService.hpp"
+#include "Nexus/OrderExecutionService/OrderRecord.hpp"
 
 namespace Nexus {
 namespace OrderExecutionService {
@@ -57,7 +62,33 @@ namespace OrderExecutionService {
     //! \cond
     (QueryExecutionReportsService,
       "Nexus.OrderExecutionService.QueryExecutionReportsService",
-      ExecutionReportQueryResult, AccountQuery, query));
+      ExecutionReportQueryResult, AccountQuery, query),
+    //! \endcond
+
+    /*! \interface Nexus::OrderExecutionService::LoadOrderRecordsService
+        \brief Loads a page of the OrderRecords submitted by a set of accounts
+               over a time range, ordered by OrderId.
+        \param accounts <code>std::vector<Beam::ServiceLocator::DirectoryEntry>
+               </code> The accounts and trading group directories to load the
+               OrderRecords of.
+        \param start_time <code>boost::posix_time::ptime</code> The start of
+               the time range to load.
+        \param end_time <code>boost::posix_time::ptime</code> The end of the
+               time range to load.
+        \param start_id <code>OrderId</code> Only Orders with an id greater
+               than this are loaded, 0 loads from the beginning.
+        \param max_count <code>int</code> The maximum number of OrderRecords
+               to load.
+        \return <code>std::vector<OrderRecord></code> The OrderRecords loaded,
+                fewer than <i>max_count</i> iff no further pages remain.
+    */
+    //! \cond
+    (LoadOrderRecordsService,
+      "Nexus.OrderExecutionService.LoadOrderRecordsService",
+      std::vector<OrderRecord>, std::vector<
+      Beam::ServiceLocator::DirectoryEntry>, accounts,
+      boost::posix_time::ptime, start_time, boost::posix_time::ptime,
+      end_time, OrderId, start_id, int, max_count));
     //! \endcond
 
   BEAM_DEFINE_MESSAGES(OrderExecutionMessages,
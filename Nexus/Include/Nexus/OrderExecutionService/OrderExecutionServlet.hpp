@@ -1,5 +1,7 @@
 #ifndef NEXUS_ORDER_EXECUTION_SERVLET_HPP
 #define NEXUS_ORDER_EXECUTION_SERVLET_HPP
+#include <algorithm>
+#include <vector>
 #include <Beam/Collections/SynchronizedMap.hpp>
 #include <Beam/Collections/SynchronizedSet.hpp>
 #include <Beam/Pointers/LocalPtr.hpp>
@@ -132,6 +134,11 @@ namespace Nexus::OrderExecutionService {
       void OnQueryExecutionReportsRequest(Beam::Services::RequestToken<
         ServiceProtocolClient, QueryExecutionReportsService>& request,
         const AccountQuery& query);
+      std::vector<OrderRecord> OnLoadOrderRecordsRequest(
+        ServiceProtocolClient& client,
+        const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts,
+        boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+        OrderId startId, int maxCount);
       void OnNewOrderSingleRequest(Beam::Services::RequestToken<
         ServiceProtocolClient, NewOrderSingleService>& request,
         const OrderFields& requestFields);
@@ -193,6 +200,10 @@ namespace Nexus::OrderExecutionService {
     QueryExecutionReportsService::AddRequestSlot(Beam::Store(slots), std::bind(
       &OrderExecutionServlet::OnQueryExecutionReportsRequest, this,
       std::placeholders::_1, std::placeholders::_2));
+    LoadOrderRecordsService::AddSlot(Beam::Store(slots), std::bind(
+      &OrderExecutionServlet::OnLoadOrderRecordsRequest, this,
+      std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
+      std::placeholders::_4, std::placeholders::_5, std::placeholders::_6));
     NewOrderSingleService::AddRequestSlot(Beam::Store(slots), std::bind(
       &OrderExecutionServlet::OnNewOrderSingleRequest, this,
       std::placeholders::_1, std::placeholders::_2));
@@ -430,6 +441,39 @@ namespace Nexus::OrderExecutionService {
       });
   }
 
+  template<typename C, typename T, typename S, typename U, typename A,
+    typename O, typename D>
+  std::vector<OrderRecord> OrderExecutionServlet<C, T, S, U, A, O, D>::
+      OnLoadOrderRecordsRequest(ServiceProtocolClient& client,
+      const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts,
+      boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+      OrderId startId, int maxCount) {
+    auto& session = client.GetSession();
+    auto permittedAccounts =
+      std::vector<Beam::ServiceLocator::DirectoryEntry>();
+    auto addAccount = [&] (const auto& account) {
+      if(session.HasOrderExecutionPermission(account) &&
+          std::find(permittedAccounts.begin(), permittedAccounts.end(),
+            account) == permittedAccounts.end()) {
+        permittedAccounts.push_back(account);
+      }
+    };
+    for(auto& account : accounts) {
+      if(account.m_type ==
+          Beam::ServiceLocator::DirectoryEntry::Type::DIRECTORY) {
+        auto tradingGroup = m_administrationClient->LoadTradingGroup(account);
+        for(auto& trader : tradingGroup.GetTraders()) {
+          addAccount(trader);
+        }
+      } else {
+        addAccount(account);
+      }
+    }
+    maxCount = std::min(maxCount, 1000);
+    return m_dataStore->LoadOrderRecords(permittedAccounts, startTime, endTime,
+      startId, maxCount);
+  }
+
   template<typename C, typename T, typename S, typename U, typename A,
     typename O, typename D>
   void OrderExecutionServlet<C, T, S, U, A, O, D>::OnNewOrderSingleRequest(
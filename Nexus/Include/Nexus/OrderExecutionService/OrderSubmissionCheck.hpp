@@ -13,6 +13,11 @@ namespace OrderExecutionService {
     public:
       virtual ~OrderSubmissionCheck() = default;
 
+      //! Returns <code>true</code> iff this check does not depend on the
+      //! order in which it runs relative to other checks, allowing it to run
+      //! concurrently with them.
+      virtual bool IsIndependent() const;
+
       //! Performs a check on a submission.
       /*!
         \param orderInfo The OrderInfo being submitted.
@@ -32,6 +37,10 @@ namespace OrderExecutionService {
       virtual void Reject(const OrderInfo& orderInfo);
   };
 
+  inline bool OrderSubmissionCheck::IsIndependent() const {
+    return false;
+  }
+
   inline void OrderSubmissionCheck::Add(const Order& order) {}
 
   inline void OrderSubmissionCheck::Reject(const OrderInfo& orderInfo) {}
@@ -1,19 +1,38 @@
 #ifndef NEXUS_ORDER_SUBMISSION_CHECK_DRIVER_HPP
 #define NEXUS_ORDER_SUBMISSION_CHECK_DRIVER_HPP
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 #include <Beam/IO/OpenState.hpp>
 #include <Beam/Pointers/LocalPtr.hpp>
+#include <Beam/Routines/RoutineHandlerGroup.hpp>
+#include <Beam/ServiceLocator/DirectoryEntry.hpp>
+#include <Beam/Threading/Mutex.hpp>
 #include <Beam/Threading/Sync.hpp>
 #include <boost/noncopyable.hpp>
+#include <boost/thread/thread.hpp>
 #include "Nexus/OrderExecutionService/AccountQuery.hpp"
 #include "Nexus/OrderExecutionService/OrderExecutionService.hpp"
+#include "Nexus/OrderExecutionService/OrderExecutionSession.hpp"
+#include "Nexus/OrderExecutionService/OrderInfo.hpp"
 #include "Nexus/OrderExecutionService/OrderSubmissionCheck.hpp"
 #include "Nexus/OrderExecutionService/OrderSubmissionCheckException.hpp"
 
 namespace Nexus::OrderExecutionService {
 
   /**
-   * Performs a series of checks on an Order submission.
+   * Performs a series of checks on an Order submission. Independent checks
+   * run concurrently with one another while all other checks run in the order
+   * they were given. A rejection is reported using the reason from the
+   * earliest failing check in the order the checks were given, and checks
+   * following a known failure are skipped. A submission returns once every
+   * check it started has finished. Rejected Orders are retained per account,
+   * so the Order returned for a rejection stays valid until its account has
+   * submitted REJECTED_ORDER_RETENTION further rejections.
    * @param <D> The type of OrderExecutionDriver to send the submission to if
    *        all checks pass.
    */
@@ -27,6 +46,9 @@ namespace Nexus::OrderExecutionService {
        */
       using OrderExecutionDriver = Beam::GetTryDereferenceType<D>;
 
+      /** The number of rejected Orders kept alive for each account. */
+      static constexpr auto REJECTED_ORDER_RETENTION = std::size_t(1024);
+
       /**
        * Constructs an OrderSubmissionCheckDriver.
        * @param orderExecutionDriver The OrderExecutionDriver to send the
@@ -53,20 +75,79 @@ namespace Nexus::OrderExecutionService {
       void Close();
 
     private:
+      struct RejectedOrders {
+        std::unordered_map<OrderId, std::unique_ptr<Order>> m_orders;
+        std::deque<OrderId> m_history;
+      };
+      using SyncRejectedOrders = Beam::Threading::Sync<std::unordered_map<
+        Beam::ServiceLocator::DirectoryEntry, RejectedOrders>,
+        Beam::Threading::Mutex>;
+      struct Submission {
+        const OrderInfo& m_info;
+        Beam::Threading::Mutex m_mutex;
+        std::size_t m_rejectionIndex;
+        std::exception_ptr m_rejection;
+        std::vector<OrderSubmissionCheck*> m_passedChecks;
+
+        Submission(const OrderInfo& info, std::size_t checkCount);
+        bool IsRejectedBefore(std::size_t index);
+        void Reject(std::size_t index, std::exception_ptr rejection);
+      };
       Beam::GetOptionalLocalPtr<D>
         m_orderExecutionDriver;
-      Beam::Threading::Sync<std::vector<std::unique_ptr<Order>>> m_orders;
+      std::vector<std::unique_ptr<SyncRejectedOrders>> m_rejectedOrders;
       std::vector<std::unique_ptr<OrderSubmissionCheck>> m_checks;
+      std::vector<std::size_t> m_independentChecks;
+      std::vector<std::size_t> m_dependentChecks;
       Beam::IO::OpenState m_openState;
+
+      SyncRejectedOrders& GetShard(
+        const Beam::ServiceLocator::DirectoryEntry& account);
+      void RunCheck(Submission& submission, std::size_t index);
   };
 
+  template<typename D>
+  OrderSubmissionCheckDriver<D>::Submission::Submission(const OrderInfo& info,
+    std::size_t checkCount)
+    : m_info(info),
+      m_rejectionIndex(checkCount) {}
+
+  template<typename D>
+  bool OrderSubmissionCheckDriver<D>::Submission::IsRejectedBefore(
+      std::size_t index) {
+    auto lock = boost::lock_guard(m_mutex);
+    return m_rejectionIndex < index;
+  }
+
+  template<typename D>
+  void OrderSubmissionCheckDriver<D>::Submission::Reject(std::size_t index,
+      std::exception_ptr rejection) {
+    if(index < m_rejectionIndex) {
+      m_rejectionIndex = index;
+      m_rejection = std::move(rejection);
+    }
+  }
+
   template<typename D>
   template<typename DF>
   OrderSubmissionCheckDriver<D>::OrderSubmissionCheckDriver(
     DF&& orderExecutionDriver,
     std::vector<std::unique_ptr<OrderSubmissionCheck>> orderSubmissionChecks)
-    : m_orderExecutionDriver(std::forward<DF>(orderExecutionDriver)),
-      m_checks(std::move(orderSubmissionChecks)) {}
+      : m_orderExecutionDriver(std::forward<DF>(orderExecutionDriver)),
+        m_checks(std::move(orderSubmissionChecks)) {
+    auto shardCount =
+      std::max<std::size_t>(1, boost::thread::hardware_concurrency());
+    for(auto i = std::size_t(0); i < shardCount; ++i) {
+      m_rejectedOrders.push_back(std::make_unique<SyncRejectedOrders>());
+    }
+    for(auto i = std::size_t(0); i != m_checks.size(); ++i) {
+      if(m_checks[i]->IsIndependent()) {
+        m_independentChecks.push_back(i);
+      } else {
+        m_dependentChecks.push_back(i);
+      }
+    }
+  }
 
   template<typename D>
   OrderSubmissionCheckDriver<D>::~OrderSubmissionCheckDriver() {
@@ -86,20 +167,50 @@ namespace Nexus::OrderExecutionService {
   template<typename D>
   const Order& OrderSubmissionCheckDriver<D>::Submit(
       const OrderInfo& orderInfo) {
-    auto submissionIterator = m_checks.begin();
-    try {
-      while(submissionIterator != m_checks.end()) {
-        (*submissionIterator)->Submit(orderInfo);
-        ++submissionIterator;
+    m_openState.EnsureOpen();
+    auto submission = Submission(orderInfo, m_checks.size());
+    auto routines = Beam::Routines::RoutineHandlerGroup();
+    for(auto index : m_independentChecks) {
+      routines.Spawn([&, index] {
+        RunCheck(submission, index);
+      });
+    }
+    for(auto index : m_dependentChecks) {
+      if(submission.IsRejectedBefore(index)) {
+        break;
+      }
+      try {
+        m_checks[index]->Submit(orderInfo);
+      } catch(...) {
+        auto lock = boost::lock_guard(submission.m_mutex);
+        submission.Reject(index, std::current_exception());
+        break;
+      }
+      auto lock = boost::lock_guard(submission.m_mutex);
+      submission.m_passedChecks.push_back(m_checks[index].get());
+    }
+    routines.Wait();
+    if(auto rejection = submission.m_rejection) {
+      for(auto check : submission.m_passedChecks) {
+        check->Reject(orderInfo);
       }
-    } catch(const std::exception& e) {
-      for(auto i = m_checks.begin(); i != submissionIterator; ++i) {
-        (*i)->Reject(orderInfo);
+      auto reason = std::string();
+      try {
+        std::rethrow_exception(rejection);
+      } catch(const std::exception& e) {
+        reason = e.what();
       }
-      auto order = BuildRejectedOrder(orderInfo, e.what());
+      auto order = BuildRejectedOrder(orderInfo, reason);
       auto result = order.get();
-      Beam::Threading::With(m_orders, [&] (auto& orders) {
-        orders.emplace_back(std::move(order));
+      auto& account = orderInfo.m_fields.m_account;
+      Beam::Threading::With(GetShard(account), [&] (auto& shard) {
+        auto& rejectedOrders = shard[account];
+        rejectedOrders.m_orders.emplace(orderInfo.m_orderId, std::move(order));
+        rejectedOrders.m_history.push_back(orderInfo.m_orderId);
+        if(rejectedOrders.m_history.size() > REJECTED_ORDER_RETENTION) {
+          rejectedOrders.m_orders.erase(rejectedOrders.m_history.front());
+          rejectedOrders.m_history.pop_front();
+        }
       });
       return *result;
     }
@@ -113,6 +224,18 @@ namespace Nexus::OrderExecutionService {
   template<typename D>
   void OrderSubmissionCheckDriver<D>::Cancel(
       const OrderExecutionSession& session, OrderId orderId) {
+    // Only the session's own account is searched, a cancel from any other
+    // account goes to the driver as it would for an evicted Order.
+    auto& account = session.GetAccount();
+    auto isRejected = Beam::Threading::With(GetShard(account),
+      [&] (auto& shard) {
+        auto rejectedOrders = shard.find(account);
+        return rejectedOrders != shard.end() &&
+          rejectedOrders->second.m_orders.count(orderId) != 0;
+      });
+    if(isRejected) {
+      return;
+    }
     return m_orderExecutionDriver->Cancel(session, orderId);
   }
 
@@ -125,8 +248,37 @@ namespace Nexus::OrderExecutionService {
 
   template<typename D>
   void OrderSubmissionCheckDriver<D>::Close() {
+    if(m_openState.SetClosing()) {
+      return;
+    }
     m_openState.Close();
   }
+
+  template<typename D>
+  typename OrderSubmissionCheckDriver<D>::SyncRejectedOrders&
+      OrderSubmissionCheckDriver<D>::GetShard(
+      const Beam::ServiceLocator::DirectoryEntry& account) {
+    return *m_rejectedOrders[std::hash<Beam::ServiceLocator::DirectoryEntry>()(
+      account) % m_rejectedOrders.size()];
+  }
+
+  template<typename D>
+  void OrderSubmissionCheckDriver<D>::RunCheck(Submission& submission,
+      std::size_t index) {
+    if(submission.IsRejectedBefore(index)) {
+      return;
+    }
+    auto& check = *m_checks[index];
+    try {
+      check.Submit(submission.m_info);
+    } catch(...) {
+      auto lock = boost::lock_guard(submission.m_mutex);
+      submission.Reject(index, std::current_exception());
+      return;
+    }
+    auto lock = boost::lock_guard(submission.m_mutex);
+    submission.m_passedChecks.push_back(&check);
+  }
 }
 
 #endif
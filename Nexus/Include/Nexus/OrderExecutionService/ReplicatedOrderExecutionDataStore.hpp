@@ -1,9 +1,19 @@
 #ifndef NEXUS_REPLICATEDORDEREXECUTIONDATASTORE_HPP
 #define NEXUS_REPLICATEDORDEREXECUTIONDATASTORE_HPP
+#include <algorithm>
+#include <deque>
 #include <iostream>
+#include <unordered_map>
 #include <vector>
+#include <Beam/IO/OpenState.hpp>
+#include <Beam/Queues/RoutineTaskQueue.hpp>
+#include <Beam/Threading/Mutex.hpp>
+#include <Beam/Threading/Sync.hpp>
+#include <Beam/Utilities/ReportException.hpp>
 #include <boost/atomic/atomic.hpp>
 #include <boost/noncopyable.hpp>
+#include <boost/optional/optional.hpp>
+#include <boost/variant/variant.hpp>
 #include "Nexus/OrderExecutionService/VirtualOrderExecutionDataStore.hpp"
 #include "Nexus/OrderExecutionService/OrderExecutionService.hpp"
 
@@ -12,10 +22,26 @@ namespace OrderExecutionService {
 
   /*! \class ReplicatedOrderExecutionDataStore
       \brief Duplicates an OrderExecutionDataStore across multiple instances.
+      \details Writes go to the primary synchronously and are queued to each
+               duplicate, which applies them asynchronously in batches.
+               Queries are only routed to duplicates that have replicated
+               every write the query depends on, otherwise they go to the
+               primary.
+               Watermarks are not persisted, instead they are derived from
+               the data stores themselves: a duplicate is fenced off for an
+               account until, on its own thread, it has loaded the primary's
+               tail, compared it with its own and copied any missing records
+               over. Until then the account's queries go to the primary.
+               A duplicate that fails a write is taken out of rotation and
+               keeps its unapplied writes, retrying them on the next write.
    */
   class ReplicatedOrderExecutionDataStore : private boost::noncopyable {
     public:
 
+      //! The maximum number of writes a faulted duplicate retains before
+      //! discarding them and resynchronizing from the primary.
+      static constexpr auto MAX_PENDING_WRITES = std::size_t(100000);
+
       //! Constructs an empty ReplicatedOrderExecutionDataStore.
       /*!
         \param primaryDataStore The primary data store to access.
@@ -34,26 +60,100 @@ namespace OrderExecutionService {
       std::vector<SequencedExecutionReport> LoadExecutionReports(
         const AccountQuery& query);
 
+      std::vector<OrderRecord> LoadOrderRecords(
+        const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts,
+        boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+        OrderId startId, int maxCount);
+
+      //! Stores a submission, any failure to store it in the primary is
+      //! propagated and the submission is not replicated.
       void Store(const SequencedAccountOrderInfo& orderInfo);
 
+      //! Stores an ExecutionReport, any failure to store it in the primary is
+      //! propagated and the report is not replicated.
       void Store(const SequencedAccountExecutionReport& executionReport);
 
       void Close();
 
     private:
+      struct Watermark {
+        Beam::Queries::Sequence m_orderSubmission;
+        Beam::Queries::Sequence m_executionReport;
+        bool m_isLoaded;
+
+        Watermark();
+      };
+      using Watermarks = std::unordered_map<
+        Beam::ServiceLocator::DirectoryEntry, Watermark>;
+      using SyncWatermarks =
+        Beam::Threading::Sync<Watermarks, Beam::Threading::Mutex>;
+      using Write = boost::variant<SequencedAccountOrderInfo,
+        SequencedAccountExecutionReport>;
+      struct PendingWrites {
+        std::deque<Write> m_writes;
+        bool m_isScheduled;
+
+        PendingWrites();
+      };
+      struct Replica {
+        std::unique_ptr<VirtualOrderExecutionDataStore> m_dataStore;
+        Beam::Threading::Sync<PendingWrites, Beam::Threading::Mutex>
+          m_pendingWrites;
+        SyncWatermarks m_watermarks;
+        boost::atomic<bool> m_isFaulted;
+        Beam::RoutineTaskQueue m_tasks;
+
+        Replica(std::unique_ptr<VirtualOrderExecutionDataStore> dataStore);
+      };
       std::unique_ptr<VirtualOrderExecutionDataStore> m_primaryDataStore;
-      std::vector<std::unique_ptr<VirtualOrderExecutionDataStore>>
-        m_duplicateDataStores;
+      SyncWatermarks m_watermarks;
+      std::vector<std::unique_ptr<Replica>> m_replicas;
       boost::atomic<std::size_t> m_nextDataStore;
+      Beam::IO::OpenState m_openState;
+
+      static Beam::Queries::Sequence GetRequiredSequence(
+        const AccountQuery& query, Beam::Queries::Sequence sequence);
+      static Watermark LoadTail(VirtualOrderExecutionDataStore& dataStore,
+        const Beam::ServiceLocator::DirectoryEntry& account);
+      boost::optional<Watermark> FindWatermark(
+        const Beam::ServiceLocator::DirectoryEntry& account);
+      Watermark LoadWatermark(
+        const Beam::ServiceLocator::DirectoryEntry& account);
+      template<typename F>
+      VirtualOrderExecutionDataStore* FindReplica(
+        const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts,
+        F&& isCaughtUp);
+      void Replicate(Replica& replica, const Write& write);
+      void Drain(Replica& replica);
+      void ScheduleSynchronize(Replica& replica,
+        const Beam::ServiceLocator::DirectoryEntry& account);
+      void Synchronize(Replica& replica,
+        const Beam::ServiceLocator::DirectoryEntry& account);
   };
 
+  inline ReplicatedOrderExecutionDataStore::Watermark::Watermark()
+    : m_orderSubmission(Beam::Queries::Sequence::First()),
+      m_executionReport(Beam::Queries::Sequence::First()),
+      m_isLoaded(false) {}
+
+  inline ReplicatedOrderExecutionDataStore::PendingWrites::PendingWrites()
+    : m_isScheduled(false) {}
+
+  inline ReplicatedOrderExecutionDataStore::Replica::Replica(
+    std::unique_ptr<VirtualOrderExecutionDataStore> dataStore)
+    : m_dataStore(std::move(dataStore)),
+      m_isFaulted(false) {}
+
   inline ReplicatedOrderExecutionDataStore::ReplicatedOrderExecutionDataStore(
       std::unique_ptr<VirtualOrderExecutionDataStore> primaryDataStore,
       std::vector<std::unique_ptr<VirtualOrderExecutionDataStore>>
       duplicateDataStores)
       : m_primaryDataStore{std::move(primaryDataStore)},
-        m_duplicateDataStores(std::move(duplicateDataStores)),
-        m_nextDataStore{0} {}
+        m_nextDataStore{0} {
+    for(auto& dataStore : duplicateDataStores) {
+      m_replicas.push_back(std::make_unique<Replica>(std::move(dataStore)));
+    }
+  }
 
   inline ReplicatedOrderExecutionDataStore::
       ~ReplicatedOrderExecutionDataStore() {
@@ -63,46 +163,370 @@ namespace OrderExecutionService {
   inline std::vector<SequencedOrderRecord>
       ReplicatedOrderExecutionDataStore::LoadOrderSubmissions(
       const AccountQuery& query) {
-    if(m_duplicateDataStores.empty()) {
-      return m_primaryDataStore->LoadOrderSubmissions(query);
-    }
-    auto index = ++m_nextDataStore;
-    index = index % m_duplicateDataStores.size();
-    return m_duplicateDataStores[index]->LoadOrderSubmissions(query);
+    auto required = FindWatermark(query.GetIndex());
+    auto dataStore = FindReplica({query.GetIndex()},
+      [&] (std::size_t, const Watermark& watermark) {
+        return required && watermark.m_orderSubmission >=
+          GetRequiredSequence(query, required->m_orderSubmission);
+      });
+    return dataStore->LoadOrderSubmissions(query);
   }
 
   inline std::vector<SequencedExecutionReport>
       ReplicatedOrderExecutionDataStore::LoadExecutionReports(
       const AccountQuery& query) {
-    if(m_duplicateDataStores.empty()) {
-      return m_primaryDataStore->LoadExecutionReports(query);
+    auto required = FindWatermark(query.GetIndex());
+    auto dataStore = FindReplica({query.GetIndex()},
+      [&] (std::size_t, const Watermark& watermark) {
+        return required && watermark.m_executionReport >=
+          GetRequiredSequence(query, required->m_executionReport);
+      });
+    return dataStore->LoadExecutionReports(query);
+  }
+
+  inline std::vector<OrderRecord>
+      ReplicatedOrderExecutionDataStore::LoadOrderRecords(
+      const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts,
+      boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+      OrderId startId, int maxCount) {
+    auto requiredWatermarks = std::vector<boost::optional<Watermark>>();
+    for(auto& account : accounts) {
+      requiredWatermarks.push_back(FindWatermark(account));
     }
-    auto index = ++m_nextDataStore;
-    index = index % m_duplicateDataStores.size();
-    return m_duplicateDataStores[index]->LoadExecutionReports(query);
+    auto dataStore = FindReplica(accounts,
+      [&] (std::size_t i, const Watermark& watermark) {
+        auto& required = requiredWatermarks[i];
+        return required &&
+          watermark.m_orderSubmission >= required->m_orderSubmission &&
+          watermark.m_executionReport >= required->m_executionReport;
+      });
+    return dataStore->LoadOrderRecords(accounts, startTime, endTime, startId,
+      maxCount);
   }
 
   inline void ReplicatedOrderExecutionDataStore::Store(
       const SequencedAccountOrderInfo& orderInfo) {
     m_primaryDataStore->Store(orderInfo);
-    for(auto& dataStore : m_duplicateDataStores) {
-      dataStore->Store(orderInfo);
+    Beam::Threading::With(m_watermarks, [&] (auto& watermarks) {
+      auto& sequence = watermarks[orderInfo->GetIndex()].m_orderSubmission;
+      sequence = std::max(sequence, orderInfo.GetSequence());
+    });
+    for(auto& replica : m_replicas) {
+      Replicate(*replica, orderInfo);
     }
   }
 
   inline void ReplicatedOrderExecutionDataStore::Store(
       const SequencedAccountExecutionReport& executionReport) {
     m_primaryDataStore->Store(executionReport);
-    for(auto& dataStore : m_duplicateDataStores) {
-      dataStore->Store(executionReport);
+    Beam::Threading::With(m_watermarks, [&] (auto& watermarks) {
+      auto& sequence =
+        watermarks[executionReport->GetIndex()].m_executionReport;
+      sequence = std::max(sequence, executionReport.GetSequence());
+    });
+    for(auto& replica : m_replicas) {
+      Replicate(*replica, executionReport);
     }
   }
 
   inline void ReplicatedOrderExecutionDataStore::Close() {
-    for(auto& dataStore : m_duplicateDataStores) {
-      dataStore->Close();
+    if(m_openState.SetClosing()) {
+      return;
+    }
+    for(auto& replica : m_replicas) {
+      replica->m_tasks.Break();
+    }
+    for(auto& replica : m_replicas) {
+      replica->m_tasks.Wait();
+      replica->m_dataStore->Close();
     }
     m_primaryDataStore->Close();
+    m_openState.Close();
+  }
+
+  inline Beam::Queries::Sequence
+      ReplicatedOrderExecutionDataStore::GetRequiredSequence(
+      const AccountQuery& query, Beam::Queries::Sequence sequence) {
+    if(auto end = boost::get<Beam::Queries::Sequence>(
+        &query.GetRange().GetEnd())) {
+      return std::min(*end, sequence);
+    }
+    return sequence;
+  }
+
+  inline ReplicatedOrderExecutionDataStore::Watermark
+      ReplicatedOrderExecutionDataStore::LoadTail(
+      VirtualOrderExecutionDataStore& dataStore,
+      const Beam::ServiceLocator::DirectoryEntry& account) {
+    auto query = AccountQuery();
+    query.SetIndex(account);
+    query.SetRange(Beam::Queries::Range::Total());
+    query.SetSnapshotLimit(Beam::Queries::SnapshotLimit::Type::TAIL, 1);
+    auto tail = Watermark();
+    auto submissions = dataStore.LoadOrderSubmissions(query);
+    if(!submissions.empty()) {
+      tail.m_orderSubmission = submissions.back().GetSequence();
+    }
+    auto executionReports = dataStore.LoadExecutionReports(query);
+    if(!executionReports.empty()) {
+      tail.m_executionReport = executionReports.back().GetSequence();
+    }
+    return tail;
+  }
+
+  inline boost::optional<ReplicatedOrderExecutionDataStore::Watermark>
+      ReplicatedOrderExecutionDataStore::FindWatermark(
+      const Beam::ServiceLocator::DirectoryEntry& account) {
+    return Beam::Threading::With(m_watermarks,
+      [&] (auto& watermarks) -> boost::optional<Watermark> {
+        auto watermark = watermarks.find(account);
+        if(watermark == watermarks.end() || !watermark->second.m_isLoaded) {
+          return boost::none;
+        }
+        return watermark->second;
+      });
+  }
+
+  inline ReplicatedOrderExecutionDataStore::Watermark
+      ReplicatedOrderExecutionDataStore::LoadWatermark(
+      const Beam::ServiceLocator::DirectoryEntry& account) {
+    if(auto watermark = FindWatermark(account)) {
+      return *watermark;
+    }
+
+    // Stores made while the tail loads are merged into the same entry, so
+    // none of them is lost when the tail is recorded.
+    auto tail = LoadTail(*m_primaryDataStore, account);
+    return Beam::Threading::With(m_watermarks, [&] (auto& watermarks) {
+      auto& watermark = watermarks[account];
+      watermark.m_orderSubmission = std::max(watermark.m_orderSubmission,
+        tail.m_orderSubmission);
+      watermark.m_executionReport = std::max(watermark.m_executionReport,
+        tail.m_executionReport);
+      watermark.m_isLoaded = true;
+      return watermark;
+    });
+  }
+
+  template<typename F>
+  VirtualOrderExecutionDataStore*
+      ReplicatedOrderExecutionDataStore::FindReplica(
+      const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts,
+      F&& isCaughtUp) {
+    if(m_replicas.empty()) {
+      return m_primaryDataStore.get();
+    }
+    auto start = ++m_nextDataStore;
+    for(auto i = std::size_t(0); i != m_replicas.size(); ++i) {
+      auto& replica = *m_replicas[(start + i) % m_replicas.size()];
+      if(replica.m_isFaulted) {
+        continue;
+      }
+      auto unverifiedAccounts =
+        std::vector<Beam::ServiceLocator::DirectoryEntry>();
+      auto isReplicaCaughtUp = Beam::Threading::With(replica.m_watermarks,
+        [&] (auto& watermarks) {
+          auto isReplicaCaughtUp = true;
+          for(auto j = std::size_t(0); j != accounts.size(); ++j) {
+            auto watermark = watermarks.find(accounts[j]);
+            if(watermark == watermarks.end()) {
+              unverifiedAccounts.push_back(accounts[j]);
+              isReplicaCaughtUp = false;
+            } else if(!isCaughtUp(j, watermark->second)) {
+              isReplicaCaughtUp = false;
+            }
+          }
+          return isReplicaCaughtUp;
+        });
+      for(auto& account : unverifiedAccounts) {
+        ScheduleSynchronize(replica, account);
+      }
+      if(isReplicaCaughtUp) {
+        return replica.m_dataStore.get();
+      }
+    }
+    return m_primaryDataStore.get();
+  }
+
+  inline void ReplicatedOrderExecutionDataStore::Replicate(Replica& replica,
+      const Write& write) {
+    auto isIdle = Beam::Threading::With(replica.m_pendingWrites,
+      [&] (auto& pendingWrites) {
+        pendingWrites.m_writes.push_back(write);
+        if(pendingWrites.m_isScheduled) {
+          return false;
+        }
+        pendingWrites.m_isScheduled = true;
+        return true;
+      });
+    if(isIdle) {
+      replica.m_tasks.Push([=, &replica] {
+        Drain(replica);
+      });
+    }
+  }
+
+  inline void ReplicatedOrderExecutionDataStore::Drain(Replica& replica) {
+    auto writes = std::deque<Write>();
+    Beam::Threading::With(replica.m_pendingWrites, [&] (auto& pendingWrites) {
+      writes.swap(pendingWrites.m_writes);
+    });
+
+    // Writes already applied are skipped, and writes to an account this
+    // replica has yet to verify are left for its synchronization to copy.
+    auto orderInfos = std::vector<SequencedAccountOrderInfo>();
+    auto executionReports = std::vector<SequencedAccountExecutionReport>();
+    auto unverifiedAccounts =
+      std::vector<Beam::ServiceLocator::DirectoryEntry>();
+    Beam::Threading::With(replica.m_watermarks, [&] (auto& watermarks) {
+      for(auto& write : writes) {
+        if(auto orderInfo = boost::get<SequencedAccountOrderInfo>(&write)) {
+          auto watermark = watermarks.find((*orderInfo)->GetIndex());
+          if(watermark == watermarks.end()) {
+            unverifiedAccounts.push_back((*orderInfo)->GetIndex());
+          } else if(watermark->second.m_orderSubmission <
+              orderInfo->GetSequence()) {
+            orderInfos.push_back(*orderInfo);
+          }
+        } else {
+          auto& executionReport =
+            boost::get<SequencedAccountExecutionReport>(write);
+          auto watermark = watermarks.find(executionReport->GetIndex());
+          if(watermark == watermarks.end()) {
+            unverifiedAccounts.push_back(executionReport->GetIndex());
+          } else if(watermark->second.m_executionReport <
+              executionReport.GetSequence()) {
+            executionReports.push_back(executionReport);
+          }
+        }
+      }
+    });
+    for(auto i = unverifiedAccounts.begin(); i != unverifiedAccounts.end();
+        ++i) {
+      if(std::find(unverifiedAccounts.begin(), i, *i) == i) {
+        ScheduleSynchronize(replica, *i);
+      }
+    }
+    try {
+      if(!orderInfos.empty()) {
+        replica.m_dataStore->Store(orderInfos);
+        Beam::Threading::With(replica.m_watermarks, [&] (auto& watermarks) {
+          for(auto& orderInfo : orderInfos) {
+            auto& sequence =
+              watermarks[orderInfo->GetIndex()].m_orderSubmission;
+            sequence = std::max(sequence, orderInfo.GetSequence());
+          }
+        });
+      }
+      if(!executionReports.empty()) {
+        replica.m_dataStore->Store(executionReports);
+        Beam::Threading::With(replica.m_watermarks, [&] (auto& watermarks) {
+          for(auto& executionReport : executionReports) {
+            auto& sequence =
+              watermarks[executionReport->GetIndex()].m_executionReport;
+            sequence = std::max(sequence, executionReport.GetSequence());
+          }
+        });
+      }
+    } catch(const std::exception&) {
+      if(!replica.m_isFaulted.exchange(true)) {
+        std::cout << "Replica faulted, writes will be retried: " <<
+          BEAM_REPORT_CURRENT_EXCEPTION() << std::flush;
+      }
+      auto isDiscarded = Beam::Threading::With(replica.m_pendingWrites,
+        [&] (auto& pendingWrites) {
+          pendingWrites.m_writes.insert(pendingWrites.m_writes.begin(),
+            writes.begin(), writes.end());
+          pendingWrites.m_isScheduled = false;
+          if(pendingWrites.m_writes.size() <= MAX_PENDING_WRITES) {
+            return false;
+          }
+          pendingWrites.m_writes.clear();
+          return true;
+        });
+      if(isDiscarded) {
+        Beam::Threading::With(replica.m_watermarks, [] (auto& watermarks) {
+          watermarks.clear();
+        });
+        std::cout << "Replica backlog discarded, accounts will be "
+          "resynchronized from the primary.\n" << std::flush;
+      }
+      return;
+    }
+    if(replica.m_isFaulted.exchange(false)) {
+      std::cout << "Replica recovered.\n" << std::flush;
+    }
+    auto isIdle = Beam::Threading::With(replica.m_pendingWrites,
+      [&] (auto& pendingWrites) {
+        if(pendingWrites.m_writes.empty()) {
+          pendingWrites.m_isScheduled = false;
+          return true;
+        }
+        return false;
+      });
+    if(!isIdle) {
+      replica.m_tasks.Push([=, &replica] {
+        Drain(replica);
+      });
+    }
+  }
+
+  inline void ReplicatedOrderExecutionDataStore::ScheduleSynchronize(
+      Replica& replica, const Beam::ServiceLocator::DirectoryEntry& account) {
+    replica.m_tasks.Push([=, &replica] {
+      try {
+        Synchronize(replica, account);
+      } catch(const std::exception&) {
+        std::cout << "Replica synchronization failed: " <<
+          BEAM_REPORT_CURRENT_EXCEPTION() << std::flush;
+      }
+    });
+  }
+
+  inline void ReplicatedOrderExecutionDataStore::Synchronize(Replica& replica,
+      const Beam::ServiceLocator::DirectoryEntry& account) {
+    auto isVerified = Beam::Threading::With(replica.m_watermarks,
+      [&] (auto& watermarks) {
+        return watermarks.find(account) != watermarks.end();
+      });
+    if(isVerified) {
+      return;
+    }
+    auto target = LoadWatermark(account);
+    auto tail = LoadTail(*replica.m_dataStore, account);
+    auto query = AccountQuery();
+    query.SetIndex(account);
+    query.SetSnapshotLimit(Beam::Queries::SnapshotLimit::Unlimited());
+    if(tail.m_orderSubmission < target.m_orderSubmission) {
+      query.SetRange(Beam::Queries::Increment(tail.m_orderSubmission),
+        target.m_orderSubmission);
+      auto orderInfos = std::vector<SequencedAccountOrderInfo>();
+      for(auto& submission : m_primaryDataStore->LoadOrderSubmissions(query)) {
+        orderInfos.push_back(Beam::Queries::SequencedValue(
+          Beam::Queries::IndexedValue(submission->m_info, account),
+          submission.GetSequence()));
+      }
+      replica.m_dataStore->Store(orderInfos);
+    }
+    if(tail.m_executionReport < target.m_executionReport) {
+      query.SetRange(Beam::Queries::Increment(tail.m_executionReport),
+        target.m_executionReport);
+      auto executionReports = std::vector<SequencedAccountExecutionReport>();
+      for(auto& executionReport :
+          m_primaryDataStore->LoadExecutionReports(query)) {
+        executionReports.push_back(Beam::Queries::SequencedValue(
+          Beam::Queries::IndexedValue(*executionReport, account),
+          executionReport.GetSequence()));
+      }
+      replica.m_dataStore->Store(executionReports);
+    }
+    Beam::Threading::With(replica.m_watermarks, [&] (auto& watermarks) {
+      auto& watermark = watermarks[account];
+      watermark.m_orderSubmission = std::max({watermark.m_orderSubmission,
+        tail.m_orderSubmission, target.m_orderSubmission});
+      watermark.m_executionReport = std::max({watermark.m_executionReport,
+        tail.m_executionReport, target.m_executionReport});
+    });
   }
 }
 }
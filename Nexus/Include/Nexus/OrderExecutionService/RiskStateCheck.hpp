@@ -35,6 +35,8 @@ namespace OrderExecutionService {
 
       virtual ~RiskStateCheck() = default;
 
+      virtual bool IsIndependent() const;
+
       virtual void Submit(const OrderInfo& orderInfo);
 
       virtual void Add(const Order& order);
@@ -70,6 +72,11 @@ namespace OrderExecutionService {
       : m_administrationClient(std::forward<AdministrationClientForward>(
           administrationClient)) {}
 
+  template<typename AdministrationClientType>
+  bool RiskStateCheck<AdministrationClientType>::IsIndependent() const {
+    return true;
+  }
+
   template<typename AdministrationClientType>
   void RiskStateCheck<AdministrationClientType>::Submit(
       const OrderInfo& orderInfo) {
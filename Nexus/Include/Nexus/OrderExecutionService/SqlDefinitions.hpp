@@ -117,6 +117,18 @@ namespace Nexus::OrderExecutionService {
     return ROW;
   }
 
+  inline const auto& GetTimestampedOrderInfoRow() {
+    static auto ROW = GetOrderInfoRow().
+      add_column("timestamp",
+        [] (auto& row) {
+          return Beam::ToSqlTimestamp(row.m_timestamp);
+        },
+        [] (auto& row, auto column) {
+          row.m_timestamp = Beam::FromSqlTimestamp(column);
+        });
+    return ROW;
+  }
+
   inline const auto& GetExecutionReportRow() {
     static auto ROW = Viper::Row<ExecutionReport>().
       add_column("order_id", &ExecutionReport::m_id).
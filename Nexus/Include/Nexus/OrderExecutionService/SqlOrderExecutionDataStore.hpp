@@ -1,7 +1,9 @@
 #ifndef NEXUS_SQL_ORDER_EXECUTION_DATA_STORE_HPP
 #define NEXUS_SQL_ORDER_EXECUTION_DATA_STORE_HPP
+#include <algorithm>
 #include <functional>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 #include <Beam/IO/OpenState.hpp>
 #include <Beam/Queries/SqlDataStore.hpp>
@@ -61,6 +63,11 @@ namespace Nexus::OrderExecutionService {
       std::vector<SequencedExecutionReport> LoadExecutionReports(
         const AccountQuery& query);
 
+      std::vector<OrderRecord> LoadOrderRecords(
+        const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts,
+        boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+        OrderId startId, int maxCount);
+
       void Store(const SequencedAccountOrderInfo& orderInfo);
 
       void Store(const std::vector<SequencedAccountOrderInfo>& orderInfo);
@@ -160,6 +167,21 @@ namespace Nexus::OrderExecutionService {
           "is_live FROM submissions LEFT JOIN live_orders ON "
           "submissions.order_id = live_orders.order_id");
       }
+
+      // The timestamp column is added by the underlying data store rather
+      // than the row, so the index is created here, which also covers tables
+      // created before the index existed. Hinting a missing index fails.
+      auto hasMarketIndex = true;
+      try {
+        writerConnection->execute("SELECT 1 FROM submissions FORCE INDEX "
+          "(account_market_timestamp) LIMIT 0");
+      } catch(const std::exception&) {
+        hasMarketIndex = false;
+      }
+      if(!hasMarketIndex) {
+        writerConnection->execute("CREATE INDEX account_market_timestamp ON "
+          "submissions (account, market, timestamp)");
+      }
     } catch(const std::exception&) {
       Close();
       BOOST_RETHROW;
@@ -214,6 +236,67 @@ namespace Nexus::OrderExecutionService {
     return m_executionReportDataStore.Load(query);
   }
 
+  template<typename C>
+  std::vector<OrderRecord> SqlOrderExecutionDataStore<C>::LoadOrderRecords(
+      const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts,
+      boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+      OrderId startId, int maxCount) {
+    if(accounts.empty() || maxCount <= 0) {
+      return {};
+    }
+    auto accountCondition = Viper::literal(false);
+    for(auto& account : accounts) {
+      accountCondition = accountCondition ||
+        Viper::sym("account") == account.m_id;
+    }
+    auto orderInfo = std::vector<OrderInfo>();
+    {
+      auto connection = m_readerPool.Acquire();
+      connection->execute(Viper::select(GetTimestampedOrderInfoRow(),
+        "submissions", accountCondition && Viper::sym("order_id") > startId &&
+        Viper::sym("timestamp") >= Beam::ToSqlTimestamp(startTime) &&
+        Viper::sym("timestamp") <= Beam::ToSqlTimestamp(endTime),
+        Viper::order_by("order_id", Viper::Order::ASC), Viper::limit(maxCount),
+        std::back_inserter(orderInfo)));
+    }
+    if(orderInfo.empty()) {
+      return {};
+    }
+
+    // The execution reports for the whole page are loaded in one query by
+    // bounding the order ids rather than issuing a query per order.
+    auto sequencedExecutionReports = m_executionReportDataStore.Load(
+      accountCondition &&
+      Viper::sym("order_id") >= orderInfo.front().m_orderId &&
+      Viper::sym("order_id") <= orderInfo.back().m_orderId);
+    auto executionReports =
+      std::unordered_map<OrderId, std::vector<ExecutionReport>>();
+    for(auto& executionReport : sequencedExecutionReports) {
+      executionReports[executionReport->m_id].push_back(
+        std::move(*executionReport));
+    }
+    auto orderRecords = std::vector<OrderRecord>();
+    orderRecords.reserve(orderInfo.size());
+    for(auto& order : orderInfo) {
+      order.m_fields.m_account = m_accountEntries.Load(
+        order.m_fields.m_account.m_id);
+      order.m_submissionAccount = m_accountEntries.Load(
+        order.m_submissionAccount.m_id);
+      auto reports = std::vector<ExecutionReport>();
+      auto reportsIterator = executionReports.find(order.m_orderId);
+      if(reportsIterator != executionReports.end()) {
+        reports = std::move(reportsIterator->second);
+        std::sort(reports.begin(), reports.end(),
+          [] (const auto& lhs, const auto& rhs) {
+            return lhs.m_sequence < rhs.m_sequence;
+          });
+      }
+      orderRecords.push_back(OrderRecord(std::move(order),
+        std::move(reports)));
+    }
+    return orderRecords;
+  }
+
   template<typename C>
   void SqlOrderExecutionDataStore<C>::Store(
       const SequencedAccountOrderInfo& orderInfo) {
@@ -1,7 +1,9 @@
 #ifndef NEXUS_ORDER_EXECUTION_SERVICE_STANDARD_QUERIES_HPP
 #define NEXUS_ORDER_EXECUTION_SERVICE_STANDARD_QUERIES_HPP
+#include <algorithm>
 #include <unordered_map>
 #include <vector>
+#include <Beam/Queries/AndExpression.hpp>
 #include <Beam/Queries/ConstantExpression.hpp>
 #include <Beam/Queries/MemberAccessExpression.hpp>
 #include <Beam/Queries/ParameterExpression.hpp>
@@ -79,6 +81,73 @@ namespace Nexus::OrderExecutionService {
     return dailyOrderSubmissionQuery;
   }
 
+  /**
+   * Builds a query to retrieve Orders submitted to any market on a daily basis
+   * where each market's day is measured in its own time zone.
+   * @param account The account to query.
+   * @param startTime The first day to retrieve order submissions for.
+   * @param endTime The last day to retrieve order submissions for.
+   * @param marketDatabase The database containing Market info.
+   * @param timeZoneDatabase The database of timezones.
+   * @return An AccountQuery whose filter consists of one clause per time zone,
+   *         each matching that time zone's markets over its UTC range.
+   */
+  inline AccountQuery BuildDailyOrderSubmissionQuery(
+      const Beam::ServiceLocator::DirectoryEntry& account,
+      boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+      const MarketDatabase& marketDatabase,
+      const boost::local_time::tz_database& timeZoneDatabase) {
+    auto marketTimeZones =
+      std::unordered_map<std::string, std::vector<MarketCode>>();
+    for(auto& market : marketDatabase.GetEntries()) {
+      marketTimeZones[market.m_timeZone].push_back(market.m_code);
+    }
+    auto infoParameterExpression = Beam::Queries::ParameterExpression(
+      0, Nexus::Queries::OrderInfoType());
+    auto timestampAccessExpression = Beam::Queries::MemberAccessExpression(
+      "timestamp", Beam::Queries::DateTimeType(), infoParameterExpression);
+    auto rangeStart = boost::posix_time::ptime(boost::posix_time::pos_infin);
+    auto rangeEnd = boost::posix_time::ptime(boost::posix_time::neg_infin);
+    auto timeZoneExpressions = std::vector<Beam::Queries::Expression>();
+    for(auto& marketTimeZone : marketTimeZones) {
+      auto marketStartOfDay = MarketDateToUtc(marketTimeZone.second.front(),
+        startTime, marketDatabase, timeZoneDatabase);
+      auto marketExpressions = std::vector<Beam::Queries::Expression>();
+      for(auto& market : marketTimeZone.second) {
+        marketExpressions.push_back(BuildMarketFilter(market));
+      }
+      auto timeZoneExpression = Beam::Queries::Expression(
+        Beam::Queries::AndExpression(Beam::Queries::MakeOrExpression(
+        marketExpressions.begin(), marketExpressions.end()),
+        Beam::Queries::MakeLessEqualsExpression(
+        Beam::Queries::ConstantExpression(
+        Beam::Queries::DateTimeValue(marketStartOfDay)),
+        timestampAccessExpression)));
+      rangeStart = std::min(rangeStart, marketStartOfDay);
+      if(endTime == boost::posix_time::pos_infin) {
+        rangeEnd = boost::posix_time::pos_infin;
+      } else {
+        auto marketEndOfDay = MarketDateToUtc(marketTimeZone.second.front(),
+          endTime, marketDatabase, timeZoneDatabase) +
+          boost::gregorian::days(1);
+        timeZoneExpression = Beam::Queries::AndExpression(timeZoneExpression,
+          Beam::Queries::MakeLessExpression(timestampAccessExpression,
+          Beam::Queries::ConstantExpression(
+          Beam::Queries::DateTimeValue(marketEndOfDay))));
+        rangeEnd = std::max(rangeEnd, marketEndOfDay);
+      }
+      timeZoneExpressions.push_back(std::move(timeZoneExpression));
+    }
+    auto dailyOrderSubmissionQuery = AccountQuery();
+    dailyOrderSubmissionQuery.SetIndex(account);
+    dailyOrderSubmissionQuery.SetRange(rangeStart, rangeEnd);
+    dailyOrderSubmissionQuery.SetFilter(Beam::Queries::MakeOrExpression(
+      timeZoneExpressions.begin(), timeZoneExpressions.end()));
+    dailyOrderSubmissionQuery.SetSnapshotLimit(
+      Beam::Queries::SnapshotLimit::Unlimited());
+    return dailyOrderSubmissionQuery;
+  }
+
   /**
    * Queries for Orders submitted to a specified market on a daily basis.
    * @param account The account to query.
@@ -99,40 +168,100 @@ namespace Nexus::OrderExecutionService {
       Beam::ScopedQueueWriter<const Order*> queue) {
     Beam::Routines::Spawn([=, queue = std::move(queue),
         &orderExecutionClient] () mutable {
-      auto marketTimeZones =
-        std::unordered_map<std::string, std::vector<MarketCode>>();
-      for(auto& market : marketDatabase.GetEntries()) {
-        marketTimeZones[market.m_timeZone].push_back(market.m_code);
+      if(marketDatabase.GetEntries().empty()) {
+        return;
       }
-      for(auto& marketTimeZone : marketTimeZones) {
-        auto marketStartDate = MarketDateToUtc(marketTimeZone.second.front(),
-          startTime, marketDatabase, timeZoneDatabase);
-        auto marketEndDate = MarketDateToUtc(marketTimeZone.second.front(),
-          endTime, marketDatabase, timeZoneDatabase) +
-          boost::gregorian::days(1);
-        auto marketExpressions = std::vector<Beam::Queries::Expression>();
-        for(auto& market : marketTimeZone.second) {
-          marketExpressions.push_back(BuildMarketFilter(market));
+      auto dailyOrderSubmissionQuery = BuildDailyOrderSubmissionQuery(
+        account, startTime, endTime, marketDatabase, timeZoneDatabase);
+      auto snapshotQueue = std::make_shared<Beam::Queue<SequencedOrder>>();
+      orderExecutionClient.QueryOrderSubmissions(dailyOrderSubmissionQuery,
+        snapshotQueue);
+      try {
+        while(true) {
+          queue.Push(std::move(snapshotQueue->Pop().GetValue()));
         }
-        auto marketFilter = Beam::Queries::MakeOrExpression(
-          marketExpressions.begin(), marketExpressions.end());
-        auto dailyOrderSubmissionQuery = AccountQuery();
-        dailyOrderSubmissionQuery.SetIndex(account);
-        dailyOrderSubmissionQuery.SetRange(marketStartDate, marketEndDate);
-        dailyOrderSubmissionQuery.SetFilter(marketFilter);
-        dailyOrderSubmissionQuery.SetSnapshotLimit(
-          Beam::Queries::SnapshotLimit::Unlimited());
-        auto snapshotQueue = std::make_shared<Beam::Queue<SequencedOrder>>();
-        orderExecutionClient.QueryOrderSubmissions(dailyOrderSubmissionQuery,
-          snapshotQueue);
-        try {
-          while(true) {
-            auto value = snapshotQueue->Pop();
-            if(value.GetValue()->GetInfo().m_timestamp < marketEndDate) {
-              queue.Push(std::move(value.GetValue()));
-            }
+      } catch(const std::exception&) {}
+    });
+  }
+
+  /**
+   * Queries for the Orders submitted to any market today and continues with
+   * the Orders submitted afterwards.
+   * @param account The account to query.
+   * @param currentTime The current time, determining what today is.
+   * @param marketDatabase The database containing Market info.
+   * @param timeZoneDatabase The database of timezones.
+   * @param orderExecutionClient The OrderExecutionClient to query.
+   * @param queue The Queue to write to.
+   */
+  template<typename OrderExecutionClient>
+  void MonitorDailyOrderSubmissions(
+      const Beam::ServiceLocator::DirectoryEntry& account,
+      boost::posix_time::ptime currentTime,
+      const MarketDatabase& marketDatabase,
+      const boost::local_time::tz_database& timeZoneDatabase,
+      OrderExecutionClient& orderExecutionClient,
+      Beam::ScopedQueueWriter<const Order*> queue) {
+    Beam::Routines::Spawn([=, queue = std::move(queue),
+        &orderExecutionClient] () mutable {
+      auto lastSequence = Beam::Queries::Sequence::First();
+      auto snapshotQuery = BuildDailyOrderSubmissionQuery(account,
+        currentTime, currentTime, marketDatabase, timeZoneDatabase);
+      auto snapshotQueue = std::make_shared<Beam::Queue<SequencedOrder>>();
+      orderExecutionClient.QueryOrderSubmissions(snapshotQuery, snapshotQueue);
+      try {
+        while(true) {
+          auto value = snapshotQueue->Pop();
+          queue.Push(value.GetValue());
+          lastSequence = std::max(lastSequence, value.GetSequence());
+        }
+      } catch(const std::exception&) {}
+      auto query = AccountQuery();
+      query.SetIndex(account);
+      query.SetSnapshotLimit(Beam::Queries::SnapshotLimit::Unlimited());
+      if(lastSequence == Beam::Queries::Sequence::First()) {
+        query.SetRange(currentTime, boost::posix_time::pos_infin);
+      } else {
+        query.SetRange(Beam::Queries::Increment(lastSequence),
+          boost::posix_time::pos_infin);
+      }
+      orderExecutionClient.QueryOrderSubmissions(query, std::move(queue));
+    });
+  }
+
+  /**
+   * Streams all OrderRecords submitted by a set of accounts over a time range
+   * ordered by OrderId, loading them one page at a time.
+   * @param accounts The accounts and trading group directories to query.
+   * @param startTime The start of the time range to query.
+   * @param endTime The end of the time range to query.
+   * @param orderExecutionClient The OrderExecutionClient to query.
+   * @param queue The Queue to write to.
+   */
+  template<typename OrderExecutionClient>
+  void ExportOrderRecords(
+      const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts,
+      boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+      OrderExecutionClient& orderExecutionClient,
+      Beam::ScopedQueueWriter<OrderRecord> queue) {
+    Beam::Routines::Spawn([=, queue = std::move(queue),
+        &orderExecutionClient] () mutable {
+      const auto PAGE_SIZE = 1000;
+      auto startId = OrderId(0);
+      try {
+        while(true) {
+          auto orderRecords = orderExecutionClient.LoadOrderRecords(accounts,
+            startTime, endTime, startId, PAGE_SIZE);
+          for(auto& orderRecord : orderRecords) {
+            startId = orderRecord.m_info.m_orderId;
+            queue.Push(std::move(orderRecord));
+          }
+          if(static_cast<int>(orderRecords.size()) < PAGE_SIZE) {
+            break;
           }
-        } catch(const std::exception&) {}
+        }
+      } catch(const std::exception&) {
+        queue.Break(std::current_exception());
       }
     });
   }
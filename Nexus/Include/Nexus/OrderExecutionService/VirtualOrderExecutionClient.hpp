@@ -1,12 +1,15 @@
 #ifndef NEXUS_VIRTUAL_ORDER_EXECUTION_CLIENT_HPP
 #define NEXUS_VIRTUAL_ORDER_EXECUTION_CLIENT_HPP
 #include <memory>
+#include <vector>
 #include <Beam/Pointers/Dereference.hpp>
 #include <Beam/Pointers/LocalPtr.hpp>
 #include <Beam/Queues/ScopedQueueWriter.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/noncopyable.hpp>
 #include "Nexus/OrderExecutionService/AccountQuery.hpp"
 #include "Nexus/OrderExecutionService/OrderExecutionService.hpp"
+#include "Nexus/OrderExecutionService/OrderRecord.hpp"
 
 namespace Nexus::OrderExecutionService {
 
@@ -27,6 +30,11 @@ namespace Nexus::OrderExecutionService {
       virtual void QueryExecutionReports(const AccountQuery& query,
         Beam::ScopedQueueWriter<ExecutionReport> queue) = 0;
 
+      virtual std::vector<OrderRecord> LoadOrderRecords(
+        const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts,
+        boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+        OrderId startId, int maxCount) = 0;
+
       virtual const Order& Submit(const OrderFields& fields) = 0;
 
       virtual void Cancel(const Order& order) = 0;
@@ -72,6 +80,11 @@ namespace Nexus::OrderExecutionService {
       void QueryExecutionReports(const AccountQuery& query,
         Beam::ScopedQueueWriter<ExecutionReport> queue) override;
 
+      std::vector<OrderRecord> LoadOrderRecords(
+        const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts,
+        boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+        OrderId startId, int maxCount) override;
+
       const Order& Submit(const OrderFields& fields) override;
 
       void Cancel(const Order& order) override;
@@ -127,6 +140,15 @@ namespace Nexus::OrderExecutionService {
     m_client->QueryExecutionReports(query, std::move(queue));
   }
 
+  template<typename C>
+  std::vector<OrderRecord> WrapperOrderExecutionClient<C>::LoadOrderRecords(
+      const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts,
+      boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+      OrderId startId, int maxCount) {
+    return m_client->LoadOrderRecords(accounts, startTime, endTime, startId,
+      maxCount);
+  }
+
   template<typename C>
   const Order& WrapperOrderExecutionClient<C>::Submit(
       const OrderFields& fields) {
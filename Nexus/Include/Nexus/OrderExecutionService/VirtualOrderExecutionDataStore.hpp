@@ -24,11 +24,22 @@ namespace OrderExecutionService {
       virtual std::vector<SequencedExecutionReport> LoadExecutionReports(
         const AccountQuery& query) = 0;
 
+      virtual std::vector<OrderRecord> LoadOrderRecords(
+        const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts,
+        boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+        OrderId startId, int maxCount) = 0;
+
       virtual void Store(const SequencedAccountOrderInfo& orderInfo) = 0;
 
+      virtual void Store(
+        const std::vector<SequencedAccountOrderInfo>& orderInfos) = 0;
+
       virtual void Store(
         const SequencedAccountExecutionReport& executionReport) = 0;
 
+      virtual void Store(const std::vector<SequencedAccountExecutionReport>&
+        executionReports) = 0;
+
       virtual void Close() = 0;
 
     protected:
@@ -65,12 +76,24 @@ namespace OrderExecutionService {
       virtual std::vector<SequencedExecutionReport> LoadExecutionReports(
         const AccountQuery& query) override final;
 
+      virtual std::vector<OrderRecord> LoadOrderRecords(
+        const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts,
+        boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+        OrderId startId, int maxCount) override final;
+
       virtual void Store(const SequencedAccountOrderInfo& orderInfo)
         override final;
 
+      virtual void Store(
+        const std::vector<SequencedAccountOrderInfo>& orderInfos)
+        override final;
+
       virtual void Store(
         const SequencedAccountExecutionReport& executionReport) override final;
 
+      virtual void Store(const std::vector<SequencedAccountExecutionReport>&
+        executionReports) override final;
+
       virtual void Close() override final;
 
     private:
@@ -115,18 +138,40 @@ namespace OrderExecutionService {
     return m_dataStore->LoadExecutionReports(query);
   }
 
+  template<typename DataStoreType>
+  std::vector<OrderRecord>
+      WrapperOrderExecutionDataStore<DataStoreType>::LoadOrderRecords(
+      const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts,
+      boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+      OrderId startId, int maxCount) {
+    return m_dataStore->LoadOrderRecords(accounts, startTime, endTime, startId,
+      maxCount);
+  }
+
   template<typename DataStoreType>
   void WrapperOrderExecutionDataStore<DataStoreType>::Store(
       const SequencedAccountOrderInfo& orderInfo) {
     return m_dataStore->Store(orderInfo);
   }
 
+  template<typename DataStoreType>
+  void WrapperOrderExecutionDataStore<DataStoreType>::Store(
+      const std::vector<SequencedAccountOrderInfo>& orderInfos) {
+    return m_dataStore->Store(orderInfos);
+  }
+
   template<typename DataStoreType>
   void WrapperOrderExecutionDataStore<DataStoreType>::Store(
       const SequencedAccountExecutionReport& executionReport) {
     return m_dataStore->Store(executionReport);
   }
 
+  template<typename DataStoreType>
+  void WrapperOrderExecutionDataStore<DataStoreType>::Store(
+      const std::vector<SequencedAccountExecutionReport>& executionReports) {
+    return m_dataStore->Store(executionReports);
+  }
+
   template<typename DataStoreType>
   void WrapperOrderExecutionDataStore<DataStoreType>::Close() {
     m_dataStore->Close();
@@ -31,6 +31,12 @@ namespace Nexus::MarketDataService {
 
       std::vector<SecurityInfo> LoadAllSecurityInfo() override;
 
+      std::unordered_map<Security, SecurityEntry::InitialSequences>
+        LoadAllInitialSequences() override;
+
+      std::unordered_map<Security, std::unordered_map<std::string, Money>>
+        LoadAllLastPrices() override;
+
       std::vector<SequencedOrderImbalance> LoadOrderImbalances(
         const MarketWideDataQuery& query) override;
 
@@ -115,6 +121,20 @@ namespace Nexus::MarketDataService {
     return m_dataStore->LoadAllSecurityInfo();
   }
 
+  template<typename D>
+  std::unordered_map<Security, SecurityEntry::InitialSequences>
+      ToPythonHistoricalDataStore<D>::LoadAllInitialSequences() {
+    auto release = Beam::Python::GilRelease();
+    return m_dataStore->LoadAllInitialSequences();
+  }
+
+  template<typename D>
+  std::unordered_map<Security, std::unordered_map<std::string, Money>>
+      ToPythonHistoricalDataStore<D>::LoadAllLastPrices() {
+    auto release = Beam::Python::GilRelease();
+    return m_dataStore->LoadAllLastPrices();
+  }
+
   template<typename D>
   std::vector<SequencedOrderImbalance>
       ToPythonHistoricalDataStore<D>::LoadOrderImbalances(
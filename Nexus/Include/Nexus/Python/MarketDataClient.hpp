@@ -60,11 +60,17 @@ namespace Nexus::MarketDataService {
       SecurityTechnicals LoadSecurityTechnicals(
         const Security& security) override;
 
+      std::vector<SecuritySnapshot> LoadSecuritySnapshots(
+        const std::vector<Security>& securities) override;
+
+      std::vector<SecurityTechnicals> LoadSecurityTechnicalsList(
+        const std::vector<Security>& securities) override;
+
       boost::optional<SecurityInfo> LoadSecurityInfo(
         const Security& security) override;
 
       std::vector<SecurityInfo> LoadSecurityInfoFromPrefix(
-        const std::string& prefix) override;
+        const std::string& prefix, const Security& start, int count) override;
 
       void Close() override;
 
@@ -188,6 +194,20 @@ namespace Nexus::MarketDataService {
     return m_client->LoadSecurityTechnicals(security);
   }
 
+  template<typename C>
+  std::vector<SecuritySnapshot> ToPythonMarketDataClient<C>::
+      LoadSecuritySnapshots(const std::vector<Security>& securities) {
+    auto release = Beam::Python::GilRelease();
+    return m_client->LoadSecuritySnapshots(securities);
+  }
+
+  template<typename C>
+  std::vector<SecurityTechnicals> ToPythonMarketDataClient<C>::
+      LoadSecurityTechnicalsList(const std::vector<Security>& securities) {
+    auto release = Beam::Python::GilRelease();
+    return m_client->LoadSecurityTechnicalsList(securities);
+  }
+
   template<typename C>
   boost::optional<SecurityInfo> ToPythonMarketDataClient<C>::LoadSecurityInfo(
       const Security& security) {
@@ -197,9 +217,10 @@ namespace Nexus::MarketDataService {
 
   template<typename C>
   std::vector<SecurityInfo> ToPythonMarketDataClient<C>::
-      LoadSecurityInfoFromPrefix(const std::string& prefix) {
+      LoadSecurityInfoFromPrefix(const std::string& prefix,
+      const Security& start, int count) {
     auto release = Beam::Python::GilRelease();
-    return m_client->LoadSecurityInfoFromPrefix(prefix);
+    return m_client->LoadSecurityInfoFromPrefix(prefix, start, count);
   }
 
   template<typename C>
@@ -38,6 +38,11 @@ namespace Nexus::OrderExecutionService {
       void QueryExecutionReports(const AccountQuery& query,
         Beam::ScopedQueueWriter<ExecutionReport> queue) override;
 
+      std::vector<OrderRecord> LoadOrderRecords(
+        const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts,
+        boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+        OrderId startId, int maxCount) override;
+
       const Order& Submit(const OrderFields& fields) override;
 
       void Cancel(const Order& order) override;
@@ -103,6 +108,16 @@ namespace Nexus::OrderExecutionService {
     m_client->QueryExecutionReports(query, std::move(queue));
   }
 
+  template<typename C>
+  std::vector<OrderRecord> ToPythonOrderExecutionClient<C>::LoadOrderRecords(
+      const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts,
+      boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+      OrderId startId, int maxCount) {
+    auto release = Beam::Python::GilRelease();
+    return m_client->LoadOrderRecords(accounts, startTime, endTime, startId,
+      maxCount);
+  }
+
   template<typename C>
   const Order& ToPythonOrderExecutionClient<C>::Submit(
       const OrderFields& fields) {
@@ -1,6 +1,8 @@
 #ifndef NEXUS_SECURITY_ORDER_SIMULATOR_HPP
 #define NEXUS_SECURITY_ORDER_SIMULATOR_HPP
-#include <unordered_set>
+#include <algorithm>
+#include <limits>
+#include <vector>
 #include <boost/noncopyable.hpp>
 #include <Beam/Pointers/Dereference.hpp>
 #include <Beam/Queues/RoutineTaskQueue.hpp>
@@ -8,14 +10,16 @@
 #include "Nexus/Definitions/BboQuote.hpp"
 #include "Nexus/Definitions/TimeAndSale.hpp"
 #include "Nexus/Definitions/DefaultTimeZoneDatabase.hpp"
-#include "Nexus/MarketDataService/MarketDataClient.hpp"
 #include "Nexus/OrderExecutionService/OrderExecutionService.hpp"
 #include "Nexus/OrderExecutionService/PrimitiveOrder.hpp"
+#include "Nexus/SimulationMatcher/SimulationMarketDataFeed.hpp"
 #include "Nexus/SimulationMatcher/SimulationMatcher.hpp"
 
 namespace Nexus::OrderExecutionService {
 
-  /** Handles simulating Orders submitted for a specific Security.
+  /** Handles simulating Orders submitted for a specific Security. The
+      simulator runs all of its tasks on a RoutineTaskQueue that may be shared
+      with the simulators of other Securities.
       \tparam TimeClientType The type of TimeClient used for Order timestamps.
    */
   template<typename TimeClientType>
@@ -27,13 +31,16 @@ namespace Nexus::OrderExecutionService {
 
       //! Constructs a SecurityOrderSimulator.
       /*!
-        \param marketDataClient The MarketDataClient to query.
+        \param feed The SimulationMarketDataFeed publishing the Security's
+               market data.
         \param security The Security to simulate Order executions for.
         \param timeClient The TimeClient used for Order timestamps.
+        \param tasks The RoutineTaskQueue to run the simulation on.
       */
       template<typename MarketDataClient>
-      SecurityOrderSimulator(MarketDataClient& marketDataClient,
-        const Security& security, Beam::Ref<TimeClient> timeClient);
+      SecurityOrderSimulator(SimulationMarketDataFeed<MarketDataClient>& feed,
+        const Security& security, Beam::Ref<TimeClient> timeClient,
+        Beam::Ref<Beam::RoutineTaskQueue> tasks);
 
       //! Submits an Order for simulated Order entry.
       /*!
@@ -62,15 +69,25 @@ namespace Nexus::OrderExecutionService {
       void Recover(const std::shared_ptr<PrimitiveOrder>& order);
 
     private:
+      struct PendingOrder {
+        Money m_price;
+        std::shared_ptr<PrimitiveOrder> m_order;
+      };
       TimeClient* m_timeClient;
       boost::gregorian::date m_date;
       boost::posix_time::ptime m_marketCloseTime;
       bool m_isMocPending;
-      std::unordered_set<std::shared_ptr<PrimitiveOrder>> m_orders;
+      std::vector<PendingOrder> m_bids;
+      std::vector<PendingOrder> m_asks;
+      std::vector<std::shared_ptr<PrimitiveOrder>> m_mocOrders;
       BboQuote m_bboQuote;
-      Beam::RoutineTaskQueue m_tasks;
+      Beam::RoutineTaskQueue* m_tasks;
 
       void SetSessionTimestamps(boost::posix_time::ptime timestamp);
+      void Insert(const std::shared_ptr<PrimitiveOrder>& order);
+      void Remove(const std::shared_ptr<PrimitiveOrder>& order);
+      void Match(std::vector<PendingOrder>& orders,
+        typename std::vector<PendingOrder>::iterator first);
       OrderStatus Fill(PrimitiveOrder& order, Money price);
       OrderStatus UpdateOrder(PrimitiveOrder& order);
       void OnBbo(const BboQuote& bboQuote);
@@ -80,30 +97,26 @@ namespace Nexus::OrderExecutionService {
   template<typename TimeClientType>
   template<typename MarketDataClient>
   SecurityOrderSimulator<TimeClientType>::SecurityOrderSimulator(
-      MarketDataClient& marketDataClient, const Security& security,
-      Beam::Ref<TimeClient> timeClient)
-      : m_timeClient(timeClient.Get()) {
+      SimulationMarketDataFeed<MarketDataClient>& feed,
+      const Security& security, Beam::Ref<TimeClient> timeClient,
+      Beam::Ref<Beam::RoutineTaskQueue> tasks)
+      : m_timeClient(timeClient.Get()),
+        m_tasks(tasks.Get()) {
     SetSessionTimestamps(m_timeClient->GetTime());
-    auto snapshot = std::make_shared<Beam::Queue<BboQuote>>();
-    marketDataClient.QueryBboQuotes(Beam::Queries::BuildLatestQuery(security),
-      snapshot);
-    try {
-      m_bboQuote = snapshot->Pop();
-    } catch(const std::exception&) {
-      return;
-    }
-    auto query = Beam::Queries::BuildCurrentQuery(security);
-    marketDataClient.QueryBboQuotes(query, m_tasks.GetSlot<BboQuote>(
+
+    // The latest BboQuote is pushed onto the task queue during the Monitor
+    // call, ahead of any Order submitted to this simulator.
+    feed.GetBboQuotePublisher(security).Monitor(m_tasks->GetSlot<BboQuote>(
       std::bind(&SecurityOrderSimulator::OnBbo, this, std::placeholders::_1)));
-    marketDataClient.QueryTimeAndSales(query, m_tasks.GetSlot<TimeAndSale>(
-      std::bind(&SecurityOrderSimulator::OnTimeAndSale, this,
-      std::placeholders::_1)));
+    feed.GetTimeAndSalePublisher(security).Monitor(
+      m_tasks->GetSlot<TimeAndSale>(std::bind(
+      &SecurityOrderSimulator::OnTimeAndSale, this, std::placeholders::_1)));
   }
 
   template<typename TimeClientType>
   void SecurityOrderSimulator<TimeClientType>::Submit(
       const std::shared_ptr<PrimitiveOrder>& order) {
-    m_tasks.Push(
+    m_tasks->Push(
       [=] {
         auto isLive = true;
         order->With(
@@ -121,9 +134,8 @@ namespace Nexus::OrderExecutionService {
               nextStatus, order->GetInfo().m_timestamp);
             order->Update(updatedReport);
           });
-        if(isLive) {
-          m_orders.insert(order);
-          UpdateOrder(*order);
+        if(isLive && !IsTerminal(UpdateOrder(*order))) {
+          Insert(order);
         }
       });
   }
@@ -131,7 +143,7 @@ namespace Nexus::OrderExecutionService {
   template<typename TimeClientType>
   void SecurityOrderSimulator<TimeClientType>::Cancel(
       const std::shared_ptr<PrimitiveOrder>& order) {
-    m_tasks.Push(
+    m_tasks->Push(
       [=] {
         order->With(
           [&] (auto status, auto& reports) {
@@ -146,6 +158,7 @@ namespace Nexus::OrderExecutionService {
               reports.back(), OrderStatus::CANCELED, m_timeClient->GetTime());
             order->Update(cancelReport);
           });
+        Remove(order);
       });
   }
 
@@ -153,7 +166,7 @@ namespace Nexus::OrderExecutionService {
   void SecurityOrderSimulator<TimeClientType>::Update(
       const std::shared_ptr<PrimitiveOrder>& order,
       const ExecutionReport& executionReport) {
-    m_tasks.Push(
+    m_tasks->Push(
       [=] {
         order->With(
           [&] (auto status, auto& executionReports) {
@@ -166,6 +179,9 @@ namespace Nexus::OrderExecutionService {
               updatedReport.m_timestamp = m_timeClient->GetTime();
             }
             order->Update(updatedReport);
+            if(IsTerminal(updatedReport.m_status)) {
+              Remove(order);
+            }
           });
       });
   }
@@ -173,10 +189,11 @@ namespace Nexus::OrderExecutionService {
   template<typename TimeClientType>
   void SecurityOrderSimulator<TimeClientType>::Recover(
       const std::shared_ptr<PrimitiveOrder>& order) {
-    m_tasks.Push(
+    m_tasks->Push(
       [=] {
-        m_orders.insert(order);
-        UpdateOrder(*order);
+        if(!IsTerminal(UpdateOrder(*order))) {
+          Insert(order);
+        }
       });
   }
 
@@ -193,6 +210,65 @@ namespace Nexus::OrderExecutionService {
     m_isMocPending = timestamp < m_marketCloseTime;
   }
 
+  template<typename TimeClientType>
+  void SecurityOrderSimulator<TimeClientType>::Insert(
+      const std::shared_ptr<PrimitiveOrder>& order) {
+    auto& fields = order->GetInfo().m_fields;
+    if(fields.m_timeInForce.GetType() == TimeInForce::Type::MOC) {
+      m_mocOrders.push_back(order);
+      return;
+    }
+    auto price = [&] {
+      if(fields.m_type == OrderType::LIMIT) {
+        return fields.m_price;
+      } else if(fields.m_side == Side::ASK) {
+        return Money::ZERO;
+      }
+      return std::numeric_limits<Money>::max();
+    }();
+
+    // Both sides are sorted from the least to the most aggressive price so
+    // that the orders that cross are always found at the back.
+    if(fields.m_side == Side::BID) {
+      auto i = std::lower_bound(m_bids.begin(), m_bids.end(), price,
+        [] (auto& pendingOrder, auto price) {
+          return pendingOrder.m_price < price;
+        });
+      m_bids.insert(i, PendingOrder{price, order});
+    } else {
+      auto i = std::lower_bound(m_asks.begin(), m_asks.end(), price,
+        [] (auto& pendingOrder, auto price) {
+          return pendingOrder.m_price > price;
+        });
+      m_asks.insert(i, PendingOrder{price, order});
+    }
+  }
+
+  template<typename TimeClientType>
+  void SecurityOrderSimulator<TimeClientType>::Remove(
+      const std::shared_ptr<PrimitiveOrder>& order) {
+    auto& fields = order->GetInfo().m_fields;
+    if(fields.m_timeInForce.GetType() == TimeInForce::Type::MOC) {
+      m_mocOrders.erase(std::remove(m_mocOrders.begin(), m_mocOrders.end(),
+        order), m_mocOrders.end());
+      return;
+    }
+    auto& orders = Pick(fields.m_side, m_asks, m_bids);
+    orders.erase(std::remove_if(orders.begin(), orders.end(),
+      [&] (auto& pendingOrder) {
+        return pendingOrder.m_order == order;
+      }), orders.end());
+  }
+
+  template<typename TimeClientType>
+  void SecurityOrderSimulator<TimeClientType>::Match(
+      std::vector<PendingOrder>& orders,
+      typename std::vector<PendingOrder>::iterator first) {
+    orders.erase(std::remove_if(first, orders.end(), [&] (auto& pendingOrder) {
+      return IsTerminal(UpdateOrder(*pendingOrder.m_order));
+    }), orders.end());
+  }
+
   template<typename TimeClientType>
   OrderStatus SecurityOrderSimulator<TimeClientType>::Fill(
       PrimitiveOrder& order, Money price) {
@@ -247,15 +323,14 @@ namespace Nexus::OrderExecutionService {
       SetSessionTimestamps(bboQuote.m_timestamp);
     }
     m_bboQuote = bboQuote;
-    auto i = m_orders.begin();
-    while(i != m_orders.end()) {
-      auto status = UpdateOrder(**i);
-      if(IsTerminal(status)) {
-        i = m_orders.erase(i);
-      } else {
-        ++i;
-      }
-    }
+    Match(m_bids, std::partition_point(m_bids.begin(), m_bids.end(),
+      [&] (auto& pendingOrder) {
+        return pendingOrder.m_price < m_bboQuote.m_ask.m_price;
+      }));
+    Match(m_asks, std::partition_point(m_asks.begin(), m_asks.end(),
+      [&] (auto& pendingOrder) {
+        return pendingOrder.m_price > m_bboQuote.m_bid.m_price;
+      }));
   }
 
   template<typename TimeClientType>
@@ -268,17 +343,10 @@ namespace Nexus::OrderExecutionService {
         timeAndSale.m_marketCenter == "TSE") {
       m_isMocPending = false;
       auto closingPrice = timeAndSale.m_price;
-      auto i = m_orders.begin();
-      while(i != m_orders.end()) {
-        auto& order = **i;
-        if(order.GetInfo().m_fields.m_timeInForce.GetType() ==
-            TimeInForce::Type::MOC) {
-          Fill(order, closingPrice);
-          i = m_orders.erase(i);
-        } else {
-          ++i;
-        }
+      for(auto& order : m_mocOrders) {
+        Fill(*order, closingPrice);
       }
+      m_mocOrders.clear();
     }
   }
 }
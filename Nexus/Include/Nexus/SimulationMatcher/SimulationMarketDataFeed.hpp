@@ -0,0 +1,105 @@
+#ifndef NEXUS_SIMULATION_MARKET_DATA_FEED_HPP
+#define NEXUS_SIMULATION_MARKET_DATA_FEED_HPP
+#include <memory>
+#include <Beam/Collections/SynchronizedMap.hpp>
+#include <Beam/Pointers/Dereference.hpp>
+#include <Beam/Pointers/LocalPtr.hpp>
+#include <Beam/Queues/Queue.hpp>
+#include <Beam/Queues/QueueWriterPublisher.hpp>
+#include <Beam/Queues/StatePublisher.hpp>
+#include <Beam/Threading/Mutex.hpp>
+#include <boost/noncopyable.hpp>
+#include "Nexus/Definitions/BboQuote.hpp"
+#include "Nexus/Definitions/Security.hpp"
+#include "Nexus/Definitions/TimeAndSale.hpp"
+#include "Nexus/MarketDataService/MarketDataClient.hpp"
+
+namespace Nexus::OrderExecutionService {
+
+  /**
+   * Subscribes to the BboQuotes and TimeAndSales of each Security at most
+   * once and fans them out to every simulator monitoring that Security.
+   * @param <C> The type of MarketDataClient to query.
+   */
+  template<typename C>
+  class SimulationMarketDataFeed : private boost::noncopyable {
+    public:
+
+      /** The type of MarketDataClient to query. */
+      using MarketDataClient = Beam::GetTryDereferenceType<C>;
+
+      /**
+       * Constructs a SimulationMarketDataFeed.
+       * @param marketDataClient Initializes the MarketDataClient.
+       */
+      template<typename CF>
+      explicit SimulationMarketDataFeed(CF&& marketDataClient);
+
+      /**
+       * Returns the publisher of a Security's BboQuotes, subscribing to them
+       * upon first use. The publisher holds the latest BboQuote, so a new
+       * monitor receives it immediately.
+       * @param security The Security whose BboQuotes are published.
+       */
+      const Beam::Publisher<BboQuote>& GetBboQuotePublisher(
+        const Security& security);
+
+      /**
+       * Returns the publisher of a Security's TimeAndSales, subscribing to
+       * them upon first use.
+       * @param security The Security whose TimeAndSales are published.
+       */
+      const Beam::Publisher<TimeAndSale>& GetTimeAndSalePublisher(
+        const Security& security);
+
+    private:
+      Beam::GetOptionalLocalPtr<C> m_marketDataClient;
+      Beam::SynchronizedUnorderedMap<Security,
+        std::shared_ptr<Beam::StatePublisher<BboQuote>>,
+        Beam::Threading::Mutex> m_bboQuotePublishers;
+      Beam::SynchronizedUnorderedMap<Security,
+        std::shared_ptr<Beam::QueueWriterPublisher<TimeAndSale>>,
+        Beam::Threading::Mutex> m_timeAndSalePublishers;
+  };
+
+  template<typename C>
+  template<typename CF>
+  SimulationMarketDataFeed<C>::SimulationMarketDataFeed(CF&& marketDataClient)
+    : m_marketDataClient(std::forward<CF>(marketDataClient)) {}
+
+  template<typename C>
+  const Beam::Publisher<BboQuote>&
+      SimulationMarketDataFeed<C>::GetBboQuotePublisher(
+      const Security& security) {
+    return *m_bboQuotePublishers.GetOrInsert(security, [&] {
+      auto publisher = std::make_shared<Beam::StatePublisher<BboQuote>>();
+
+      // The latest BboQuote is loaded up front so that the first monitor
+      // never observes an empty quote while the current query catches up.
+      auto snapshot = std::make_shared<Beam::Queue<BboQuote>>();
+      m_marketDataClient->QueryBboQuotes(
+        Beam::Queries::BuildLatestQuery(security), snapshot);
+      try {
+        publisher->Push(snapshot->Pop());
+      } catch(const std::exception&) {}
+      m_marketDataClient->QueryBboQuotes(
+        Beam::Queries::BuildCurrentQuery(security), publisher);
+      return publisher;
+    });
+  }
+
+  template<typename C>
+  const Beam::Publisher<TimeAndSale>&
+      SimulationMarketDataFeed<C>::GetTimeAndSalePublisher(
+      const Security& security) {
+    return *m_timeAndSalePublishers.GetOrInsert(security, [&] {
+      auto publisher =
+        std::make_shared<Beam::QueueWriterPublisher<TimeAndSale>>();
+      m_marketDataClient->QueryTimeAndSales(
+        Beam::Queries::BuildRealTimeQuery(security), publisher);
+      return publisher;
+    });
+  }
+}
+
+#endif
@@ -1,25 +1,34 @@
 #ifndef NEXUS_SIMULATION_ORDER_EXECUTION_DRIVER_HPP
 #define NEXUS_SIMULATION_ORDER_EXECUTION_DRIVER_HPP
+#include <algorithm>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 #include <Beam/Collections/SynchronizedMap.hpp>
 #include <Beam/IO/OpenState.hpp>
 #include <Beam/Pointers/LocalPtr.hpp>
+#include <Beam/Queues/RoutineTaskQueue.hpp>
 #include <Beam/Threading/Mutex.hpp>
 #include <Beam/TimeService/TimeClient.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/noncopyable.hpp>
+#include <boost/thread/thread.hpp>
 #include "Nexus/MarketDataService/MarketDataClient.hpp"
 #include "Nexus/OrderExecutionService/AccountQuery.hpp"
 #include "Nexus/OrderExecutionService/OrderExecutionService.hpp"
 #include "Nexus/OrderExecutionService/OrderUnrecoverableException.hpp"
 #include "Nexus/OrderExecutionService/PrimitiveOrder.hpp"
 #include "Nexus/SimulationMatcher/SecurityOrderSimulator.hpp"
+#include "Nexus/SimulationMatcher/SimulationMarketDataFeed.hpp"
 #include "Nexus/SimulationMatcher/SimulationMatcher.hpp"
 
 namespace Nexus::OrderExecutionService {
 
   /**
-   * An OrderExecutionDriver that simulates transactions.
+   * An OrderExecutionDriver that simulates transactions. Securities are
+   * spread across a fixed pool of task queues rather than each being given
+   * its own, and their market data is received through a single
+   * SimulationMarketDataFeed.
    * @param C The type of MarketDataClient to use.
    * @param T The type of TimeClient used for Order timestamps.
    */
@@ -41,8 +50,27 @@ namespace Nexus::OrderExecutionService {
       template<typename CF, typename TF>
       SimulationOrderExecutionDriver(CF&& marketDataClient, TF&& timeClient);
 
+      /**
+       * Constructs a SimulationOrderExecutionDriver.
+       * @param marketDataClient Initializes the MarketDataClient.
+       * @param timeClient Initializes the TimeClient.
+       * @param shardCount The number of task queues to spread Securities over.
+       */
+      template<typename CF, typename TF>
+      SimulationOrderExecutionDriver(CF&& marketDataClient, TF&& timeClient,
+        std::size_t shardCount);
+
       ~SimulationOrderExecutionDriver();
 
+      /** Returns the number of task queues Securities are spread over. */
+      std::size_t GetShardCount() const;
+
+      /**
+       * Returns the index of the task queue a Security is simulated on.
+       * @param security The Security to look up.
+       */
+      std::size_t GetShard(const Security& security) const;
+
       const Order& Recover(const SequencedAccountOrderRecord& orderRecord);
 
       const Order& Submit(const OrderInfo& orderInfo);
@@ -62,9 +90,11 @@ namespace Nexus::OrderExecutionService {
       using SecurityOrderSimulators = std::unordered_map<Security,
         std::unique_ptr<SecurityOrderSimulator>>;
       Beam::GetOptionalLocalPtr<C> m_marketDataClient;
+      SimulationMarketDataFeed<MarketDataClient*> m_feed;
       Beam::GetOptionalLocalPtr<T> m_timeClient;
       Beam::SynchronizedMap<Orders> m_orders;
       OrderId m_nextOrderId;
+      std::vector<std::unique_ptr<Beam::RoutineTaskQueue>> m_tasks;
       Beam::SynchronizedMap<SecurityOrderSimulators, Beam::Threading::Mutex>
         m_securityOrderSimulators;
       Beam::IO::OpenState m_openState;
@@ -76,18 +106,43 @@ namespace Nexus::OrderExecutionService {
   template<typename CF, typename TF>
   SimulationOrderExecutionDriver<C, T>::SimulationOrderExecutionDriver(
     CF&& marketDataClient, TF&& timeClient)
+    : SimulationOrderExecutionDriver(std::forward<CF>(marketDataClient),
+        std::forward<TF>(timeClient), boost::thread::hardware_concurrency()) {}
+
+  template<typename C, typename T>
+  template<typename CF, typename TF>
+  SimulationOrderExecutionDriver<C, T>::SimulationOrderExecutionDriver(
+    CF&& marketDataClient, TF&& timeClient, std::size_t shardCount)
     : m_marketDataClient(std::forward<CF>(marketDataClient)),
+      m_feed(&*m_marketDataClient),
       m_timeClient(std::forward<TF>(timeClient)),
-      m_nextOrderId(1) {}
+      m_nextOrderId(1) {
+    shardCount = std::max<std::size_t>(1, shardCount);
+    for(auto i = std::size_t(0); i != shardCount; ++i) {
+      m_tasks.push_back(std::make_unique<Beam::RoutineTaskQueue>());
+    }
+  }
 
   template<typename C, typename T>
   SimulationOrderExecutionDriver<C, T>::~SimulationOrderExecutionDriver() {
     Close();
   }
 
+  template<typename C, typename T>
+  std::size_t SimulationOrderExecutionDriver<C, T>::GetShardCount() const {
+    return m_tasks.size();
+  }
+
+  template<typename C, typename T>
+  std::size_t SimulationOrderExecutionDriver<C, T>::GetShard(
+      const Security& security) const {
+    return std::hash<Security>()(security) % m_tasks.size();
+  }
+
   template<typename C, typename T>
   const Order& SimulationOrderExecutionDriver<C, T>::Recover(
       const SequencedAccountOrderRecord& orderRecord) {
+    m_openState.EnsureOpen();
     auto order = std::make_shared<PrimitiveOrder>(**orderRecord);
     m_orders.Insert((*orderRecord)->m_info.m_orderId, order);
     auto& simulator = LoadSimulator((*orderRecord)->m_info.m_fields.m_security);
@@ -98,6 +153,7 @@ namespace Nexus::OrderExecutionService {
   template<typename C, typename T>
   const Order& SimulationOrderExecutionDriver<C, T>::Submit(
       const OrderInfo& orderInfo) {
+    m_openState.EnsureOpen();
     auto order = std::make_shared<PrimitiveOrder>(orderInfo);
     m_orders.Insert(orderInfo.m_orderId, order);
     auto& simulator = LoadSimulator(orderInfo.m_fields.m_security);
@@ -108,6 +164,7 @@ namespace Nexus::OrderExecutionService {
   template<typename C, typename T>
   void SimulationOrderExecutionDriver<C, T>::Cancel(
       const OrderExecutionSession& session, OrderId orderId) {
+    m_openState.EnsureOpen();
     if(auto order = m_orders.Find(orderId)) {
       auto& simulator = LoadSimulator((*order)->GetInfo().m_fields.m_security);
       simulator.Cancel(*order);
@@ -118,6 +175,7 @@ namespace Nexus::OrderExecutionService {
   void SimulationOrderExecutionDriver<C, T>::Update(
       const OrderExecutionSession& session, OrderId orderId,
       const ExecutionReport& executionReport) {
+    m_openState.EnsureOpen();
     if(auto order = m_orders.Find(orderId)) {
       auto& simulator = LoadSimulator((*order)->GetInfo().m_fields.m_security);
       simulator.Update(*order, executionReport);
@@ -129,6 +187,12 @@ namespace Nexus::OrderExecutionService {
     if(m_openState.SetClosing()) {
       return;
     }
+    for(auto& tasks : m_tasks) {
+      tasks->Break();
+    }
+    for(auto& tasks : m_tasks) {
+      tasks->Wait();
+    }
     m_securityOrderSimulators.Clear();
     m_openState.Close();
   }
@@ -138,8 +202,9 @@ namespace Nexus::OrderExecutionService {
       SimulationOrderExecutionDriver<C, T>::LoadSimulator(
       const Security& security) {
     return *m_securityOrderSimulators.GetOrInsert(security, [&] {
-      return std::make_unique<SecurityOrderSimulator>(*m_marketDataClient,
-        security, Beam::Ref(*m_timeClient));
+      auto& tasks = *m_tasks[GetShard(security)];
+      return std::make_unique<SecurityOrderSimulator>(m_feed, security,
+        Beam::Ref(*m_timeClient), Beam::Ref(tasks));
     });
   }
 }
@@ -61,16 +61,32 @@ namespace Nexus::SoupBinTcp {
         const std::string& session, std::uint64_t sequenceNumber, CF&& channel,
         TF&& timer);
 
-      /** Reads the next SoupBinTcpPacket. */
+      /** The type of Buffer packets are read into. */
+      using Buffer = typename Channel::Reader::Buffer;
+
+      /**
+       * Reads the next SoupBinTcpPacket, its payload is only valid until the
+       * next call to Read.
+       */
       SoupBinTcpPacket Read();
 
+      /**
+       * Reads the next SoupBinTcpPacket into a caller owned Buffer so that its
+       * payload can be handed off without being copied.
+       * @param buffer The Buffer the payload is appended to, the payload stays
+       *        valid for as long as the <i>buffer</i> is left unmodified.
+       * @return The SoupBinTcpPacket whose payload points into the
+       *         <i>buffer</i>.
+       */
+      SoupBinTcpPacket Read(Beam::Out<Buffer> buffer);
+
       /** Closes the connection to the server. */
       void Close();
 
     private:
       Beam::GetOptionalLocalPtr<C> m_channel;
       Beam::GetOptionalLocalPtr<T> m_timer;
-      typename Channel::Reader::Buffer m_buffer;
+      Buffer m_buffer;
       std::string m_session;
       std::uint64_t m_sequenceNumber;
       Beam::Routines::RoutineHandler m_heartbeatLoop;
@@ -138,9 +154,14 @@ namespace Nexus::SoupBinTcp {
 
   template<typename C, typename T>
   SoupBinTcpPacket SoupBinTcpClient<C, T>::Read() {
-    m_openState.EnsureOpen();
     m_buffer.Reset();
-    return ReadPacket(m_channel->GetReader(), Beam::Store(m_buffer));
+    return Read(Beam::Store(m_buffer));
+  }
+
+  template<typename C, typename T>
+  SoupBinTcpPacket SoupBinTcpClient<C, T>::Read(Beam::Out<Buffer> buffer) {
+    m_openState.EnsureOpen();
+    return ReadPacket(m_channel->GetReader(), Beam::Store(buffer));
   }
 
   template<typename C, typename T>
@@ -48,20 +48,26 @@ namespace SoupBinTcp {
   //! Reads a logical packet from a Reader.
   /*!
     \param reader The Reader to read the logical packet from.
-    \param payloadBuffer The Buffer used to store the payload.
+    \param buffer The Buffer the payload is appended to, the packet's payload
+           points into this buffer and is valid until it is next modified.
     \return The logical packet read from the <i>reader</i>.
   */
   template<typename Reader, typename Buffer>
   SoupBinTcpPacket ReadPacket(Reader& reader, Beam::Out<Buffer> buffer) {
+    static const auto HEADER_SIZE =
+      sizeof(SoupBinTcpPacket::m_length) + sizeof(SoupBinTcpPacket::m_type);
+    char header[HEADER_SIZE];
+    Beam::IO::ReadExactSize(reader, header, HEADER_SIZE);
     SoupBinTcpPacket packet;
-    Beam::IO::ReadExactSize(reader, reinterpret_cast<char*>(&packet.m_length),
-      sizeof(packet.m_length));
-    packet.m_length = Beam::FromBigEndian(packet.m_length);
-    Beam::IO::ReadExactSize(reader, reinterpret_cast<char*>(&packet.m_type),
-      sizeof(packet.m_type));
-    packet.m_type = Beam::FromBigEndian(packet.m_type);
+    packet.m_length = Beam::FromBigEndian(
+      *reinterpret_cast<const std::uint16_t*>(header));
+    if(packet.m_length < sizeof(packet.m_type)) {
+      BOOST_THROW_EXCEPTION(SoupBinTcpParserException("Invalid length."));
+    }
+    packet.m_type = static_cast<std::uint8_t>(header[HEADER_SIZE - 1]);
+    auto payloadOffset = buffer->GetSize();
     Beam::IO::ReadExactSize(reader, Beam::Store(buffer), packet.m_length - 1);
-    packet.m_payload = buffer->GetData();
+    packet.m_payload = buffer->GetData() + payloadOffset;
     return packet;
   }
 }
@@ -1,10 +1,17 @@
 #ifndef NEXUS_STAMPMESSAGE_HPP
 #define NEXUS_STAMPMESSAGE_HPP
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
 #include <Beam/Pointers/Ref.hpp>
 #include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/optional/optional.hpp>
 #include <boost/throw_exception.hpp>
+#include "Nexus/Definitions/Money.hpp"
 #include "Nexus/Definitions/Side.hpp"
 #include "Nexus/StampProtocol/StampMessage.hpp"
 #include "Nexus/StampProtocol/StampPacket.hpp"
@@ -21,7 +28,10 @@ namespace Details {
       const char* result = static_cast<const char*>(std::memchr(token, *pattern,
         size - (token - source)));
       if(result == nullptr ||
-          std::memcmp(result, pattern, patternLength) == 0) {
+          patternLength > size - (result - source)) {
+        return nullptr;
+      }
+      if(std::memcmp(result, pattern, patternLength) == 0) {
         return result;
       }
       token = result + 1;
@@ -35,7 +45,7 @@ namespace Details {
     if(source == nullptr) {
       return false;
     }
-    char fieldIdentifier[16];
+    char fieldIdentifier[32];
     int length;
     if(order == -1) {
       length = std::sprintf(fieldIdentifier, "\x1e%d=", index);
@@ -46,52 +56,76 @@ namespace Details {
     if(field == nullptr) {
       return false;
     }
+    static const char DELIMITERS[] = "\x1e\x03";
+    auto sourceEnd = source + sourceSize;
     *valueStart = field + length;
-    *valueEnd = std::strpbrk(*valueStart, "\x1e\x03");
+    *valueEnd = std::find_first_of(*valueStart, sourceEnd, DELIMITERS,
+      DELIMITERS + 2);
     return true;
   }
 
+  inline boost::optional<std::string_view> FindValue(const char* source,
+      std::size_t sourceSize, int index, int order) {
+    const char* valueStart;
+    const char* valueEnd;
+    if(!FindValue(source, sourceSize, index, order, Beam::Store(valueStart),
+        Beam::Store(valueEnd))) {
+      return boost::none;
+    }
+    return std::string_view(valueStart, valueEnd - valueStart);
+  }
+
+  inline int ParseDigits(std::string_view value, std::size_t offset,
+      std::size_t length) {
+    auto result = 0;
+    for(auto i = offset; i != offset + length; ++i) {
+      if(!std::isdigit(static_cast<unsigned char>(value[i]))) {
+        BOOST_THROW_EXCEPTION(boost::bad_lexical_cast());
+      }
+      result = 10 * result + (value[i] - '0');
+    }
+    return result;
+  }
+
   template<typename T>
   boost::optional<T> GetBusinessFieldHelper(int index, int order,
       const char* source, std::size_t sourceSize) {
-    boost::optional<std::string> field = GetBusinessFieldHelper<std::string>(
-      index, order, source, sourceSize);
-    if(!field.is_initialized()) {
-      return boost::optional<T>();
+    auto field = FindValue(source, sourceSize, index, order);
+    if(!field) {
+      return boost::none;
     }
-    return boost::lexical_cast<T>(*field);
+    return boost::lexical_cast<T>(field->data(), field->size());
   }
 
   template<>
-  boost::optional<std::string> GetBusinessFieldHelper<std::string>(int index,
-      int order, const char* source, std::size_t sourceSize) {
-    const char* valueStart;
-    const char* valueEnd;
-    if(!FindValue(source, sourceSize, index, order, Beam::Store(valueStart),
-        Beam::Store(valueEnd))) {
-      return boost::optional<std::string>();
+  inline boost::optional<std::string> GetBusinessFieldHelper<std::string>(
+      int index, int order, const char* source, std::size_t sourceSize) {
+    auto field = FindValue(source, sourceSize, index, order);
+    if(!field) {
+      return boost::none;
     }
-    return std::string(valueStart, valueEnd - valueStart);
+    return std::string(*field);
   }
 
   template<>
-  boost::optional<Money> GetBusinessFieldHelper<Money>(int index,
+  inline boost::optional<Money> GetBusinessFieldHelper<Money>(int index,
       int order, const char* source, std::size_t sourceSize) {
-    boost::optional<std::string> value = GetBusinessFieldHelper<std::string>(
-      index, order, source, sourceSize);
-    if(!value.is_initialized()) {
-      return boost::optional<Money>();
+    auto field = FindValue(source, sourceSize, index, order);
+    if(!field) {
+      return boost::none;
     }
-    return Money::FromValue(*value);
+
+    // Money::FromValue only parses a std::string, so the price is copied into
+    // a temporary, unlike the other numeric fields.
+    return Money::FromValue(std::string(*field));
   }
 
   template<>
-  boost::optional<Side> GetBusinessFieldHelper<Side>(int index,
+  inline boost::optional<Side> GetBusinessFieldHelper<Side>(int index,
       int order, const char* source, std::size_t sourceSize) {
-    boost::optional<std::string> value = GetBusinessFieldHelper<std::string>(
-      index, order, source, sourceSize);
-    if(!value.is_initialized()) {
-      return boost::optional<Side>();
+    auto value = FindValue(source, sourceSize, index, order);
+    if(!value) {
+      return boost::none;
     }
     if(*value == "Buy") {
       return Side(Side::BID);
@@ -104,25 +138,24 @@ namespace Details {
     } else if(*value == "NA") {
       return Side(Side::NONE);
     }
-    return boost::optional<Side>();
+    return boost::none;
   }
 
   template<>
-  boost::optional<boost::posix_time::ptime> GetBusinessFieldHelper<
+  inline boost::optional<boost::posix_time::ptime> GetBusinessFieldHelper<
       boost::posix_time::ptime>(int index, int order, const char* source,
       std::size_t sourceSize) {
-    boost::optional<std::string> value = GetBusinessFieldHelper<std::string>(
-      index, order, source, sourceSize);
-    if(!value.is_initialized() || value->size() < 16) {
-      return boost::optional<boost::posix_time::ptime>();
+    auto value = FindValue(source, sourceSize, index, order);
+    if(!value || value->size() < 16) {
+      return boost::none;
     }
-    auto y = boost::lexical_cast<int>(value->substr(0, 4));
-    auto m = boost::lexical_cast<int>(value->substr(4, 2));
-    auto d = boost::lexical_cast<int>(value->substr(6, 2));
-    auto hr = boost::lexical_cast<int>(value->substr(8, 2));
-    auto mn = boost::lexical_cast<int>(value->substr(10, 2));
-    auto sec = boost::lexical_cast<int>(value->substr(12, 2));
-    auto mill = boost::lexical_cast<int>(value->substr(14, 2));
+    auto y = ParseDigits(*value, 0, 4);
+    auto m = ParseDigits(*value, 4, 2);
+    auto d = ParseDigits(*value, 6, 2);
+    auto hr = ParseDigits(*value, 8, 2);
+    auto mn = ParseDigits(*value, 10, 2);
+    auto sec = ParseDigits(*value, 12, 2);
+    auto mill = ParseDigits(*value, 14, 2);
     boost::posix_time::ptime timestamp(
       boost::gregorian::date(static_cast<unsigned short>(y),
       static_cast<unsigned short>(m), static_cast<unsigned short>(d)),
@@ -177,6 +210,28 @@ namespace Details {
       template<typename T>
       boost::optional<T> GetBusinessField(int index, int order) const;
 
+      //! Returns a view of a field within the business content section of the
+      //! message without copying it.
+      /*!
+        \param index The index of the field to retrieve.
+        \return A view into the message's data of the field with the specified
+                index, or <i>none</i> iff no such field exists. The view is
+                valid only as long as the message's data.
+      */
+      boost::optional<std::string_view> GetBusinessFieldView(int index) const;
+
+      //! Returns a view of a field within the business content section of the
+      //! message without copying it.
+      /*!
+        \param index The index of the field to retrieve.
+        \param order The order in which the field appears in the specified
+               <i>index</i>.
+        \return A view into the message's data of the field with the specified
+                index and order, or <i>none</i> iff no such field exists.
+      */
+      boost::optional<std::string_view> GetBusinessFieldView(int index,
+        int order) const;
+
     private:
       StampHeader m_header;
       const char* m_controlSection;
@@ -194,11 +249,12 @@ namespace Details {
       '\x1c', size));
     if(m_businessContent == nullptr) {
       m_controlSectionSize = size;
+      m_businessContentSize = 0;
     } else {
       m_controlSectionSize = static_cast<std::size_t>(
         m_businessContent - m_controlSection);
       ++m_businessContent;
-      m_businessContentSize = size - m_controlSectionSize;
+      m_businessContentSize = size - m_controlSectionSize - 1;
     }
   }
 
@@ -226,6 +282,18 @@ namespace Details {
     return Details::GetBusinessFieldHelper<T>(index, order, m_businessContent,
       m_businessContentSize);
   }
+
+  inline boost::optional<std::string_view> StampMessage::GetBusinessFieldView(
+      int index) const {
+    return Details::FindValue(m_businessContent, m_businessContentSize, index,
+      -1);
+  }
+
+  inline boost::optional<std::string_view> StampMessage::GetBusinessFieldView(
+      int index, int order) const {
+    return Details::FindValue(m_businessContent, m_businessContentSize, index,
+      order);
+  }
 }
 }
 
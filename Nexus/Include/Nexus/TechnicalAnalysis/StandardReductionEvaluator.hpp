@@ -0,0 +1,546 @@
+#ifndef NEXUS_STANDARDREDUCTIONEVALUATOR_HPP
+#define NEXUS_STANDARDREDUCTIONEVALUATOR_HPP
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+#include <Beam/Queries/ConstantExpression.hpp>
+#include <Beam/Queries/Expression.hpp>
+#include <Beam/Queries/ExpressionVisitor.hpp>
+#include <Beam/Queries/FunctionExpression.hpp>
+#include <Beam/Queries/MemberAccessExpression.hpp>
+#include <Beam/Queries/OrExpression.hpp>
+#include <Beam/Queries/ParameterExpression.hpp>
+#include <Beam/Queries/ReduceExpression.hpp>
+#include <Beam/Queries/StandardFunctionExpressions.hpp>
+#include <boost/optional/optional.hpp>
+#include "Nexus/Definitions/Money.hpp"
+#include "Nexus/Definitions/Quantity.hpp"
+#include "Nexus/Definitions/TimeAndSale.hpp"
+#include "Nexus/Queries/StandardDataTypes.hpp"
+#include "Nexus/TechnicalAnalysis/TechnicalAnalysis.hpp"
+
+namespace Nexus {
+namespace TechnicalAnalysis {
+
+  //! Lists the reductions that can be evaluated in batch.
+  enum class StandardReductionType {
+
+    //! The maximum of all values.
+    MAX,
+
+    //! The minimum of all values.
+    MIN,
+
+    //! The sum of all values.
+    SUM
+  };
+
+  //! Lists the TimeAndSale fields a standard reduction can be applied to.
+  enum class StandardReductionField {
+
+    //! The TimeAndSale's price.
+    PRICE,
+
+    //! The TimeAndSale's size.
+    SIZE
+  };
+
+  /*! \struct StandardReduction
+      \brief Describes a ReduceExpression over TimeAndSales that can be
+             evaluated over columns rather than one record at a time.
+   */
+  struct StandardReduction {
+
+    //! The type of reduction.
+    StandardReductionType m_type;
+
+    //! The field being reduced.
+    StandardReductionField m_field;
+
+    //! The initial value of the reduction, a Money for prices and a Quantity
+    //! for sizes.
+    Queries::QueryVariant m_initialValue;
+
+    //! The market centers to include, or an empty list to include all.
+    std::vector<std::string> m_marketCenters;
+  };
+
+  /*! \class TimeAndSaleColumns
+      \brief Stores a series of TimeAndSales as contiguous columns.
+   */
+  class TimeAndSaleColumns {
+    public:
+
+      //! Constructs an empty set of columns.
+      TimeAndSaleColumns() = default;
+
+      //! Constructs columns from a range of TimeAndSales.
+      /*!
+        \param first An iterator to the first TimeAndSale.
+        \param last An iterator to one past the last TimeAndSale.
+      */
+      template<typename Iterator>
+      TimeAndSaleColumns(Iterator first, Iterator last);
+
+      //! Returns the number of rows stored.
+      std::size_t GetSize() const;
+
+      //! Returns the price column.
+      const std::vector<Money>& GetPrices() const;
+
+      //! Returns the size column.
+      const std::vector<Quantity>& GetSizes() const;
+
+      //! Returns the dictionary encoded market center column.
+      const std::vector<std::uint16_t>& GetMarketCenters() const;
+
+      //! Returns the id used to encode a market center, if present.
+      /*!
+        \param marketCenter The market center to look up.
+        \return The id used to encode the <i>marketCenter</i> or
+                <code>boost::none</code> if no row belongs to it.
+      */
+      boost::optional<std::uint16_t> FindMarketCenter(
+        const std::string& marketCenter) const;
+
+      //! Returns the number of distinct market centers stored.
+      std::size_t GetMarketCenterCount() const;
+
+      //! Appends a TimeAndSale.
+      /*!
+        \param timeAndSale The TimeAndSale to append.
+      */
+      void Append(const TimeAndSale& timeAndSale);
+
+      //! Reserves space for a number of rows.
+      /*!
+        \param size The number of rows to reserve space for.
+      */
+      void Reserve(std::size_t size);
+
+    private:
+      std::vector<Money> m_prices;
+      std::vector<Quantity> m_sizes;
+      std::vector<std::uint16_t> m_marketCenters;
+      std::unordered_map<std::string, std::uint16_t> m_marketCenterIds;
+  };
+
+namespace Details {
+  struct StandardReductionMatcher : Beam::Queries::ExpressionVisitor {
+    const Beam::Queries::ConstantExpression* m_constant = nullptr;
+    const Beam::Queries::FunctionExpression* m_function = nullptr;
+    const Beam::Queries::MemberAccessExpression* m_memberAccess = nullptr;
+    const Beam::Queries::OrExpression* m_or = nullptr;
+    const Beam::Queries::ParameterExpression* m_parameter = nullptr;
+    const Beam::Queries::ReduceExpression* m_reduce = nullptr;
+
+    void Visit(const Beam::Queries::ConstantExpression& expression) override {
+      m_constant = &expression;
+    }
+
+    void Visit(const Beam::Queries::FunctionExpression& expression) override {
+      m_function = &expression;
+    }
+
+    void Visit(
+        const Beam::Queries::MemberAccessExpression& expression) override {
+      m_memberAccess = &expression;
+    }
+
+    void Visit(const Beam::Queries::OrExpression& expression) override {
+      m_or = &expression;
+    }
+
+    void Visit(const Beam::Queries::ParameterExpression& expression) override {
+      m_parameter = &expression;
+    }
+
+    void Visit(const Beam::Queries::ReduceExpression& expression) override {
+      m_reduce = &expression;
+    }
+  };
+
+  inline const TimeAndSale& GetTimeAndSale(const TimeAndSale& timeAndSale) {
+    return timeAndSale;
+  }
+
+  template<typename T>
+  const TimeAndSale& GetTimeAndSale(const T& value) {
+    return GetTimeAndSale(*value);
+  }
+
+  inline bool IsParameter(const Beam::Queries::Expression& expression,
+      int index) {
+    auto matcher = StandardReductionMatcher();
+    expression->Apply(matcher);
+    return matcher.m_parameter && matcher.m_parameter->GetIndex() == index;
+  }
+
+  inline boost::optional<std::string> GetTimeAndSaleMember(
+      const Beam::Queries::Expression& expression) {
+    auto matcher = StandardReductionMatcher();
+    expression->Apply(matcher);
+    if(!matcher.m_memberAccess) {
+      return boost::none;
+    }
+    auto parameterMatcher = StandardReductionMatcher();
+    matcher.m_memberAccess->GetExpression()->Apply(parameterMatcher);
+    if(!parameterMatcher.m_parameter ||
+        parameterMatcher.m_parameter->GetIndex() != 0 ||
+        !(parameterMatcher.m_parameter->GetType() ==
+        Queries::TimeAndSaleType())) {
+      return boost::none;
+    }
+    return matcher.m_memberAccess->GetName();
+  }
+
+  inline bool ExtractMarketCenters(const Beam::Queries::Expression& expression,
+      std::vector<std::string>& marketCenters) {
+    auto matcher = StandardReductionMatcher();
+    expression->Apply(matcher);
+    if(matcher.m_or) {
+      return ExtractMarketCenters(matcher.m_or->GetLeftExpression(),
+        marketCenters) && ExtractMarketCenters(
+        matcher.m_or->GetRightExpression(), marketCenters);
+    }
+    if(!matcher.m_function ||
+        matcher.m_function->GetName() != Beam::Queries::EQUALS_NAME ||
+        matcher.m_function->GetParameters().size() != 2) {
+      return false;
+    }
+    auto& parameters = matcher.m_function->GetParameters();
+    for(auto i = std::size_t(0); i != 2; ++i) {
+      auto member = GetTimeAndSaleMember(parameters[i]);
+      if(!member || *member != "market_center") {
+        continue;
+      }
+      auto constantMatcher = StandardReductionMatcher();
+      parameters[1 - i]->Apply(constantMatcher);
+      if(!constantMatcher.m_constant) {
+        return false;
+      }
+      auto& value = constantMatcher.m_constant->GetValue();
+      if(value->GetType()->GetNativeType() != typeid(std::string)) {
+        return false;
+      }
+      marketCenters.push_back(value->GetValue<std::string>());
+      return true;
+    }
+    return false;
+  }
+
+  template<typename T, typename Selector>
+  T Reduce(StandardReductionType type, const std::vector<T>& column,
+      T value, Selector&& isSelected) {
+    auto size = column.size();
+    auto data = column.data();
+    if(type == StandardReductionType::MAX) {
+      for(auto i = std::size_t(0); i != size; ++i) {
+        auto candidate = data[i];
+        value = isSelected(i) && value < candidate ? candidate : value;
+      }
+    } else if(type == StandardReductionType::MIN) {
+      for(auto i = std::size_t(0); i != size; ++i) {
+        auto candidate = data[i];
+        value = isSelected(i) && candidate < value ? candidate : value;
+      }
+    } else {
+      for(auto i = std::size_t(0); i != size; ++i) {
+        if(isSelected(i)) {
+          value += data[i];
+        }
+      }
+    }
+    return value;
+  }
+
+  template<typename T>
+  T Reduce(const StandardReduction& reduction, const std::vector<T>& column,
+      const TimeAndSaleColumns& columns) {
+    auto initialValue = boost::get<T>(reduction.m_initialValue);
+    if(reduction.m_marketCenters.empty()) {
+      return Reduce(reduction.m_type, column, initialValue,
+        [] (std::size_t) {
+          return true;
+        });
+    }
+    if(reduction.m_marketCenters.size() == 1) {
+      auto id = columns.FindMarketCenter(reduction.m_marketCenters.front());
+      if(!id) {
+        return initialValue;
+      }
+      auto marketCenters = columns.GetMarketCenters().data();
+      auto selectedId = *id;
+      return Reduce(reduction.m_type, column, initialValue,
+        [=] (std::size_t i) {
+          return marketCenters[i] == selectedId;
+        });
+    }
+    auto selection = std::vector<std::uint8_t>(columns.GetMarketCenterCount(),
+      0);
+    for(auto& marketCenter : reduction.m_marketCenters) {
+      if(auto id = columns.FindMarketCenter(marketCenter)) {
+        selection[*id] = 1;
+      }
+    }
+    auto marketCenters = columns.GetMarketCenters().data();
+    auto selected = selection.data();
+    return Reduce(reduction.m_type, column, initialValue,
+      [=] (std::size_t i) {
+        return selected[marketCenters[i]] != 0;
+      });
+  }
+
+  template<typename T>
+  boost::optional<std::size_t> FindLastChangedRow(
+      const StandardReduction& reduction, const std::vector<T>& column,
+      const TimeAndSaleColumns& columns) {
+    auto selection = std::vector<std::uint8_t>(columns.GetMarketCenterCount(),
+      reduction.m_marketCenters.empty() ? 1 : 0);
+    for(auto& marketCenter : reduction.m_marketCenters) {
+      if(auto id = columns.FindMarketCenter(marketCenter)) {
+        selection[*id] = 1;
+      }
+    }
+    auto& marketCenters = columns.GetMarketCenters();
+    auto value = boost::get<T>(reduction.m_initialValue);
+    auto row = boost::optional<std::size_t>();
+    for(auto i = std::size_t(0); i != column.size(); ++i) {
+      if(selection[marketCenters[i]] == 0) {
+        continue;
+      }
+      auto next = value;
+      if(reduction.m_type == StandardReductionType::MAX) {
+        next = value < column[i] ? column[i] : value;
+      } else if(reduction.m_type == StandardReductionType::MIN) {
+        next = column[i] < value ? column[i] : value;
+      } else {
+        next += column[i];
+      }
+      if(!row || next != value) {
+        row = i;
+      }
+      value = next;
+    }
+    return row;
+  }
+}
+
+  //! Recognizes a standard reduction over TimeAndSales.
+  /*!
+    \param expression The query's expression.
+    \param filter The query's filter.
+    \return The StandardReduction represented by the <i>expression</i> and
+            <i>filter</i>, or <code>boost::none</code> if they must be
+            evaluated by the interpreter.
+  */
+  inline boost::optional<StandardReduction> RecognizeStandardReduction(
+      const Beam::Queries::Expression& expression,
+      const Beam::Queries::Expression& filter) {
+    auto matcher = Details::StandardReductionMatcher();
+    expression->Apply(matcher);
+    if(!matcher.m_reduce) {
+      return boost::none;
+    }
+    auto& reduce = *matcher.m_reduce;
+    auto reducerMatcher = Details::StandardReductionMatcher();
+    reduce.GetReduceExpression()->Apply(reducerMatcher);
+    if(!reducerMatcher.m_function ||
+        reducerMatcher.m_function->GetParameters().size() != 2 ||
+        !Details::IsParameter(
+        reducerMatcher.m_function->GetParameters()[0], 0) ||
+        !Details::IsParameter(
+        reducerMatcher.m_function->GetParameters()[1], 1)) {
+      return boost::none;
+    }
+    auto reduction = StandardReduction();
+    auto& name = reducerMatcher.m_function->GetName();
+    if(name == Beam::Queries::MAX_NAME) {
+      reduction.m_type = StandardReductionType::MAX;
+    } else if(name == Beam::Queries::MIN_NAME) {
+      reduction.m_type = StandardReductionType::MIN;
+    } else if(name == Beam::Queries::ADDITION_NAME) {
+      reduction.m_type = StandardReductionType::SUM;
+    } else {
+      return boost::none;
+    }
+    auto member = Details::GetTimeAndSaleMember(reduce.GetSeriesExpression());
+    if(!member) {
+      return boost::none;
+    }
+    auto& initialValue = reduce.GetInitialValue();
+    if(*member == "price" &&
+        initialValue->GetType()->GetNativeType() == typeid(Money)) {
+      reduction.m_field = StandardReductionField::PRICE;
+      reduction.m_initialValue = initialValue->GetValue<Money>();
+    } else if(*member == "size" &&
+        initialValue->GetType()->GetNativeType() == typeid(Quantity)) {
+      reduction.m_field = StandardReductionField::SIZE;
+      reduction.m_initialValue = initialValue->GetValue<Quantity>();
+    } else {
+      return boost::none;
+    }
+    auto filterMatcher = Details::StandardReductionMatcher();
+    filter->Apply(filterMatcher);
+    if(filterMatcher.m_constant) {
+      auto& value = filterMatcher.m_constant->GetValue();
+      if(value->GetType()->GetNativeType() != typeid(bool) ||
+          !value->GetValue<bool>()) {
+        return boost::none;
+      }
+    } else if(!Details::ExtractMarketCenters(filter,
+        reduction.m_marketCenters)) {
+      return boost::none;
+    }
+    return reduction;
+  }
+
+  //! Evaluates a StandardReduction over a set of columns.
+  /*!
+    \param reduction The StandardReduction to evaluate.
+    \param columns The TimeAndSales to reduce.
+    \return The result of the <i>reduction</i>, identical to the value the
+            interpreter produces after evaluating every selected row in order.
+  */
+  inline Queries::QueryVariant Evaluate(const StandardReduction& reduction,
+      const TimeAndSaleColumns& columns) {
+    if(reduction.m_field == StandardReductionField::PRICE) {
+      return Details::Reduce(reduction, columns.GetPrices(), columns);
+    }
+    return Details::Reduce(reduction, columns.GetSizes(), columns);
+  }
+
+  //! Returns the index of the last row selected by a StandardReduction.
+  /*!
+    \param reduction The StandardReduction whose market centers select rows.
+    \param columns The TimeAndSales to search.
+    \return The index of the last row the <i>reduction</i> is applied to, or
+            <code>boost::none</code> if it applies to no row.
+  */
+  inline boost::optional<std::size_t> FindLastSelectedRow(
+      const StandardReduction& reduction, const TimeAndSaleColumns& columns) {
+    auto size = columns.GetSize();
+    if(reduction.m_marketCenters.empty()) {
+      if(size == 0) {
+        return boost::none;
+      }
+      return size - 1;
+    }
+    auto selection = std::vector<std::uint8_t>(columns.GetMarketCenterCount(),
+      0);
+    for(auto& marketCenter : reduction.m_marketCenters) {
+      if(auto id = columns.FindMarketCenter(marketCenter)) {
+        selection[*id] = 1;
+      }
+    }
+    auto& marketCenters = columns.GetMarketCenters();
+    for(auto i = size; i != 0; --i) {
+      if(selection[marketCenters[i - 1]] != 0) {
+        return i - 1;
+      }
+    }
+    return boost::none;
+  }
+
+  //! Returns the index of the last row at which a StandardReduction's value
+  //! changes, the row whose sequence the interpreter reports under
+  //! UpdatePolicy::CHANGE.
+  /*!
+    \param reduction The StandardReduction to evaluate.
+    \param columns The TimeAndSales to search.
+    \return The index of the last selected row that changes the reduced
+            value, counting the first selected row as a change, or
+            <code>boost::none</code> if the <i>reduction</i> applies to no
+            row.
+  */
+  inline boost::optional<std::size_t> FindLastChangedRow(
+      const StandardReduction& reduction, const TimeAndSaleColumns& columns) {
+    if(reduction.m_field == StandardReductionField::PRICE) {
+      return Details::FindLastChangedRow(reduction, columns.GetPrices(),
+        columns);
+    }
+    return Details::FindLastChangedRow(reduction, columns.GetSizes(),
+      columns);
+  }
+
+  //! Evaluates a query's expression over a series of TimeAndSales if it
+  //! represents a StandardReduction.
+  /*!
+    \param expression The query's expression.
+    \param filter The query's filter.
+    \param first An iterator to the first TimeAndSale.
+    \param last An iterator to one past the last TimeAndSale.
+    \return The reduced value, or <code>boost::none</code> if the
+            <i>expression</i> must be evaluated by the interpreter.
+  */
+  template<typename Iterator>
+  boost::optional<Queries::QueryVariant> EvaluateStandardReduction(
+      const Beam::Queries::Expression& expression,
+      const Beam::Queries::Expression& filter, Iterator first, Iterator last) {
+    auto reduction = RecognizeStandardReduction(expression, filter);
+    if(!reduction) {
+      return boost::none;
+    }
+    return Evaluate(*reduction, TimeAndSaleColumns(first, last));
+  }
+
+  template<typename Iterator>
+  TimeAndSaleColumns::TimeAndSaleColumns(Iterator first, Iterator last) {
+    Reserve(static_cast<std::size_t>(std::distance(first, last)));
+    while(first != last) {
+      Append(Details::GetTimeAndSale(*first));
+      ++first;
+    }
+  }
+
+  inline std::size_t TimeAndSaleColumns::GetSize() const {
+    return m_prices.size();
+  }
+
+  inline const std::vector<Money>& TimeAndSaleColumns::GetPrices() const {
+    return m_prices;
+  }
+
+  inline const std::vector<Quantity>& TimeAndSaleColumns::GetSizes() const {
+    return m_sizes;
+  }
+
+  inline const std::vector<std::uint16_t>&
+      TimeAndSaleColumns::GetMarketCenters() const {
+    return m_marketCenters;
+  }
+
+  inline boost::optional<std::uint16_t> TimeAndSaleColumns::FindMarketCenter(
+      const std::string& marketCenter) const {
+    auto id = m_marketCenterIds.find(marketCenter);
+    if(id == m_marketCenterIds.end()) {
+      return boost::none;
+    }
+    return id->second;
+  }
+
+  inline std::size_t TimeAndSaleColumns::GetMarketCenterCount() const {
+    return m_marketCenterIds.size();
+  }
+
+  inline void TimeAndSaleColumns::Append(const TimeAndSale& timeAndSale) {
+    m_prices.push_back(timeAndSale.m_price);
+    m_sizes.push_back(timeAndSale.m_size);
+    auto id = m_marketCenterIds.emplace(timeAndSale.m_marketCenter,
+      static_cast<std::uint16_t>(m_marketCenterIds.size())).first->second;
+    m_marketCenters.push_back(id);
+  }
+
+  inline void TimeAndSaleColumns::Reserve(std::size_t size) {
+    m_prices.reserve(size);
+    m_sizes.reserve(size);
+    m_marketCenters.reserve(size);
+  }
+}
+}
+
+#endif
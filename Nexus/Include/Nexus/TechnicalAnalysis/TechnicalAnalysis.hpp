@@ -4,6 +4,8 @@
 namespace Nexus {
 namespace TechnicalAnalysis {
   template<typename DomainType, typename RangeType> class Candlestick;
+  struct StandardReduction;
+  class TimeAndSaleColumns;
 }
 }
 
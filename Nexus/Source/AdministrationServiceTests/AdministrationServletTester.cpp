@@ -187,4 +187,63 @@ TEST_SUITE("AdministrationServlet") {
       m_clientProtocol.SendRequest<LoadManagedTradingGroupsService>(trader);
     REQUIRE(managedTradingGroupsResult.empty());
   }
+
+  TEST_CASE_FIXTURE(Fixture, "load_account_roles") {
+    auto tradingGroup = MakeTradingGroup("test_group");
+    auto managers =
+      m_serviceLocatorEnvironment.GetRoot().LoadDirectoryEntry(tradingGroup,
+      "managers");
+    auto traders =
+      m_serviceLocatorEnvironment.GetRoot().LoadDirectoryEntry(tradingGroup,
+      "traders");
+    auto administrator = MakeAccount("test_admin",
+      GetAdministratorsDirectory());
+    auto manager = MakeAccount("test_manager", managers);
+    auto trader = MakeAccount("test_trader", traders);
+    auto service = MakeAccount("test_service", GetServicesDirectory());
+    auto roles =
+      m_clientProtocol.SendRequest<LoadAccountRolesService>(administrator);
+    REQUIRE(roles.Test(AccountRole::ADMINISTRATOR));
+    roles = m_clientProtocol.SendRequest<LoadAccountRolesService>(manager);
+    REQUIRE(roles.Test(AccountRole::MANAGER));
+    REQUIRE(!roles.Test(AccountRole::TRADER));
+    roles = m_clientProtocol.SendRequest<LoadAccountRolesService>(trader);
+    REQUIRE(roles.Test(AccountRole::TRADER));
+    REQUIRE(!roles.Test(AccountRole::MANAGER));
+    roles = m_clientProtocol.SendRequest<LoadAccountRolesService>(service);
+    REQUIRE(roles.Test(AccountRole::SERVICE));
+    REQUIRE(m_clientProtocol.SendRequest<LoadParentTradingGroupService>(
+      trader) == tradingGroup);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "load_supervised_account_roles") {
+    auto tradingGroupA = MakeTradingGroup("test_group_a");
+    auto tradingGroupB = MakeTradingGroup("test_group_b");
+    auto& root = m_serviceLocatorEnvironment.GetRoot();
+    auto managersA = root.LoadDirectoryEntry(tradingGroupA, "managers");
+    auto tradersA = root.LoadDirectoryEntry(tradingGroupA, "traders");
+    auto tradersB = root.LoadDirectoryEntry(tradingGroupB, "traders");
+    auto administrator = MakeAccount("test_admin",
+      GetAdministratorsDirectory());
+    auto manager = MakeAccount("test_manager", managersA);
+    auto trader = MakeAccount("test_trader", tradersA);
+    auto roles = m_clientProtocol.SendRequest<
+      LoadSupervisedAccountRolesService>(manager, trader);
+    REQUIRE(roles.Test(AccountRole::MANAGER));
+    REQUIRE(!roles.Test(AccountRole::ADMINISTRATOR));
+    roles = m_clientProtocol.SendRequest<LoadSupervisedAccountRolesService>(
+      administrator, trader);
+    REQUIRE(roles.Test(AccountRole::ADMINISTRATOR));
+    REQUIRE(roles.Test(AccountRole::MANAGER));
+    roles = m_clientProtocol.SendRequest<LoadSupervisedAccountRolesService>(
+      trader, manager);
+    REQUIRE(roles.GetBitset().none());
+    root.Detach(trader, tradersA);
+    root.Associate(trader, tradersB);
+    roles = m_clientProtocol.SendRequest<LoadSupervisedAccountRolesService>(
+      manager, trader);
+    REQUIRE(!roles.Test(AccountRole::MANAGER));
+    REQUIRE(m_clientProtocol.SendRequest<LoadParentTradingGroupService>(
+      trader) == tradingGroupB);
+  }
 }
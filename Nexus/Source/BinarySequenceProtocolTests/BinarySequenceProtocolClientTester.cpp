@@ -0,0 +1,225 @@
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <Beam/IO/SharedBuffer.hpp>
+#include <Beam/Queues/Queue.hpp>
+#include <Beam/Routines/RoutineHandler.hpp>
+#include <Beam/Threading/TriggerTimer.hpp>
+#include <Beam/Utilities/Endian.hpp>
+#include <doctest/doctest.h>
+#include "Nexus/BinarySequenceProtocol/BinarySequenceProtocolClient.hpp"
+
+using namespace Beam;
+using namespace Beam::IO;
+using namespace Beam::Routines;
+using namespace Beam::Threading;
+using namespace Nexus;
+using namespace Nexus::BinarySequenceProtocol;
+
+namespace {
+
+  /** Delivers whole datagrams in the order they are pushed. */
+  struct TestChannel {
+    struct Connection {
+      std::shared_ptr<Queue<SharedBuffer>> m_datagrams;
+
+      void Close() {
+        m_datagrams->Break();
+      }
+    };
+
+    struct Reader {
+      using Buffer = SharedBuffer;
+      std::shared_ptr<Queue<SharedBuffer>> m_datagrams;
+
+      template<typename B>
+      std::size_t Read(Out<B> destination) {
+        auto datagram = m_datagrams->Pop();
+        destination->Append(datagram.GetData(), datagram.GetSize());
+        return datagram.GetSize();
+      }
+    };
+
+    struct Writer {
+      using Buffer = SharedBuffer;
+      std::function<void (const SharedBuffer&)> m_onWrite;
+
+      template<typename B>
+      void Write(const B& data) {
+        m_onWrite(data);
+      }
+    };
+
+    std::shared_ptr<Queue<SharedBuffer>> m_datagrams;
+    Connection m_connection;
+    Reader m_reader;
+    Writer m_writer;
+
+    TestChannel()
+      : m_datagrams(std::make_shared<Queue<SharedBuffer>>()),
+        m_connection{m_datagrams},
+        m_reader{m_datagrams},
+        m_writer{[] (const SharedBuffer&) {}} {}
+
+    Connection& GetConnection() {
+      return m_connection;
+    }
+
+    Reader& GetReader() {
+      return m_reader;
+    }
+
+    Writer& GetWriter() {
+      return m_writer;
+    }
+  };
+
+  /** Stands in for a retransmission server that replies from a store. */
+  struct RetransmissionServer {
+    TestChannel m_channel;
+    std::map<std::uint32_t, SharedBuffer> m_packets;
+    std::vector<std::pair<std::uint32_t, std::uint16_t>> m_requests;
+    std::shared_ptr<Queue<std::uint32_t>> m_requestedSequenceNumbers;
+
+    RetransmissionServer()
+        : m_requestedSequenceNumbers(
+            std::make_shared<Queue<std::uint32_t>>()) {
+      m_channel.m_writer.m_onWrite = [this] (const SharedBuffer& request) {
+        REQUIRE(request.GetSize() ==
+          sizeof(std::uint32_t) + sizeof(std::uint16_t));
+        auto sequenceNumber = FromBigEndian(
+          *reinterpret_cast<const std::uint32_t*>(request.GetData()));
+        auto count = FromBigEndian(*reinterpret_cast<const std::uint16_t*>(
+          request.GetData() + sizeof(std::uint32_t)));
+        m_requests.emplace_back(sequenceNumber, count);
+        m_requestedSequenceNumbers->Push(sequenceNumber);
+        for(auto i = m_packets.lower_bound(sequenceNumber);
+            i != m_packets.end() && i->first < sequenceNumber + count; ++i) {
+          m_channel.m_datagrams->Push(i->second);
+        }
+      };
+    }
+  };
+
+  auto MakePacket(std::uint32_t sequenceNumber,
+      const std::vector<std::string>& messages) {
+    auto packet = SharedBuffer();
+    packet.Append(ToBigEndian(sequenceNumber));
+    packet.Append(ToBigEndian(static_cast<std::uint16_t>(messages.size())));
+    for(auto& message : messages) {
+      packet.Append(ToBigEndian(static_cast<std::uint16_t>(message.size())));
+      packet.Append(message.data(), message.size());
+    }
+    return packet;
+  }
+
+  using Message = std::pair<std::uint32_t, std::string>;
+  using Client = BinarySequenceProtocolClient<TestChannel*, std::uint32_t>;
+  using RecoveryClient = BinarySequenceProtocolClient<TestChannel*,
+    std::uint32_t, TestChannel*, TriggerTimer*>;
+
+  template<typename C>
+  auto ReadMessage(C& client) {
+    auto sequenceNumber = std::uint32_t();
+    auto message = client.Read(Store(sequenceNumber));
+    return Message(sequenceNumber,
+      std::string(message.m_data, message.m_length));
+  }
+}
+
+TEST_SUITE("BinarySequenceProtocolClient") {
+  TEST_CASE("in_order") {
+    auto channel = TestChannel();
+    channel.m_datagrams->Push(MakePacket(1, {"a", "b"}));
+    channel.m_datagrams->Push(MakePacket(3, {"c"}));
+    auto client = Client(&channel);
+    REQUIRE(ReadMessage(client) == Message(1, "a"));
+    REQUIRE(ReadMessage(client) == Message(2, "b"));
+    REQUIRE(ReadMessage(client) == Message(3, "c"));
+    REQUIRE(client.GetLostMessageCount() == 0);
+  }
+
+  TEST_CASE("read_batch") {
+    auto channel = TestChannel();
+    channel.m_datagrams->Push(MakePacket(5, {"a", "b", "c"}));
+    auto client = Client(&channel);
+    auto batch = BinarySequenceProtocolMessageBatch<std::uint32_t>();
+    client.ReadBatch(Store(batch));
+    REQUIRE(batch.m_sequenceNumber == 5);
+    REQUIRE(batch.m_messages.size() == 3);
+    REQUIRE(std::string(batch.m_messages[2].m_data,
+      batch.m_messages[2].m_length) == "c");
+  }
+
+  TEST_CASE("read_batch_ends_at_gap") {
+    auto channel = TestChannel();
+    channel.m_datagrams->Push(MakePacket(1, {"a", "b"}));
+    channel.m_datagrams->Push(MakePacket(4, {"d"}));
+    auto client = Client(&channel);
+    auto batch = BinarySequenceProtocolMessageBatch<std::uint32_t>();
+    client.ReadBatch(Store(batch));
+    REQUIRE(batch.m_sequenceNumber == 1);
+    REQUIRE(batch.m_messages.size() == 2);
+    client.ReadBatch(Store(batch));
+    REQUIRE(batch.m_sequenceNumber == 4);
+    REQUIRE(batch.m_messages.size() == 1);
+    REQUIRE(std::string(batch.m_messages[0].m_data,
+      batch.m_messages[0].m_length) == "d");
+    REQUIRE(client.GetLostMessageCount() == 2);
+  }
+
+  TEST_CASE("skip_gap_without_recovery") {
+    auto channel = TestChannel();
+    channel.m_datagrams->Push(MakePacket(1, {"a"}));
+    channel.m_datagrams->Push(MakePacket(4, {"d"}));
+    auto client = Client(&channel);
+    REQUIRE(ReadMessage(client) == Message(1, "a"));
+    REQUIRE(ReadMessage(client) == Message(4, "d"));
+    REQUIRE(client.GetLostMessageCount() == 2);
+  }
+
+  TEST_CASE("recover_gap") {
+    auto channel = TestChannel();
+    auto server = RetransmissionServer();
+    auto timer = TriggerTimer();
+    server.m_packets.emplace(2, MakePacket(2, {"b", "c"}));
+    channel.m_datagrams->Push(MakePacket(1, {"a"}));
+    channel.m_datagrams->Push(MakePacket(4, {"d"}));
+    auto client = RecoveryClient(&channel, &server.m_channel, &timer,
+      RecoveryClient::DEFAULT_BUFFER_COUNT);
+    REQUIRE(ReadMessage(client) == Message(1, "a"));
+    REQUIRE(ReadMessage(client) == Message(2, "b"));
+    REQUIRE(ReadMessage(client) == Message(3, "c"));
+    REQUIRE(ReadMessage(client) == Message(4, "d"));
+    REQUIRE(server.m_requests.size() == 1);
+    REQUIRE(server.m_requests.front() ==
+      std::pair(std::uint32_t(2), std::uint16_t(2)));
+    REQUIRE(client.GetLostMessageCount() == 0);
+  }
+
+  TEST_CASE("expire_unanswered_gap") {
+    auto channel = TestChannel();
+    auto server = RetransmissionServer();
+    auto timer = TriggerTimer();
+    channel.m_datagrams->Push(MakePacket(1, {"a"}));
+    channel.m_datagrams->Push(MakePacket(3, {"c"}));
+    auto client = RecoveryClient(&channel, &server.m_channel, &timer,
+      RecoveryClient::DEFAULT_BUFFER_COUNT);
+    auto trigger = RoutineHandler(Spawn([&] {
+      for(auto i = std::size_t(0);
+          i != RecoveryClient::MAX_RETRANSMIT_REQUESTS; ++i) {
+        server.m_requestedSequenceNumbers->Pop();
+        timer.Trigger();
+      }
+    }));
+    REQUIRE(ReadMessage(client) == Message(1, "a"));
+    REQUIRE(ReadMessage(client) == Message(3, "c"));
+    REQUIRE(client.GetLostMessageCount() == 1);
+    for(auto& request : server.m_requests) {
+      REQUIRE(request == std::pair(std::uint32_t(2), std::uint16_t(1)));
+    }
+  }
+}
@@ -0,0 +1,3 @@
+#include <Beam/Utilities/DoctestMain.hpp>
+
+DOCTEST_MAIN()
@@ -3,8 +3,11 @@
 #include <boost/functional/factory.hpp>
 #include <doctest/doctest.h>
 #include "Nexus/ChartingService/ChartingServlet.hpp"
+#include "Nexus/Definitions/DefaultMarketDatabase.hpp"
+#include "Nexus/Definitions/DefaultTimeZoneDatabase.hpp"
 #include "Nexus/ServiceClients/TestEnvironment.hpp"
 #include "Nexus/ServiceClients/TestServiceClients.hpp"
+#include "Nexus/TechnicalAnalysis/StandardSecurityQueries.hpp"
 
 using namespace Beam;
 using namespace Beam::Services;
@@ -62,4 +65,66 @@ TEST_SUITE("ChartingServlet") {
       interval);
     REQUIRE(result.series == expectedSeries);
   }
+
+  TEST_CASE_FIXTURE(Fixture, "historical_daily_high") {
+    auto security = Security("TST", DefaultMarkets::NYSE(),
+      DefaultCountries::US());
+    auto day = ptime(date(2010, May, 6));
+    auto timestamp = ptime(date(2010, May, 6), time_duration(15, 0, 0, 0));
+    for(auto price : {Money::ONE, 3 * Money::ONE, 2 * Money::ONE}) {
+      m_environment.GetMarketDataEnvironment().Publish(security,
+        TimeAndSale(timestamp, price, 100, TimeAndSale::Condition(
+        TimeAndSale::Condition::Type::NONE, "?"), "N"));
+      timestamp += minutes(1);
+    }
+    auto query = BuildDailyHighQuery(security, day, day,
+      GetDefaultMarketDatabase(), GetDefaultTimeZoneDatabase());
+    auto result = m_clientProtocol->SendRequest<QuerySecurityService>(query,
+      1);
+    REQUIRE(result.m_queryId == 1);
+    REQUIRE(result.m_snapshot.size() == 1);
+    REQUIRE(boost::get<Money>(*result.m_snapshot.front()) ==
+      3 * Money::ONE);
+    auto nextDay = day + days(1);
+    auto emptyQuery = BuildDailyHighQuery(security, nextDay, nextDay,
+      GetDefaultMarketDatabase(), GetDefaultTimeZoneDatabase());
+    auto emptyResult = m_clientProtocol->SendRequest<QuerySecurityService>(
+      emptyQuery, 2);
+    REQUIRE(emptyResult.m_snapshot.empty());
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "historical_daily_high_matches_interpreter") {
+    auto security = Security("TST", DefaultMarkets::NYSE(),
+      DefaultCountries::US());
+    auto day = ptime(date(2010, May, 6));
+    auto timestamp = ptime(date(2010, May, 6), time_duration(15, 0, 0, 0));
+    for(auto price : {Money::ONE, 3 * Money::ONE, 2 * Money::ONE,
+        3 * Money::ONE}) {
+      m_environment.GetMarketDataEnvironment().Publish(security,
+        TimeAndSale(timestamp, price, 100, TimeAndSale::Condition(
+        TimeAndSale::Condition::Type::NONE, "?"), "N"));
+      timestamp += minutes(1);
+    }
+    auto query = BuildDailyHighQuery(security, day, day,
+      GetDefaultMarketDatabase(), GetDefaultTimeZoneDatabase());
+    REQUIRE(query.GetUpdatePolicy() ==
+      Beam::Queries::ExpressionQuery::UpdatePolicy::CHANGE);
+    auto batchResult = m_clientProtocol->SendRequest<QuerySecurityService>(
+      query, 1);
+
+    // Without a TAIL 1 snapshot limit the query is left to the interpreter,
+    // whose last update is the value the batch path must reproduce.
+    auto interpretedQuery = query;
+    interpretedQuery.SetSnapshotLimit(
+      Beam::Queries::SnapshotLimit::Unlimited());
+    auto interpretedResult =
+      m_clientProtocol->SendRequest<QuerySecurityService>(interpretedQuery, 2);
+    REQUIRE(batchResult.m_snapshot.size() == 1);
+    REQUIRE(interpretedResult.m_snapshot.size() == 2);
+    auto& batchValue = batchResult.m_snapshot.front();
+    auto& interpretedValue = interpretedResult.m_snapshot.back();
+    REQUIRE(boost::get<Money>(*batchValue) ==
+      boost::get<Money>(*interpretedValue));
+    REQUIRE(batchValue.GetSequence() == interpretedValue.GetSequence());
+  }
 }
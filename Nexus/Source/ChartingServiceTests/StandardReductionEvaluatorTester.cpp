@@ -0,0 +1,228 @@
+#include <Beam/Queries/Evaluator.hpp>
+#include <Beam/Queries/StandardValues.hpp>
+#include <doctest/doctest.h>
+#include "Nexus/Definitions/DefaultCountryDatabase.hpp"
+#include "Nexus/Definitions/DefaultMarketDatabase.hpp"
+#include "Nexus/Definitions/DefaultTimeZoneDatabase.hpp"
+#include "Nexus/Queries/EvaluatorTranslator.hpp"
+#include "Nexus/TechnicalAnalysis/StandardReductionEvaluator.hpp"
+#include "Nexus/TechnicalAnalysis/StandardSecurityQueries.hpp"
+
+using namespace Beam;
+using namespace Beam::Queries;
+using namespace boost;
+using namespace boost::gregorian;
+using namespace boost::posix_time;
+using namespace Nexus;
+using namespace Nexus::TechnicalAnalysis;
+
+namespace {
+  auto MakeTimeAndSales() {
+    auto timeAndSales = std::vector<TimeAndSale>();
+    auto timestamp = ptime(date(2021, 3, 4), hours(15));
+    auto marketCenters = std::vector<std::string>{"TSE", "CHX", "ALP", "TSE"};
+    for(auto i = 0; i < 1000; ++i) {
+      auto price = Money::CENT * (1000 + ((i * 7919) % 503));
+      auto size = Quantity(100 * (1 + (i * 31) % 17));
+      timeAndSales.emplace_back(timestamp + seconds(i), price, size,
+        TimeAndSale::Condition(TimeAndSale::Condition::Type::REGULAR, "@"),
+        marketCenters[i % marketCenters.size()]);
+    }
+    return timeAndSales;
+  }
+
+  template<typename T>
+  T Interpret(const Expression& expression, const Expression& filter,
+      const std::vector<TimeAndSale>& timeAndSales) {
+    auto filterTranslator = Nexus::Queries::EvaluatorTranslator();
+    filterTranslator.Translate(filter);
+    auto filterEvaluator = Evaluator(std::move(
+      filterTranslator.GetEvaluator()), filterTranslator.GetParameters());
+    auto translator = Nexus::Queries::EvaluatorTranslator();
+    translator.Translate(expression);
+    auto evaluator = Evaluator(std::move(translator.GetEvaluator()),
+      translator.GetParameters());
+    auto result = boost::optional<T>();
+    for(auto& timeAndSale : timeAndSales) {
+      if(filterEvaluator.Eval<bool>(timeAndSale)) {
+        result = evaluator.Eval<T>(timeAndSale);
+      }
+    }
+    return *result;
+  }
+
+  template<typename T>
+  boost::optional<std::size_t> InterpretLastChangedRow(
+      const Expression& expression, const Expression& filter,
+      const std::vector<TimeAndSale>& timeAndSales) {
+    auto filterTranslator = Nexus::Queries::EvaluatorTranslator();
+    filterTranslator.Translate(filter);
+    auto filterEvaluator = Evaluator(std::move(
+      filterTranslator.GetEvaluator()), filterTranslator.GetParameters());
+    auto translator = Nexus::Queries::EvaluatorTranslator();
+    translator.Translate(expression);
+    auto evaluator = Evaluator(std::move(translator.GetEvaluator()),
+      translator.GetParameters());
+    auto previous = boost::optional<T>();
+    auto row = boost::optional<std::size_t>();
+    for(auto i = std::size_t(0); i != timeAndSales.size(); ++i) {
+      if(filterEvaluator.Eval<bool>(timeAndSales[i])) {
+        auto result = evaluator.Eval<T>(timeAndSales[i]);
+        if(!previous || *previous != result) {
+          row = i;
+        }
+        previous = result;
+      }
+    }
+    return row;
+  }
+
+  Expression MakeMarketCenterFilter(const std::string& marketCenter) {
+    return MakeEqualsExpression(ConstantExpression(StringValue(marketCenter)),
+      MemberAccessExpression("market_center", StringType(),
+      ParameterExpression(0, Nexus::Queries::TimeAndSaleType())));
+  }
+
+  auto MakeQuery(ChartingService::SecurityChartingQuery (*builder)(
+      const Security&, const ptime&, const ptime&, const MarketDatabase&,
+      const local_time::tz_database&)) {
+    auto security = Security("TST", DefaultMarkets::TSX(),
+      DefaultCountries::CA());
+    auto day = ptime(date(2021, 3, 4));
+    return builder(security, day, day, GetDefaultMarketDatabase(),
+      GetDefaultTimeZoneDatabase());
+  }
+}
+
+TEST_SUITE("StandardReductionEvaluator") {
+  TEST_CASE("daily_high") {
+    auto query = MakeQuery(&BuildDailyHighQuery);
+    auto reduction = RecognizeStandardReduction(query.GetExpression(),
+      query.GetFilter());
+    REQUIRE(reduction.is_initialized());
+    REQUIRE(reduction->m_type == StandardReductionType::MAX);
+    REQUIRE(reduction->m_field == StandardReductionField::PRICE);
+    auto timeAndSales = MakeTimeAndSales();
+    auto columns = TimeAndSaleColumns(timeAndSales.begin(), timeAndSales.end());
+    REQUIRE(get<Money>(Evaluate(*reduction, columns)) ==
+      Interpret<Money>(query.GetExpression(), query.GetFilter(),
+      timeAndSales));
+  }
+
+  TEST_CASE("daily_low") {
+    auto query = MakeQuery(&BuildDailyLowQuery);
+    auto reduction = RecognizeStandardReduction(query.GetExpression(),
+      query.GetFilter());
+    REQUIRE(reduction.is_initialized());
+    REQUIRE(reduction->m_type == StandardReductionType::MIN);
+    auto timeAndSales = MakeTimeAndSales();
+    auto columns = TimeAndSaleColumns(timeAndSales.begin(), timeAndSales.end());
+    REQUIRE(get<Money>(Evaluate(*reduction, columns)) ==
+      Interpret<Money>(query.GetExpression(), query.GetFilter(),
+      timeAndSales));
+  }
+
+  TEST_CASE("daily_volume") {
+    auto query = MakeQuery(&BuildDailyVolumeQuery);
+    auto reduction = RecognizeStandardReduction(query.GetExpression(),
+      query.GetFilter());
+    REQUIRE(reduction.is_initialized());
+    REQUIRE(reduction->m_type == StandardReductionType::SUM);
+    REQUIRE(reduction->m_field == StandardReductionField::SIZE);
+    auto timeAndSales = MakeTimeAndSales();
+    auto columns = TimeAndSaleColumns(timeAndSales.begin(), timeAndSales.end());
+    REQUIRE(get<Quantity>(Evaluate(*reduction, columns)) ==
+      Interpret<Quantity>(query.GetExpression(), query.GetFilter(),
+      timeAndSales));
+  }
+
+  TEST_CASE("market_center_filter") {
+    auto query = MakeQuery(&BuildDailyVolumeQuery);
+    auto filter = MakeMarketCenterFilter("TSE");
+    auto reduction = RecognizeStandardReduction(query.GetExpression(), filter);
+    REQUIRE(reduction.is_initialized());
+    REQUIRE(reduction->m_marketCenters == std::vector<std::string>{"TSE"});
+    auto timeAndSales = MakeTimeAndSales();
+    auto columns = TimeAndSaleColumns(timeAndSales.begin(), timeAndSales.end());
+    REQUIRE(get<Quantity>(Evaluate(*reduction, columns)) ==
+      Interpret<Quantity>(query.GetExpression(), filter, timeAndSales));
+  }
+
+  TEST_CASE("multiple_market_center_filter") {
+    auto query = MakeQuery(&BuildDailyHighQuery);
+    auto filter = Expression(OrExpression(MakeMarketCenterFilter("CHX"),
+      MakeMarketCenterFilter("ALP")));
+    auto reduction = RecognizeStandardReduction(query.GetExpression(), filter);
+    REQUIRE(reduction.is_initialized());
+    REQUIRE(reduction->m_marketCenters.size() == 2);
+    auto timeAndSales = MakeTimeAndSales();
+    auto columns = TimeAndSaleColumns(timeAndSales.begin(), timeAndSales.end());
+    REQUIRE(get<Money>(Evaluate(*reduction, columns)) ==
+      Interpret<Money>(query.GetExpression(), filter, timeAndSales));
+  }
+
+  TEST_CASE("missing_market_center") {
+    auto query = MakeQuery(&BuildDailyLowQuery);
+    auto reduction = RecognizeStandardReduction(query.GetExpression(),
+      MakeMarketCenterFilter("XYZ"));
+    REQUIRE(reduction.is_initialized());
+    auto timeAndSales = MakeTimeAndSales();
+    auto columns = TimeAndSaleColumns(timeAndSales.begin(), timeAndSales.end());
+    REQUIRE(get<Money>(Evaluate(*reduction, columns)) ==
+      get<Money>(reduction->m_initialValue));
+    REQUIRE(!FindLastSelectedRow(*reduction, columns).is_initialized());
+  }
+
+  TEST_CASE("last_selected_row") {
+    auto query = MakeQuery(&BuildDailyHighQuery);
+    auto timeAndSales = MakeTimeAndSales();
+    auto columns = TimeAndSaleColumns(timeAndSales.begin(), timeAndSales.end());
+    auto reduction = RecognizeStandardReduction(query.GetExpression(),
+      query.GetFilter());
+    REQUIRE(reduction.is_initialized());
+    REQUIRE(FindLastSelectedRow(*reduction, columns) ==
+      timeAndSales.size() - 1);
+    auto filteredReduction = RecognizeStandardReduction(query.GetExpression(),
+      MakeMarketCenterFilter("ALP"));
+    REQUIRE(filteredReduction.is_initialized());
+    REQUIRE(FindLastSelectedRow(*filteredReduction, columns) ==
+      timeAndSales.size() - 2);
+    REQUIRE(!FindLastSelectedRow(*reduction,
+      TimeAndSaleColumns()).is_initialized());
+  }
+
+  TEST_CASE("last_changed_row") {
+    auto timeAndSales = MakeTimeAndSales();
+    auto columns = TimeAndSaleColumns(timeAndSales.begin(), timeAndSales.end());
+    for(auto builder : {&BuildDailyHighQuery, &BuildDailyLowQuery}) {
+      auto query = MakeQuery(builder);
+      for(auto& filter : {query.GetFilter(), MakeMarketCenterFilter("ALP")}) {
+        auto reduction = RecognizeStandardReduction(query.GetExpression(),
+          filter);
+        REQUIRE(reduction.is_initialized());
+        auto row = FindLastChangedRow(*reduction, columns);
+        REQUIRE(row.is_initialized());
+        REQUIRE(row == InterpretLastChangedRow<Money>(query.GetExpression(),
+          filter, timeAndSales));
+        REQUIRE(*row < *FindLastSelectedRow(*reduction, columns));
+      }
+    }
+    auto volumeQuery = MakeQuery(&BuildDailyVolumeQuery);
+    auto volumeReduction = RecognizeStandardReduction(
+      volumeQuery.GetExpression(), volumeQuery.GetFilter());
+    REQUIRE(volumeReduction.is_initialized());
+    REQUIRE(FindLastChangedRow(*volumeReduction, columns) ==
+      InterpretLastChangedRow<Quantity>(volumeQuery.GetExpression(),
+      volumeQuery.GetFilter(), timeAndSales));
+    REQUIRE(!FindLastChangedRow(*volumeReduction,
+      TimeAndSaleColumns()).is_initialized());
+  }
+
+  TEST_CASE("unrecognized_expression") {
+    auto expression = MemberAccessExpression("price",
+      Nexus::Queries::MoneyType(),
+      ParameterExpression(0, Nexus::Queries::TimeAndSaleType()));
+    REQUIRE(!RecognizeStandardReduction(expression,
+      ConstantExpression(BoolValue(true))).is_initialized());
+  }
+}
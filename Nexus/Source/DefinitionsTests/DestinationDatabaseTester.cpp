@@ -0,0 +1,99 @@
+#include <Beam/IO/SharedBuffer.hpp>
+#include <Beam/Serialization/BinaryReceiver.hpp>
+#include <Beam/Serialization/BinarySender.hpp>
+#include <doctest/doctest.h>
+#include "Nexus/Definitions/DefaultMarketDatabase.hpp"
+#include "Nexus/Definitions/Destination.hpp"
+
+using namespace Beam;
+using namespace Beam::IO;
+using namespace Beam::Serialization;
+using namespace Nexus;
+
+namespace {
+  auto MakeEntry(Destination id, std::vector<MarketCode> markets) {
+    auto entry = DestinationDatabase::Entry();
+    entry.m_id = id;
+    entry.m_markets = std::move(markets);
+    entry.m_description = std::move(id) + " Destination";
+    return entry;
+  }
+}
+
+TEST_SUITE("DestinationDatabase") {
+  TEST_CASE("lookup") {
+    auto database = DestinationDatabase();
+    auto nasdaq = MakeEntry("NASDAQ", {DefaultMarkets::NASDAQ()});
+    auto smart = MakeEntry("SMART",
+      {DefaultMarkets::NASDAQ(), DefaultMarkets::NYSE()});
+    auto nyse = MakeEntry("NYSE", {DefaultMarkets::NYSE()});
+    database.Add(smart);
+    database.Add(nyse);
+    database.Add(nasdaq);
+    REQUIRE(database.FromId("NASDAQ") == nasdaq);
+    REQUIRE(database.FromId("SMART") == smart);
+    REQUIRE(database.FromId("NYSE") == nyse);
+    REQUIRE((database.FromMarket(DefaultMarkets::NASDAQ()) ==
+      std::vector{nasdaq, smart}));
+    REQUIRE((database.FromMarket(DefaultMarkets::NYSE()) ==
+      std::vector{nyse, smart}));
+    database.SetPreferredDesintation(DefaultMarkets::NYSE(), "SMART");
+    REQUIRE(database.GetPreferredDestination(DefaultMarkets::NYSE()) ==
+      smart);
+    database.Delete("NASDAQ");
+    REQUIRE(database.FromId("SMART") == smart);
+    REQUIRE(database.FromId("NYSE") == nyse);
+    REQUIRE((database.FromMarket(DefaultMarkets::NASDAQ()) ==
+      std::vector{smart}));
+    REQUIRE(database.GetPreferredDestination(DefaultMarkets::NYSE()) ==
+      smart);
+  }
+
+  TEST_CASE("miss") {
+    auto database = DestinationDatabase();
+    REQUIRE(database.FromId("NASDAQ").m_id.empty());
+    REQUIRE(database.FromMarket(DefaultMarkets::NASDAQ()).empty());
+    REQUIRE(database.GetPreferredDestination(
+      DefaultMarkets::NASDAQ()).m_id.empty());
+    database.Add(MakeEntry("NASDAQ", {DefaultMarkets::NASDAQ()}));
+    REQUIRE(database.FromId("NYSE").m_id.empty());
+    REQUIRE(database.FromMarket(DefaultMarkets::NYSE()).empty());
+    database.SetPreferredDesintation(DefaultMarkets::NYSE(), "NYSE");
+    REQUIRE(database.GetPreferredDestination(
+      DefaultMarkets::NYSE()).m_id.empty());
+    database.Delete("NASDAQ");
+    REQUIRE(database.FromId("NASDAQ").m_id.empty());
+    REQUIRE(database.FromMarket(DefaultMarkets::NASDAQ()).empty());
+  }
+
+  TEST_CASE("duplicate_id") {
+    auto database = DestinationDatabase();
+    auto nasdaq = MakeEntry("NASDAQ", {DefaultMarkets::NASDAQ()});
+    database.Add(nasdaq);
+    database.Add(MakeEntry("NASDAQ", {DefaultMarkets::NYSE()}));
+    REQUIRE(database.FromId("NASDAQ") == nasdaq);
+    REQUIRE((database.FromMarket(DefaultMarkets::NASDAQ()) ==
+      std::vector{nasdaq}));
+    REQUIRE(database.FromMarket(DefaultMarkets::NYSE()).empty());
+  }
+
+  TEST_CASE("serialization") {
+    auto database = DestinationDatabase();
+    auto nasdaq = MakeEntry("NASDAQ", {DefaultMarkets::NASDAQ()});
+    database.Add(nasdaq);
+    database.SetPreferredDesintation(DefaultMarkets::NASDAQ(), "NASDAQ");
+    auto buffer = SharedBuffer();
+    auto sender = BinarySender<SharedBuffer>();
+    sender.SetSink(Ref(buffer));
+    sender.Shuttle(database);
+    auto receiver = BinaryReceiver<SharedBuffer>();
+    receiver.SetSource(Ref(buffer));
+    auto receivedDatabase = DestinationDatabase();
+    receiver.Shuttle(receivedDatabase);
+    REQUIRE(receivedDatabase.FromId("NASDAQ") == nasdaq);
+    REQUIRE((receivedDatabase.FromMarket(DefaultMarkets::NASDAQ()) ==
+      std::vector{nasdaq}));
+    REQUIRE(receivedDatabase.GetPreferredDestination(
+      DefaultMarkets::NASDAQ()) == nasdaq);
+  }
+}
@@ -0,0 +1,80 @@
+#include <atomic>
+#include <thread>
+#include <doctest/doctest.h>
+#include "Nexus/Definitions/DefaultCurrencyDatabase.hpp"
+#include "Nexus/Definitions/ExchangeRateTable.hpp"
+
+using namespace boost;
+using namespace Nexus;
+
+TEST_SUITE("ExchangeRateTable") {
+  TEST_CASE("find") {
+    auto table = ExchangeRateTable();
+    REQUIRE(!table.Find({DefaultCurrencies::USD(), DefaultCurrencies::CAD()}));
+    REQUIRE(table.Find({DefaultCurrencies::USD(), DefaultCurrencies::USD()})->
+      m_rate == 1);
+    table.Add(ExchangeRate({DefaultCurrencies::USD(), DefaultCurrencies::CAD()},
+      rational<int>(5, 4)));
+    REQUIRE(table.Find({DefaultCurrencies::USD(), DefaultCurrencies::CAD()})->
+      m_rate == rational<int>(5, 4));
+    REQUIRE(table.Find({DefaultCurrencies::CAD(), DefaultCurrencies::USD()})->
+      m_rate == rational<int>(4, 5));
+    REQUIRE(!table.Find({DefaultCurrencies::USD(), DefaultCurrencies::AUD()}));
+  }
+
+  TEST_CASE("update") {
+    auto table = ExchangeRateTable();
+    table.Add(ExchangeRate({DefaultCurrencies::USD(), DefaultCurrencies::CAD()},
+      rational<int>(5, 4)));
+    table.Add(ExchangeRate({DefaultCurrencies::AUD(), DefaultCurrencies::USD()},
+      rational<int>(3, 4)));
+    table.Add(ExchangeRate({DefaultCurrencies::CAD(), DefaultCurrencies::USD()},
+      rational<int>(2, 3)));
+    REQUIRE(table.Find({DefaultCurrencies::USD(), DefaultCurrencies::CAD()})->
+      m_rate == rational<int>(3, 2));
+    REQUIRE(table.Find({DefaultCurrencies::USD(), DefaultCurrencies::AUD()})->
+      m_rate == rational<int>(4, 3));
+    REQUIRE(!table.Find({DefaultCurrencies::AUD(), DefaultCurrencies::CAD()}));
+  }
+
+  TEST_CASE("convert") {
+    auto table = ExchangeRateTable();
+    table.Add(ExchangeRate({DefaultCurrencies::USD(), DefaultCurrencies::CAD()},
+      rational<int>(5, 4)));
+    REQUIRE(table.Convert(4 * Money::ONE, DefaultCurrencies::USD(),
+      DefaultCurrencies::CAD()) == 5 * Money::ONE);
+    REQUIRE_THROWS_AS(table.Convert(Money::ONE, DefaultCurrencies::USD(),
+      DefaultCurrencies::AUD()), CurrencyPairNotFoundException);
+  }
+
+  TEST_CASE("concurrent_update") {
+    auto table = ExchangeRateTable();
+    auto pair = CurrencyPair{DefaultCurrencies::USD(),
+      DefaultCurrencies::CAD()};
+    table.Add(ExchangeRate(pair, rational<int>(5, 4)));
+    auto isDone = std::atomic_bool(false);
+    auto failures = std::atomic_int(0);
+    auto readers = std::vector<std::thread>();
+    for(auto i = 0; i != 4; ++i) {
+      readers.emplace_back([&] {
+        while(!isDone) {
+          auto rate = table.Find(pair);
+          if(!rate || (rate->m_rate != rational<int>(5, 4) &&
+              rate->m_rate != rational<int>(3, 2))) {
+            ++failures;
+          }
+        }
+      });
+    }
+    for(auto i = 0; i != 10000; ++i) {
+      table.Add(ExchangeRate(pair, i % 2 == 0 ? rational<int>(3, 2) :
+        rational<int>(5, 4)));
+    }
+    isDone = true;
+    for(auto& reader : readers) {
+      reader.join();
+    }
+    REQUIRE(failures == 0);
+    REQUIRE(table.Find(pair)->m_rate == rational<int>(5, 4));
+  }
+}
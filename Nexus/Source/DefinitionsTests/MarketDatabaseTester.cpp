@@ -0,0 +1,105 @@
+#include <Beam/IO/SharedBuffer.hpp>
+#include <Beam/Serialization/BinaryReceiver.hpp>
+#include <Beam/Serialization/BinarySender.hpp>
+#include <doctest/doctest.h>
+#include "Nexus/Definitions/DefaultCountryDatabase.hpp"
+#include "Nexus/Definitions/DefaultMarketDatabase.hpp"
+#include "Nexus/Definitions/Market.hpp"
+
+using namespace Beam;
+using namespace Beam::IO;
+using namespace Beam::Serialization;
+using namespace Nexus;
+
+namespace {
+  auto MakeEntry(MarketCode code, std::string displayName) {
+    auto entry = MarketDatabase::Entry();
+    entry.m_code = code;
+    entry.m_countryCode = DefaultCountries::US();
+    entry.m_timeZone = "Eastern_Time";
+    entry.m_description = displayName + " Exchange";
+    entry.m_displayName = std::move(displayName);
+    return entry;
+  }
+}
+
+TEST_SUITE("MarketDatabase") {
+  TEST_CASE("lookup") {
+    auto database = MarketDatabase();
+    auto nasdaq = MakeEntry(DefaultMarkets::NASDAQ(), "NSDQ");
+    auto nyse = MakeEntry(DefaultMarkets::NYSE(), "NYSE");
+    auto arca = MakeEntry(DefaultMarkets::ARCX(), "ARCA");
+    database.Add(nyse);
+    database.Add(nasdaq);
+    database.Add(arca);
+    REQUIRE(database.GetEntries().size() == 3);
+    REQUIRE(database.FromCode(DefaultMarkets::NASDAQ()) == nasdaq);
+    REQUIRE(database.FromCode(DefaultMarkets::NYSE()) == nyse);
+    REQUIRE(database.FromCode(DefaultMarkets::ARCX()) == arca);
+    REQUIRE(database.FromDisplayName("NSDQ") == nasdaq);
+    REQUIRE(database.FromDisplayName("NYSE") == nyse);
+    REQUIRE(database.FromDisplayName("ARCA") == arca);
+    database.Delete(DefaultMarkets::NASDAQ());
+    REQUIRE(database.GetEntries().size() == 2);
+    REQUIRE(database.FromCode(DefaultMarkets::NYSE()) == nyse);
+    REQUIRE(database.FromCode(DefaultMarkets::ARCX()) == arca);
+    REQUIRE(database.FromDisplayName("ARCA") == arca);
+  }
+
+  TEST_CASE("miss") {
+    auto database = MarketDatabase();
+    REQUIRE(database.FromCode(DefaultMarkets::NASDAQ()).m_code ==
+      MarketCode());
+    REQUIRE(database.FromDisplayName("NSDQ").m_code == MarketCode());
+    database.Add(MakeEntry(DefaultMarkets::NASDAQ(), "NSDQ"));
+    REQUIRE(database.FromCode(DefaultMarkets::NYSE()).m_code == MarketCode());
+    REQUIRE(database.FromDisplayName("NYSE").m_code == MarketCode());
+    REQUIRE(database.FromDisplayName("nsdq").m_code == MarketCode());
+    database.Delete(DefaultMarkets::NASDAQ());
+    REQUIRE(database.FromCode(DefaultMarkets::NASDAQ()).m_code ==
+      MarketCode());
+    REQUIRE(database.FromDisplayName("NSDQ").m_code == MarketCode());
+  }
+
+  TEST_CASE("duplicate_code") {
+    auto database = MarketDatabase();
+    auto nasdaq = MakeEntry(DefaultMarkets::NASDAQ(), "NSDQ");
+    database.Add(nasdaq);
+    database.Add(MakeEntry(DefaultMarkets::NASDAQ(), "OTHER"));
+    REQUIRE(database.GetEntries().size() == 1);
+    REQUIRE(database.FromCode(DefaultMarkets::NASDAQ()) == nasdaq);
+    REQUIRE(database.FromDisplayName("NSDQ") == nasdaq);
+    REQUIRE(database.FromDisplayName("OTHER").m_code == MarketCode());
+  }
+
+  TEST_CASE("duplicate_display_name") {
+    auto database = MarketDatabase();
+    auto nyse = MakeEntry(DefaultMarkets::NYSE(), "SAME");
+    auto nasdaq = MakeEntry(DefaultMarkets::NASDAQ(), "SAME");
+    database.Add(nyse);
+    database.Add(nasdaq);
+    auto first = database.GetEntries().front();
+    REQUIRE(database.FromDisplayName("SAME") == first);
+    database.Delete(first.m_code);
+    REQUIRE(database.FromDisplayName("SAME") ==
+      database.GetEntries().front());
+  }
+
+  TEST_CASE("serialization") {
+    auto database = MarketDatabase();
+    auto nasdaq = MakeEntry(DefaultMarkets::NASDAQ(), "NSDQ");
+    auto nyse = MakeEntry(DefaultMarkets::NYSE(), "NYSE");
+    database.Add(nasdaq);
+    database.Add(nyse);
+    auto buffer = SharedBuffer();
+    auto sender = BinarySender<SharedBuffer>();
+    sender.SetSink(Ref(buffer));
+    sender.Shuttle(database);
+    auto receiver = BinaryReceiver<SharedBuffer>();
+    receiver.SetSource(Ref(buffer));
+    auto receivedDatabase = MarketDatabase();
+    receiver.Shuttle(receivedDatabase);
+    REQUIRE(receivedDatabase.FromCode(DefaultMarkets::NASDAQ()) == nasdaq);
+    REQUIRE(receivedDatabase.FromDisplayName("NYSE") == nyse);
+  }
+}
@@ -1,3 +1,5 @@
+#include <atomic>
+#include <thread>
 #include <doctest/doctest.h>
 #include "Nexus/Definitions/DefaultMarketDatabase.hpp"
 #include "Nexus/Definitions/TradingSchedule.hpp"
@@ -126,6 +128,120 @@ TEST_SUITE("TradingSchedule") {
     REQUIRE(foundEvents.front() == events.front());
   }
 
+  TEST_CASE("find_precedence") {
+    auto openEvent = TradingSchedule::Event{"O", ptime(date(1900, 1, 1),
+      time_duration(9, 30, 0, 0))};
+    auto closeEvent = TradingSchedule::Event{"C", ptime(date(1900, 1, 1),
+      time_duration(16, 0, 0, 0))};
+    auto rules = std::vector<TradingSchedule::Rule>();
+    rules.push_back(TradingSchedule::Rule{{DefaultMarkets::NYSE()},
+      {greg_weekday::weekday_enum::Saturday}, {}, {}, {}, {}});
+    rules.push_back(TradingSchedule::Rule{{}, {}, {}, {}, {},
+      {openEvent, closeEvent}});
+    auto schedule = TradingSchedule(rules);
+    REQUIRE(schedule.Find(date(2020, 7, 18), DefaultMarkets::NYSE())->empty());
+    auto events = schedule.Find(date(2020, 7, 17), DefaultMarkets::NYSE());
+    REQUIRE(events->size() == 2);
+    REQUIRE(events->front().m_timestamp ==
+      ptime(date(2020, 7, 17), time_duration(9, 30, 0, 0)));
+    REQUIRE(schedule.Find(date(2020, 7, 17), DefaultMarkets::NYSE()) ==
+      events);
+    REQUIRE(schedule.Find(date(2020, 7, 18),
+      DefaultMarkets::NASDAQ())->size() == 2);
+  }
+
+  TEST_CASE("cached_days") {
+    auto openEvent = TradingSchedule::Event{"O", ptime(date(1900, 1, 1),
+      time_duration(9, 30, 0, 0))};
+    auto rules = std::vector<TradingSchedule::Rule>();
+    rules.push_back(TradingSchedule::Rule{{DefaultMarkets::NYSE()},
+      {greg_weekday::weekday_enum::Saturday,
+      greg_weekday::weekday_enum::Sunday}, {}, {}, {}, {}});
+    rules.push_back(TradingSchedule::Rule{{}, {}, {}, {}, {}, {openEvent}});
+    auto schedule = TradingSchedule(rules);
+    auto uncachedSchedule = TradingSchedule(rules);
+    for(auto pass = 0; pass != 2; ++pass) {
+      for(auto day = date(2020, 7, 1); day != date(2020, 8, 1);
+          day += days(1)) {
+        auto events = schedule.Find(day, DefaultMarkets::NYSE());
+        REQUIRE(*events ==
+          *uncachedSchedule.Find(day, DefaultMarkets::NYSE()));
+        if(day.day_of_week() == Saturday || day.day_of_week() == Sunday) {
+          REQUIRE(events->empty());
+        } else {
+          REQUIRE(events->size() == 1);
+          REQUIRE(events->front().m_timestamp ==
+            ptime(day, time_duration(9, 30, 0, 0)));
+        }
+      }
+    }
+  }
+
+  TEST_CASE("cached_lookup_shares_events") {
+    auto openEvent = TradingSchedule::Event{"O", ptime(date(1900, 1, 1),
+      time_duration(9, 30, 0, 0))};
+    auto schedule = TradingSchedule({TradingSchedule::Rule{
+      {DefaultMarkets::NYSE()}, {}, {}, {}, {}, {openEvent}}});
+    auto events = schedule.Find(date(2020, 7, 17), DefaultMarkets::NYSE());
+    REQUIRE(schedule.Find(date(2020, 7, 17), DefaultMarkets::NYSE()).get() ==
+      events.get());
+    REQUIRE(schedule.Find(date(2020, 7, 17), DefaultMarkets::TSX())->empty());
+    for(auto day = date(2020, 7, 18); day != date(2020, 7, 25);
+        day += days(1)) {
+      schedule.Find(day, DefaultMarkets::NYSE());
+    }
+    REQUIRE(events->size() == 1);
+    REQUIRE(events->front().m_timestamp ==
+      ptime(date(2020, 7, 17), time_duration(9, 30, 0, 0)));
+  }
+
+  TEST_CASE("moved_from") {
+    auto openEvent = TradingSchedule::Event{"O", ptime(date(1900, 1, 1),
+      time_duration(9, 30, 0, 0))};
+    auto schedule = TradingSchedule({TradingSchedule::Rule{{}, {}, {}, {}, {},
+      {openEvent}}});
+    auto movedSchedule = std::move(schedule);
+    REQUIRE(movedSchedule.Find(date(2020, 7, 17),
+      DefaultMarkets::NYSE())->size() == 1);
+    REQUIRE_NOTHROW(schedule.Find(date(2020, 7, 17), DefaultMarkets::NYSE()));
+    REQUIRE_NOTHROW(schedule.Find(date(2020, 7, 17), DefaultMarkets::NYSE(),
+      [] (auto& event) {
+        return true;
+      }));
+    schedule = movedSchedule;
+    REQUIRE(schedule.Find(date(2020, 7, 17), DefaultMarkets::NYSE())->size() ==
+      1);
+  }
+
+  TEST_CASE("concurrent_find") {
+    auto openEvent = TradingSchedule::Event{"O", ptime(date(1900, 1, 1),
+      time_duration(9, 30, 0, 0))};
+    auto schedule = TradingSchedule({TradingSchedule::Rule{{}, {}, {}, {}, {},
+      {openEvent}}});
+    auto failures = std::atomic_int(0);
+    auto threads = std::vector<std::thread>();
+    for(auto i = 0; i != 4; ++i) {
+      threads.emplace_back([&, i] {
+        auto markets = {DefaultMarkets::NYSE(), DefaultMarkets::NASDAQ(),
+          DefaultMarkets::TSX()};
+        for(auto j = 0; j != 1000; ++j) {
+          auto day = date(2020, 1, 1) + days((i + j) % 30);
+          for(auto market : markets) {
+            auto events = schedule.Find(day, market);
+            if(events->size() != 1 || events->front().m_timestamp !=
+                ptime(day, time_duration(9, 30, 0, 0))) {
+              ++failures;
+            }
+          }
+        }
+      });
+    }
+    for(auto& thread : threads) {
+      thread.join();
+    }
+    REQUIRE(failures == 0);
+  }
+
   TEST_CASE("parse_schedule") {
     auto ss = std::stringstream();
     ss << "- market: NSDQ\n"
@@ -138,9 +254,9 @@ TEST_SUITE("TradingSchedule") {
     auto schedule = ParseTradingSchedule(node, GetDefaultMarketDatabase());
     auto emptyEvents = schedule.Find(
       date(2020, 1, 15), DefaultMarkets::NASDAQ());
-    REQUIRE(emptyEvents.empty());
+    REQUIRE(emptyEvents->empty());
     auto event = schedule.Find(date(2020, 7, 18), DefaultMarkets::NASDAQ());
-    REQUIRE(event.size() == 1);
-    REQUIRE(event.front().m_code == "OPEN");
+    REQUIRE(event->size() == 1);
+    REQUIRE(event->front().m_code == "OPEN");
   }
 }
@@ -3,8 +3,62 @@
 #include "Nexus/FeeHandlingTests/FeeTableTestUtilities.hpp"
 
 using namespace Beam;
+using namespace Beam::ServiceLocator;
+using namespace boost;
+using namespace boost::posix_time;
 using namespace Nexus;
+using namespace Nexus::OrderExecutionService;
 using namespace Nexus::Tests;
 
 TEST_SUITE("ConsolidatedTmxFeeTable") {
+  TEST_CASE("calculate_fees") {
+    auto feeTable = ConsolidatedTmxFeeTable();
+    feeTable.m_spireFee = Money::CENT;
+    feeTable.m_iirocFee = 3 * Money::CENT;
+    feeTable.m_cdsFee = 10 * Money::CENT;
+    feeTable.m_cdsCap = 1;
+    feeTable.m_clearingFee = Money::CENT;
+    feeTable.m_perOrderFee = Money::CENT;
+    feeTable.m_perOrderCap = 150 * Money::CENT;
+    feeTable.m_cseFeeTable.m_feeTable[static_cast<int>(
+      CseFeeTable::PriceClass::DEFAULT)][static_cast<int>(
+      LiquidityFlag::ACTIVE)] = 2 * Money::CENT;
+    auto state = ConsolidatedTmxFeeTable::State();
+    auto timestamp = ptime(gregorian::date(2021, 3, 1), hours(14));
+    auto account = DirectoryEntry::MakeAccount(123, "test");
+    auto security = Security("TST", DefaultMarkets::CSE(),
+      DefaultCountries::CA());
+    auto orders = std::vector<OrderInfo>();
+    orders.emplace_back(OrderFields::BuildLimitOrder(account, security,
+      DefaultCurrencies::CAD(), Side::BID, DefaultDestinations::CSE(), 300,
+      10 * Money::ONE), 1, false, timestamp);
+    auto executionReports = std::vector<ExecutionReport>();
+    auto addReport = [&] (Quantity quantity) {
+      auto report = ExecutionReport::BuildInitialReport(1, timestamp);
+      report.m_lastQuantity = quantity;
+      report.m_lastPrice = 10 * Money::ONE;
+      report.m_liquidityFlag = "A";
+      executionReports.push_back(report);
+    };
+    addReport(100);
+    addReport(100);
+    addReport(0);
+    auto feesReports = CalculateFees(feeTable, state, orders,
+      executionReports);
+    REQUIRE(feesReports.size() == 3);
+    REQUIRE(feesReports[0].m_executionFee == 2 * Money::ONE);
+    REQUIRE(feesReports[0].m_processingFee == 213 * Money::CENT);
+    REQUIRE(feesReports[0].m_commission == Money::ONE);
+    REQUIRE(feesReports[1].m_executionFee == 2 * Money::ONE);
+    REQUIRE(feesReports[1].m_processingFee == 153 * Money::CENT);
+    REQUIRE(feesReports[1].m_commission == Money::ONE);
+    REQUIRE(feesReports[2].m_executionFee == Money::ZERO);
+    REQUIRE(feesReports[2].m_processingFee == Money::ZERO);
+    REQUIRE(feesReports[2].m_commission == Money::ZERO);
+    REQUIRE(state.m_fillCount.Get(1) == 2);
+    REQUIRE(state.m_perOrderCharges.Get(1) == feeTable.m_perOrderCap);
+    executionReports.push_back(ExecutionReport::BuildInitialReport(2,
+      timestamp));
+    REQUIRE_THROWS(CalculateFees(feeTable, state, orders, executionReports));
+  }
 }
@@ -3,8 +3,59 @@
 #include "Nexus/FeeHandlingTests/FeeTableTestUtilities.hpp"
 
 using namespace Beam;
+using namespace Beam::ServiceLocator;
+using namespace boost;
+using namespace boost::posix_time;
 using namespace Nexus;
+using namespace Nexus::OrderExecutionService;
 using namespace Nexus::Tests;
 
 TEST_SUITE("ConsolidatedUsFeeTable") {
+  TEST_CASE("calculate_fees") {
+    auto feeTable = ConsolidatedUsFeeTable();
+    feeTable.m_spireFee = Money::CENT;
+    feeTable.m_clearingFee = 2 * Money::CENT;
+    feeTable.m_secRate = rational<int>(1, 1000);
+    feeTable.m_batsFeeTable.m_feeTable["A"] = rational<int>(3, 1000);
+    feeTable.m_edgxFeeTable.m_feeTable["R"] = rational<int>(-2, 1000);
+    auto timestamp = ptime(gregorian::date(2021, 3, 1), hours(14));
+    auto account = DirectoryEntry::MakeAccount(123, "test");
+    auto security = Security("TST", DefaultMarkets::NYSE(),
+      DefaultCountries::US());
+    auto orders = std::vector<OrderInfo>();
+    orders.emplace_back(OrderFields::BuildLimitOrder(account, security,
+      DefaultCurrencies::USD(), Side::ASK, DefaultDestinations::BATS(), 100,
+      10 * Money::ONE), 1, false, timestamp);
+    orders.emplace_back(OrderFields::BuildLimitOrder(account, security,
+      DefaultCurrencies::USD(), Side::BID, DefaultDestinations::EDGX(), 200,
+      10 * Money::ONE), 2, false, timestamp);
+    auto executionReports = std::vector<ExecutionReport>();
+    auto addReport = [&] (OrderId id, Quantity quantity, std::string flag) {
+      auto report = ExecutionReport::BuildInitialReport(id, timestamp);
+      report.m_lastQuantity = quantity;
+      report.m_lastPrice = 10 * Money::ONE;
+      report.m_liquidityFlag = std::move(flag);
+      executionReports.push_back(report);
+    };
+    addReport(1, 50, "A");
+    addReport(2, 100, "R");
+    addReport(1, 50, "A");
+    auto feesReports = CalculateFees(feeTable, orders, executionReports);
+    REQUIRE(feesReports.size() == 3);
+    REQUIRE(feesReports[0].m_id == 1);
+    REQUIRE(feesReports[0].m_executionFee == 15 * Money::CENT);
+    REQUIRE(feesReports[0].m_processingFee == 101 * Money::CENT);
+    REQUIRE(feesReports[0].m_commission == 50 * Money::CENT);
+    REQUIRE(feesReports[1].m_id == 2);
+    REQUIRE(feesReports[1].m_executionFee == -20 * Money::CENT);
+    REQUIRE(feesReports[1].m_processingFee == 301 * Money::CENT);
+    REQUIRE(feesReports[1].m_commission == Money::ONE);
+    REQUIRE(feesReports[2].m_id == 1);
+    REQUIRE(feesReports[2].m_executionFee == 15 * Money::CENT);
+    REQUIRE(feesReports[2].m_processingFee == 101 * Money::CENT);
+    REQUIRE(feesReports[2].m_commission == 50 * Money::CENT);
+    executionReports.push_back(ExecutionReport::BuildInitialReport(3,
+      timestamp));
+    REQUIRE_THROWS(CalculateFees(feeTable, orders, executionReports));
+  }
 }
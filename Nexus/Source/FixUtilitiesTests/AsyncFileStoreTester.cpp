@@ -0,0 +1,185 @@
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <doctest/doctest.h>
+#include "Nexus/FixUtilities/AsyncFileStore.hpp"
+
+using namespace boost;
+using namespace boost::gregorian;
+using namespace boost::posix_time;
+using namespace Nexus;
+using namespace Nexus::FixUtilities;
+
+namespace {
+  const auto JOURNAL_PATH = std::string("async_file_store_tester.journal");
+  const auto FILE_STORE_PREFIX = std::string("async_file_store_tester");
+
+  struct Fixture {
+    FIX::UtcTimeStamp m_creationTime;
+
+    Fixture()
+        : m_creationTime(GetUtcTimestamp(
+            ptime(date(2021, 3, 12), time_duration(13, 33, 26)))) {
+      Remove();
+    }
+
+    ~Fixture() {
+      Remove();
+    }
+
+    void Remove() {
+      std::remove(JOURNAL_PATH.c_str());
+      for(auto extension : {".seqnums", ".session", ".header", ".body"}) {
+        std::remove((FILE_STORE_PREFIX + extension).c_str());
+      }
+    }
+
+    std::string ReadJournal() const {
+      auto journal = std::ifstream(JOURNAL_PATH, std::ios::binary);
+      return std::string(std::istreambuf_iterator<char>(journal),
+        std::istreambuf_iterator<char>());
+    }
+  };
+}
+
+TEST_SUITE("AsyncFileStore") {
+  TEST_CASE_FIXTURE(Fixture, "empty_store") {
+    auto store = AsyncFileStore(JOURNAL_PATH, m_creationTime);
+    REQUIRE(store.getNextSenderMsgSeqNum() == 1);
+    REQUIRE(store.getNextTargetMsgSeqNum() == 1);
+    REQUIRE(GetTimestamp(store.getCreationTime()) ==
+      GetTimestamp(m_creationTime));
+    auto messages = std::vector<std::string>();
+    store.get(1, 10, messages);
+    REQUIRE(messages.empty());
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "recover") {
+    {
+      auto store = AsyncFileStore(JOURNAL_PATH, m_creationTime);
+      store.set(1, "a");
+      store.incrNextSenderMsgSeqNum();
+      store.set(2, "b\nc");
+      store.incrNextSenderMsgSeqNum();
+      store.set(3, "d");
+      store.incrNextSenderMsgSeqNum();
+      store.setNextTargetMsgSeqNum(7);
+    }
+    auto store = AsyncFileStore(JOURNAL_PATH,
+      GetUtcTimestamp(ptime(date(2021, 3, 13), hours(1))));
+    REQUIRE(store.getNextSenderMsgSeqNum() == 4);
+    REQUIRE(store.getNextTargetMsgSeqNum() == 7);
+    REQUIRE(GetTimestamp(store.getCreationTime()) ==
+      GetTimestamp(m_creationTime));
+    auto messages = std::vector<std::string>();
+    store.get(2, 3, messages);
+    REQUIRE(messages == std::vector<std::string>{"b\nc", "d"});
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "recover_torn_record") {
+    {
+      auto store = AsyncFileStore(JOURNAL_PATH, m_creationTime);
+      store.set(1, "a");
+      store.incrNextSenderMsgSeqNum();
+    }
+    {
+      auto journal = std::ofstream(JOURNAL_PATH,
+        std::ios::binary | std::ios::app);
+      journal << "M 2 10\nabc";
+    }
+    {
+      auto store = AsyncFileStore(JOURNAL_PATH, m_creationTime);
+      REQUIRE(store.getNextSenderMsgSeqNum() == 2);
+      store.set(2, "b");
+      store.incrNextSenderMsgSeqNum();
+    }
+    auto store = AsyncFileStore(JOURNAL_PATH, m_creationTime);
+    REQUIRE(store.getNextSenderMsgSeqNum() == 3);
+    auto messages = std::vector<std::string>();
+    store.get(1, 2, messages);
+    REQUIRE(messages == std::vector<std::string>{"a", "b"});
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "reset") {
+    auto store = AsyncFileStore(JOURNAL_PATH, m_creationTime);
+    store.set(1, "a");
+    store.incrNextSenderMsgSeqNum();
+    store.incrNextTargetMsgSeqNum();
+    auto resetTime = GetUtcTimestamp(ptime(date(2021, 3, 13), hours(1)));
+    store.reset(resetTime);
+    REQUIRE(store.getNextSenderMsgSeqNum() == 1);
+    REQUIRE(store.getNextTargetMsgSeqNum() == 1);
+    REQUIRE(GetTimestamp(store.getCreationTime()) == GetTimestamp(resetTime));
+    store.refresh();
+    REQUIRE(store.getNextSenderMsgSeqNum() == 1);
+    auto messages = std::vector<std::string>();
+    store.get(1, 1, messages);
+    REQUIRE(messages.empty());
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "background_sequence_numbers") {
+    {
+      auto store = AsyncFileStore(JOURNAL_PATH, m_creationTime);
+      store.setNextSenderMsgSeqNum(5);
+      store.incrNextTargetMsgSeqNum();
+      REQUIRE(store.getNextSenderMsgSeqNum() == 5);
+      REQUIRE(store.getNextTargetMsgSeqNum() == 2);
+    }
+    auto journal = ReadJournal();
+    REQUIRE(journal.find("S 5\n") != std::string::npos);
+    REQUIRE(journal.find("T 2\n") != std::string::npos);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "recover_sender_from_messages") {
+    std::ofstream(JOURNAL_PATH, std::ios::binary) <<
+      "C 20210312T133326\nS 1\nT 4\nM 1 1\na\nM 2 1\nb\nS 2\n";
+    auto store = AsyncFileStore(JOURNAL_PATH, m_creationTime);
+    REQUIRE(store.getNextSenderMsgSeqNum() == 3);
+    REQUIRE(store.getNextTargetMsgSeqNum() == 4);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "message_limit") {
+    {
+      auto store = AsyncFileStore(JOURNAL_PATH, m_creationTime, {}, 2);
+      for(auto i = 1; i <= 4; ++i) {
+        store.set(i, std::to_string(i));
+        store.incrNextSenderMsgSeqNum();
+      }
+      auto messages = std::vector<std::string>();
+      store.get(1, 4, messages);
+      REQUIRE(messages == std::vector<std::string>{"3", "4"});
+    }
+    auto store = AsyncFileStore(JOURNAL_PATH, m_creationTime, {}, 2);
+    REQUIRE(store.getNextSenderMsgSeqNum() == 5);
+    auto messages = std::vector<std::string>();
+    store.get(1, 4, messages);
+    REQUIRE(messages == std::vector<std::string>{"3", "4"});
+    REQUIRE(ReadJournal().find("M 1 ") == std::string::npos);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "import_file_store") {
+    std::ofstream(FILE_STORE_PREFIX + ".seqnums") <<
+      "0000000005 : 0000000009";
+    std::ofstream(FILE_STORE_PREFIX + ".session") << "20210310-08:15:00";
+    std::ofstream(FILE_STORE_PREFIX + ".header") << "1,0,1 2,1,3 ";
+    std::ofstream(FILE_STORE_PREFIX + ".body", std::ios::binary) << "ab\nc";
+    {
+      auto store = AsyncFileStore(JOURNAL_PATH, m_creationTime,
+        FILE_STORE_PREFIX);
+      REQUIRE(store.getNextSenderMsgSeqNum() == 5);
+      REQUIRE(store.getNextTargetMsgSeqNum() == 9);
+      REQUIRE(GetTimestamp(store.getCreationTime()) ==
+        ptime(date(2021, 3, 10), time_duration(8, 15, 0)));
+      auto messages = std::vector<std::string>();
+      store.get(1, 2, messages);
+      REQUIRE(messages == std::vector<std::string>{"a", "b\nc"});
+      store.incrNextSenderMsgSeqNum();
+    }
+    std::ofstream(FILE_STORE_PREFIX + ".seqnums") <<
+      "0000000020 : 0000000020";
+    auto store = AsyncFileStore(JOURNAL_PATH, m_creationTime,
+      FILE_STORE_PREFIX);
+    REQUIRE(store.getNextSenderMsgSeqNum() == 6);
+    REQUIRE(store.getNextTargetMsgSeqNum() == 9);
+  }
+}
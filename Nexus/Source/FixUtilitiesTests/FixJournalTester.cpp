@@ -0,0 +1,66 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <doctest/doctest.h>
+#include "Nexus/FixUtilities/FixJournal.hpp"
+
+using namespace Nexus;
+using namespace Nexus::FixUtilities;
+
+namespace {
+  const auto JOURNAL_PATH = std::string("fix_journal_tester.journal");
+
+  struct Fixture {
+    Fixture() {
+      std::remove(JOURNAL_PATH.c_str());
+    }
+
+    ~Fixture() {
+      std::remove(JOURNAL_PATH.c_str());
+    }
+
+    std::string ReadJournal() const {
+      auto journal = std::ifstream(JOURNAL_PATH, std::ios::binary);
+      return std::string(std::istreambuf_iterator<char>(journal),
+        std::istreambuf_iterator<char>());
+    }
+  };
+}
+
+TEST_SUITE("FixJournal") {
+  TEST_CASE_FIXTURE(Fixture, "append_and_reset") {
+    auto journal = FixJournal(JOURNAL_PATH, false);
+    journal.Append("a");
+    journal.Append("b");
+    journal.Flush();
+    REQUIRE(ReadJournal() == "ab");
+    journal.Reset("c");
+    REQUIRE(ReadJournal() == "c");
+  }
+
+#ifndef _WIN32
+  TEST_CASE("write_failure") {
+    auto journal = FixJournal("/dev/full", true);
+    journal.Append("a");
+    REQUIRE_THROWS_AS(journal.Flush(), std::runtime_error);
+    REQUIRE_THROWS_AS(journal.Append("b"), std::runtime_error);
+  }
+
+  TEST_CASE("reset_failure") {
+    auto directory = std::filesystem::temp_directory_path() /
+      "fix_journal_tester";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    auto path = (directory / "journal").string();
+    {
+      auto journal = FixJournal(path, false);
+      std::filesystem::remove_all(directory);
+      REQUIRE_THROWS_AS(journal.Reset("a"), std::runtime_error);
+      REQUIRE_THROWS_AS(journal.Append("b"), std::runtime_error);
+      REQUIRE_THROWS_AS(journal.Reset("c"), std::runtime_error);
+    }
+    REQUIRE(!std::filesystem::exists(directory));
+  }
+#endif
+}
@@ -84,14 +84,15 @@ namespace {
       REQUIRE(!m_mockDriverMonitor->TryPop());
     }
 
-    void SetBbo(Money bid, Money ask) {
+    void SetBbo(Money bid, Money ask, const Security& security = TST) {
       auto bbo = BboQuote(Quote(bid, 100, Side::BID),
         Quote(ask, 100, Side::ASK), not_a_date_time);
-      m_environment.Publish(TST, bbo);
+      m_environment.Publish(security, bbo);
     }
 
-    auto Submit(Side side, Money price, Quantity quantity) {
-      auto fields = OrderFields::BuildLimitOrder(TRADER_A, TST,
+    auto Submit(Side side, Money price, Quantity quantity,
+        const Security& security = TST) {
+      auto fields = OrderFields::BuildLimitOrder(TRADER_A, security,
         DefaultCurrencies::USD(), side, "NASDAQ", quantity, price);
       auto orderEntry = OrderEntry();
       orderEntry.m_fields = fields;
@@ -119,8 +120,9 @@ namespace {
       ExpectStatus(orderEntry.m_mockExecutionReportQueue, OrderStatus::NEW);
     }
 
-    auto Execute(Side side, Money price, Quantity quantity) {
-      auto orderEntry = Submit(side, price, quantity);
+    auto Execute(Side side, Money price, Quantity quantity,
+        const Security& security = TST) {
+      auto orderEntry = Submit(side, price, quantity, security);
       Accept(orderEntry);
       ExpectStatus(orderEntry.m_executionReportQueue, OrderStatus::NEW);
       return orderEntry;
@@ -257,6 +259,25 @@ TEST_SUITE("InternalMatchingOrderExecutionDriver") {
     ExpectActiveInternalMatch(askOrderEntry, Money::ONE, 100);
   }
 
+  TEST_CASE_FIXTURE(Fixture, "match_best_price_level_first") {
+    SetBbo(Money::ONE, Money::ONE + 5 * Money::CENT);
+    auto bidOrderEntryA = Execute(Side::BID, Money::ONE, 100);
+    auto bidOrderEntryB = Execute(Side::BID, Money::ONE + Money::CENT, 100);
+    auto askOrderEntry = Submit(Side::ASK, Money::ONE, 100);
+    ExpectPassiveInternalMatch(bidOrderEntryB, 100);
+    ExpectStatus(askOrderEntry.m_executionReportQueue, OrderStatus::NEW);
+    ExpectActiveInternalMatch(askOrderEntry, Money::ONE + Money::CENT, 100);
+    Cancel(bidOrderEntryA);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "canceled_bid_without_matching") {
+    SetBbo(Money::ONE, Money::ONE + Money::CENT);
+    auto bidOrderEntry = Execute(Side::BID, Money::ONE, 100);
+    Cancel(bidOrderEntry);
+    auto askOrderEntry = Execute(Side::ASK, Money::ONE, 100);
+    Cancel(askOrderEntry);
+  }
+
   TEST_CASE_FIXTURE(Fixture, "far_bid_and_crossed_ask_without_matching") {
     SetBbo(Money::ONE, Money::ONE + Money::CENT);
     auto bidOrderEntry = Execute(Side::BID, 50 * Money::CENT, 100);
@@ -328,4 +349,47 @@ TEST_SUITE("InternalMatchingOrderExecutionDriver") {
     ExpectActiveInternalMatch(askOrderEntry, Money::ONE, 100);
     Cancel(bidOrderEntry);
   }
+
+  TEST_CASE_FIXTURE(Fixture, "fifo_within_price_level") {
+    SetBbo(Money::ONE, Money::ONE + Money::CENT);
+    auto bidOrderEntryA = Execute(Side::BID, Money::ONE, 200);
+    auto bidOrderEntryB = Execute(Side::BID, Money::ONE, 100);
+    auto askOrderEntryA = Submit(Side::ASK, Money::ONE, 100);
+    ExpectPassiveInternalMatch(bidOrderEntryA, 100);
+    ExpectStatus(askOrderEntryA.m_executionReportQueue, OrderStatus::NEW);
+    ExpectActiveInternalMatch(askOrderEntryA, Money::ONE, 100);
+
+    // The partially matched bid is resubmitted but keeps its place ahead of
+    // the later bid at the same price.
+    auto askOrderEntryB = Submit(Side::ASK, Money::ONE, 100);
+    ExpectPassiveInternalMatch(bidOrderEntryA, 100);
+    ExpectStatus(askOrderEntryB.m_executionReportQueue, OrderStatus::NEW);
+    ExpectActiveInternalMatch(askOrderEntryB, Money::ONE, 100);
+    Cancel(bidOrderEntryB);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "securities_match_independently") {
+    auto securities = std::vector<Security>();
+    for(auto symbol : {"A", "B", "C", "D", "E", "F", "G", "H"}) {
+      securities.emplace_back(symbol, DefaultMarkets::NASDAQ(),
+        DefaultCountries::US());
+    }
+    SetBbo(Money::ONE, Money::ONE + Money::CENT);
+    auto bidOrderEntries = std::vector<OrderEntry>();
+    for(auto& security : securities) {
+      SetBbo(Money::ONE, Money::ONE + Money::CENT, security);
+      bidOrderEntries.push_back(
+        Execute(Side::BID, Money::ONE, 100, security));
+    }
+
+    // An ask priced through a bid on another security must not match it.
+    auto unmatchedAskOrderEntry = Execute(Side::ASK, Money::ONE, 100);
+    for(auto i = std::size_t(0); i != securities.size(); ++i) {
+      auto askOrderEntry = Submit(Side::ASK, Money::ONE, 100, securities[i]);
+      ExpectPassiveInternalMatch(bidOrderEntries[i], 100);
+      ExpectStatus(askOrderEntry.m_executionReportQueue, OrderStatus::NEW);
+      ExpectActiveInternalMatch(askOrderEntry, Money::ONE, 100);
+    }
+    Cancel(unmatchedAskOrderEntry);
+  }
 }
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <vector>
+#include <doctest/doctest.h>
+#include "Nexus/Definitions/DefaultMarketDatabase.hpp"
+#include "Nexus/MarketDataService/ConflationBuffer.hpp"
+
+using namespace Beam;
+using namespace Beam::Queries;
+using namespace boost;
+using namespace boost::posix_time;
+using namespace Nexus;
+using namespace Nexus::MarketDataService;
+
+namespace {
+  const auto TEST_SECURITY = Security("TST", DefaultMarkets::NASDAQ(),
+    DefaultCountries::US());
+
+  struct FlushedValues {
+    std::vector<SequencedSecurityBboQuote> m_bboQuotes;
+    std::vector<SequencedSecurityBookQuote> m_bookQuotes;
+    std::vector<SequencedSecurityTimeAndSale> m_timeAndSales;
+
+    template<typename T>
+    void operator ()(const T& value) {
+      if constexpr(std::is_same_v<T, SequencedSecurityBboQuote>) {
+        m_bboQuotes.push_back(value);
+      } else if constexpr(std::is_same_v<T, SequencedSecurityBookQuote>) {
+        m_bookQuotes.push_back(value);
+      } else if constexpr(std::is_same_v<T, SequencedSecurityTimeAndSale>) {
+        m_timeAndSales.push_back(value);
+      }
+    }
+  };
+
+  const auto OTHER_SECURITY = Security("OTH", DefaultMarkets::NASDAQ(),
+    DefaultCountries::US());
+
+  const auto TIMESTAMP = ptime(gregorian::date(2021, 3, 4), hours(10));
+
+  auto MakeBboQuote(Money bid, Sequence sequence,
+      const Security& security = TEST_SECURITY) {
+    return SequencedValue(IndexedValue(BboQuote(Quote(bid, 100, Side::BID),
+      Quote(bid + Money::CENT, 100, Side::ASK), second_clock::universal_time()),
+      security), sequence);
+  }
+
+  auto MakeBookQuote(std::string mpid, Money price, Quantity size,
+      Sequence sequence) {
+    return SequencedValue(IndexedValue(BookQuote(std::move(mpid), false,
+      DefaultMarkets::NASDAQ(), Quote(price, size, Side::BID),
+      second_clock::universal_time()), TEST_SECURITY), sequence);
+  }
+
+  auto MakeTimeAndSale(Quantity size, Sequence sequence) {
+    return SequencedValue(IndexedValue(TimeAndSale(
+      second_clock::universal_time(), Money::ONE, size,
+      TimeAndSale::Condition(TimeAndSale::Condition::Type::REGULAR, "@"),
+      "NSDQ"), TEST_SECURITY), sequence);
+  }
+}
+
+TEST_SUITE("ConflationBuffer") {
+  TEST_CASE("disabled") {
+    auto buffer = ConflationBuffer();
+    REQUIRE(!buffer.IsEnabled());
+    REQUIRE(!buffer.Push(MakeBboQuote(Money::ONE, Sequence(1)), TIMESTAMP));
+    REQUIRE(!buffer.Push(MakeBboQuote(Money::ONE, Sequence(2)), TIMESTAMP));
+    REQUIRE(!buffer.IsBacklogged());
+    auto values = FlushedValues();
+    buffer.Flush(std::ref(values));
+    REQUIRE(values.m_bboQuotes.empty());
+  }
+
+  TEST_CASE("send_until_backlogged") {
+    auto buffer = ConflationBuffer();
+    buffer.SetPolicy(ConflationPolicy(seconds(1), 10));
+    REQUIRE(buffer.IsEnabled());
+    REQUIRE(!buffer.Push(MakeBboQuote(Money::ONE, Sequence(1)), TIMESTAMP));
+    REQUIRE(!buffer.IsBacklogged());
+    REQUIRE(!buffer.Push(MakeBboQuote(2 * Money::ONE, Sequence(2)),
+      TIMESTAMP + seconds(1)));
+    REQUIRE(!buffer.IsBacklogged());
+    REQUIRE(buffer.Push(MakeBboQuote(3 * Money::ONE, Sequence(3)),
+      TIMESTAMP + seconds(1) + milliseconds(100)));
+    REQUIRE(buffer.IsBacklogged());
+  }
+
+  TEST_CASE("latest_bbo_quote") {
+    auto buffer = ConflationBuffer();
+    buffer.SetPolicy(ConflationPolicy(seconds(1), 10));
+    REQUIRE(!buffer.Push(MakeBboQuote(Money::ONE, Sequence(1)), TIMESTAMP));
+    REQUIRE(buffer.Push(MakeBboQuote(2 * Money::ONE, Sequence(2)),
+      TIMESTAMP));
+    REQUIRE(buffer.Push(MakeBboQuote(3 * Money::ONE, Sequence(3)),
+      TIMESTAMP));
+    auto values = FlushedValues();
+    buffer.Flush(std::ref(values));
+    REQUIRE(values.m_bboQuotes.size() == 1);
+    REQUIRE(values.m_bboQuotes.front().GetSequence() == Sequence(3));
+    REQUIRE(values.m_bboQuotes.front()->GetValue().m_bid.m_price ==
+      3 * Money::ONE);
+    REQUIRE(!buffer.IsBacklogged());
+  }
+
+  TEST_CASE("latest_book_level") {
+    auto buffer = ConflationBuffer();
+    buffer.SetPolicy(ConflationPolicy(seconds(1), 10));
+    REQUIRE(!buffer.Push(MakeBookQuote("A", Money::ONE, 100, Sequence(1)),
+      TIMESTAMP));
+    buffer.Push(MakeBookQuote("B", Money::ONE, 200, Sequence(2)), TIMESTAMP);
+    buffer.Push(MakeBookQuote("A", Money::ONE, 0, Sequence(3)), TIMESTAMP);
+    buffer.Push(MakeBookQuote("A", 2 * Money::ONE, 300, Sequence(4)),
+      TIMESTAMP);
+    buffer.Push(MakeBookQuote("B", Money::ONE, 100, Sequence(5)), TIMESTAMP);
+    auto values = FlushedValues();
+    buffer.Flush(std::ref(values));
+    REQUIRE(values.m_bookQuotes.size() == 3);
+    auto sequences = std::vector<Sequence>();
+    for(auto& bookQuote : values.m_bookQuotes) {
+      sequences.push_back(bookQuote.GetSequence());
+    }
+    std::sort(sequences.begin(), sequences.end());
+    REQUIRE(sequences == std::vector{Sequence(3), Sequence(4), Sequence(5)});
+  }
+
+  TEST_CASE("time_and_sale_limit") {
+    auto buffer = ConflationBuffer();
+    buffer.SetPolicy(ConflationPolicy(seconds(1), 2));
+    REQUIRE(!buffer.Push(MakeTimeAndSale(100, Sequence(1)), TIMESTAMP));
+    buffer.Push(MakeTimeAndSale(200, Sequence(2)), TIMESTAMP);
+    buffer.Push(MakeTimeAndSale(300, Sequence(3)), TIMESTAMP);
+    buffer.Push(MakeTimeAndSale(400, Sequence(4)), TIMESTAMP);
+    REQUIRE(buffer.GetDiscardCount() == 1);
+    auto values = FlushedValues();
+    buffer.Flush(std::ref(values));
+    REQUIRE(values.m_timeAndSales.size() == 2);
+    REQUIRE(values.m_timeAndSales[0].GetSequence() == Sequence(3));
+    REQUIRE(values.m_timeAndSales[1].GetSequence() == Sequence(4));
+  }
+
+  TEST_CASE("update_interval") {
+    auto buffer = ConflationBuffer();
+    buffer.SetPolicy(ConflationPolicy(seconds(1), 10));
+    auto values = FlushedValues();
+    REQUIRE(!buffer.Push(MakeBboQuote(Money::ONE, Sequence(1)), TIMESTAMP));
+    REQUIRE(buffer.Push(MakeBboQuote(2 * Money::ONE, Sequence(2)),
+      TIMESTAMP + milliseconds(100)));
+    REQUIRE(buffer.Flush(TIMESTAMP + milliseconds(500), std::ref(values)));
+    REQUIRE(values.m_bboQuotes.empty());
+    REQUIRE(!buffer.Flush(TIMESTAMP + seconds(1), std::ref(values)));
+    REQUIRE(values.m_bboQuotes.size() == 1);
+    REQUIRE(values.m_bboQuotes.back().GetSequence() == Sequence(2));
+    REQUIRE(!buffer.IsBacklogged());
+    REQUIRE(buffer.Push(MakeBboQuote(3 * Money::ONE, Sequence(3)),
+      TIMESTAMP + seconds(1) + milliseconds(100)));
+    REQUIRE(!buffer.Push(MakeBboQuote(4 * Money::ONE, Sequence(4),
+      OTHER_SECURITY), TIMESTAMP + seconds(1) + milliseconds(100)));
+  }
+
+  TEST_CASE("security_policy") {
+    auto buffer = ConflationBuffer();
+    buffer.SetPolicy(TEST_SECURITY, ConflationPolicy(seconds(1), 10));
+    REQUIRE(buffer.IsEnabled());
+    REQUIRE(buffer.GetPolicy(TEST_SECURITY).IsEnabled());
+    REQUIRE(!buffer.GetPolicy(OTHER_SECURITY).IsEnabled());
+    REQUIRE(!buffer.Push(MakeBboQuote(Money::ONE, Sequence(1)), TIMESTAMP));
+    REQUIRE(buffer.Push(MakeBboQuote(2 * Money::ONE, Sequence(2)),
+      TIMESTAMP));
+    REQUIRE(!buffer.Push(MakeBboQuote(Money::ONE, Sequence(3),
+      OTHER_SECURITY), TIMESTAMP));
+    REQUIRE(!buffer.Push(MakeBboQuote(2 * Money::ONE, Sequence(4),
+      OTHER_SECURITY), TIMESTAMP));
+    buffer.SetPolicy(TEST_SECURITY, ConflationPolicy());
+    REQUIRE(!buffer.IsEnabled());
+    auto values = FlushedValues();
+    buffer.Flush(std::ref(values));
+    REQUIRE(values.m_bboQuotes.size() == 1);
+    REQUIRE(values.m_bboQuotes.front().GetSequence() == Sequence(2));
+  }
+
+  TEST_CASE("schedule") {
+    auto buffer = ConflationBuffer();
+    buffer.SetPolicy(ConflationPolicy(seconds(1), 10));
+    REQUIRE(buffer.Schedule());
+    REQUIRE(!buffer.Schedule());
+    buffer.Push(MakeBboQuote(Money::ONE, Sequence(1)), TIMESTAMP);
+    buffer.Push(MakeBboQuote(2 * Money::ONE, Sequence(2)), TIMESTAMP);
+    auto batch = ConflationBuffer::Batch();
+    REQUIRE(buffer.Take(TIMESTAMP, Store(batch)));
+    REQUIRE(batch.IsEmpty());
+    REQUIRE(!buffer.Schedule());
+    REQUIRE(!buffer.Take(TIMESTAMP + seconds(1), Store(batch)));
+    REQUIRE(batch.m_bboQuotes.size() == 1);
+    REQUIRE(buffer.Schedule());
+  }
+}
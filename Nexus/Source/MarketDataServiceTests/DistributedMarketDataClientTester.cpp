@@ -0,0 +1,116 @@
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <Beam/ServiceLocatorTests/ServiceLocatorTestEnvironment.hpp>
+#include <boost/optional/optional.hpp>
+#include <doctest/doctest.h>
+#include "Nexus/AdministrationServiceTests/AdministrationServiceTestEnvironment.hpp"
+#include "Nexus/Definitions/DefaultCountryDatabase.hpp"
+#include "Nexus/Definitions/DefaultMarketDatabase.hpp"
+#include "Nexus/MarketDataService/DistributedMarketDataClient.hpp"
+#include "Nexus/MarketDataServiceTests/MarketDataServiceTestEnvironment.hpp"
+
+using namespace Beam;
+using namespace Beam::ServiceLocator;
+using namespace Beam::ServiceLocator::Tests;
+using namespace boost;
+using namespace boost::posix_time;
+using namespace Nexus;
+using namespace Nexus::AdministrationService::Tests;
+using namespace Nexus::MarketDataService;
+using namespace Nexus::MarketDataService::Tests;
+
+namespace {
+  struct Fixture {
+    ServiceLocatorTestEnvironment m_serviceLocatorEnvironment;
+    std::shared_ptr<VirtualServiceLocatorClient> m_serviceLocatorClient;
+    AdministrationServiceTestEnvironment m_administrationEnvironment;
+    MarketDataServiceTestEnvironment m_caEnvironment;
+    MarketDataServiceTestEnvironment m_usEnvironment;
+    optional<DistributedMarketDataClient> m_client;
+
+    Fixture()
+        : m_serviceLocatorClient(m_serviceLocatorEnvironment.BuildClient()),
+          m_administrationEnvironment(m_serviceLocatorClient),
+          m_caEnvironment(m_serviceLocatorClient,
+            m_administrationEnvironment.BuildClient(
+            Ref(*m_serviceLocatorClient))),
+          m_usEnvironment(m_serviceLocatorClient,
+            m_administrationEnvironment.BuildClient(
+            Ref(*m_serviceLocatorClient))) {
+      auto caClient = std::shared_ptr<VirtualMarketDataClient>(
+        m_caEnvironment.BuildClient(Ref(*m_serviceLocatorClient)));
+      auto usClient = std::shared_ptr<VirtualMarketDataClient>(
+        m_usEnvironment.BuildClient(Ref(*m_serviceLocatorClient)));
+      m_client.emplace(
+        std::unordered_map<CountryCode,
+          std::shared_ptr<VirtualMarketDataClient>>{
+          {DefaultCountries::CA(), caClient},
+          {DefaultCountries::US(), usClient}},
+        std::unordered_map<MarketCode,
+          std::shared_ptr<VirtualMarketDataClient>>{
+          {DefaultMarkets::TSX(), caClient},
+          {DefaultMarkets::NYSE(), usClient}});
+    }
+
+    SecurityInfo Add(MarketDataServiceTestEnvironment& environment,
+        const Security& security, std::string name, Quantity volume) {
+      auto securityInfo = SecurityInfo(security, std::move(name), "", 100);
+      environment.Add(securityInfo);
+      if(volume != 0) {
+        environment.Publish(security, TimeAndSale(
+          second_clock::universal_time(), Money::ONE, volume,
+          TimeAndSale::Condition(TimeAndSale::Condition::Type::REGULAR, "@"),
+          "N"));
+      }
+      return securityInfo;
+    }
+
+    SecurityInfo AddCa(std::string symbol, std::string name,
+        Quantity volume) {
+      return Add(m_caEnvironment, Security(std::move(symbol),
+        DefaultMarkets::TSX(), DefaultCountries::CA()), std::move(name),
+        volume);
+    }
+
+    SecurityInfo AddUs(std::string symbol, std::string name,
+        Quantity volume) {
+      return Add(m_usEnvironment, Security(std::move(symbol),
+        DefaultMarkets::NYSE(), DefaultCountries::US()), std::move(name),
+        volume);
+    }
+  };
+}
+
+TEST_SUITE("DistributedMarketDataClient") {
+  TEST_CASE_FIXTURE(Fixture, "prefix_merged_by_rank") {
+    auto caLow = AddCa("ABA", "Aba Mining", 0);
+    auto caName = AddCa("XYZ", "Abacus Corp", 5000);
+    auto usHigh = AddUs("ABB", "Abb Holdings", 1000);
+    auto usLow = AddUs("ABC", "Abc Energy", 10);
+    auto result = m_client->LoadSecurityInfoFromPrefix("AB", Security(), 10);
+    REQUIRE((result == std::vector{usHigh, usLow, caLow, caName}));
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "prefix_pagination") {
+    auto caLow = AddCa("ABA", "Aba Mining", 0);
+    auto caName = AddCa("XYZ", "Abacus Corp", 5000);
+    auto usHigh = AddUs("ABB", "Abb Holdings", 1000);
+    auto usLow = AddUs("ABC", "Abc Energy", 10);
+    auto page = m_client->LoadSecurityInfoFromPrefix("AB", Security(), 1);
+    REQUIRE((page == std::vector{usHigh}));
+    page = m_client->LoadSecurityInfoFromPrefix("AB", page.back().m_security,
+      2);
+    REQUIRE((page == std::vector{usLow, caLow}));
+    page = m_client->LoadSecurityInfoFromPrefix("AB", page.back().m_security,
+      2);
+    REQUIRE((page == std::vector{caName}));
+    page = m_client->LoadSecurityInfoFromPrefix("AB", page.back().m_security,
+      2);
+    REQUIRE(page.empty());
+    auto unknown = Security("ABZ", DefaultMarkets::NYSE(),
+      DefaultCountries::US());
+    REQUIRE(m_client->LoadSecurityInfoFromPrefix("AB", unknown, 2).empty());
+  }
+}
@@ -0,0 +1,110 @@
+#include <vector>
+#include <doctest/doctest.h>
+#include "Nexus/Definitions/DefaultMarketDatabase.hpp"
+#include "Nexus/MarketDataService/EntitlementGroups.hpp"
+
+using namespace Beam;
+using namespace Beam::ServiceLocator;
+using namespace Nexus;
+using namespace Nexus::AdministrationService;
+using namespace Nexus::MarketDataService;
+
+namespace {
+  const auto TSX_GROUP = DirectoryEntry::MakeDirectory(10, "TSX");
+  const auto NYSE_GROUP = DirectoryEntry::MakeDirectory(11, "NYSE");
+
+  auto MakeEntitlementDatabase() {
+    auto database = EntitlementDatabase();
+    auto tsxEntitlement = EntitlementDatabase::Entry();
+    tsxEntitlement.m_name = "TSX";
+    tsxEntitlement.m_groupEntry = TSX_GROUP;
+    tsxEntitlement.m_applicability[EntitlementKey(DefaultMarkets::TSX())].Set(
+      MarketDataType::BOOK_QUOTE);
+    database.Add(tsxEntitlement);
+    auto nyseEntitlement = EntitlementDatabase::Entry();
+    nyseEntitlement.m_name = "NYSE";
+    nyseEntitlement.m_groupEntry = NYSE_GROUP;
+    nyseEntitlement.m_applicability[
+      EntitlementKey(DefaultMarkets::NYSE())].Set(MarketDataType::BOOK_QUOTE);
+    database.Add(nyseEntitlement);
+    return database;
+  }
+}
+
+TEST_SUITE("EntitlementGroups") {
+  TEST_CASE("identical_entitlements_share_group") {
+    auto groups = EntitlementGroups(MakeEntitlementDatabase());
+    auto a = MarketDataRegistrySession();
+    auto b = MarketDataRegistrySession();
+    auto c = MarketDataRegistrySession();
+    groups.Grant(a, {TSX_GROUP});
+    groups.Grant(b, {TSX_GROUP});
+    groups.Grant(c, {TSX_GROUP, NYSE_GROUP});
+    REQUIRE(a.m_entitlementGroup >= 0);
+    REQUIRE(a.m_entitlementGroup == b.m_entitlementGroup);
+    REQUIRE(a.m_entitlementGroup != c.m_entitlementGroup);
+    REQUIRE(a.m_entitlements.HasEntitlement(
+      EntitlementKey(DefaultMarkets::TSX()), MarketDataType::BOOK_QUOTE));
+    REQUIRE(!a.m_entitlements.HasEntitlement(
+      EntitlementKey(DefaultMarkets::NYSE()), MarketDataType::BOOK_QUOTE));
+    REQUIRE(c.m_entitlements.HasEntitlement(
+      EntitlementKey(DefaultMarkets::NYSE()), MarketDataType::BOOK_QUOTE));
+  }
+
+  TEST_CASE("unknown_entries_ignored") {
+    auto groups = EntitlementGroups(MakeEntitlementDatabase());
+    auto a = MarketDataRegistrySession();
+    auto b = MarketDataRegistrySession();
+    groups.Grant(a, {TSX_GROUP});
+    groups.Grant(b, {TSX_GROUP, DirectoryEntry::MakeDirectory(12, "ASX")});
+    REQUIRE(a.m_entitlementGroup == b.m_entitlementGroup);
+  }
+
+  TEST_CASE("bypass_roles_separate_group") {
+    auto groups = EntitlementGroups(MakeEntitlementDatabase());
+    auto trader = MarketDataRegistrySession();
+    auto administrator = MarketDataRegistrySession();
+    administrator.m_roles.Set(AccountRole::ADMINISTRATOR);
+    auto service = MarketDataRegistrySession();
+    service.m_roles.Set(AccountRole::SERVICE);
+    groups.Grant(trader, {});
+    groups.Grant(administrator, {});
+    groups.Grant(service, {});
+    REQUIRE(trader.m_entitlementGroup != administrator.m_entitlementGroup);
+    REQUIRE(administrator.m_entitlementGroup == service.m_entitlementGroup);
+  }
+
+  TEST_CASE("cache_checks_once_per_group") {
+    auto groups = EntitlementGroups(MakeEntitlementDatabase());
+    auto entitled = MarketDataRegistrySession();
+    auto unentitled = MarketDataRegistrySession();
+    groups.Grant(entitled, {TSX_GROUP});
+    groups.Grant(unentitled, {NYSE_GROUP});
+    auto cache = EntitlementGroupCache(EntitlementKey(DefaultMarkets::TSX()),
+      MarketDataType::BOOK_QUOTE);
+    REQUIRE(cache.HasEntitlement(entitled));
+    REQUIRE(!cache.HasEntitlement(unentitled));
+
+    // A session in the entitled group reuses the cached result rather than
+    // consulting its own entitlements.
+    auto member = MarketDataRegistrySession();
+    member.m_entitlementGroup = entitled.m_entitlementGroup;
+    REQUIRE(cache.HasEntitlement(member));
+    auto other = MarketDataRegistrySession();
+    other.m_entitlementGroup = unentitled.m_entitlementGroup;
+    other.m_entitlements.GrantEntitlement(
+      EntitlementKey(DefaultMarkets::TSX()), MarketDataType::BOOK_QUOTE);
+    REQUIRE(!cache.HasEntitlement(other));
+  }
+
+  TEST_CASE("cache_checks_ungrouped_sessions") {
+    auto cache = EntitlementGroupCache(EntitlementKey(DefaultMarkets::TSX()),
+      MarketDataType::BOOK_QUOTE);
+    auto unentitled = MarketDataRegistrySession();
+    REQUIRE(!cache.HasEntitlement(unentitled));
+    auto entitled = MarketDataRegistrySession();
+    entitled.m_entitlements.GrantEntitlement(
+      EntitlementKey(DefaultMarkets::TSX()), MarketDataType::BOOK_QUOTE);
+    REQUIRE(cache.HasEntitlement(entitled));
+  }
+}
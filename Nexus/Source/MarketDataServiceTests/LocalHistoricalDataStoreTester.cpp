@@ -83,4 +83,44 @@ TEST_SUITE("LocalHistoricalDataStore") {
       SnapshotLimit(SnapshotLimit::Type::TAIL, 4),
       {bboQuoteA, bboQuoteB, bboQuoteC});
   }
+
+  TEST_CASE("load_all_initial_sequences_and_last_prices") {
+    auto dataStore = LocalHistoricalDataStore();
+    auto timeClient = IncrementalTimeClient();
+    StoreBboQuote(dataStore, Money::ONE, 100, Money::ONE + Money::CENT, 100,
+      timeClient.GetTime(), Beam::Queries::Sequence(7));
+    StoreBboQuote(dataStore, Money::ONE, 100, Money::ONE + Money::CENT, 100,
+      timeClient.GetTime(), Beam::Queries::Sequence(9));
+    auto storeTimeAndSale = [&] (Money price, std::string marketCenter,
+        Beam::Queries::Sequence sequence) {
+      dataStore.Store(SequencedSecurityTimeAndSale(SecurityTimeAndSale(
+        TimeAndSale(timeClient.GetTime(), price, 100,
+        TimeAndSale::Condition(), std::move(marketCenter)), TEST_SECURITY),
+        sequence));
+    };
+    storeTimeAndSale(Money::ONE, "NSDQ", Beam::Queries::Sequence(3));
+    storeTimeAndSale(2 * Money::ONE, "ARCX", Beam::Queries::Sequence(4));
+    storeTimeAndSale(3 * Money::ONE, "NSDQ", Beam::Queries::Sequence(5));
+    auto security = Security(TEST_SECURITY.GetSymbol(),
+      TEST_SECURITY.GetCountry());
+    auto initialSequences = dataStore.LoadAllInitialSequences();
+    REQUIRE(initialSequences.size() == 1);
+    auto& sequences = initialSequences.at(security);
+    auto expectedSequences = LoadInitialSequences(dataStore, TEST_SECURITY);
+    REQUIRE(sequences.m_nextBboQuoteSequence ==
+      expectedSequences.m_nextBboQuoteSequence);
+    REQUIRE(sequences.m_nextBboQuoteSequence == Beam::Queries::Sequence(10));
+    REQUIRE(sequences.m_nextBookQuoteSequence ==
+      Beam::Queries::Sequence::First());
+    REQUIRE(sequences.m_nextMarketQuoteSequence ==
+      Beam::Queries::Sequence::First());
+    REQUIRE(sequences.m_nextTimeAndSaleSequence ==
+      expectedSequences.m_nextTimeAndSaleSequence);
+    auto lastPrices = dataStore.LoadAllLastPrices();
+    REQUIRE(lastPrices.size() == 1);
+    auto& prices = lastPrices.at(security);
+    REQUIRE(prices.size() == 2);
+    REQUIRE(prices.at("NSDQ") == 3 * Money::ONE);
+    REQUIRE(prices.at("ARCX") == 2 * Money::ONE);
+  }
 }
@@ -1,6 +1,8 @@
+#include <Beam/Queues/Queue.hpp>
 #include <Beam/ServiceLocator/SessionAuthenticator.hpp>
 #include <Beam/ServiceLocatorTests/ServiceLocatorTestEnvironment.hpp>
 #include <Beam/ServicesTests/ServicesTests.hpp>
+#include <Beam/Threading/TriggerTimer.hpp>
 #include <boost/optional/optional.hpp>
 #include <doctest/doctest.h>
 #include "Nexus/AdministrationService/VirtualAdministrationClient.hpp"
@@ -28,16 +30,23 @@ namespace {
     return Security("ABX", DefaultMarkets::TSX(), DefaultCountries::CA());
   }
 
+  auto GetNyseTestSecurity() {
+    return Security("IBM", DefaultMarkets::NYSE(), DefaultCountries::US());
+  }
+
   struct Fixture {
     using TestServletContainer =
       TestAuthenticatedServiceProtocolServletContainer<
       MetaMarketDataRegistryServlet<MarketDataRegistry*,
-      LocalHistoricalDataStore, std::unique_ptr<VirtualAdministrationClient>>,
+      LocalHistoricalDataStore, std::unique_ptr<VirtualAdministrationClient>,
+      std::unique_ptr<TriggerTimer>>,
       NativePointerPolicy>;
 
     ServiceLocatorTestEnvironment m_serviceLocatorEnvironment;
     AdministrationServiceTestEnvironment m_administrationEnvironment;
     MarketDataRegistry m_registry;
+    TriggerTimer* m_flushTimer;
+    TriggerTimer* m_maintenanceTimer;
     boost::optional<TestServletContainer::Servlet::Servlet> m_registryServlet;
     boost::optional<TestServletContainer> m_container;
     boost::optional<TestServiceProtocolClient> m_clientProtocol;
@@ -47,8 +56,13 @@ namespace {
             m_serviceLocatorEnvironment.BuildClient(), BuildEntitlements()) {
       auto servletServiceLocatorClient =
         m_serviceLocatorEnvironment.BuildClient();
+      auto flushTimer = std::make_unique<TriggerTimer>();
+      m_flushTimer = flushTimer.get();
+      auto maintenanceTimer = std::make_unique<TriggerTimer>();
+      m_maintenanceTimer = maintenanceTimer.get();
       m_registryServlet.emplace(m_administrationEnvironment.BuildClient(
-        Ref(*servletServiceLocatorClient)), &m_registry, Initialize());
+        Ref(*servletServiceLocatorClient)), &m_registry, Initialize(),
+        std::move(flushTimer), std::move(maintenanceTimer));
       auto serverConnection = std::make_shared<TestServerConnection>();
       m_container.emplace(Initialize(std::move(servletServiceLocatorClient),
         &*m_registryServlet), serverConnection,
@@ -128,4 +142,102 @@ TEST_SUITE("MarketDataRegistryServlet") {
       GetTsxTestSecurity());
     m_registryServlet->UpdateBookQuote(bookQuote, 1);
   }
+
+  TEST_CASE_FIXTURE(Fixture, "load_security_snapshots") {
+    auto bboQuote = BboQuote(Quote(Money::ONE, 100, Side::BID),
+      Quote(Money::ONE + Money::CENT, 100, Side::ASK),
+      second_clock::universal_time());
+    m_registryServlet->PublishBboQuote(
+      SecurityBboQuote(bboQuote, GetTsxTestSecurity()), 1);
+    m_registryServlet->PublishBboQuote(
+      SecurityBboQuote(bboQuote, GetNyseTestSecurity()), 1);
+    auto missingSecurity = Security("XYZ", DefaultMarkets::NYSE(),
+      DefaultCountries::US());
+    auto snapshots =
+      m_clientProtocol->SendRequest<LoadSecuritySnapshotsService>(
+      std::vector{GetNyseTestSecurity(), GetTsxTestSecurity(),
+      missingSecurity});
+    REQUIRE(snapshots.size() == 3);
+    REQUIRE(snapshots[0].m_security == GetNyseTestSecurity());
+    REQUIRE(snapshots[0].m_bboQuote->m_bid.m_price == Money::ONE);
+    REQUIRE(snapshots[1].m_security == GetTsxTestSecurity());
+    REQUIRE(snapshots[1].m_bboQuote == SequencedBboQuote());
+    REQUIRE(snapshots[2].m_security == Security());
+    auto technicals =
+      m_clientProtocol->SendRequest<LoadSecurityTechnicalsListService>(
+      std::vector{GetNyseTestSecurity(), missingSecurity});
+    REQUIRE(technicals.size() == 2);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "conflation") {
+    auto bboQuotes = std::make_shared<Queue<SequencedSecurityBboQuote>>();
+    AddMessageSlot<BboQuoteMessage>(Store(m_clientProtocol->GetSlots()),
+      [=] (auto& client, const SequencedSecurityBboQuote& bboQuote) {
+        bboQuotes->Push(bboQuote);
+      });
+    m_clientProtocol->SendRequest<SetConflationPolicyService>(
+      ConflationPolicy(minutes(1), 10));
+    auto query = SecurityMarketDataQuery();
+    query.SetIndex(GetNyseTestSecurity());
+    query.SetRange(Range::RealTime());
+    m_clientProtocol->SendRequest<QueryBboQuotesService>(query);
+    for(auto bid : {Money::ONE, 2 * Money::ONE, 3 * Money::ONE}) {
+      m_registryServlet->PublishBboQuote(SecurityBboQuote(BboQuote(
+        Quote(bid, 100, Side::BID), Quote(bid + Money::CENT, 100, Side::ASK),
+        second_clock::universal_time()), GetNyseTestSecurity()), 1);
+    }
+    auto bboQuote = bboQuotes->Pop();
+    REQUIRE(bboQuote.GetValue().GetIndex() == GetNyseTestSecurity());
+    REQUIRE(bboQuote->GetValue().m_bid.m_price == Money::ONE);
+    m_clientProtocol->SendRequest<SetConflationPolicyService>(
+      ConflationPolicy());
+    bboQuote = bboQuotes->Pop();
+    REQUIRE(bboQuote->GetValue().m_bid.m_price == 3 * Money::ONE);
+    m_registryServlet->PublishBboQuote(SecurityBboQuote(BboQuote(
+      Quote(4 * Money::ONE, 100, Side::BID),
+      Quote(4 * Money::ONE + Money::CENT, 100, Side::ASK),
+      second_clock::universal_time()), GetNyseTestSecurity()), 1);
+    bboQuote = bboQuotes->Pop();
+    REQUIRE(bboQuote->GetValue().m_bid.m_price == 4 * Money::ONE);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "security_conflation") {
+    auto bboQuotes = std::make_shared<Queue<SequencedSecurityBboQuote>>();
+    AddMessageSlot<BboQuoteMessage>(Store(m_clientProtocol->GetSlots()),
+      [=] (auto& client, const SequencedSecurityBboQuote& bboQuote) {
+        bboQuotes->Push(bboQuote);
+      });
+    auto otherSecurity = Security("GE", DefaultMarkets::NYSE(),
+      DefaultCountries::US());
+    m_clientProtocol->SendRequest<SetSecurityConflationPolicyService>(
+      GetNyseTestSecurity(), ConflationPolicy(minutes(1), 10));
+    for(auto& security : {GetNyseTestSecurity(), otherSecurity}) {
+      auto query = SecurityMarketDataQuery();
+      query.SetIndex(security);
+      query.SetRange(Range::RealTime());
+      m_clientProtocol->SendRequest<QueryBboQuotesService>(query);
+    }
+    for(auto bid : {Money::ONE, 2 * Money::ONE}) {
+      for(auto& security : {GetNyseTestSecurity(), otherSecurity}) {
+        m_registryServlet->PublishBboQuote(SecurityBboQuote(BboQuote(
+          Quote(bid, 100, Side::BID),
+          Quote(bid + Money::CENT, 100, Side::ASK),
+          second_clock::universal_time()), security), 1);
+      }
+    }
+    auto bboQuote = bboQuotes->Pop();
+    REQUIRE(bboQuote.GetValue().GetIndex() == GetNyseTestSecurity());
+    REQUIRE(bboQuote->GetValue().m_bid.m_price == Money::ONE);
+    bboQuote = bboQuotes->Pop();
+    REQUIRE(bboQuote.GetValue().GetIndex() == otherSecurity);
+    REQUIRE(bboQuote->GetValue().m_bid.m_price == Money::ONE);
+    bboQuote = bboQuotes->Pop();
+    REQUIRE(bboQuote.GetValue().GetIndex() == otherSecurity);
+    REQUIRE(bboQuote->GetValue().m_bid.m_price == 2 * Money::ONE);
+    m_clientProtocol->SendRequest<SetSecurityConflationPolicyService>(
+      GetNyseTestSecurity(), ConflationPolicy());
+    bboQuote = bboQuotes->Pop();
+    REQUIRE(bboQuote.GetValue().GetIndex() == GetNyseTestSecurity());
+    REQUIRE(bboQuote->GetValue().m_bid.m_price == 2 * Money::ONE);
+  }
 }
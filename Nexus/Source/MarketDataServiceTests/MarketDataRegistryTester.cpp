@@ -1,11 +1,201 @@
+#include <filesystem>
+#include <fstream>
+#include <Beam/TimeService/IncrementalTimeClient.hpp>
 #include <doctest/doctest.h>
+#include "Nexus/Definitions/DefaultCountryDatabase.hpp"
+#include "Nexus/Definitions/DefaultMarketDatabase.hpp"
+#include "Nexus/MarketDataService/LocalHistoricalDataStore.hpp"
 #include "Nexus/MarketDataService/MarketDataRegistry.hpp"
 
+using namespace Beam;
+using namespace Beam::IO;
+using namespace Beam::Serialization;
+using namespace Beam::TimeService;
+using namespace boost;
+using namespace boost::posix_time;
 using namespace Nexus;
 using namespace Nexus::MarketDataService;
 
+namespace {
+  const auto TEST_SECURITY = Security("TST", DefaultMarkets::NASDAQ(),
+    DefaultCountries::US());
+  const auto TEST_SOURCE = 321;
+
+  struct Fixture {
+    std::filesystem::path m_directory;
+    IncrementalTimeClient m_timeClient;
+    LocalHistoricalDataStore m_dataStore;
+
+    Fixture()
+        : m_directory(std::filesystem::temp_directory_path() /
+            "market_data_registry_tester") {
+      std::filesystem::remove_all(m_directory);
+    }
+
+    ~Fixture() {
+      std::filesystem::remove_all(m_directory);
+    }
+
+    auto MakeCheckpoint(const ptime& timestamp, Quantity volume) {
+      auto checkpoint = MarketDataRegistryCheckpoint();
+      checkpoint.m_timestamp = timestamp;
+      auto securityCheckpoint = SecurityEntry::Checkpoint();
+      securityCheckpoint.m_security = TEST_SECURITY;
+      securityCheckpoint.m_technicals.m_volume = volume;
+      checkpoint.m_securityEntries.push_back(securityCheckpoint);
+      return checkpoint;
+    }
+
+    void WriteCheckpoint(const MarketDataRegistryCheckpoint& checkpoint,
+        int version) {
+      auto buffer = SharedBuffer();
+      auto sender = BinarySender<SharedBuffer>();
+      sender.SetSink(Ref(buffer));
+      sender.Shuttle(version);
+      sender.Shuttle(checkpoint);
+      std::filesystem::create_directories(m_directory);
+      auto file = std::ofstream(m_directory / ("checkpoint-" +
+        to_iso_string(checkpoint.m_timestamp) + ".dat"), std::ios::binary);
+      file.write(buffer.GetData(), buffer.GetSize());
+    }
+
+    auto Publish(MarketDataRegistry& registry, Money bid, Money ask,
+        bool isStored) {
+      auto bboQuote = SecurityBboQuote(BboQuote(Quote(bid, 100, Side::BID),
+        Quote(ask, 100, Side::ASK), m_timeClient.GetTime()), TEST_SECURITY);
+      auto result = optional<SequencedSecurityBboQuote>();
+      registry.PublishBboQuote(bboQuote, TEST_SOURCE, m_dataStore,
+        [&] (const auto& value) {
+          result = value;
+          if(isStored) {
+            m_dataStore.Store(value);
+          }
+        });
+      REQUIRE(result.is_initialized());
+      return *result;
+    }
+
+    auto Publish(MarketDataRegistry& registry, Money price, Quantity size,
+        Side side, bool isStored) {
+      auto bookQuote = SecurityBookQuote(BookQuote("ABC", false,
+        DefaultMarkets::NASDAQ(), Quote(price, size, side),
+        m_timeClient.GetTime()), TEST_SECURITY);
+      registry.UpdateBookQuote(bookQuote, TEST_SOURCE, m_dataStore,
+        [&] (const auto& value) {
+          if(isStored) {
+            m_dataStore.Store(value);
+          }
+        });
+    }
+
+    auto Publish(MarketDataRegistry& registry, Money price, Quantity size) {
+      auto timeAndSale = SecurityTimeAndSale(TimeAndSale(
+        m_timeClient.GetTime(), price, size, TimeAndSale::Condition(),
+        "NSDQ"), TEST_SECURITY);
+      registry.PublishTimeAndSale(timeAndSale, TEST_SOURCE, m_dataStore,
+        [&] (const auto& value) {
+          m_dataStore.Store(value);
+        });
+    }
+  };
+}
+
 TEST_SUITE("MarketDataRegistry") {
   TEST_CASE("publish_bbo_quote") {
     auto registry = MarketDataRegistry();
   }
+
+  TEST_CASE_FIXTURE(Fixture, "checkpoint_round_trip") {
+    auto timestamp = m_timeClient.GetTime();
+    SaveCheckpoint(MakeCheckpoint(timestamp, 500), m_directory);
+    auto checkpoint = LoadLatestCheckpoint(m_directory, timestamp);
+    REQUIRE(checkpoint.is_initialized());
+    REQUIRE(checkpoint->m_timestamp == timestamp);
+    REQUIRE(checkpoint->m_securityEntries.size() == 1);
+    REQUIRE(checkpoint->m_securityEntries[0].m_security == TEST_SECURITY);
+    REQUIRE(checkpoint->m_securityEntries[0].m_technicals.m_volume == 500);
+    REQUIRE(!LoadLatestCheckpoint(m_directory,
+      timestamp + seconds(1)).is_initialized());
+    REQUIRE(!LoadLatestCheckpoint(m_directory / "missing",
+      timestamp).is_initialized());
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "checkpoint_version_mismatch") {
+    auto sessionStart = m_timeClient.GetTime();
+    SaveCheckpoint(MakeCheckpoint(m_timeClient.GetTime(), 100), m_directory);
+    WriteCheckpoint(MakeCheckpoint(m_timeClient.GetTime(), 200),
+      MARKET_DATA_REGISTRY_CHECKPOINT_VERSION + 1);
+    auto checkpoint = LoadLatestCheckpoint(m_directory, sessionStart);
+    REQUIRE(checkpoint.is_initialized());
+    REQUIRE(checkpoint->m_securityEntries[0].m_technicals.m_volume == 100);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "skip_unreadable_checkpoint") {
+    auto sessionStart = m_timeClient.GetTime();
+    SaveCheckpoint(MakeCheckpoint(m_timeClient.GetTime(), 100), m_directory);
+    {
+      auto file = std::ofstream(m_directory / ("checkpoint-" +
+        to_iso_string(m_timeClient.GetTime()) + ".dat"), std::ios::binary);
+      file << "corrupt";
+    }
+    auto checkpoint = LoadLatestCheckpoint(m_directory, sessionStart);
+    REQUIRE(checkpoint.is_initialized());
+    REQUIRE(checkpoint->m_securityEntries[0].m_technicals.m_volume == 100);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "checkpoint_retention") {
+    auto sessionStart = m_timeClient.GetTime();
+    for(auto volume : {100, 200, 300}) {
+      SaveCheckpoint(MakeCheckpoint(m_timeClient.GetTime(), volume),
+        m_directory, 2);
+    }
+    auto count = std::distance(std::filesystem::directory_iterator(
+      m_directory), std::filesystem::directory_iterator());
+    REQUIRE(count == 2);
+    auto checkpoint = LoadLatestCheckpoint(m_directory, sessionStart);
+    REQUIRE(checkpoint.is_initialized());
+    REQUIRE(checkpoint->m_securityEntries[0].m_technicals.m_volume == 300);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "restore_and_replay_tail") {
+    auto info = SecurityInfo(TEST_SECURITY, "Test Inc", "", 100);
+    auto registry = MarketDataRegistry();
+    registry.Add(info);
+    Publish(registry, Money::ONE, Money::ONE + Money::CENT, true);
+    Publish(registry, Money::ONE, 100, Side::BID, true);
+    auto checkpoint = registry.MakeCheckpoint();
+    Publish(registry, 2 * Money::ONE, 100);
+    auto lastQuote = Publish(registry, 2 * Money::ONE,
+      2 * Money::ONE + Money::CENT, true);
+    auto restoredRegistry = MarketDataRegistry();
+    restoredRegistry.Add(info);
+    restoredRegistry.Restore(checkpoint, m_dataStore);
+    auto snapshot = restoredRegistry.FindSnapshot(TEST_SECURITY);
+    REQUIRE(snapshot.is_initialized());
+    REQUIRE(snapshot->m_bboQuote == lastQuote);
+    REQUIRE(snapshot->m_bidBook.size() == 1);
+    REQUIRE((*snapshot->m_bidBook[0])->m_quote.m_size == 100);
+    auto technicals = restoredRegistry.FindSecurityTechnicals(TEST_SECURITY);
+    REQUIRE(technicals.is_initialized());
+    REQUIRE(technicals->m_volume == 100);
+    REQUIRE(technicals->m_high == 2 * Money::ONE);
+    auto nextQuote = Publish(restoredRegistry, 3 * Money::ONE,
+      3 * Money::ONE + Money::CENT, true);
+    REQUIRE(nextQuote.GetSequence() > lastQuote.GetSequence());
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "restore_drops_unreconciled_book") {
+    auto info = SecurityInfo(TEST_SECURITY, "Test Inc", "", 100);
+    auto registry = MarketDataRegistry();
+    registry.Add(info);
+    Publish(registry, Money::ONE, 100, Side::BID, false);
+    auto checkpoint = registry.MakeCheckpoint();
+    REQUIRE(registry.FindSnapshot(TEST_SECURITY)->m_bidBook.size() == 1);
+    auto restoredRegistry = MarketDataRegistry();
+    restoredRegistry.Add(info);
+    restoredRegistry.Restore(checkpoint, m_dataStore);
+    auto snapshot = restoredRegistry.FindSnapshot(TEST_SECURITY);
+    REQUIRE(snapshot.is_initialized());
+    REQUIRE(snapshot->m_bidBook.empty());
+  }
 }
@@ -0,0 +1,196 @@
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <Beam/Queues/Queue.hpp>
+#include <Beam/ServiceLocator/SessionAuthenticator.hpp>
+#include <Beam/ServiceLocatorTests/ServiceLocatorTestEnvironment.hpp>
+#include <Beam/ServicesTests/ServicesTests.hpp>
+#include <Beam/Threading/TimerThreadPool.hpp>
+#include <Beam/Threading/TriggerTimer.hpp>
+#include <boost/optional/optional.hpp>
+#include <doctest/doctest.h>
+#include "Nexus/AdministrationService/VirtualAdministrationClient.hpp"
+#include "Nexus/AdministrationServiceTests/AdministrationServiceTestEnvironment.hpp"
+#include "Nexus/Definitions/DefaultMarketDatabase.hpp"
+#include "Nexus/MarketDataService/MarketDataRelayServlet.hpp"
+#include "Nexus/MarketDataServiceTests/MarketDataServiceTestEnvironment.hpp"
+
+using namespace Beam;
+using namespace Beam::Queries;
+using namespace Beam::Services;
+using namespace Beam::Services::Tests;
+using namespace Beam::ServiceLocator;
+using namespace Beam::ServiceLocator::Tests;
+using namespace Beam::Threading;
+using namespace boost;
+using namespace boost::posix_time;
+using namespace Nexus;
+using namespace Nexus::AdministrationService;
+using namespace Nexus::AdministrationService::Tests;
+using namespace Nexus::MarketDataService;
+using namespace Nexus::MarketDataService::Tests;
+
+namespace {
+  auto MakeSecurity(int index) {
+    return Security("S" + std::to_string(index), DefaultMarkets::NYSE(),
+      DefaultCountries::US());
+  }
+
+  auto MakeBboQuote(Money bid) {
+    return BboQuote(Quote(bid, 100, Side::BID),
+      Quote(bid + Money::CENT, 100, Side::ASK),
+      second_clock::universal_time());
+  }
+
+  struct Fixture {
+    using TestServletContainer =
+      TestAuthenticatedServiceProtocolServletContainer<
+      MetaMarketDataRelayServlet<std::shared_ptr<VirtualMarketDataClient>,
+      std::unique_ptr<VirtualAdministrationClient>,
+      std::unique_ptr<TriggerTimer>>, NativePointerPolicy>;
+
+    ServiceLocatorTestEnvironment m_serviceLocatorEnvironment;
+    std::shared_ptr<VirtualServiceLocatorClient> m_serviceLocatorClient;
+    AdministrationServiceTestEnvironment m_administrationEnvironment;
+    MarketDataServiceTestEnvironment m_marketDataEnvironment;
+    TimerThreadPool m_timerThreadPool;
+    optional<TestServletContainer::Servlet::Servlet> m_relayServlet;
+    optional<TestServletContainer> m_container;
+    optional<TestServiceProtocolClient> m_clientProtocol;
+    std::shared_ptr<Queue<SequencedSecurityBboQuote>> m_bboQuotes;
+
+    Fixture()
+        : m_serviceLocatorClient(m_serviceLocatorEnvironment.BuildClient()),
+          m_administrationEnvironment(m_serviceLocatorClient),
+          m_marketDataEnvironment(m_serviceLocatorClient,
+            m_administrationEnvironment.BuildClient(
+            Ref(*m_serviceLocatorClient))),
+          m_bboQuotes(std::make_shared<Queue<SequencedSecurityBboQuote>>()) {
+      auto clientEntry = m_serviceLocatorEnvironment.GetRoot().MakeAccount(
+        "client", "", DirectoryEntry::GetStarDirectory());
+      m_administrationEnvironment.MakeAdministrator(clientEntry);
+      auto servletServiceLocatorClient =
+        m_serviceLocatorEnvironment.BuildClient();
+      m_relayServlet.emplace(EntitlementDatabase(), seconds(1),
+        [this] {
+          return m_marketDataEnvironment.BuildClient(
+            Ref(*m_serviceLocatorClient));
+        }, 1, 1, hours(1), std::make_unique<TriggerTimer>(),
+        m_administrationEnvironment.BuildClient(
+        Ref(*servletServiceLocatorClient)), Ref(m_timerThreadPool));
+      auto serverConnection = std::make_shared<TestServerConnection>();
+      m_container.emplace(Initialize(std::move(servletServiceLocatorClient),
+        &*m_relayServlet), serverConnection,
+        factory<std::unique_ptr<TriggerTimer>>());
+      m_clientProtocol.emplace(Initialize("test", *serverConnection),
+        Initialize());
+      Nexus::Queries::RegisterQueryTypes(
+        Store(m_clientProtocol->GetSlots().GetRegistry()));
+      RegisterMarketDataRegistryServices(Store(m_clientProtocol->GetSlots()));
+      RegisterMarketDataRegistryMessages(Store(m_clientProtocol->GetSlots()));
+      AddMessageSlot<BboQuoteMessage>(Store(m_clientProtocol->GetSlots()),
+        [bboQuotes = m_bboQuotes] (auto& client,
+            const SequencedSecurityBboQuote& bboQuote) {
+          bboQuotes->Push(bboQuote);
+        });
+      auto clientServiceLocatorClient =
+        m_serviceLocatorEnvironment.BuildClient("client", "");
+      auto authenticator = SessionAuthenticator(
+        Ref(*clientServiceLocatorClient));
+      authenticator(*m_clientProtocol);
+    }
+
+    void Subscribe(const Security& security) {
+      auto query = SecurityMarketDataQuery();
+      query.SetIndex(security);
+      query.SetRange(Range::RealTime());
+      m_clientProtocol->SendRequest<QueryBboQuotesService>(query);
+    }
+
+    void RequireBboQuote(const Security& security, Money bid) {
+      auto bboQuote = m_bboQuotes->Pop();
+      REQUIRE(bboQuote.GetValue().GetIndex() == security);
+      REQUIRE(bboQuote->GetValue().m_bid.m_price == bid);
+    }
+  };
+
+  template<typename M>
+  auto GetSubscriptionCount(const std::vector<M>& metrics) {
+    auto count = 0;
+    for(auto& entry : metrics) {
+      count += entry.m_subscriptionCount;
+    }
+    return count;
+  }
+
+  template<typename M>
+  auto GetMessageCount(const std::vector<M>& metrics) {
+    auto count = std::uint64_t(0);
+    for(auto& entry : metrics) {
+      count += entry.m_messageCount;
+    }
+    return count;
+  }
+}
+
+TEST_SUITE("MarketDataRelayServlet") {
+  TEST_CASE_FIXTURE(Fixture, "real_time_query_entry_metrics") {
+    auto metrics = m_relayServlet->GetRealTimeQueryEntryMetrics();
+    REQUIRE(!metrics.empty());
+    REQUIRE(GetSubscriptionCount(metrics) == 0);
+    Subscribe(MakeSecurity(0));
+    Subscribe(MakeSecurity(1));
+    for(auto bid : {Money::ONE, 2 * Money::ONE}) {
+      m_marketDataEnvironment.Publish(MakeSecurity(0), MakeBboQuote(bid));
+      RequireBboQuote(MakeSecurity(0), bid);
+    }
+    m_marketDataEnvironment.Publish(MakeSecurity(1),
+      MakeBboQuote(3 * Money::ONE));
+    RequireBboQuote(MakeSecurity(1), 3 * Money::ONE);
+    metrics = m_relayServlet->GetRealTimeQueryEntryMetrics();
+    REQUIRE(GetSubscriptionCount(metrics) == 2);
+    REQUIRE(GetMessageCount(metrics) == 3);
+    for(auto& entry : metrics) {
+      REQUIRE(entry.m_queueDepth == 0);
+    }
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "rebalance_migrates_busiest_subscription") {
+    auto entryCount =
+      static_cast<int>(m_relayServlet->GetRealTimeQueryEntryMetrics().size());
+    if(entryCount < 2) {
+      return;
+    }
+
+    // With every upstream client idle, subscriptions are assigned round robin
+    // so the first client ends up with the first and the last Security.
+    for(auto i = 0; i <= entryCount; ++i) {
+      Subscribe(MakeSecurity(i));
+    }
+    auto first = MakeSecurity(0);
+    auto last = MakeSecurity(entryCount);
+    auto metrics = m_relayServlet->GetRealTimeQueryEntryMetrics();
+    REQUIRE(metrics.front().m_subscriptionCount == 2);
+    m_marketDataEnvironment.Publish(first, MakeBboQuote(Money::ONE));
+    RequireBboQuote(first, Money::ONE);
+    for(auto bid : {Money::ONE, 2 * Money::ONE, 3 * Money::ONE}) {
+      m_marketDataEnvironment.Publish(last, MakeBboQuote(bid));
+      RequireBboQuote(last, bid);
+    }
+    m_relayServlet->Rebalance();
+    metrics = m_relayServlet->GetRealTimeQueryEntryMetrics();
+    REQUIRE(metrics.front().m_subscriptionCount == 1);
+    REQUIRE(GetSubscriptionCount(metrics) == entryCount + 1);
+
+    // The migrated subscription resumes after its last update without
+    // repeating it, and the original client keeps publishing the other.
+    m_marketDataEnvironment.Publish(last, MakeBboQuote(4 * Money::ONE));
+    RequireBboQuote(last, 4 * Money::ONE);
+    m_marketDataEnvironment.Publish(first, MakeBboQuote(2 * Money::ONE));
+    RequireBboQuote(first, 2 * Money::ONE);
+    metrics = m_relayServlet->GetRealTimeQueryEntryMetrics();
+    REQUIRE(GetMessageCount(metrics) == 6);
+    REQUIRE(metrics.front().m_messageCount == 5);
+  }
+}
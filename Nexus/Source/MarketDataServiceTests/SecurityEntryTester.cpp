@@ -160,4 +160,68 @@ TEST_SUITE("SecurityEntry") {
       2 * Money::ONE, 100, Side::ASK, Queries::Sequence(6), 100);
     TestBookQuoteSnapshot(entry, {abcAskD}, {abcBidC});
   }
+
+  TEST_CASE_FIXTURE(Fixture, "restore_from_checkpoint") {
+    auto initialSequences = SecurityEntry::InitialSequences();
+    auto entry = SecurityEntry(TEST_SECURITY, Money::ZERO, initialSequences);
+    auto bboQuote = PublishBboQuote(entry, Money::ONE, 100,
+      Money::ONE + Money::CENT, 100, Queries::Sequence(0));
+    auto abcBid = PublishBookQuote(entry, "ABC", false, DefaultMarkets::NYSE(),
+      Money::ONE, 100, Side::BID, Queries::Sequence(0), 100);
+    auto abcAsk = PublishBookQuote(entry, "ABC", false, DefaultMarkets::NYSE(),
+      2 * Money::ONE, 100, Side::ASK, Queries::Sequence(1), 100);
+    PublishBookQuote(entry, "ABC", false, DefaultMarkets::NYSE(),
+      2 * Money::ONE, -100, Side::ASK, Queries::Sequence(2), 0);
+    auto restoredEntry = SecurityEntry(entry.MakeCheckpoint());
+    REQUIRE(restoredEntry.GetSecurity() == TEST_SECURITY);
+    REQUIRE(restoredEntry.GetBboQuote() == bboQuote);
+    TestBookQuoteSnapshot(restoredEntry, {}, {abcBid});
+    PublishBboQuote(restoredEntry, 2 * Money::ONE, 100,
+      2 * Money::ONE + Money::CENT, 100, Queries::Sequence(1));
+    auto liveBid = PublishBookQuote(restoredEntry, "ABC", false,
+      DefaultMarkets::NYSE(), Money::ONE, 100, Side::BID,
+      Queries::Sequence(3), 100);
+    TestBookQuoteSnapshot(restoredEntry, {}, {liveBid});
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "clear_restored_book") {
+    auto initialSequences = SecurityEntry::InitialSequences();
+    auto entry = SecurityEntry(TEST_SECURITY, Money::ZERO, initialSequences);
+    auto abcBid = PublishBookQuote(entry, "ABC", false, DefaultMarkets::NYSE(),
+      Money::ONE, 100, Side::BID, Queries::Sequence(0), 100);
+    auto restoredEntry = SecurityEntry(entry.MakeCheckpoint());
+    TestBookQuoteSnapshot(restoredEntry, {}, {abcBid});
+    restoredEntry.Clear(TEST_SOURCE + 1);
+    TestBookQuoteSnapshot(restoredEntry, {}, {});
+    auto expiredEntry = SecurityEntry(entry.MakeCheckpoint());
+    expiredEntry.ExpireRestoredBook();
+    TestBookQuoteSnapshot(expiredEntry, {}, {});
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "replay_after_checkpoint") {
+    auto initialSequences = SecurityEntry::InitialSequences();
+    auto entry = SecurityEntry(TEST_SECURITY, Money::ZERO, initialSequences);
+    PublishBboQuote(entry, Money::ONE, 100, Money::ONE + Money::CENT, 100,
+      Queries::Sequence(0));
+    auto restoredEntry = SecurityEntry(entry.MakeCheckpoint());
+    auto timestamp = m_timeClient.GetTime();
+    auto timeAndSale = Queries::SequencedValue(TimeAndSale(timestamp,
+      3 * Money::ONE, 100, TimeAndSale::Condition(), "NYSE"),
+      EncodeTimestamp(timestamp, Queries::Sequence(4)));
+    restoredEntry.Replay(timeAndSale);
+    REQUIRE(restoredEntry.GetSecurityTechnicals().m_high == 3 * Money::ONE);
+    REQUIRE(restoredEntry.GetSecurityTechnicals().m_volume == 100);
+    auto replayedQuote = Queries::SequencedValue(BboQuote(
+      Quote(2 * Money::ONE, 100, Side::BID),
+      Quote(2 * Money::ONE + Money::CENT, 100, Side::ASK), timestamp),
+      EncodeTimestamp(timestamp, Queries::Sequence(5)));
+    restoredEntry.Replay(replayedQuote);
+    REQUIRE(*replayedQuote == *restoredEntry.GetBboQuote());
+    auto bboQuote = restoredEntry.PublishBboQuote(BboQuote(
+      Quote(Money::ONE, 100, Side::BID),
+      Quote(Money::ONE + Money::CENT, 100, Side::ASK),
+      m_timeClient.GetTime()), TEST_SOURCE);
+    REQUIRE(bboQuote.is_initialized());
+    REQUIRE(bboQuote->GetSequence() > replayedQuote.GetSequence());
+  }
 }
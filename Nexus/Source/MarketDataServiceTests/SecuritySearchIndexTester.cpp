@@ -0,0 +1,135 @@
+#include <doctest/doctest.h>
+#include "Nexus/Definitions/DefaultCountryDatabase.hpp"
+#include "Nexus/Definitions/DefaultMarketDatabase.hpp"
+#include "Nexus/MarketDataService/SecuritySearchIndex.hpp"
+
+using namespace Nexus;
+using namespace Nexus::MarketDataService;
+
+namespace {
+  auto MakeInfo(std::string symbol, std::string name) {
+    return SecurityInfo(Security(std::move(symbol), DefaultMarkets::NASDAQ(),
+      DefaultCountries::US()), std::move(name), "", 100);
+  }
+
+  struct Fixture {
+    SecurityInfo m_abc;
+    SecurityInfo m_abd;
+    SecurityInfo m_xyz;
+    SecurityInfo m_msft;
+    SecuritySearchIndex m_index;
+
+    Fixture()
+        : m_abc(MakeInfo("ABC", "Alpha Beta Corp")),
+          m_abd(MakeInfo("ABD", "Abdominal Inc")),
+          m_xyz(MakeInfo("XYZ", "ABC Holdings")),
+          m_msft(MakeInfo("MSFT", "Microsoft Corp")) {
+      m_index.Add(m_abc);
+      m_index.Add(m_abd);
+      m_index.Add(m_xyz);
+      m_index.Add(m_msft);
+    }
+  };
+}
+
+TEST_SUITE("SecuritySearchIndex") {
+  TEST_CASE_FIXTURE(Fixture, "symbol_and_name_prefix") {
+    REQUIRE(m_index.GetSize() == 4);
+    auto result = m_index.Search("ab", Security(), 10);
+    REQUIRE((result == std::vector{m_abc, m_abd, m_xyz}));
+    result = m_index.Search("HOLD", Security(), 10);
+    REQUIRE((result == std::vector{m_xyz}));
+    result = m_index.Search("ALPHA B", Security(), 10);
+    REQUIRE((result == std::vector{m_abc}));
+    REQUIRE(m_index.Search("", Security(), 10).empty());
+    REQUIRE(m_index.Search("AB", Security(), 0).empty());
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "rank") {
+    auto activity = std::unordered_map<Security, Quantity>();
+    activity[m_abd.m_security] = 1000;
+    activity[m_abc.m_security] = 10;
+    m_index.Rank(activity);
+    auto result = m_index.Search("AB", Security(), 10);
+    REQUIRE((result == std::vector{m_abd, m_abc, m_xyz}));
+    auto abe = MakeInfo("ABE", "Abe Inc");
+    m_index.Add(abe);
+    result = m_index.Search("AB", Security(), 10);
+    REQUIRE((result == std::vector{m_abd, m_abc, abe, m_xyz}));
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "apply_ranking") {
+    auto activity = std::unordered_map<Security, Quantity>();
+    activity[m_abd.m_security] = 1000;
+    auto ranking = m_index.MakeRanking();
+    ranking.Rank(activity);
+    auto abe = MakeInfo("ABE", "Abe Inc");
+    m_index.Add(abe);
+    REQUIRE(!m_index.Apply(std::move(ranking)));
+    auto result = m_index.Search("AB", Security(), 10);
+    REQUIRE((result == std::vector{m_abc, m_abd, abe, m_xyz}));
+    ranking = m_index.MakeRanking();
+    ranking.Rank(activity);
+    REQUIRE(m_index.Apply(std::move(ranking)));
+    result = m_index.Search("AB", Security(), 10);
+    REQUIRE((result == std::vector{m_abd, m_abc, abe, m_xyz}));
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "pagination") {
+    auto result = m_index.Search("AB", Security(), 2);
+    REQUIRE((result == std::vector{m_abc, m_abd}));
+    result = m_index.Search("AB", result.back().m_security, 2);
+    REQUIRE((result == std::vector{m_xyz}));
+    result = m_index.Search("AB", result.back().m_security, 2);
+    REQUIRE(result.empty());
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "pagination_unknown_start") {
+    auto unknown = Security("ABZ", DefaultMarkets::NASDAQ(),
+      DefaultCountries::US());
+    REQUIRE(m_index.Search("AB", unknown, 2).empty());
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "pagination_across_rank") {
+    auto firstPage = m_index.Search("AB", Security(), 2);
+    REQUIRE((firstPage == std::vector{m_abc, m_abd}));
+    auto activity = std::unordered_map<Security, Quantity>();
+    activity[m_abd.m_security] = 1000;
+    m_index.Rank(activity);
+
+    // The next page continues after the start's new rank, so a security that
+    // moved below the start is repeated.
+    auto result = m_index.Search("AB", firstPage.back().m_security, 2);
+    REQUIRE((result == std::vector{m_abc, m_xyz}));
+
+    // And a security that moved above the start is skipped.
+    result = m_index.Search("AB", m_abc.m_security, 2);
+    REQUIRE((result == std::vector{m_xyz}));
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "match_group") {
+    REQUIRE(SecuritySearchIndex::GetMatchGroup("ab", m_abc) == 0);
+    REQUIRE(SecuritySearchIndex::GetMatchGroup("ab", m_xyz) == 1);
+    REQUIRE(SecuritySearchIndex::GetMatchGroup("MIRCO", m_msft) == 2);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "update") {
+    auto renamed = MakeInfo("XYZ", "Zeta Holdings");
+    m_index.Add(renamed);
+    REQUIRE(m_index.GetSize() == 4);
+    auto result = m_index.Search("AB", Security(), 10);
+    REQUIRE((result == std::vector{m_abc, m_abd}));
+    result = m_index.Search("ZETA H", Security(), 10);
+    REQUIRE((result == std::vector{renamed}));
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "fuzzy") {
+    auto result = m_index.Search("MSTF", Security(), 10);
+    REQUIRE((result == std::vector{m_msft}));
+    result = m_index.Search("MIRCO", Security(), 10);
+    REQUIRE((result == std::vector{m_msft}));
+    result = m_index.Search("MSXT", Security(), 10);
+    REQUIRE((result == std::vector{m_msft}));
+    REQUIRE(m_index.Search("QQQ", Security(), 10).empty());
+  }
+}
@@ -0,0 +1,139 @@
+#include <filesystem>
+#include <Beam/TimeService/IncrementalTimeClient.hpp>
+#include <doctest/doctest.h>
+#include <Viper/Sqlite3/Connection.hpp>
+#include "Nexus/Definitions/DefaultCountryDatabase.hpp"
+#include "Nexus/Definitions/DefaultMarketDatabase.hpp"
+#include "Nexus/MarketDataService/SqlHistoricalDataStore.hpp"
+
+using namespace Beam;
+using namespace Beam::Queries;
+using namespace Beam::TimeService;
+using namespace Nexus;
+using namespace Nexus::MarketDataService;
+using namespace Viper;
+using namespace Viper::Sqlite3;
+
+namespace {
+  using TestSqlHistoricalDataStore = SqlHistoricalDataStore<Connection>;
+
+  const auto TST = Security("TST", DefaultMarkets::NASDAQ(),
+    DefaultCountries::US());
+  const auto ABX = Security("ABX", DefaultMarkets::TSX(),
+    DefaultCountries::CA());
+
+  struct Fixture {
+    std::filesystem::path m_path;
+    IncrementalTimeClient m_timeClient;
+
+    Fixture()
+        : m_path(std::filesystem::temp_directory_path() /
+            "sql_historical_data_store_tester.db") {
+      std::filesystem::remove(m_path);
+    }
+
+    ~Fixture() {
+      std::filesystem::remove(m_path);
+    }
+
+    auto MakeDataStore() {
+      auto path = m_path.string();
+      return std::make_unique<TestSqlHistoricalDataStore>([=] {
+        return Connection(path);
+      });
+    }
+
+    void StoreTimeAndSale(TestSqlHistoricalDataStore& dataStore,
+        const Security& security, Money price, std::string marketCenter,
+        Sequence sequence) {
+      dataStore.Store(SequencedSecurityTimeAndSale(SecurityTimeAndSale(
+        TimeAndSale(m_timeClient.GetTime(), price, 100,
+        TimeAndSale::Condition(), std::move(marketCenter)), security),
+        sequence));
+    }
+  };
+}
+
+TEST_SUITE("SqlHistoricalDataStore") {
+  TEST_CASE_FIXTURE(Fixture, "load_all_initial_sequences") {
+    auto dataStore = MakeDataStore();
+    REQUIRE(dataStore->LoadAllInitialSequences().empty());
+    for(auto sequence : {Sequence(5), Sequence(7)}) {
+      dataStore->Store(SequencedSecurityBboQuote(SecurityBboQuote(BboQuote(
+        Quote(Money::ONE, 100, Side::BID),
+        Quote(Money::ONE + Money::CENT, 100, Side::ASK),
+        m_timeClient.GetTime()), TST), sequence));
+    }
+    StoreTimeAndSale(*dataStore, TST, Money::ONE, "NSDQ", Sequence(3));
+    StoreTimeAndSale(*dataStore, ABX, Money::ONE, "TSE", Sequence(10));
+    auto initialSequences = dataStore->LoadAllInitialSequences();
+    REQUIRE(initialSequences.size() == 2);
+    auto& tst = initialSequences.at(TST);
+    REQUIRE(tst.m_nextBboQuoteSequence == Increment(Sequence(7)));
+    REQUIRE(tst.m_nextTimeAndSaleSequence == Increment(Sequence(3)));
+    REQUIRE(tst.m_nextBookQuoteSequence == Sequence::First());
+    REQUIRE(tst.m_nextMarketQuoteSequence == Sequence::First());
+    auto& abx = initialSequences.at(ABX);
+    REQUIRE(abx.m_nextBboQuoteSequence == Sequence::First());
+    REQUIRE(abx.m_nextTimeAndSaleSequence == Increment(Sequence(10)));
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "load_all_last_prices") {
+    auto dataStore = MakeDataStore();
+    REQUIRE(dataStore->LoadAllLastPrices().empty());
+    StoreTimeAndSale(*dataStore, TST, Money::ONE, "NSDQ", Sequence(3));
+    StoreTimeAndSale(*dataStore, TST, 2 * Money::ONE, "NSDQ", Sequence(4));
+    StoreTimeAndSale(*dataStore, TST, 3 * Money::ONE, "ARCX", Sequence(5));
+    dataStore->Store(std::vector{
+      SequencedSecurityTimeAndSale(SecurityTimeAndSale(TimeAndSale(
+        m_timeClient.GetTime(), 4 * Money::ONE, 100, TimeAndSale::Condition(),
+        "TSE"), ABX), Sequence(10)),
+      SequencedSecurityTimeAndSale(SecurityTimeAndSale(TimeAndSale(
+        m_timeClient.GetTime(), 5 * Money::ONE, 100, TimeAndSale::Condition(),
+        "TSE"), ABX), Sequence(11))});
+    auto lastPrices = dataStore->LoadAllLastPrices();
+    REQUIRE(lastPrices.size() == 2);
+    REQUIRE(lastPrices.at(TST).size() == 2);
+    REQUIRE(lastPrices.at(TST).at("NSDQ") == 2 * Money::ONE);
+    REQUIRE(lastPrices.at(TST).at("ARCX") == 3 * Money::ONE);
+    REQUIRE(lastPrices.at(ABX).size() == 1);
+    REQUIRE(lastPrices.at(ABX).at("TSE") == 5 * Money::ONE);
+    dataStore.reset();
+    dataStore = MakeDataStore();
+    REQUIRE(dataStore->LoadAllLastPrices() == lastPrices);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "last_price_ignores_older_sequence") {
+    auto dataStore = MakeDataStore();
+    StoreTimeAndSale(*dataStore, TST, 2 * Money::ONE, "NSDQ", Sequence(5));
+    StoreTimeAndSale(*dataStore, TST, Money::ONE, "NSDQ", Sequence(4));
+    dataStore->Store(std::vector{
+      SequencedSecurityTimeAndSale(SecurityTimeAndSale(TimeAndSale(
+        m_timeClient.GetTime(), 4 * Money::ONE, 100, TimeAndSale::Condition(),
+        "TSE"), ABX), Sequence(11)),
+      SequencedSecurityTimeAndSale(SecurityTimeAndSale(TimeAndSale(
+        m_timeClient.GetTime(), 3 * Money::ONE, 100, TimeAndSale::Condition(),
+        "TSE"), ABX), Sequence(10))});
+    auto lastPrices = dataStore->LoadAllLastPrices();
+    REQUIRE(lastPrices.at(TST).at("NSDQ") == 2 * Money::ONE);
+    REQUIRE(lastPrices.at(ABX).at("TSE") == 4 * Money::ONE);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "load_stored_time_and_sales") {
+    auto dataStore = MakeDataStore();
+    StoreTimeAndSale(*dataStore, TST, Money::ONE, "NSDQ", Sequence(3));
+    StoreTimeAndSale(*dataStore, TST, 2 * Money::ONE, "ARCX", Sequence(4));
+    auto query = SecurityMarketDataQuery();
+    query.SetIndex(TST);
+    query.SetRange(Range::Total());
+    query.SetSnapshotLimit(SnapshotLimit::Unlimited());
+    auto timeAndSales = dataStore->LoadTimeAndSales(query);
+    REQUIRE(timeAndSales.size() == 2);
+    REQUIRE(timeAndSales[0].GetSequence() == Sequence(3));
+    REQUIRE(timeAndSales[0]->m_price == Money::ONE);
+    REQUIRE(timeAndSales[0]->m_marketCenter == "NSDQ");
+    REQUIRE(timeAndSales[1].GetSequence() == Sequence(4));
+    REQUIRE(timeAndSales[1]->m_price == 2 * Money::ONE);
+    REQUIRE(timeAndSales[1]->m_marketCenter == "ARCX");
+  }
+}
@@ -0,0 +1,373 @@
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <Beam/IO/SharedBuffer.hpp>
+#include <Beam/Queues/Queue.hpp>
+#include <Beam/Routines/RoutineHandler.hpp>
+#include <Beam/Threading/TriggerTimer.hpp>
+#include <Beam/Utilities/Endian.hpp>
+#include <doctest/doctest.h>
+#include "Nexus/MoldUdp64/MoldUdp64Client.hpp"
+
+using namespace Beam;
+using namespace Beam::IO;
+using namespace Beam::Routines;
+using namespace Beam::Threading;
+using namespace Nexus;
+using namespace Nexus::MoldUdp64;
+
+namespace {
+
+  /** Delivers whole datagrams in the order they are pushed. */
+  struct TestChannel {
+    struct Connection {
+      std::shared_ptr<Queue<SharedBuffer>> m_datagrams;
+
+      void Close() {
+        m_datagrams->Break();
+      }
+    };
+
+    struct Reader {
+      using Buffer = SharedBuffer;
+      std::shared_ptr<Queue<SharedBuffer>> m_datagrams;
+      std::shared_ptr<Queue<int>> m_reads;
+      int m_readCount = 0;
+
+      template<typename B>
+      std::size_t Read(Out<B> destination) {
+        m_reads->Push(++m_readCount);
+        auto datagram = m_datagrams->Pop();
+        destination->Append(datagram.GetData(), datagram.GetSize());
+        return datagram.GetSize();
+      }
+    };
+
+    struct Writer {
+      using Buffer = SharedBuffer;
+      std::function<void (const SharedBuffer&)> m_onWrite;
+
+      template<typename B>
+      void Write(const B& data) {
+        m_onWrite(data);
+      }
+    };
+
+    std::shared_ptr<Queue<SharedBuffer>> m_datagrams;
+    Connection m_connection;
+    Reader m_reader;
+    Writer m_writer;
+
+    TestChannel()
+      : m_datagrams(std::make_shared<Queue<SharedBuffer>>()),
+        m_connection{m_datagrams},
+        m_reader{m_datagrams, std::make_shared<Queue<int>>()},
+        m_writer{[] (const SharedBuffer&) {}} {}
+
+    Connection& GetConnection() {
+      return m_connection;
+    }
+
+    Reader& GetReader() {
+      return m_reader;
+    }
+
+    Writer& GetWriter() {
+      return m_writer;
+    }
+  };
+
+  /** Stands in for a retransmission server that replies from a store. */
+  struct RetransmissionServer {
+    TestChannel m_channel;
+    std::map<std::uint64_t, SharedBuffer> m_packets;
+    std::vector<std::pair<std::uint64_t, std::uint16_t>> m_requests;
+    std::shared_ptr<Queue<std::uint64_t>> m_requestedSequenceNumbers;
+    int m_ignoredRequests;
+
+    RetransmissionServer()
+        : m_requestedSequenceNumbers(
+            std::make_shared<Queue<std::uint64_t>>()),
+          m_ignoredRequests(0) {
+      m_channel.m_writer.m_onWrite = [this] (const SharedBuffer& request) {
+        auto sequenceNumber = FromBigEndian(
+          *reinterpret_cast<const std::uint64_t*>(request.GetData() +
+          MoldUdp64Packet::SESSION_FIELD_LENGTH));
+        auto count = FromBigEndian(*reinterpret_cast<const std::uint16_t*>(
+          request.GetData() + MoldUdp64Packet::SESSION_FIELD_LENGTH +
+          sizeof(std::uint64_t)));
+        m_requests.emplace_back(sequenceNumber, count);
+        m_requestedSequenceNumbers->Push(sequenceNumber);
+        if(m_ignoredRequests != 0) {
+          --m_ignoredRequests;
+          return;
+        }
+        for(auto i = m_packets.lower_bound(sequenceNumber);
+            i != m_packets.end() && i->first < sequenceNumber + count; ++i) {
+          m_channel.m_datagrams->Push(i->second);
+        }
+      };
+    }
+  };
+
+  auto MakePacket(std::uint64_t sequenceNumber,
+      const std::vector<std::string>& messages) {
+    auto packet = SharedBuffer();
+    auto session = std::string(MoldUdp64Packet::SESSION_FIELD_LENGTH, ' ');
+    session.replace(0, 4, "TEST");
+    packet.Append(session.data(), session.size());
+    packet.Append(ToBigEndian(sequenceNumber));
+    packet.Append(ToBigEndian(static_cast<std::uint16_t>(messages.size())));
+    for(auto& message : messages) {
+      packet.Append(ToBigEndian(static_cast<std::uint16_t>(
+        message.size() + 1)));
+      packet.Append('A');
+      packet.Append(message.data(), message.size());
+    }
+    return packet;
+  }
+
+  using Message = std::pair<std::uint64_t, std::string>;
+  using RecoveryClient = MoldUdp64Client<TestChannel*, TestChannel*,
+    TriggerTimer*>;
+
+  template<typename Client>
+  auto ReadMessage(Client& client) {
+    auto sequenceNumber = std::uint64_t();
+    auto message = client.Read(Store(sequenceNumber));
+    return Message(sequenceNumber,
+      std::string(message.m_data, message.m_length - 1));
+  }
+
+  auto GetMessages(const MoldUdp64MessageBatch& batch) {
+    auto messages = std::vector<std::string>();
+    for(auto& message : batch.m_messages) {
+      messages.emplace_back(message.m_data, message.m_length - 1);
+    }
+    return messages;
+  }
+
+  void WaitForReads(const TestChannel& channel, int count) {
+    while(channel.m_reader.m_reads->Pop() < count) {}
+  }
+}
+
+TEST_SUITE("MoldUdp64Client") {
+  TEST_CASE("in_order") {
+    auto channel = TestChannel();
+    channel.m_datagrams->Push(MakePacket(1, {"a", "b"}));
+    channel.m_datagrams->Push(MakePacket(3, {"c"}));
+    auto client = MoldUdp64Client<TestChannel*>(&channel);
+    REQUIRE(ReadMessage(client) == Message(1, "a"));
+    REQUIRE(ReadMessage(client) == Message(2, "b"));
+    REQUIRE(ReadMessage(client) == Message(3, "c"));
+    REQUIRE(client.GetLostMessageCount() == 0);
+  }
+
+  TEST_CASE("read_batch") {
+    auto channel = TestChannel();
+    channel.m_datagrams->Push(MakePacket(1, {"a", "b"}));
+    channel.m_datagrams->Push(MakePacket(3, {"c"}));
+    channel.m_datagrams->Push(MakePacket(4, {"d"}));
+    auto client = MoldUdp64Client<TestChannel*>(&channel);
+    WaitForReads(channel, 4);
+    auto batch = MoldUdp64MessageBatch();
+    client.ReadBatch(Store(batch));
+    REQUIRE(batch.m_sequenceNumber == 1);
+    REQUIRE((GetMessages(batch) ==
+      std::vector<std::string>{"a", "b", "c", "d"}));
+    channel.m_datagrams->Push(MakePacket(5, {"e"}));
+    client.ReadBatch(Store(batch));
+    REQUIRE(batch.m_sequenceNumber == 5);
+    REQUIRE((GetMessages(batch) == std::vector<std::string>{"e"}));
+  }
+
+  TEST_CASE("read_batch_ends_at_gap") {
+    auto channel = TestChannel();
+    channel.m_datagrams->Push(MakePacket(1, {"a"}));
+    channel.m_datagrams->Push(MakePacket(3, {"c"}));
+    auto client = MoldUdp64Client<TestChannel*>(&channel);
+    WaitForReads(channel, 3);
+    auto batch = MoldUdp64MessageBatch();
+    client.ReadBatch(Store(batch));
+    REQUIRE(batch.m_sequenceNumber == 1);
+    REQUIRE((GetMessages(batch) == std::vector<std::string>{"a"}));
+    client.ReadBatch(Store(batch));
+    REQUIRE(batch.m_sequenceNumber == 3);
+    REQUIRE((GetMessages(batch) == std::vector<std::string>{"c"}));
+    REQUIRE(client.GetLostMessageCount() == 1);
+  }
+
+  TEST_CASE("read_batch_leaves_buffer_free") {
+    auto channel = TestChannel();
+    channel.m_datagrams->Push(MakePacket(1, {"a"}));
+    channel.m_datagrams->Push(MakePacket(2, {"b"}));
+    channel.m_datagrams->Push(MakePacket(3, {"c"}));
+    auto client = MoldUdp64Client<TestChannel*>(&channel, 2);
+    WaitForReads(channel, 2);
+    auto batch = MoldUdp64MessageBatch();
+    for(auto message : {"a", "b", "c"}) {
+      client.ReadBatch(Store(batch));
+      REQUIRE((GetMessages(batch) == std::vector<std::string>{message}));
+    }
+  }
+
+  TEST_CASE("read_within_batch") {
+    auto channel = TestChannel();
+    channel.m_datagrams->Push(MakePacket(1, {"a", "b"}));
+    channel.m_datagrams->Push(MakePacket(3, {"c"}));
+    auto client = MoldUdp64Client<TestChannel*>(&channel);
+    WaitForReads(channel, 3);
+    REQUIRE(ReadMessage(client) == Message(1, "a"));
+    REQUIRE(ReadMessage(client) == Message(2, "b"));
+    REQUIRE(ReadMessage(client) == Message(3, "c"));
+  }
+
+  TEST_CASE("reordered_packets") {
+    auto channel = TestChannel();
+    auto server = RetransmissionServer();
+    auto timer = TriggerTimer();
+    channel.m_datagrams->Push(MakePacket(1, {"a"}));
+    channel.m_datagrams->Push(MakePacket(3, {"c"}));
+    channel.m_datagrams->Push(MakePacket(2, {"b"}));
+    channel.m_datagrams->Push(MakePacket(2, {"b"}));
+    channel.m_datagrams->Push(MakePacket(4, {"d"}));
+    auto client = RecoveryClient(&channel, &server.m_channel, &timer,
+      RecoveryClient::DEFAULT_BUFFER_COUNT);
+    REQUIRE(ReadMessage(client) == Message(1, "a"));
+    REQUIRE(ReadMessage(client) == Message(2, "b"));
+    REQUIRE(ReadMessage(client) == Message(3, "c"));
+    REQUIRE(ReadMessage(client) == Message(4, "d"));
+    REQUIRE(client.GetLostMessageCount() == 0);
+  }
+
+  TEST_CASE("recover_gap") {
+    auto channel = TestChannel();
+    auto server = RetransmissionServer();
+    auto timer = TriggerTimer();
+    server.m_packets.emplace(2, MakePacket(2, {"b", "c"}));
+    channel.m_datagrams->Push(MakePacket(1, {"a"}));
+    channel.m_datagrams->Push(MakePacket(4, {"d"}));
+    auto client = RecoveryClient(&channel, &server.m_channel, &timer,
+      RecoveryClient::DEFAULT_BUFFER_COUNT);
+    REQUIRE(ReadMessage(client) == Message(1, "a"));
+    REQUIRE(ReadMessage(client) == Message(2, "b"));
+    REQUIRE(ReadMessage(client) == Message(3, "c"));
+    REQUIRE(ReadMessage(client) == Message(4, "d"));
+    REQUIRE(server.m_requests.size() == 1);
+    REQUIRE(server.m_requests.front() ==
+      std::pair(std::uint64_t(2), std::uint16_t(2)));
+    REQUIRE(client.GetLostMessageCount() == 0);
+  }
+
+  TEST_CASE("heartbeat_gap") {
+    auto channel = TestChannel();
+    auto server = RetransmissionServer();
+    auto timer = TriggerTimer();
+    server.m_packets.emplace(2, MakePacket(2, {"b"}));
+    channel.m_datagrams->Push(MakePacket(1, {"a"}));
+    channel.m_datagrams->Push(MakePacket(3, {}));
+    auto client = RecoveryClient(&channel, &server.m_channel, &timer,
+      RecoveryClient::DEFAULT_BUFFER_COUNT);
+    REQUIRE(ReadMessage(client) == Message(1, "a"));
+    REQUIRE(ReadMessage(client) == Message(2, "b"));
+    REQUIRE(server.m_requests.front() ==
+      std::pair(std::uint64_t(2), std::uint16_t(1)));
+  }
+
+  TEST_CASE("skip_gap_without_recovery") {
+    auto channel = TestChannel();
+    channel.m_datagrams->Push(MakePacket(1, {"a"}));
+    channel.m_datagrams->Push(MakePacket(3, {"c"}));
+    auto client = MoldUdp64Client<TestChannel*>(&channel);
+    REQUIRE(ReadMessage(client) == Message(1, "a"));
+    REQUIRE(ReadMessage(client) == Message(3, "c"));
+    REQUIRE(client.GetLostMessageCount() == 1);
+    channel.m_datagrams->Push(MakePacket(2, {"b"}));
+    channel.m_datagrams->Push(MakePacket(4, {"d"}));
+    REQUIRE(ReadMessage(client) == Message(4, "d"));
+    REQUIRE(client.GetLostMessageCount() == 1);
+  }
+
+  TEST_CASE("skip_unanswered_gap") {
+    auto channel = TestChannel();
+    auto server = RetransmissionServer();
+    auto timer = TriggerTimer();
+    channel.m_datagrams->Push(MakePacket(1, {"a"}));
+    for(auto i = std::size_t(0);
+        i <= RecoveryClient::MAX_OUT_OF_ORDER_PACKETS; ++i) {
+      channel.m_datagrams->Push(MakePacket(3 + i, {"x"}));
+    }
+    auto client = RecoveryClient(&channel, &server.m_channel, &timer,
+      RecoveryClient::DEFAULT_BUFFER_COUNT);
+    REQUIRE(ReadMessage(client) == Message(1, "a"));
+    REQUIRE(ReadMessage(client) == Message(3, "x"));
+    REQUIRE(client.GetLostMessageCount() == 1);
+    REQUIRE(server.m_requests.size() >=
+      RecoveryClient::MAX_OUT_OF_ORDER_PACKETS /
+      RecoveryClient::RETRANSMIT_INTERVAL);
+    for(auto& request : server.m_requests) {
+      REQUIRE(request.first == 2);
+    }
+  }
+
+  TEST_CASE("retransmit_on_timer") {
+    auto channel = TestChannel();
+    auto server = RetransmissionServer();
+    auto timer = TriggerTimer();
+    server.m_ignoredRequests = 1;
+    server.m_packets.emplace(2, MakePacket(2, {"b"}));
+    channel.m_datagrams->Push(MakePacket(1, {"a"}));
+    channel.m_datagrams->Push(MakePacket(3, {"c"}));
+    auto client = RecoveryClient(&channel, &server.m_channel, &timer,
+      RecoveryClient::DEFAULT_BUFFER_COUNT);
+    auto trigger = RoutineHandler(Spawn([&] {
+      server.m_requestedSequenceNumbers->Pop();
+      timer.Trigger();
+    }));
+    REQUIRE(ReadMessage(client) == Message(1, "a"));
+    REQUIRE(ReadMessage(client) == Message(2, "b"));
+    REQUIRE(ReadMessage(client) == Message(3, "c"));
+    REQUIRE(server.m_requests.size() == 2);
+    REQUIRE(client.GetLostMessageCount() == 0);
+  }
+
+  TEST_CASE("expire_unanswered_gap") {
+    auto channel = TestChannel();
+    auto server = RetransmissionServer();
+    auto timer = TriggerTimer();
+    channel.m_datagrams->Push(MakePacket(1, {"a"}));
+    channel.m_datagrams->Push(MakePacket(3, {"c"}));
+    auto client = RecoveryClient(&channel, &server.m_channel, &timer,
+      RecoveryClient::DEFAULT_BUFFER_COUNT);
+    auto trigger = RoutineHandler(Spawn([&] {
+      for(auto i = std::size_t(0);
+          i != RecoveryClient::MAX_RETRANSMIT_REQUESTS; ++i) {
+        server.m_requestedSequenceNumbers->Pop();
+        timer.Trigger();
+      }
+    }));
+    REQUIRE(ReadMessage(client) == Message(1, "a"));
+    REQUIRE(ReadMessage(client) == Message(3, "c"));
+    REQUIRE(client.GetLostMessageCount() == 1);
+    REQUIRE(server.m_requests.size() ==
+      RecoveryClient::MAX_RETRANSMIT_REQUESTS);
+  }
+
+  TEST_CASE("idle_recovery_channel") {
+    auto channel = TestChannel();
+    auto server = RetransmissionServer();
+    auto timer = TriggerTimer();
+    auto client = RecoveryClient(&channel, &server.m_channel, &timer, 2);
+    WaitForReads(server.m_channel, 1);
+    channel.m_datagrams->Push(MakePacket(1, {"a"}));
+    REQUIRE(ReadMessage(client) == Message(1, "a"));
+    WaitForReads(channel, 2);
+    channel.m_datagrams->Push(MakePacket(2, {"b"}));
+    REQUIRE(ReadMessage(client) == Message(2, "b"));
+    REQUIRE(server.m_requests.empty());
+  }
+}
@@ -0,0 +1,69 @@
+#include <doctest/doctest.h>
+#include "Nexus/OrderExecutionService/ExecutionReportWriteLog.hpp"
+
+using namespace Nexus;
+using namespace Nexus::OrderExecutionService;
+
+namespace {
+  auto MakeReport(int sequence) {
+    auto report = ExecutionReport();
+    report.m_id = 1;
+    report.m_sequence = sequence;
+    return report;
+  }
+}
+
+TEST_SUITE("ExecutionReportWriteLog") {
+  TEST_CASE("empty") {
+    auto log = ExecutionReportWriteLog();
+    REQUIRE(log.IsEmpty());
+    REQUIRE(log.GetFront() == nullptr);
+    REQUIRE(log.Find(0) == nullptr);
+    log.PopFront();
+    REQUIRE(log.IsEmpty());
+  }
+
+  TEST_CASE("out_of_order_insert") {
+    auto log = ExecutionReportWriteLog();
+    REQUIRE(log.Insert(MakeReport(5)));
+    REQUIRE(log.Insert(MakeReport(3)));
+    REQUIRE(log.Insert(MakeReport(20)));
+    REQUIRE(!log.Insert(MakeReport(5)));
+    REQUIRE(log.GetSize() == 3);
+    REQUIRE(log.GetFront()->m_sequence == 3);
+    REQUIRE(log.Find(5)->m_sequence == 5);
+    REQUIRE(log.Find(20)->m_sequence == 20);
+    REQUIRE(log.Find(4) == nullptr);
+    log.PopFront();
+    REQUIRE(log.GetFront()->m_sequence == 5);
+    log.Discard(19);
+    REQUIRE(log.GetSize() == 1);
+    REQUIRE(log.GetFront()->m_sequence == 20);
+    log.PopFront();
+    REQUIRE(log.IsEmpty());
+  }
+
+  TEST_CASE("wrap_around") {
+    auto log = ExecutionReportWriteLog();
+    for(auto i = 0; i < 100; ++i) {
+      REQUIRE(log.Insert(MakeReport(i + 1)));
+      REQUIRE(log.Insert(MakeReport(i)));
+      REQUIRE(log.GetFront()->m_sequence == i);
+      log.PopFront();
+      log.PopFront();
+      REQUIRE(log.IsEmpty());
+    }
+  }
+
+  TEST_CASE("capacity") {
+    auto log = ExecutionReportWriteLog(10);
+    REQUIRE(log.Insert(MakeReport(10)));
+    REQUIRE(log.Insert(MakeReport(19)));
+    REQUIRE(!log.Insert(MakeReport(20)));
+    REQUIRE(!log.Insert(MakeReport(9)));
+    log.PopFront();
+    REQUIRE(log.Insert(MakeReport(20)));
+    REQUIRE(log.Find(19)->m_sequence == 19);
+    REQUIRE(log.Find(20)->m_sequence == 20);
+  }
+}
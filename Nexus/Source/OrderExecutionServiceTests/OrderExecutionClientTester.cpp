@@ -4,6 +4,7 @@
 #include <boost/optional/optional.hpp>
 #include <doctest/doctest.h>
 #include "Nexus/Definitions/DefaultCountryDatabase.hpp"
+#include "Nexus/Definitions/DefaultCurrencyDatabase.hpp"
 #include "Nexus/Definitions/DefaultMarketDatabase.hpp"
 #include "Nexus/OrderExecutionService/OrderExecutionClient.hpp"
 #include "Nexus/OrderExecutionServiceTests/OrderExecutionServiceTests.hpp"
@@ -27,24 +28,31 @@ namespace {
     using TestOrderExecutionClient = OrderExecutionClient<
       TestServiceProtocolClientBuilder>;
 
+    std::shared_ptr<TestServerConnection> m_serverConnection;
     boost::optional<Beam::Services::Tests::TestServiceProtocolServer>
       m_server;
     boost::optional<TestOrderExecutionClient> m_client;
 
-    Fixture() {
-      auto serverConnection = std::make_shared<TestServerConnection>();
-      m_server.emplace(serverConnection,
+    Fixture()
+        : m_serverConnection(std::make_shared<TestServerConnection>()) {
+      m_server.emplace(m_serverConnection,
         factory<std::unique_ptr<TriggerTimer>>(), NullSlot(), NullSlot());
       Nexus::Queries::RegisterQueryTypes(
         Store(m_server->GetSlots().GetRegistry()));
       RegisterOrderExecutionServices(Store(m_server->GetSlots()));
       RegisterOrderExecutionMessages(Store(m_server->GetSlots()));
+      MakeClient(ExecutionReportWriteLog::DEFAULT_CAPACITY);
+    }
+
+    void MakeClient(std::size_t writeLogCapacity) {
+      auto serverConnection = m_serverConnection;
       auto builder = TestServiceProtocolClientBuilder(
         [=] {
           return std::make_unique<TestServiceProtocolClientBuilder::Channel>(
             "test", *serverConnection);
         }, factory<std::unique_ptr<TestServiceProtocolClientBuilder::Timer>>());
-      m_client.emplace(builder);
+      m_client.reset();
+      m_client.emplace(builder, writeLogCapacity);
     }
   };
 }
@@ -101,4 +109,56 @@ TEST_SUITE("OrderExecutionClient") {
     REQUIRE(newReportIn.m_id == 1);
     REQUIRE(newReportIn.m_additionalTags.empty());
   }
+
+  TEST_CASE_FIXTURE(Fixture, "write_log_overflow_recovery") {
+    MakeClient(4);
+    auto orderFields = OrderFields::BuildLimitOrder(
+      DirectoryEntry::GetRootAccount(), Security("TST", DefaultMarkets::NYSE(),
+      DefaultCountries::US()), DefaultCurrencies::USD(), Side::BID, "TST",
+      100, Money::CENT);
+    auto reports = std::vector<ExecutionReport>();
+    reports.push_back(ExecutionReport::BuildInitialReport(1,
+      microsec_clock::universal_time()));
+    for(auto i = 1; i < 8; ++i) {
+      reports.push_back(ExecutionReport::BuildUpdatedReport(reports.back(),
+        OrderStatus::NEW, microsec_clock::universal_time()));
+    }
+    auto serverClient = (TestServiceProtocolServer::ServiceProtocolClient*)(
+      nullptr);
+    auto recoveryCount = 0;
+    QueryOrderSubmissionsService::AddSlot(Store(m_server->GetSlots()),
+      [&] (auto& client, auto& query) {
+        auto result = OrderSubmissionQueryResult();
+        result.m_queryId = -1;
+        if(query.GetRange().GetStart() == Sequence::First()) {
+          ++recoveryCount;
+          result.m_snapshot.push_back(SequencedValue(OrderRecord{
+            OrderInfo(orderFields, 1, microsec_clock::universal_time()),
+            reports}, Sequence(5)));
+        }
+        return result;
+      });
+    NewOrderSingleService::AddSlot(Store(m_server->GetSlots()),
+      [&] (auto& client, auto& requestedOrderFields) {
+        serverClient = &client;
+        auto order = SequencedAccountOrderInfo();
+        order.GetSequence() = Beam::Queries::Sequence(5);
+        order->GetIndex() = requestedOrderFields.m_account;
+        (*order)->m_orderId = 1;
+        (*order)->m_fields = requestedOrderFields;
+        return order;
+      });
+    auto& order = m_client->Submit(orderFields);
+    auto updates = std::make_shared<Queue<ExecutionReport>>();
+    order.GetPublisher().Monitor(updates);
+    SendRecordMessage<OrderUpdateMessage>(*serverClient, reports[0]);
+    REQUIRE(updates->Pop().m_sequence == 0);
+    for(auto i = 2; i < 8; ++i) {
+      SendRecordMessage<OrderUpdateMessage>(*serverClient, reports[i]);
+    }
+    for(auto i = 1; i < 8; ++i) {
+      REQUIRE(updates->Pop().m_sequence == i);
+    }
+    REQUIRE(recoveryCount == 1);
+  }
 }
@@ -144,4 +144,32 @@ TEST_SUITE("OrderExecutionServlet") {
     messageAsync.Get();
     REQUIRE(report.m_status == OrderStatus::EXPIRED);
   }
+
+  TEST_CASE_FIXTURE(Fixture, "load_order_records") {
+    auto account = m_clientServiceLocatorClient->GetAccount();
+    auto otherAccount = m_serviceLocatorEnvironment.GetRoot().MakeAccount(
+      "other", "", DirectoryEntry::GetStarDirectory());
+    auto orderFields = OrderFields::BuildLimitOrder(account,
+      Security("TST", DefaultMarkets::NYSE(), DefaultCountries::US()),
+      DefaultCurrencies::USD(), Side::BID, "TEST", 100, Money::CENT);
+    auto firstOrder = m_clientProtocol->SendRequest<NewOrderSingleService>(
+      orderFields);
+    auto secondOrder = m_clientProtocol->SendRequest<NewOrderSingleService>(
+      orderFields);
+    auto orderRecords = m_clientProtocol->SendRequest<LoadOrderRecordsService>(
+      std::vector{account, otherAccount}, ptime(neg_infin), ptime(pos_infin),
+      OrderId(0), 10);
+    REQUIRE(orderRecords.size() == 2);
+    REQUIRE(orderRecords[0].m_info.m_orderId == (*firstOrder)->m_orderId);
+    REQUIRE(orderRecords[1].m_info.m_orderId == (*secondOrder)->m_orderId);
+    orderRecords = m_clientProtocol->SendRequest<LoadOrderRecordsService>(
+      std::vector{account}, ptime(neg_infin), ptime(pos_infin),
+      (*firstOrder)->m_orderId, 10);
+    REQUIRE(orderRecords.size() == 1);
+    REQUIRE(orderRecords[0].m_info.m_orderId == (*secondOrder)->m_orderId);
+    orderRecords = m_clientProtocol->SendRequest<LoadOrderRecordsService>(
+      std::vector{otherAccount}, ptime(neg_infin), ptime(pos_infin),
+      OrderId(0), 10);
+    REQUIRE(orderRecords.empty());
+  }
 }
@@ -0,0 +1,258 @@
+#include <boost/atomic/atomic.hpp>
+#include <boost/thread/thread.hpp>
+#include <doctest/doctest.h>
+#ifdef FAIL
+  #undef FAIL
+#endif
+#include "Nexus/Definitions/DefaultCountryDatabase.hpp"
+#include "Nexus/Definitions/DefaultCurrencyDatabase.hpp"
+#include "Nexus/Definitions/DefaultMarketDatabase.hpp"
+#include "Nexus/Definitions/DefaultTimeZoneDatabase.hpp"
+#include "Nexus/OrderExecutionService/BoardLotCheck.hpp"
+#include "Nexus/OrderExecutionService/OrderExecutionSession.hpp"
+#include "Nexus/OrderExecutionService/OrderSubmissionCheckDriver.hpp"
+#include "Nexus/OrderExecutionService/VirtualOrderExecutionDriver.hpp"
+#include "Nexus/OrderExecutionServiceTests/MockOrderExecutionDriver.hpp"
+#include "Nexus/ServiceClients/TestEnvironment.hpp"
+#include "Nexus/ServiceClients/TestServiceClients.hpp"
+
+using namespace Beam;
+using namespace Beam::ServiceLocator;
+using namespace boost;
+using namespace boost::posix_time;
+using namespace Nexus;
+using namespace Nexus::MarketDataService;
+using namespace Nexus::OrderExecutionService;
+using namespace Nexus::OrderExecutionService::Tests;
+
+namespace {
+  class TestCheck : public OrderSubmissionCheck {
+    public:
+      boost::atomic<int> m_submitCount;
+      boost::atomic<int> m_addCount;
+      boost::atomic<int> m_rejectCount;
+
+      TestCheck(bool isIndependent, std::string rejection,
+          time_duration delay = seconds(0))
+        : m_submitCount(0),
+          m_addCount(0),
+          m_rejectCount(0),
+          m_isIndependent(isIndependent),
+          m_rejection(std::move(rejection)),
+          m_delay(delay) {}
+
+      bool IsIndependent() const override {
+        return m_isIndependent;
+      }
+
+      void Submit(const OrderInfo& orderInfo) override {
+        boost::this_thread::sleep(m_delay);
+        ++m_submitCount;
+        if(!m_rejection.empty()) {
+          throw OrderSubmissionCheckException(m_rejection);
+        }
+      }
+
+      void Add(const Order& order) override {
+        ++m_addCount;
+      }
+
+      void Reject(const OrderInfo& orderInfo) override {
+        ++m_rejectCount;
+      }
+
+    private:
+      bool m_isIndependent;
+      std::string m_rejection;
+      time_duration m_delay;
+  };
+
+  struct Fixture {
+    using TestOrderSubmissionCheckDriver =
+      OrderSubmissionCheckDriver<MockOrderExecutionDriver*>;
+    MockOrderExecutionDriver m_mockDriver;
+    std::vector<TestCheck*> m_checks;
+    optional<TestOrderSubmissionCheckDriver> m_driver;
+
+    void MakeDriver(std::vector<std::unique_ptr<TestCheck>> checks) {
+      auto submissionChecks =
+        std::vector<std::unique_ptr<OrderSubmissionCheck>>();
+      for(auto& check : checks) {
+        m_checks.push_back(check.get());
+        submissionChecks.push_back(std::move(check));
+      }
+      m_driver.emplace(&m_mockDriver, std::move(submissionChecks));
+    }
+
+    OrderInfo MakeOrderInfo(OrderId orderId,
+        const DirectoryEntry& account = DirectoryEntry::GetRootAccount())
+        const {
+      return OrderInfo(OrderFields::BuildLimitOrder(account, Security("TST",
+        DefaultMarkets::TSX(), DefaultCountries::CA()),
+        DefaultCurrencies::CAD(), Side::BID, "TSX", 100, Money::ONE), orderId,
+        second_clock::universal_time());
+    }
+  };
+
+  auto MakeCheck(bool isIndependent, std::string rejection,
+      time_duration delay = seconds(0)) {
+    return std::make_unique<TestCheck>(isIndependent, std::move(rejection),
+      delay);
+  }
+
+  auto GetRejection(const Order& order) {
+    auto reason = std::string();
+    order.With(
+      [&] (OrderStatus status, const std::vector<ExecutionReport>& reports) {
+        REQUIRE(status == OrderStatus::REJECTED);
+        reason = reports.back().m_text;
+      });
+    return reason;
+  }
+}
+
+TEST_SUITE("OrderSubmissionCheckDriver") {
+  TEST_CASE_FIXTURE(Fixture, "accept") {
+    auto checks = std::vector<std::unique_ptr<TestCheck>>();
+    checks.push_back(MakeCheck(true, ""));
+    checks.push_back(MakeCheck(false, ""));
+    checks.push_back(MakeCheck(true, ""));
+    MakeDriver(std::move(checks));
+    auto& order = m_driver->Submit(MakeOrderInfo(1));
+    REQUIRE(&order == &m_mockDriver.FindOrder(1));
+    m_driver->Close();
+    for(auto check : m_checks) {
+      REQUIRE(check->m_submitCount == 1);
+      REQUIRE(check->m_addCount == 1);
+      REQUIRE(check->m_rejectCount == 0);
+    }
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "checks_finish_before_submit_returns") {
+    auto checks = std::vector<std::unique_ptr<TestCheck>>();
+    checks.push_back(MakeCheck(true, "", milliseconds(20)));
+    checks.push_back(MakeCheck(false, "second"));
+    checks.push_back(MakeCheck(true, "", milliseconds(20)));
+    MakeDriver(std::move(checks));
+    auto& order = m_driver->Submit(MakeOrderInfo(1));
+    REQUIRE(GetRejection(order) == "second");
+    REQUIRE(m_checks[0]->m_submitCount == 1);
+    REQUIRE(m_checks[0]->m_rejectCount == 1);
+    REQUIRE(m_checks[2]->m_rejectCount == m_checks[2]->m_submitCount);
+    m_driver->Close();
+    REQUIRE_THROWS(m_driver->Submit(MakeOrderInfo(2)));
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "declared_order_rejection") {
+    auto checks = std::vector<std::unique_ptr<TestCheck>>();
+    checks.push_back(MakeCheck(true, "first", milliseconds(20)));
+    checks.push_back(MakeCheck(false, "second"));
+    checks.push_back(MakeCheck(true, "third"));
+    MakeDriver(std::move(checks));
+    for(auto i = OrderId(1); i <= 5; ++i) {
+      auto& order = m_driver->Submit(MakeOrderInfo(i));
+      REQUIRE(GetRejection(order) == "first");
+    }
+    m_driver->Close();
+    REQUIRE(m_checks[0]->m_submitCount == 5);
+    for(auto check : m_checks) {
+      REQUIRE(check->m_addCount == 0);
+    }
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "early_rejection") {
+    auto checks = std::vector<std::unique_ptr<TestCheck>>();
+    checks.push_back(MakeCheck(false, "first"));
+    checks.push_back(MakeCheck(false, ""));
+    checks.push_back(MakeCheck(true, "", milliseconds(5)));
+    MakeDriver(std::move(checks));
+    auto& order = m_driver->Submit(MakeOrderInfo(1));
+    REQUIRE(GetRejection(order) == "first");
+    m_driver->Close();
+    REQUIRE(m_checks[1]->m_submitCount == 0);
+    REQUIRE(m_checks[1]->m_rejectCount == 0);
+    REQUIRE(m_checks[2]->m_rejectCount == m_checks[2]->m_submitCount);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "rollback") {
+    auto checks = std::vector<std::unique_ptr<TestCheck>>();
+    checks.push_back(MakeCheck(false, ""));
+    checks.push_back(MakeCheck(true, ""));
+    checks.push_back(MakeCheck(false, ""));
+    checks.push_back(MakeCheck(false, "fourth"));
+    checks.push_back(MakeCheck(true, "", milliseconds(20)));
+    MakeDriver(std::move(checks));
+    auto& order = m_driver->Submit(MakeOrderInfo(1));
+    REQUIRE(GetRejection(order) == "fourth");
+    m_driver->Close();
+    REQUIRE_THROWS(m_mockDriver.FindOrder(1));
+    REQUIRE(m_checks[0]->m_rejectCount == 1);
+    REQUIRE(m_checks[1]->m_rejectCount == 1);
+    REQUIRE(m_checks[2]->m_rejectCount == 1);
+    REQUIRE(m_checks[3]->m_rejectCount == 0);
+    REQUIRE(m_checks[4]->m_rejectCount == m_checks[4]->m_submitCount);
+    for(auto check : m_checks) {
+      REQUIRE(check->m_addCount == 0);
+    }
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "board_lot_check_rollback") {
+    auto environment = TestEnvironment();
+    auto serviceClients = TestServiceClients(Ref(environment));
+    auto dependentCheck = MakeCheck(false, "");
+    auto check = dependentCheck.get();
+    auto checks = std::vector<std::unique_ptr<OrderSubmissionCheck>>();
+    checks.push_back(std::move(dependentCheck));
+    checks.push_back(std::make_unique<BoardLotCheck<VirtualMarketDataClient*>>(
+      &serviceClients.GetMarketDataClient(), GetDefaultMarketDatabase(),
+      GetDefaultTimeZoneDatabase()));
+    auto driver = OrderSubmissionCheckDriver<MockOrderExecutionDriver*>(
+      &m_mockDriver, std::move(checks));
+    auto& order = driver.Submit(MakeOrderInfo(1));
+    REQUIRE(!GetRejection(order).empty());
+    driver.Close();
+    REQUIRE(check->m_submitCount == 1);
+    REQUIRE(check->m_rejectCount == 1);
+    REQUIRE(check->m_addCount == 0);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "rejected_order_retention_per_account") {
+    auto checks = std::vector<std::unique_ptr<TestCheck>>();
+    checks.push_back(MakeCheck(false, "rejected"));
+    MakeDriver(std::move(checks));
+    auto upstreamDriver = MakeVirtualOrderExecutionDriver(&*m_driver);
+    auto traderA = DirectoryEntry::MakeAccount(123, "trader_a");
+    auto traderB = DirectoryEntry::MakeAccount(124, "trader_b");
+    auto& orderB = upstreamDriver->Submit(MakeOrderInfo(1, traderB));
+    auto retention = TestOrderSubmissionCheckDriver::REJECTED_ORDER_RETENTION;
+    auto evictedCount = std::size_t(5);
+    auto orders = std::vector<const Order*>();
+    for(auto i = OrderId(2); i < retention + evictedCount + 2; ++i) {
+      auto& order = upstreamDriver->Submit(MakeOrderInfo(i, traderA));
+      if(i >= evictedCount + 2) {
+        orders.push_back(&order);
+      }
+    }
+    REQUIRE(orders.size() == retention);
+    REQUIRE(GetRejection(orderB) == "rejected");
+    auto sessionA = OrderExecutionSession();
+    sessionA.SetAccount(traderA);
+    for(auto i = std::size_t(0); i != orders.size(); ++i) {
+      auto orderId = OrderId(i + evictedCount + 2);
+      REQUIRE(orders[i]->GetInfo().m_orderId == orderId);
+      REQUIRE(GetRejection(*orders[i]) == "rejected");
+      REQUIRE_NOTHROW(upstreamDriver->Cancel(sessionA, orderId));
+    }
+    auto sessionB = OrderExecutionSession();
+    sessionB.SetAccount(traderB);
+    REQUIRE_NOTHROW(upstreamDriver->Cancel(sessionB, 1));
+
+    // Cancels of evicted Orders, or from another account, reach the mock
+    // driver, which has never seen them.
+    REQUIRE_THROWS(upstreamDriver->Cancel(sessionA, 2));
+    REQUIRE_THROWS(upstreamDriver->Cancel(sessionB, evictedCount + 2));
+    upstreamDriver->Close();
+    REQUIRE(m_checks[0]->m_submitCount ==
+      static_cast<int>(retention + evictedCount + 1));
+  }
+}
@@ -0,0 +1,379 @@
+#include <Beam/Queues/Queue.hpp>
+#include <boost/atomic/atomic.hpp>
+#include <boost/thread/thread.hpp>
+#include <doctest/doctest.h>
+#include "Nexus/OrderExecutionService/LocalOrderExecutionDataStore.hpp"
+#include "Nexus/OrderExecutionService/ReplicatedOrderExecutionDataStore.hpp"
+
+using namespace Beam;
+using namespace Beam::Queries;
+using namespace Beam::ServiceLocator;
+using namespace boost;
+using namespace boost::posix_time;
+using namespace Nexus;
+using namespace Nexus::OrderExecutionService;
+
+namespace {
+  class DelayedDataStore : public VirtualOrderExecutionDataStore {
+    public:
+      Queue<bool> m_gate;
+      boost::atomic<int> m_loadCount;
+      boost::atomic<int> m_storeCount;
+      boost::atomic<int> m_writeCount;
+
+      DelayedDataStore()
+        : m_loadCount(0),
+          m_storeCount(0),
+          m_writeCount(0) {}
+
+      std::vector<SequencedOrderRecord> LoadOrderSubmissions(
+          const AccountQuery& query) override {
+        CountLoad(query);
+        return m_dataStore.LoadOrderSubmissions(query);
+      }
+
+      std::vector<SequencedExecutionReport> LoadExecutionReports(
+          const AccountQuery& query) override {
+        CountLoad(query);
+        return m_dataStore.LoadExecutionReports(query);
+      }
+
+      std::vector<OrderRecord> LoadOrderRecords(
+          const std::vector<DirectoryEntry>& accounts, ptime startTime,
+          ptime endTime, OrderId startId, int maxCount) override {
+        ++m_loadCount;
+        return m_dataStore.LoadOrderRecords(accounts, startTime, endTime,
+          startId, maxCount);
+      }
+
+      void Store(const SequencedAccountOrderInfo& orderInfo) override {
+        Store(std::vector{orderInfo});
+      }
+
+      void Store(
+          const std::vector<SequencedAccountOrderInfo>& orderInfos) override {
+        m_gate.Pop();
+        m_dataStore.Store(orderInfos);
+        CountStore(orderInfos.size());
+      }
+
+      void Store(
+          const SequencedAccountExecutionReport& executionReport) override {
+        Store(std::vector{executionReport});
+      }
+
+      void Store(const std::vector<SequencedAccountExecutionReport>&
+          executionReports) override {
+        m_gate.Pop();
+        m_dataStore.Store(executionReports);
+        CountStore(executionReports.size());
+      }
+
+      void Close() override {}
+
+    private:
+      LocalOrderExecutionDataStore m_dataStore;
+
+      void CountStore(std::size_t writeCount) {
+        ++m_storeCount;
+        m_writeCount += static_cast<int>(writeCount);
+      }
+
+      void CountLoad(const AccountQuery& query) {
+
+        // Tail loads verify the replica against the primary, only count
+        // the queries routed to it.
+        if(query.GetSnapshotLimit() == SnapshotLimit::Unlimited()) {
+          ++m_loadCount;
+        }
+      }
+  };
+
+  class FaultyDataStore : public VirtualOrderExecutionDataStore {
+    public:
+      boost::atomic<bool> m_isFailing;
+      boost::atomic<int> m_failureCount;
+      boost::atomic<int> m_loadCount;
+      boost::atomic<int> m_tailLoadCount;
+
+      FaultyDataStore()
+        : m_isFailing(false),
+          m_failureCount(0),
+          m_loadCount(0),
+          m_tailLoadCount(0) {}
+
+      std::vector<SequencedOrderRecord> LoadOrderSubmissions(
+          const AccountQuery& query) override {
+        CountLoad(query);
+        return m_dataStore.LoadOrderSubmissions(query);
+      }
+
+      std::vector<SequencedExecutionReport> LoadExecutionReports(
+          const AccountQuery& query) override {
+        CountLoad(query);
+        return m_dataStore.LoadExecutionReports(query);
+      }
+
+      std::vector<OrderRecord> LoadOrderRecords(
+          const std::vector<DirectoryEntry>& accounts, ptime startTime,
+          ptime endTime, OrderId startId, int maxCount) override {
+        ++m_loadCount;
+        return m_dataStore.LoadOrderRecords(accounts, startTime, endTime,
+          startId, maxCount);
+      }
+
+      void Store(const SequencedAccountOrderInfo& orderInfo) override {
+        CheckFailure();
+        m_dataStore.Store(orderInfo);
+      }
+
+      void Store(
+          const std::vector<SequencedAccountOrderInfo>& orderInfos) override {
+        CheckFailure();
+        m_dataStore.Store(orderInfos);
+      }
+
+      void Store(
+          const SequencedAccountExecutionReport& executionReport) override {
+        CheckFailure();
+        m_dataStore.Store(executionReport);
+      }
+
+      void Store(const std::vector<SequencedAccountExecutionReport>&
+          executionReports) override {
+        CheckFailure();
+        m_dataStore.Store(executionReports);
+      }
+
+      void Close() override {}
+
+    private:
+      LocalOrderExecutionDataStore m_dataStore;
+
+      void CountLoad(const AccountQuery& query) {
+        if(query.GetSnapshotLimit() == SnapshotLimit::Unlimited()) {
+          ++m_loadCount;
+        } else {
+          ++m_tailLoadCount;
+        }
+      }
+
+      void CheckFailure() {
+        if(m_isFailing) {
+          ++m_failureCount;
+          throw std::runtime_error("Store failed.");
+        }
+      }
+  };
+
+  AccountQuery MakeQuery(const DirectoryEntry& account, Sequence end) {
+    auto query = AccountQuery();
+    query.SetIndex(account);
+    query.SetRange(Sequence::First(), end);
+    query.SetSnapshotLimit(SnapshotLimit::Unlimited());
+    return query;
+  }
+
+  SequencedAccountExecutionReport MakeReport(const DirectoryEntry& account,
+      int sequence) {
+    auto report = ExecutionReport::BuildInitialReport(1, ptime());
+    report.m_sequence = sequence;
+    return SequencedValue(IndexedValue(report, account),
+      Sequence(sequence + 1));
+  }
+
+  template<typename F>
+  void Wait(F&& condition) {
+    for(auto i = 0; i < 1000 && !condition(); ++i) {
+      boost::this_thread::sleep_for(boost::chrono::milliseconds(1));
+    }
+    REQUIRE(condition());
+  }
+
+  struct Fixture {
+    DirectoryEntry m_account;
+    DelayedDataStore* m_replica;
+    optional<ReplicatedOrderExecutionDataStore> m_dataStore;
+
+    Fixture()
+        : m_account(DirectoryEntry::MakeAccount(123, "simba")) {
+      auto replica = std::make_unique<DelayedDataStore>();
+      m_replica = replica.get();
+      auto replicas =
+        std::vector<std::unique_ptr<VirtualOrderExecutionDataStore>>();
+      replicas.push_back(std::move(replica));
+      m_dataStore.emplace(MakeVirtualOrderExecutionDataStore(
+        std::make_unique<LocalOrderExecutionDataStore>()),
+        std::move(replicas));
+    }
+
+    AccountQuery MakeQuery(Sequence end) const {
+      return ::MakeQuery(m_account, end);
+    }
+
+    SequencedAccountExecutionReport MakeReport(int sequence) const {
+      return ::MakeReport(m_account, sequence);
+    }
+
+    void WaitForReplica(const AccountQuery& query) {
+      for(auto i = 0; i < 1000 && m_replica->m_loadCount == 0; ++i) {
+        m_dataStore->LoadExecutionReports(query);
+        if(m_replica->m_loadCount == 0) {
+          boost::this_thread::sleep_for(boost::chrono::milliseconds(1));
+        }
+      }
+      REQUIRE(m_replica->m_loadCount != 0);
+    }
+  };
+}
+
+TEST_SUITE("ReplicatedOrderExecutionDataStore") {
+  TEST_CASE_FIXTURE(Fixture, "lagging_replica") {
+    auto orderInfo = SequencedValue(IndexedValue(
+      OrderInfo(OrderFields(), 1, ptime()), m_account), Sequence(1));
+    m_dataStore->Store(orderInfo);
+    auto submissions = m_dataStore->LoadOrderSubmissions(
+      MakeQuery(Sequence::Present()));
+    REQUIRE(submissions.size() == 1);
+    REQUIRE(m_replica->m_loadCount == 0);
+    m_replica->m_gate.Push(true);
+    m_dataStore->Store(MakeReport(0));
+    m_replica->m_gate.Push(true);
+    WaitForReplica(MakeQuery(Sequence::Present()));
+    m_dataStore->Close();
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "read_up_to_replicated_sequence") {
+    m_dataStore->Store(MakeReport(0));
+    m_replica->m_gate.Push(true);
+    WaitForReplica(MakeQuery(Sequence::Present()));
+    m_dataStore->Store(MakeReport(1));
+    auto loadCount = m_replica->m_loadCount.load();
+    auto reports = m_dataStore->LoadExecutionReports(
+      MakeQuery(Sequence::Present()));
+    REQUIRE(reports.size() == 2);
+    REQUIRE(m_replica->m_loadCount == loadCount);
+    reports = m_dataStore->LoadExecutionReports(MakeQuery(Sequence(1)));
+    REQUIRE(reports.size() == 1);
+    REQUIRE(m_replica->m_loadCount == loadCount + 1);
+    m_replica->m_gate.Push(true);
+    m_dataStore->Close();
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "batched_replication") {
+    m_dataStore->Store(MakeReport(0));
+    m_replica->m_gate.Push(true);
+    WaitForReplica(MakeQuery(Sequence::Present()));
+    auto storeCount = m_replica->m_storeCount.load();
+    auto writeCount = m_replica->m_writeCount.load();
+
+    // The first write holds the replica at its gate while the rest queue up
+    // behind it, so they are applied together once the gate opens.
+    for(auto i = 1; i <= 4; ++i) {
+      m_dataStore->Store(MakeReport(i));
+    }
+    m_replica->m_gate.Push(true);
+    m_replica->m_gate.Push(true);
+    Wait([&] {
+      return m_replica->m_writeCount == writeCount + 4;
+    });
+    REQUIRE(m_replica->m_storeCount - storeCount <= 2);
+    auto loadCount = m_replica->m_loadCount.load();
+    Wait([&] {
+      m_dataStore->LoadExecutionReports(MakeQuery(Sequence::Present()));
+      return m_replica->m_loadCount != loadCount;
+    });
+    REQUIRE(m_dataStore->LoadExecutionReports(
+      MakeQuery(Sequence::Present())).size() == 5);
+    m_dataStore->Close();
+  }
+
+  TEST_CASE("stores_skip_primary_tail") {
+    auto account = DirectoryEntry::MakeAccount(123, "simba");
+    auto primary = std::make_unique<FaultyDataStore>();
+    auto primaryDataStore = primary.get();
+    auto dataStore = ReplicatedOrderExecutionDataStore(std::move(primary),
+      {});
+    for(auto i = 0; i != 3; ++i) {
+      dataStore.Store(MakeReport(account, i));
+    }
+    REQUIRE(dataStore.LoadExecutionReports(
+      MakeQuery(account, Sequence::Present())).size() == 3);
+    REQUIRE(primaryDataStore->m_tailLoadCount == 0);
+    dataStore.Close();
+  }
+
+  TEST_CASE("primary_failure_propagates") {
+    auto account = DirectoryEntry::MakeAccount(123, "simba");
+    auto primary = std::make_unique<FaultyDataStore>();
+    auto primaryDataStore = primary.get();
+    auto replica = std::make_unique<FaultyDataStore>();
+    auto replicaDataStore = replica.get();
+    auto replicas =
+      std::vector<std::unique_ptr<VirtualOrderExecutionDataStore>>();
+    replicas.push_back(std::move(replica));
+    auto dataStore = ReplicatedOrderExecutionDataStore(std::move(primary),
+      std::move(replicas));
+    primaryDataStore->m_isFailing = true;
+    REQUIRE_THROWS_AS(dataStore.Store(MakeReport(account, 0)),
+      std::runtime_error);
+    primaryDataStore->m_isFailing = false;
+    REQUIRE(dataStore.LoadExecutionReports(
+      MakeQuery(account, Sequence::Present())).empty());
+    dataStore.Close();
+    REQUIRE(replicaDataStore->LoadExecutionReports(
+      MakeQuery(account, Sequence::Present())).empty());
+  }
+
+  TEST_CASE("faulted_replica_retries") {
+    auto account = DirectoryEntry::MakeAccount(123, "simba");
+    auto replica = std::make_unique<FaultyDataStore>();
+    auto replicaDataStore = replica.get();
+    replicaDataStore->m_isFailing = true;
+    auto replicas =
+      std::vector<std::unique_ptr<VirtualOrderExecutionDataStore>>();
+    replicas.push_back(std::move(replica));
+    auto dataStore = ReplicatedOrderExecutionDataStore(
+      MakeVirtualOrderExecutionDataStore(
+      std::make_unique<LocalOrderExecutionDataStore>()), std::move(replicas));
+    dataStore.Store(MakeReport(account, 0));
+    Wait([&] {
+      return replicaDataStore->m_failureCount != 0;
+    });
+    auto query = MakeQuery(account, Sequence::Present());
+    REQUIRE(dataStore.LoadExecutionReports(query).size() == 1);
+    REQUIRE(replicaDataStore->m_loadCount == 0);
+    replicaDataStore->m_isFailing = false;
+    dataStore.Store(MakeReport(account, 1));
+    Wait([&] {
+      dataStore.LoadExecutionReports(query);
+      return replicaDataStore->m_loadCount != 0;
+    });
+    dataStore.Close();
+    REQUIRE(replicaDataStore->LoadExecutionReports(query).size() == 2);
+  }
+
+  TEST_CASE("restart_resynchronizes_replica") {
+    auto account = DirectoryEntry::MakeAccount(123, "simba");
+    auto primary = std::make_unique<LocalOrderExecutionDataStore>();
+    primary->Store(MakeReport(account, 0));
+    primary->Store(MakeReport(account, 1));
+    auto replica = std::make_unique<FaultyDataStore>();
+    auto replicaDataStore = replica.get();
+    replicaDataStore->Store(MakeReport(account, 0));
+    auto replicas =
+      std::vector<std::unique_ptr<VirtualOrderExecutionDataStore>>();
+    replicas.push_back(std::move(replica));
+    auto dataStore = ReplicatedOrderExecutionDataStore(
+      MakeVirtualOrderExecutionDataStore(std::move(primary)),
+      std::move(replicas));
+    auto query = MakeQuery(account, Sequence::Present());
+    REQUIRE(dataStore.LoadExecutionReports(query).size() == 2);
+    Wait([&] {
+      dataStore.LoadExecutionReports(query);
+      return replicaDataStore->m_loadCount != 0;
+    });
+    dataStore.Close();
+    REQUIRE(replicaDataStore->LoadExecutionReports(query).size() == 2);
+  }
+}
@@ -0,0 +1,179 @@
+#include <Beam/Queues/Queue.hpp>
+#include <doctest/doctest.h>
+#include "Nexus/Definitions/DefaultCountryDatabase.hpp"
+#include "Nexus/Definitions/DefaultCurrencyDatabase.hpp"
+#include "Nexus/Definitions/DefaultMarketDatabase.hpp"
+#include "Nexus/OrderExecutionService/OrderExecutionSession.hpp"
+#include "Nexus/ServiceClients/TestEnvironment.hpp"
+#include "Nexus/ServiceClients/TestServiceClients.hpp"
+#include "Nexus/SimulationMatcher/SimulationMarketDataFeed.hpp"
+#include "Nexus/SimulationMatcher/SimulationOrderExecutionDriver.hpp"
+
+using namespace Beam;
+using namespace Beam::IO;
+using namespace Beam::ServiceLocator;
+using namespace Beam::TimeService;
+using namespace boost;
+using namespace boost::posix_time;
+using namespace Nexus;
+using namespace Nexus::MarketDataService;
+using namespace Nexus::OrderExecutionService;
+
+namespace {
+  const auto SHARD_COUNT = std::size_t(4);
+
+  struct Fixture {
+    using TestSimulationOrderExecutionDriver = SimulationOrderExecutionDriver<
+      VirtualMarketDataClient*, VirtualTimeClient*>;
+    TestEnvironment m_environment;
+    TestServiceClients m_serviceClients;
+    TestSimulationOrderExecutionDriver m_driver;
+    OrderId m_nextOrderId;
+
+    Fixture()
+      : m_serviceClients(Ref(m_environment)),
+        m_driver(&m_serviceClients.GetMarketDataClient(),
+          &m_serviceClients.GetTimeClient(), SHARD_COUNT),
+        m_nextOrderId(1) {}
+
+    Security MakeSecurity(std::string symbol) {
+      auto security = Security(std::move(symbol), DefaultMarkets::NASDAQ(),
+        DefaultCountries::US());
+      m_environment.Publish(security, BboQuote(
+        Quote(Money::ONE, 100, Side::BID),
+        Quote(Money::ONE + Money::CENT, 100, Side::ASK),
+        m_serviceClients.GetTimeClient().GetTime()));
+      return security;
+    }
+
+    OrderInfo MakeOrderInfo(const Security& security) {
+      return OrderInfo(OrderFields::BuildLimitOrder(
+        DirectoryEntry::GetRootAccount(), security, DefaultCurrencies::USD(),
+        Side::BID, "NASDAQ", 100, Money::ONE), m_nextOrderId++,
+        m_serviceClients.GetTimeClient().GetTime());
+    }
+  };
+
+  ExecutionReport RequireStatus(const Order& order, OrderStatus status) {
+    auto reports = std::make_shared<Queue<ExecutionReport>>();
+    order.GetPublisher().Monitor(reports);
+    while(true) {
+      auto report = reports->Pop();
+      if(report.m_status == status) {
+        return report;
+      }
+    }
+  }
+}
+
+TEST_SUITE("SimulationOrderExecutionDriver") {
+  TEST_CASE_FIXTURE(Fixture, "shard_routing") {
+    REQUIRE(m_driver.GetShardCount() == SHARD_COUNT);
+    auto securities = std::vector<Security>();
+    for(auto symbol : {"AAA", "BBB", "CCC", "DDD", "EEE", "FFF"}) {
+      securities.push_back(MakeSecurity(symbol));
+    }
+    for(auto& security : securities) {
+      auto shard = m_driver.GetShard(security);
+      REQUIRE(shard < SHARD_COUNT);
+      REQUIRE(shard == std::hash<Security>()(security) % SHARD_COUNT);
+      REQUIRE(m_driver.GetShard(security) == shard);
+    }
+    for(auto& security : securities) {
+      auto& order = m_driver.Submit(MakeOrderInfo(security));
+      RequireStatus(order, OrderStatus::NEW);
+      auto& nextOrder = m_driver.Submit(MakeOrderInfo(security));
+      RequireStatus(nextOrder, OrderStatus::NEW);
+      m_driver.Cancel(OrderExecutionSession(), order.GetInfo().m_orderId);
+      RequireStatus(order, OrderStatus::CANCELED);
+    }
+  }
+
+  TEST_CASE("single_shard") {
+    auto environment = TestEnvironment();
+    auto serviceClients = TestServiceClients(Ref(environment));
+    auto driver = SimulationOrderExecutionDriver<VirtualMarketDataClient*,
+      VirtualTimeClient*>(&serviceClients.GetMarketDataClient(),
+      &serviceClients.GetTimeClient(), 0);
+    REQUIRE(driver.GetShardCount() == 1);
+    REQUIRE(driver.GetShard(Security("TST", DefaultMarkets::NASDAQ(),
+      DefaultCountries::US())) == 0);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "shutdown") {
+    auto security = MakeSecurity("TST");
+    auto& order = m_driver.Submit(MakeOrderInfo(security));
+    RequireStatus(order, OrderStatus::NEW);
+    m_driver.Close();
+    REQUIRE(m_driver.GetShardCount() == SHARD_COUNT);
+    REQUIRE_THROWS_AS(m_driver.Submit(MakeOrderInfo(security)),
+      NotConnectedException);
+    REQUIRE_THROWS_AS(m_driver.Submit(MakeOrderInfo(MakeSecurity("NEW"))),
+      NotConnectedException);
+    REQUIRE_THROWS_AS(m_driver.Cancel(OrderExecutionSession(),
+      order.GetInfo().m_orderId), NotConnectedException);
+    REQUIRE_NOTHROW(m_driver.Close());
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "reject_without_bbo") {
+    auto security = Security("NOBBO", DefaultMarkets::NASDAQ(),
+      DefaultCountries::US());
+    auto& order = m_driver.Submit(MakeOrderInfo(security));
+    RequireStatus(order, OrderStatus::REJECTED);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "fill_on_bbo") {
+    auto security = MakeSecurity("TST");
+    auto& order = m_driver.Submit(MakeOrderInfo(security));
+    RequireStatus(order, OrderStatus::NEW);
+    m_environment.Publish(security, BboQuote(
+      Quote(Money::ONE - Money::CENT, 100, Side::BID),
+      Quote(Money::ONE, 100, Side::ASK),
+      m_serviceClients.GetTimeClient().GetTime()));
+    auto report = RequireStatus(order, OrderStatus::FILLED);
+    REQUIRE(report.m_lastPrice == Money::ONE);
+    REQUIRE(report.m_lastQuantity == 100);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "moc_fill_on_close") {
+    m_environment.SetTime(ptime(gregorian::date(2021, 3, 4), hours(15)));
+    auto security = MakeSecurity("TST");
+    auto orderInfo = MakeOrderInfo(security);
+    orderInfo.m_fields.m_timeInForce = TimeInForce(TimeInForce::Type::MOC);
+    auto& order = m_driver.Submit(orderInfo);
+    RequireStatus(order, OrderStatus::NEW);
+    m_environment.Publish(security, TimeAndSale(
+      ptime(gregorian::date(2021, 3, 4), hours(21)), 2 * Money::ONE, 500,
+      TimeAndSale::Condition(TimeAndSale::Condition::Type::REGULAR, "@"),
+      "TSE"));
+    auto report = RequireStatus(order, OrderStatus::FILLED);
+    REQUIRE(report.m_lastPrice == 2 * Money::ONE);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "shared_feed") {
+    auto security = MakeSecurity("TST");
+    auto feed = SimulationMarketDataFeed<VirtualMarketDataClient*>(
+      &m_serviceClients.GetMarketDataClient());
+    auto& publisher = feed.GetBboQuotePublisher(security);
+    REQUIRE(&feed.GetBboQuotePublisher(security) == &publisher);
+    auto first = std::make_shared<Queue<BboQuote>>();
+    auto second = std::make_shared<Queue<BboQuote>>();
+    publisher.Monitor(first);
+    publisher.Monitor(second);
+    REQUIRE(first->Pop().m_bid.m_price == Money::ONE);
+    REQUIRE(second->Pop().m_bid.m_price == Money::ONE);
+    m_environment.Publish(security, BboQuote(
+      Quote(2 * Money::ONE, 100, Side::BID),
+      Quote(2 * Money::ONE + Money::CENT, 100, Side::ASK),
+      m_serviceClients.GetTimeClient().GetTime()));
+    auto isUpdated = [] (auto& queue) {
+      while(true) {
+        if(queue->Pop().m_bid.m_price == 2 * Money::ONE) {
+          return true;
+        }
+      }
+    };
+    REQUIRE(isUpdated(first));
+    REQUIRE(isUpdated(second));
+  }
+}
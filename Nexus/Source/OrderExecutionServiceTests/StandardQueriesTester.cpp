@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <vector>
+#include <Beam/Queues/Queue.hpp>
+#include <doctest/doctest.h>
+#include "Nexus/Definitions/DefaultCountryDatabase.hpp"
+#include "Nexus/Definitions/DefaultCurrencyDatabase.hpp"
+#include "Nexus/Definitions/DefaultMarketDatabase.hpp"
+#include "Nexus/Definitions/DefaultTimeZoneDatabase.hpp"
+#include "Nexus/OrderExecutionService/LocalOrderExecutionDataStore.hpp"
+#include "Nexus/OrderExecutionService/PrimitiveOrder.hpp"
+#include "Nexus/OrderExecutionService/StandardQueries.hpp"
+
+using namespace Beam;
+using namespace Beam::Queries;
+using namespace Beam::ServiceLocator;
+using namespace boost;
+using namespace boost::gregorian;
+using namespace boost::posix_time;
+using namespace Nexus;
+using namespace Nexus::OrderExecutionService;
+
+namespace {
+  const auto TRADER = DirectoryEntry::MakeAccount(123, "trader");
+  const auto OTHER_TRADER = DirectoryEntry::MakeAccount(124, "other_trader");
+  const auto DAY = ptime(date(2024, 1, 10), hours(12));
+
+  /** Records the queries it receives and replies from a fixed snapshot. */
+  struct TestOrderExecutionClient {
+    std::vector<SequencedOrder> m_snapshot;
+    std::vector<AccountQuery> m_snapshotQueries;
+    std::shared_ptr<Queue<AccountQuery>> m_realTimeQueries;
+
+    TestOrderExecutionClient()
+      : m_realTimeQueries(std::make_shared<Queue<AccountQuery>>()) {}
+
+    void QueryOrderSubmissions(const AccountQuery& query,
+        ScopedQueueWriter<SequencedOrder> queue) {
+      m_snapshotQueries.push_back(query);
+      for(auto& order : m_snapshot) {
+        queue.Push(order);
+      }
+    }
+
+    void QueryOrderSubmissions(const AccountQuery& query,
+        ScopedQueueWriter<const Order*> queue) {
+      m_realTimeQueries->Push(query);
+    }
+  };
+
+  auto MakeOrderInfo(OrderId id, const DirectoryEntry& account,
+      MarketCode market, ptime timestamp) {
+    auto& entry = GetDefaultMarketDatabase().FromCode(market);
+    return SequencedValue(IndexedValue(OrderInfo(OrderFields::BuildLimitOrder(
+      account, Security("TST", market, entry.m_countryCode),
+      entry.m_currency, Side::BID, "", 100, Money::ONE), id, timestamp),
+      account), Sequence(id));
+  }
+
+  auto GetOrderIds(const std::vector<SequencedOrderRecord>& records) {
+    auto ids = std::vector<OrderId>();
+    for(auto& record : records) {
+      ids.push_back(record->m_info.m_orderId);
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+  }
+}
+
+TEST_SUITE("StandardQueries") {
+  TEST_CASE("daily_order_submissions_across_time_zones") {
+    auto& marketDatabase = GetDefaultMarketDatabase();
+    auto& timeZoneDatabase = GetDefaultTimeZoneDatabase();
+    auto tsxStart = MarketDateToUtc(DefaultMarkets::TSX(), DAY, marketDatabase,
+      timeZoneDatabase);
+    auto asxStart = MarketDateToUtc(DefaultMarkets::ASX(), DAY, marketDatabase,
+      timeZoneDatabase);
+    REQUIRE(asxStart < tsxStart);
+    auto dataStore = LocalOrderExecutionDataStore();
+    dataStore.Store(MakeOrderInfo(1, TRADER, DefaultMarkets::TSX(),
+      tsxStart + hours(1)));
+
+    // Inside the ASX's day but before the TSX's.
+    dataStore.Store(MakeOrderInfo(2, TRADER, DefaultMarkets::TSX(),
+      tsxStart - minutes(1)));
+    dataStore.Store(MakeOrderInfo(3, TRADER, DefaultMarkets::ASX(),
+      asxStart + hours(1)));
+
+    // Inside the TSX's day but after the ASX's.
+    dataStore.Store(MakeOrderInfo(4, TRADER, DefaultMarkets::ASX(),
+      asxStart + days(1)));
+    dataStore.Store(MakeOrderInfo(5, OTHER_TRADER, DefaultMarkets::TSX(),
+      tsxStart + hours(1)));
+    auto query = BuildDailyOrderSubmissionQuery(TRADER, DAY, DAY,
+      marketDatabase, timeZoneDatabase);
+    REQUIRE(GetOrderIds(dataStore.LoadOrderSubmissions(query)) ==
+      std::vector<OrderId>{1, 3});
+    auto perMarketIds = std::vector<OrderId>();
+    for(auto& market : marketDatabase.GetEntries()) {
+      auto marketQuery = BuildDailyOrderSubmissionQuery(market.m_code, TRADER,
+        DAY, DAY, marketDatabase, timeZoneDatabase);
+      for(auto id : GetOrderIds(dataStore.LoadOrderSubmissions(marketQuery))) {
+        perMarketIds.push_back(id);
+      }
+    }
+    std::sort(perMarketIds.begin(), perMarketIds.end());
+    REQUIRE(perMarketIds == std::vector<OrderId>{1, 3});
+  }
+
+  TEST_CASE("daily_order_submissions_open_ended") {
+    auto& marketDatabase = GetDefaultMarketDatabase();
+    auto& timeZoneDatabase = GetDefaultTimeZoneDatabase();
+    auto tsxStart = MarketDateToUtc(DefaultMarkets::TSX(), DAY, marketDatabase,
+      timeZoneDatabase);
+    auto dataStore = LocalOrderExecutionDataStore();
+    dataStore.Store(MakeOrderInfo(1, TRADER, DefaultMarkets::TSX(),
+      tsxStart - minutes(1)));
+    dataStore.Store(MakeOrderInfo(2, TRADER, DefaultMarkets::TSX(),
+      tsxStart + days(3)));
+    auto query = BuildDailyOrderSubmissionQuery(TRADER, DAY, pos_infin,
+      marketDatabase, timeZoneDatabase);
+    REQUIRE(query.GetRange().GetEnd() == Range::Point(ptime(pos_infin)));
+    REQUIRE(GetOrderIds(dataStore.LoadOrderSubmissions(query)) ==
+      std::vector<OrderId>{2});
+  }
+
+  TEST_CASE("monitor_daily_order_submissions") {
+    auto& marketDatabase = GetDefaultMarketDatabase();
+    auto& timeZoneDatabase = GetDefaultTimeZoneDatabase();
+    auto client = TestOrderExecutionClient();
+    auto order = PrimitiveOrder(MakeOrderInfo(1, TRADER, DefaultMarkets::TSX(),
+      DAY)->GetValue());
+    client.m_snapshot.push_back(SequencedValue(&order, Sequence(5)));
+    auto orders = std::make_shared<Queue<const Order*>>();
+    MonitorDailyOrderSubmissions(TRADER, DAY, marketDatabase, timeZoneDatabase,
+      client, orders);
+    REQUIRE(orders->Pop() == &order);
+    auto realTimeQuery = client.m_realTimeQueries->Pop();
+    REQUIRE(client.m_snapshotQueries.size() == 1);
+    auto& snapshotQuery = client.m_snapshotQueries.front();
+    auto dailyQuery = BuildDailyOrderSubmissionQuery(TRADER, DAY, DAY,
+      marketDatabase, timeZoneDatabase);
+    REQUIRE(snapshotQuery.GetIndex() == TRADER);
+    REQUIRE(snapshotQuery.GetRange().GetStart() ==
+      dailyQuery.GetRange().GetStart());
+    REQUIRE(snapshotQuery.GetRange().GetEnd() ==
+      dailyQuery.GetRange().GetEnd());
+    REQUIRE(realTimeQuery.GetIndex() == TRADER);
+    REQUIRE(realTimeQuery.GetRange().GetStart() ==
+      Range::Point(Increment(Sequence(5))));
+  }
+
+  TEST_CASE("monitor_daily_order_submissions_without_snapshot") {
+    auto client = TestOrderExecutionClient();
+    auto orders = std::make_shared<Queue<const Order*>>();
+    MonitorDailyOrderSubmissions(TRADER, DAY, GetDefaultMarketDatabase(),
+      GetDefaultTimeZoneDatabase(), client, orders);
+    auto realTimeQuery = client.m_realTimeQueries->Pop();
+    REQUIRE(client.m_snapshotQueries.size() == 1);
+    REQUIRE(realTimeQuery.GetRange().GetStart() == Range::Point(DAY));
+  }
+}
@@ -287,6 +287,7 @@ void Nexus::Python::ExportDestination(pybind11::module& module) {
     .def(init())
     .def(init<const DestinationDatabase&>())
     .def("from_id", &DestinationDatabase::FromId)
+    .def("from_market", &DestinationDatabase::FromMarket)
     .def("get_preferred_destination",
       &DestinationDatabase::GetPreferredDestination)
     .def("select_entry",
@@ -738,7 +739,7 @@ void Nexus::Python::ExportTradingSchedule(pybind11::module& module) {
   auto outer = class_<TradingSchedule>(module, "TradingSchedule")
     .def(init<std::vector<TradingSchedule::Rule>>())
     .def("find", [] (TradingSchedule& self, date date, MarketCode market) {
-      return self.Find(date, market);
+      return *self.Find(date, market);
     })
     .def("find", [] (TradingSchedule& self, date date, MarketCode market,
         const object& f) {
@@ -1,6 +1,7 @@
 #include "Nexus/Python/FeeHandling.hpp"
 #include <Beam/Python/Beam.hpp>
 #include <boost/lexical_cast.hpp>
+#include <pybind11/stl.h>
 #include "Nexus/FeeHandling/AmexFeeTable.hpp"
 #include "Nexus/FeeHandling/ArcaFeeTable.hpp"
 #include "Nexus/FeeHandling/AsxtFeeTable.hpp"
@@ -208,6 +209,10 @@ void Nexus::Python::ExportConsolidatedTmxFeeTable(pybind11::module& module) {
   module.def("calculate_fee", static_cast<ExecutionReport (*)(
     const ConsolidatedTmxFeeTable&, ConsolidatedTmxFeeTable::State&,
     const Order&, const ExecutionReport&)>(&CalculateFee));
+  module.def("calculate_fees", static_cast<std::vector<ExecutionReport> (*)(
+    const ConsolidatedTmxFeeTable&, ConsolidatedTmxFeeTable::State&,
+    const std::vector<OrderInfo>&, const std::vector<ExecutionReport>&)>(
+    &CalculateFees));
 }
 
 void Nexus::Python::ExportConsolidatedUsFeeTable(pybind11::module& module) {
@@ -231,6 +236,9 @@ void Nexus::Python::ExportConsolidatedUsFeeTable(pybind11::module& module) {
   module.def("calculate_fee", static_cast<ExecutionReport (*)(
     const ConsolidatedUsFeeTable&, const Order&, const ExecutionReport&)>(
     &CalculateFee));
+  module.def("calculate_fees", static_cast<std::vector<ExecutionReport> (*)(
+    const ConsolidatedUsFeeTable&, const std::vector<OrderInfo>&,
+    const std::vector<ExecutionReport>&)>(&CalculateFees));
 }
 
 void Nexus::Python::ExportCseFeeTable(pybind11::module& module) {
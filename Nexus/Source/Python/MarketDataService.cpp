@@ -49,6 +49,11 @@ using namespace pybind11;
 
 namespace {
   struct TrampolineHistoricalDataStore final : VirtualHistoricalDataStore {
+    using InitialSequencesMap =
+      std::unordered_map<Security, SecurityEntry::InitialSequences>;
+    using LastPricesMap =
+      std::unordered_map<Security, std::unordered_map<std::string, Money>>;
+
     boost::optional<SecurityInfo> LoadSecurityInfo(
         const Security& security) override {
       PYBIND11_OVERLOAD_PURE_NAME(boost::optional<SecurityInfo>,
@@ -62,6 +67,17 @@ namespace {
         LoadAllSecurityInfo);
     }
 
+    InitialSequencesMap LoadAllInitialSequences() override {
+      PYBIND11_OVERLOAD_PURE_NAME(InitialSequencesMap,
+        VirtualHistoricalDataStore, "load_all_initial_sequences",
+        LoadAllInitialSequences);
+    }
+
+    LastPricesMap LoadAllLastPrices() override {
+      PYBIND11_OVERLOAD_PURE_NAME(LastPricesMap, VirtualHistoricalDataStore,
+        "load_all_last_prices", LoadAllLastPrices);
+    }
+
     std::vector<SequencedOrderImbalance> LoadOrderImbalances(
         const MarketWideDataQuery& query) override {
       PYBIND11_OVERLOAD_PURE_NAME(std::vector<SequencedOrderImbalance>,
@@ -238,6 +254,20 @@ namespace {
         "load_security_technicals", LoadSecurityTechnicals, security);
     }
 
+    std::vector<SecuritySnapshot> LoadSecuritySnapshots(
+        const std::vector<Security>& securities) override {
+      PYBIND11_OVERLOAD_PURE_NAME(std::vector<SecuritySnapshot>,
+        VirtualMarketDataClient, "load_security_snapshots",
+        LoadSecuritySnapshots, securities);
+    }
+
+    std::vector<SecurityTechnicals> LoadSecurityTechnicalsList(
+        const std::vector<Security>& securities) override {
+      PYBIND11_OVERLOAD_PURE_NAME(std::vector<SecurityTechnicals>,
+        VirtualMarketDataClient, "load_security_technicals_list",
+        LoadSecurityTechnicalsList, securities);
+    }
+
     boost::optional<SecurityInfo> LoadSecurityInfo(
         const Security& security) override {
       PYBIND11_OVERLOAD_PURE_NAME(boost::optional<SecurityInfo>,
@@ -246,10 +276,11 @@ namespace {
     }
 
     std::vector<SecurityInfo> LoadSecurityInfoFromPrefix(
-        const std::string& prefix) override {
+        const std::string& prefix, const Security& start,
+        int count) override {
       PYBIND11_OVERLOAD_PURE_NAME(std::vector<SecurityInfo>,
         VirtualMarketDataClient, "load_security_info_from_prefix",
-        LoadSecurityInfoFromPrefix, prefix);
+        LoadSecurityInfoFromPrefix, prefix, start, count);
     }
 
     void Close() override {
@@ -432,12 +463,26 @@ void Nexus::Python::ExportApplicationMarketDataFeedClient(
 }
 
 void Nexus::Python::ExportHistoricalDataStore(pybind11::module& module) {
+  class_<SecurityEntry::InitialSequences>(module, "InitialSequences")
+    .def(init())
+    .def(init<const SecurityEntry::InitialSequences&>())
+    .def_readwrite("next_bbo_quote_sequence",
+      &SecurityEntry::InitialSequences::m_nextBboQuoteSequence)
+    .def_readwrite("next_book_quote_sequence",
+      &SecurityEntry::InitialSequences::m_nextBookQuoteSequence)
+    .def_readwrite("next_market_quote_sequence",
+      &SecurityEntry::InitialSequences::m_nextMarketQuoteSequence)
+    .def_readwrite("next_time_and_sale_sequence",
+      &SecurityEntry::InitialSequences::m_nextTimeAndSaleSequence);
   class_<VirtualHistoricalDataStore, TrampolineHistoricalDataStore,
       std::shared_ptr<VirtualHistoricalDataStore>>(module,
     "HistoricalDataStore")
     .def("load_security_info", &VirtualHistoricalDataStore::LoadSecurityInfo)
     .def("load_all_security_info",
       &VirtualHistoricalDataStore::LoadAllSecurityInfo)
+    .def("load_all_initial_sequences",
+      &VirtualHistoricalDataStore::LoadAllInitialSequences)
+    .def("load_all_last_prices", &VirtualHistoricalDataStore::LoadAllLastPrices)
     .def("load_order_imbalances",
       &VirtualHistoricalDataStore::LoadOrderImbalances)
     .def("load_bbo_quotes", &VirtualHistoricalDataStore::LoadBboQuotes)
@@ -518,6 +563,10 @@ void Nexus::Python::ExportMarketDataClient(pybind11::module& module) {
       &VirtualMarketDataClient::LoadSecuritySnapshot)
     .def("load_security_technicals",
       &VirtualMarketDataClient::LoadSecurityTechnicals)
+    .def("load_security_snapshots",
+      &VirtualMarketDataClient::LoadSecuritySnapshots)
+    .def("load_security_technicals_list",
+      &VirtualMarketDataClient::LoadSecurityTechnicalsList)
     .def("load_security_info", &VirtualMarketDataClient::LoadSecurityInfo)
     .def("load_security_info_from_prefix",
       &VirtualMarketDataClient::LoadSecurityInfoFromPrefix)
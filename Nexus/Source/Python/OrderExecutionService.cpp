@@ -80,6 +80,14 @@ namespace {
         std::move(queue));
     }
 
+    std::vector<OrderRecord> LoadOrderRecords(
+        const std::vector<DirectoryEntry>& accounts, ptime startTime,
+        ptime endTime, OrderId startId, int maxCount) override {
+      PYBIND11_OVERLOAD_PURE_NAME(std::vector<OrderRecord>,
+        VirtualOrderExecutionClient, "load_order_records", LoadOrderRecords,
+        accounts, startTime, endTime, startId, maxCount);
+    }
+
     const Order& Submit(const OrderFields& fields) override {
       PYBIND11_OVERLOAD_PURE_NAME(const Order&, VirtualOrderExecutionClient,
         "submit", Submit, fields);
@@ -221,6 +229,7 @@ void Nexus::Python::ExportOrderExecutionClient(pybind11::module& module) {
       &VirtualOrderExecutionClient::QueryOrderSubmissions))
     .def("query_execution_reports",
       &VirtualOrderExecutionClient::QueryExecutionReports)
+    .def("load_order_records", &VirtualOrderExecutionClient::LoadOrderRecords)
     .def("submit", &VirtualOrderExecutionClient::Submit,
       return_value_policy::reference_internal)
     .def("cancel", &VirtualOrderExecutionClient::Cancel)
@@ -485,7 +494,15 @@ void Nexus::Python::ExportPrimitiveOrder(pybind11::module& module) {
 
 void Nexus::Python::ExportStandardQueries(pybind11::module& module) {
   module.def("build_daily_order_submission_query",
-    &BuildDailyOrderSubmissionQuery);
+    static_cast<AccountQuery (*)(MarketCode, const DirectoryEntry&, ptime,
+      ptime, const MarketDatabase&, const local_time::tz_database&)>(
+      &BuildDailyOrderSubmissionQuery));
+  module.def("build_daily_order_submission_query",
+    static_cast<AccountQuery (*)(const DirectoryEntry&, ptime, ptime,
+      const MarketDatabase&, const local_time::tz_database&)>(
+      &BuildDailyOrderSubmissionQuery));
   module.def("query_daily_order_submissions",
     &QueryDailyOrderSubmissions<VirtualOrderExecutionClient>);
+  module.def("export_order_records",
+    &ExportOrderRecords<VirtualOrderExecutionClient>);
 }
@@ -0,0 +1,60 @@
+#include <cstdint>
+#include <string>
+#include <Beam/IO/BufferReader.hpp>
+#include <Beam/IO/SharedBuffer.hpp>
+#include <Beam/Utilities/Endian.hpp>
+#include <doctest/doctest.h>
+#include "Nexus/SoupBinTcp/SoupBinTcpPacket.hpp"
+
+using namespace Beam;
+using namespace Beam::IO;
+using namespace Nexus;
+using namespace Nexus::SoupBinTcp;
+
+namespace {
+  auto MakePacket(std::uint16_t length, char type,
+      const std::string& payload) {
+    auto packet = SharedBuffer();
+    packet.Append(ToBigEndian(length));
+    packet.Append(type);
+    packet.Append(payload.data(), payload.size());
+    return packet;
+  }
+}
+
+TEST_SUITE("SoupBinTcpPacket") {
+  TEST_CASE("read_packet") {
+    auto reader = BufferReader<SharedBuffer>(MakePacket(4, 'S', "abc"));
+    auto buffer = SharedBuffer();
+    auto packet = ReadPacket(reader, Store(buffer));
+    REQUIRE(packet.m_length == 4);
+    REQUIRE(packet.m_type == 'S');
+    REQUIRE(std::string(packet.m_payload, packet.m_length - 1) == "abc");
+  }
+
+  TEST_CASE("payload_appended_to_buffer") {
+    auto reader = BufferReader<SharedBuffer>(MakePacket(3, 'S', "de"));
+    auto buffer = SharedBuffer();
+    buffer.Append("abc", 3);
+    auto packet = ReadPacket(reader, Store(buffer));
+    REQUIRE(buffer.GetSize() == 5);
+    REQUIRE(packet.m_payload == buffer.GetData() + 3);
+    REQUIRE(std::string(packet.m_payload, packet.m_length - 1) == "de");
+  }
+
+  TEST_CASE("empty_payload") {
+    auto reader = BufferReader<SharedBuffer>(MakePacket(1, 'H', ""));
+    auto buffer = SharedBuffer();
+    auto packet = ReadPacket(reader, Store(buffer));
+    REQUIRE(packet.m_length == 1);
+    REQUIRE(packet.m_type == 'H');
+    REQUIRE(buffer.GetSize() == 0);
+  }
+
+  TEST_CASE("zero_length") {
+    auto reader = BufferReader<SharedBuffer>(MakePacket(0, 'S', "abc"));
+    auto buffer = SharedBuffer();
+    REQUIRE_THROWS_AS(ReadPacket(reader, Store(buffer)),
+      SoupBinTcpParserException);
+  }
+}
@@ -0,0 +1,80 @@
+#include <string>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/lexical_cast.hpp>
+#include <doctest/doctest.h>
+#include "Nexus/StampProtocol/StampMessage.hpp"
+
+using namespace boost;
+using namespace boost::gregorian;
+using namespace boost::posix_time;
+using namespace Nexus;
+using namespace Nexus::StampProtocol;
+
+namespace {
+  auto MakeMessage(const std::string& data) {
+    return StampMessage(StampHeader(), data.data(), data.size());
+  }
+}
+
+TEST_SUITE("StampMessage") {
+  TEST_CASE("business_content_excludes_separator") {
+    auto data = std::string("control\x1c\x1e" "1=abc");
+    auto message = MakeMessage(data);
+    REQUIRE(message.GetBusinessContentData() == data.data() + 8);
+    REQUIRE(message.GetBusinessContentSize() == 6);
+    REQUIRE(message.GetBusinessFieldView(1) == std::string_view("abc"));
+  }
+
+  TEST_CASE("no_business_content") {
+    auto data = std::string("control\x1e" "1=abc");
+    auto message = MakeMessage(data);
+    REQUIRE(message.GetBusinessContentData() == nullptr);
+    REQUIRE(message.GetBusinessContentSize() == 0);
+    REQUIRE(!message.GetBusinessFieldView(1));
+  }
+
+  TEST_CASE("field_lookup_bounded_by_size") {
+    // The message is a prefix of a larger buffer, so only the fields within
+    // the first message may be found and values end at the message's end.
+    auto data = std::string("c\x1c\x1e" "1=abc\x1e" "2=def\x1e" "3=ghi");
+    auto message = StampMessage(StampHeader(), data.data(), data.size() - 7);
+    REQUIRE(message.GetBusinessFieldView(1) == std::string_view("abc"));
+    REQUIRE(message.GetBusinessFieldView(2) == std::string_view("de"));
+    REQUIRE(!message.GetBusinessFieldView(3));
+  }
+
+  TEST_CASE("field_identifier_straddling_end") {
+    auto data = std::string("c\x1c\x1e" "1=abc\x1e" "12=def");
+    auto message = StampMessage(StampHeader(), data.data(), data.size() - 4);
+    REQUIRE(!message.GetBusinessFieldView(12));
+    REQUIRE(message.GetBusinessFieldView(1) == std::string_view("abc"));
+  }
+
+  TEST_CASE("ordered_fields") {
+    auto data = std::string("c\x1c\x1e" "5.1=a\x1e" "5.2=b\x03");
+    auto message = MakeMessage(data);
+    REQUIRE(message.GetBusinessFieldView(5, 1) == std::string_view("a"));
+    REQUIRE(message.GetBusinessFieldView(5, 2) == std::string_view("b"));
+    REQUIRE(!message.GetBusinessFieldView(5));
+  }
+
+  TEST_CASE("typed_fields") {
+    auto data = std::string("c\x1c\x1e" "1=12\x1e" "2=1.25\x1e" "3=Sell\x1e"
+      "4=2024011012304550\x1e" "5=xyz");
+    auto message = MakeMessage(data);
+    REQUIRE(message.GetBusinessField<int>(1) == 12);
+    REQUIRE(message.GetBusinessField<Money>(2) == Money::FromValue("1.25"));
+    REQUIRE(message.GetBusinessField<Side>(3) == Side(Side::ASK));
+    REQUIRE(message.GetBusinessField<ptime>(4) == ptime(date(2024, 1, 10),
+      hours(12) + minutes(30) + seconds(45) + milliseconds(500)));
+    REQUIRE(message.GetBusinessField<std::string>(5) == std::string("xyz"));
+    REQUIRE(!message.GetBusinessField<int>(6));
+  }
+
+  TEST_CASE("invalid_timestamp_digit") {
+    // A byte outside of ASCII within the minutes.
+    auto data = std::string("c\x1c\x1e" "1=2024011012\xe9" "04550");
+    auto message = MakeMessage(data);
+    REQUIRE_THROWS_AS(message.GetBusinessField<ptime>(1), bad_lexical_cast);
+  }
+}